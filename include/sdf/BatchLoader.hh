@@ -0,0 +1,125 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_BATCHLOADER_HH_
+#define SDF_BATCHLOADER_HH_
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sdf/Error.hh"
+#include "sdf/Root.hh"
+#include "sdf/sdf_config.h"
+#include "sdf/system_util.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  // Forward declare private data class.
+  class BatchLoaderPrivate;
+
+  /// \brief The result of loading one file with a BatchLoader.
+  struct SDFORMAT_VISIBLE BatchLoadResult
+  {
+    /// \brief Name of the loaded file, as given to BatchLoader::Load.
+    std::string filename;
+
+    /// \brief The loaded document.
+    Root root;
+
+    /// \brief Errors of the file, the same as the ones returned by
+    /// Root::Load(const std::string &).
+    Errors errors;
+
+    /// \brief Time spent reading and parsing the file, including its
+    /// includes and conversion to the latest SDF version.
+    std::chrono::steady_clock::duration readTime{0};
+
+    /// \brief Time spent building the DOM objects and frame graphs.
+    std::chrono::steady_clock::duration loadTime{0};
+  };
+
+  /// \brief Loads many SDF files, one Root per file, on a pool of threads.
+  ///
+  /// The files of a batch share state that Root::Load would otherwise
+  /// compute again for each file: the schema is parsed once and copied
+  /// for each file, the paths found for file names and include URIs are
+  /// remembered, and the SDF version conversion recipes are parsed once.
+  /// The paths set with sdf::addURIPath and sdf::setFindCallback must not
+  /// change while a batch is loading. The numeric locale is set to C before
+  /// the threads start, and the messages they write go through the Console,
+  /// which serializes them.
+  class SDFORMAT_VISIBLE BatchLoader
+  {
+    /// \brief Default constructor
+    public: BatchLoader();
+
+    /// \brief Copy constructor is deleted, since the caches are not
+    /// copyable.
+    public: BatchLoader(const BatchLoader &_loader) = delete;
+
+    /// \brief Copy assignment operator is deleted.
+    public: BatchLoader &operator=(const BatchLoader &_loader) = delete;
+
+    /// \brief Destructor
+    public: ~BatchLoader();
+
+    /// \brief Set the number of threads that load files.
+    /// \param[in] _threads Maximum number of threads. The default is 0,
+    /// which uses the number of hardware threads.
+    public: void SetThreads(unsigned int _threads);
+
+    /// \brief Get the number of threads that load files.
+    /// \return Maximum number of threads, 0 for the number of hardware
+    /// threads.
+    public: unsigned int Threads() const;
+
+    /// \brief Load files. File paths found by previous calls are reused.
+    /// \param[in] _filenames Names of the files to load, which are found
+    /// like in Root::Load(const std::string &).
+    /// \return One result per file, in the order of _filenames.
+    public: std::vector<BatchLoadResult> Load(
+                const std::vector<std::string> &_filenames);
+
+    /// \brief Get the number of file and URI lookups that were answered by
+    /// the cache, over all the calls to Load.
+    /// \return Number of cache hits.
+    public: std::size_t FindFileHits() const;
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<BatchLoaderPrivate> dataPtr;
+  };
+  }
+}
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif
@@ -21,6 +21,7 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <sdf/sdf_config.h>
@@ -77,7 +78,10 @@ namespace sdf
               stream(_stream) {}
 
       /// \brief Redirect whatever is passed in to both our ostream
-      ///        (if non-NULL) and the log file (if open).
+      ///        (if non-NULL) and the log file (if open). The values are
+      ///        collected per thread, and a message is written at once
+      ///        when it ends with a new line, or else when the next message
+      ///        of the thread starts.
       /// \param[in] _rhs Content to be logged.
       /// \return Reference to myself.
       public: template <class T>
@@ -92,6 +96,18 @@ namespace sdf
                           const std::string &_file,
                           unsigned int _line, int _color);
 
+      /// \brief Get the stream in which the message of the calling thread
+      /// is collected. A message of another stream that did not end with a
+      /// new line is written first.
+      /// \return Stream of the message.
+      private: std::ostream &MessageStream();
+
+      /// \brief Write the message of the calling thread to both our
+      /// ostream and the log file, under a single lock.
+      /// \param[in] _ended True to only write the message if it ends with
+      /// a new line.
+      private: void WriteMessage(bool _ended);
+
       /// \brief The ostream to log to; can be NULL/nullptr.
       private: std::ostream *stream;
     };
@@ -148,23 +164,19 @@ namespace sdf
 
     /// \brief logfile stream
     public: std::ofstream logFileStream;
+
+    /// \brief Serializes the writes of whole messages to the streams,
+    /// which may come from several threads, such as those of
+    /// Root::SetLoadThreads.
+    public: std::mutex mutex;
   };
 
   ///////////////////////////////////////////////
   template <class T>
   Console::ConsoleStream &Console::ConsoleStream::operator<<(const T &_rhs)
   {
-    if (this->stream)
-    {
-      *this->stream << _rhs;
-    }
-
-    if (Console::Instance()->dataPtr->logFileStream.is_open())
-    {
-      Console::Instance()->dataPtr->logFileStream << _rhs;
-      Console::Instance()->dataPtr->logFileStream.flush();
-    }
-
+    this->MessageStream() << _rhs;
+    this->WriteMessage(true);
     return *this;
   }
   }
@@ -18,13 +18,16 @@
 #define SDF_ELEMENT_HH_
 
 #include <any>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "sdf/MemoryBreakdown.hh"
 #include "sdf/Param.hh"
 #include "sdf/sdf_config.h"
 #include "sdf/system_util.hh"
@@ -45,6 +48,9 @@ namespace sdf
   inline namespace SDF_VERSION_NAMESPACE {
   //
 
+  class ElementEdit;
+  class ElementPath;
+  class ElementVisitor;
   class ElementPrivate;
   class SDFORMAT_VISIBLE Element;
 
@@ -310,6 +316,53 @@ namespace sdf
     /// child = child->GetNextElement() to iterate through the children.
     public: ElementPtr GetNextElement(const std::string &_name = "") const;
 
+    /// \brief Get the first element matched by a compiled path, evaluated
+    /// relative to this element.
+    /// \param[in] _path Compiled path.
+    /// \return The first matching element, or nullptr if there is no match.
+    /// \sa ElementPath
+    public: ElementPtr Select(const ElementPath &_path) const;
+
+    /// \brief Get all the elements matched by a compiled path, evaluated
+    /// relative to this element. All matches are collected in a single
+    /// traversal of the tree.
+    /// \param[in] _path Compiled path.
+    /// \return The matching elements in document order.
+    /// \sa ElementPath
+    public: ElementPtr_V SelectAll(const ElementPath &_path) const;
+
+    /// \brief Get a hash of the structure of this element and all of its
+    /// descendants: names, attributes, values, include file names, file
+    /// paths and original versions. Structurally identical subtrees have
+    /// the same hash. Hashes are cached per element and only the elements
+    /// that changed since the previous call, and their ancestors, are
+    /// hashed again.
+    /// \remarks Calling this function concurrently on overlapping trees is
+    /// not thread safe, since it updates the cache.
+    /// \return Hash of the subtree rooted at this element.
+    public: std::size_t Hash() const;
+
+    /// \brief Replace each descendant whose name is in _names by an earlier
+    /// descendant that is structurally identical, so that both parents
+    /// share a single subtree. Sharing stops at the first shared element,
+    /// nested elements of a shared subtree are not visited again.
+    ///
+    /// Shared subtrees must be treated as immutable. Modifying one affects
+    /// every parent it is shared with, and its parent is the parent of the
+    /// first occurrence. Clone an element before modifying it.
+    /// \param[in] _names Names of the elements that may be shared, for
+    /// example visual, collision, material and sensor.
+    /// \return Number of subtrees that were replaced.
+    public: std::size_t DeduplicateSubtrees(
+                const std::set<std::string> &_names);
+
+    /// \brief Estimate the memory held by this element and its descendants.
+    /// Subtrees shared by several parents are counted once. The element
+    /// descriptions, which Clone copies into every element, are counted in
+    /// the description bytes.
+    /// \return Memory breakdown of the subtree rooted at this element.
+    public: MemoryBreakdown MemoryUsage() const;
+
     /// \brief Get set of child element type names.
     /// \return A set of the names of the child elements.
     public: std::set<std::string> GetElementTypeNames() const;
@@ -353,6 +406,12 @@ namespace sdf
     /// \param[in] _elem the element object to add.
     public: void InsertElement(ElementPtr _elem);
 
+    /// \brief Add an element object at a given position.
+    /// \param[in] _elem the element object to add.
+    /// \param[in] _index Position of the new child element. The element is
+    /// appended if _index is not less than the number of child elements.
+    public: void InsertElement(ElementPtr _elem, std::size_t _index);
+
     /// \brief Remove this element from its parent.
     public: void RemoveFromParent();
 
@@ -444,6 +503,19 @@ namespace sdf
                                   const std::string &_description="");
 
 
+    /// \brief Get the index of child element positions keyed by element
+    /// name. The index is built on first use and discarded whenever the
+    /// children of this element change.
+    /// \return The child index.
+    private: std::shared_ptr<const
+             std::unordered_map<std::string, std::vector<std::size_t>>>
+             ChildIndex() const;
+
+    friend class ElementPath;
+    friend class ElementVisitor;
+    friend std::vector<ElementEdit> Diff(const ElementPtr &_a,
+                                         const ElementPtr &_b);
+
     /// \brief Private data pointer
     private: std::unique_ptr<ElementPrivate> dataPtr;
   };
@@ -490,6 +562,28 @@ namespace sdf
 
     /// \brief Spec version that this was originally parsed from.
     public: std::string originalVersion;
+
+    /// \brief Positions of the child elements keyed by element name. Built
+    /// lazily by Element::ChildIndex and reset to nullptr when the child
+    /// elements change. Always accessed with std::atomic_load/store so that
+    /// concurrent readers of a tree can share it.
+    public: std::shared_ptr<const
+            std::unordered_map<std::string, std::vector<std::size_t>>>
+            childIndex;
+
+    /// \brief True if hash and ownHash are up to date with the structure
+    /// of this element. Parameter changes are detected with paramRevision.
+    public: bool hashValid = false;
+
+    /// \brief Cached hash of the subtree rooted at this element.
+    public: std::size_t hash = 0;
+
+    /// \brief Cached hash of this element without its children.
+    public: std::size_t ownHash = 0;
+
+    /// \brief Sum of the revisions of the attributes and value when
+    /// ownHash was computed.
+    public: std::uint64_t paramRevision = 0;
   };
 
   ///////////////////////////////////////////////
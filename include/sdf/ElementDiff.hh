@@ -0,0 +1,180 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_ELEMENTDIFF_HH_
+#define SDF_ELEMENTDIFF_HH_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "sdf/Element.hh"
+#include "sdf/Error.hh"
+#include "sdf/sdf_config.h"
+#include "sdf/system_util.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::string and std::shared_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \enum ElementEditType
+  /// \brief The types of edits in an ElementPatch.
+  enum class ElementEditType
+  {
+    /// \brief Insert a copy of ElementEdit::Element() as a child of the
+    /// element at ElementEdit::Path(), at position ElementEdit::Index().
+    INSERT,
+
+    /// \brief Remove the element at ElementEdit::Path().
+    REMOVE,
+
+    /// \brief Set the attribute ElementEdit::Key() of the element at
+    /// ElementEdit::Path() to ElementEdit::Value(). A string attribute is
+    /// added if the element does not have the attribute.
+    SET_ATTRIBUTE,
+
+    /// \brief Set the value of the element at ElementEdit::Path() to
+    /// ElementEdit::Value().
+    SET_VALUE,
+  };
+
+  /// \brief A single edit of an Element tree, produced by sdf::Diff.
+  ///
+  /// Paths use the ElementPath syntax and are relative to the root of the
+  /// patched tree. An empty path refers to the root itself. Each path is
+  /// valid for the tree as it is when the edit is applied, after all the
+  /// previous edits of the patch.
+  class SDFORMAT_VISIBLE ElementEdit
+  {
+    /// \brief Default constructor
+    public: ElementEdit() = default;
+
+    /// \brief Constructor for REMOVE, SET_ATTRIBUTE and SET_VALUE edits.
+    /// \param[in] _type Type of the edit.
+    /// \param[in] _path Path of the edited element.
+    /// \param[in] _key Attribute name for SET_ATTRIBUTE edits.
+    /// \param[in] _value New value for SET_ATTRIBUTE and SET_VALUE edits.
+    public: ElementEdit(ElementEditType _type, const std::string &_path,
+                        const std::string &_key = "",
+                        const std::string &_value = "");
+
+    /// \brief Constructor for INSERT edits.
+    /// \param[in] _path Path of the parent of the inserted element.
+    /// \param[in] _elem Element to insert. A copy is inserted each time the
+    /// edit is applied.
+    /// \param[in] _index Position of the inserted element among the children
+    /// of its parent.
+    public: ElementEdit(const std::string &_path, ElementPtr _elem,
+                        std::size_t _index);
+
+    /// \brief Get the type of the edit.
+    /// \return Type of the edit.
+    public: ElementEditType Type() const;
+
+    /// \brief Get the path of the edited element, or of the parent of the
+    /// inserted element for INSERT edits.
+    /// \return Path relative to the root of the patched tree.
+    public: const std::string &Path() const;
+
+    /// \brief Get the attribute name of a SET_ATTRIBUTE edit.
+    /// \return Attribute name.
+    public: const std::string &Key() const;
+
+    /// \brief Get the new value of a SET_ATTRIBUTE or SET_VALUE edit.
+    /// \return New value as a string.
+    public: const std::string &Value() const;
+
+    /// \brief Get the element inserted by an INSERT edit.
+    /// \return Element to insert, or nullptr for other edits.
+    public: ElementPtr Element() const;
+
+    /// \brief Get the position of the element inserted by an INSERT edit.
+    /// \return Position among the children of the parent.
+    public: std::size_t Index() const;
+
+    /// \brief Type of the edit.
+    private: ElementEditType type = ElementEditType::SET_VALUE;
+
+    /// \brief Path of the edited element.
+    private: std::string path;
+
+    /// \brief Attribute name.
+    private: std::string key;
+
+    /// \brief New value.
+    private: std::string value;
+
+    /// \brief Element to insert.
+    private: ElementPtr elem;
+
+    /// \brief Position of the inserted element.
+    private: std::size_t index = 0;
+  };
+
+  /// \brief Output operator for an edit, one line per edit except for the
+  /// XML of inserted elements.
+  /// \param[in,out] _out The output stream.
+  /// \param[in] _edit The edit to output.
+  /// \return Reference to the given output stream
+  SDFORMAT_VISIBLE
+  std::ostream &operator<<(std::ostream &_out, const ElementEdit &_edit);
+
+  /// \brief An edit script that transforms one Element tree into another.
+  using ElementPatch = std::vector<ElementEdit>;
+
+  /// \brief Compute the edits that transform a tree into another one.
+  ///
+  /// Child elements are matched by name and name attribute, or by position
+  /// among the siblings with the same name when the name attribute is not
+  /// unique. Matched subtrees with the same structural hash are skipped, so
+  /// the cost is linear in the size of the trees and unchanged subtrees
+  /// are not compared. Attributes and values that exist in _a but not in _b
+  /// are left unchanged, since Element does not support removing them. The
+  /// order of matched siblings that were reordered is not changed.
+  /// \param[in] _a Tree to transform.
+  /// \param[in] _b Tree to obtain. Its root should have the same name as
+  /// the root of _a.
+  /// \return The edits, in the order they must be applied.
+  /// \sa Element::Hash
+  SDFORMAT_VISIBLE
+  ElementPatch Diff(const ElementPtr &_a, const ElementPtr &_b);
+
+  /// \brief Apply a patch produced by sdf::Diff.
+  /// \param[in] _elem Root of the tree to modify.
+  /// \param[in] _patch Edits to apply in order.
+  /// \return Errors, which is a vector of Error objects. Each Error includes
+  /// an error code and message. An empty vector indicates no error. Edits
+  /// that fail are skipped and the remaining edits are still applied.
+  SDFORMAT_VISIBLE
+  Errors Apply(const ElementPtr &_elem, const ElementPatch &_patch);
+  }
+}
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_ELEMENTPATH_HH_
+#define SDF_ELEMENTPATH_HH_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "sdf/Element.hh"
+#include "sdf/Error.hh"
+#include "sdf/sdf_config.h"
+#include "sdf/system_util.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  // Forward declare private data class.
+  class ElementPathPrivate;
+
+  /// \brief A compiled query over an Element tree.
+  ///
+  /// A path is compiled once and can then be evaluated against any number of
+  /// elements with Element::Select and Element::SelectAll. The syntax is a
+  /// small subset of XPath, relative to the element the path is evaluated on:
+  ///
+  /// - `a/b` selects the `<b>` children of the `<a>` children.
+  /// - `a//b` selects the `<b>` descendants of the `<a>` children. A leading
+  ///   `//` selects descendants of the context element.
+  /// - `*` matches any element name.
+  /// - `[@key]` keeps elements that have the attribute `key`.
+  /// - `[@key='value']` keeps elements whose attribute `key` equals `value`.
+  /// - `[key='value']` keeps elements whose attribute or child element `key`
+  ///   equals `value`, using the same lookup order as Element::Get.
+  /// - `[N]` keeps the N-th (1-based) candidate of each context element.
+  ///
+  /// For example, `world/model[@name='x']/link/sensor[@type='camera']`.
+  class SDFORMAT_VISIBLE ElementPath
+  {
+    /// \brief Default constructor. The resulting path is empty and matches
+    /// nothing.
+    public: ElementPath();
+
+    /// \brief Constructor that compiles a path. Use Valid() to check the
+    /// result, or Compile() to get the errors.
+    /// \param[in] _path Path to compile.
+    public: explicit ElementPath(const std::string &_path);
+
+    /// \brief Copy constructor
+    /// \param[in] _path ElementPath to copy.
+    public: ElementPath(const ElementPath &_path);
+
+    /// \brief Move constructor
+    /// \param[in] _path ElementPath to move.
+    public: ElementPath(ElementPath &&_path) noexcept;
+
+    /// \brief Copy assignment operator.
+    /// \param[in] _path ElementPath to copy.
+    /// \return Reference to this.
+    public: ElementPath &operator=(const ElementPath &_path);
+
+    /// \brief Move assignment operator.
+    /// \param[in] _path ElementPath to move.
+    /// \return Reference to this.
+    public: ElementPath &operator=(ElementPath &&_path) noexcept;
+
+    /// \brief Destructor
+    public: ~ElementPath();
+
+    /// \brief Compile a path, replacing the current one.
+    /// \param[in] _path Path to compile.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: sdf::Errors Compile(const std::string &_path);
+
+    /// \brief Get whether the path compiled successfully and has at least
+    /// one step.
+    /// \return True if the path can be evaluated.
+    public: bool Valid() const;
+
+    /// \brief Get the source string of the path.
+    /// \return The string that was compiled.
+    public: const std::string &Str() const;
+
+    /// \brief Find the first element matched by this path. Candidates are
+    /// visited depth first, which is document order unless the path
+    /// contains a `//` step.
+    /// \param[in] _elem Context element.
+    /// \return The first match or nullptr.
+    private: ElementPtr First(const Element &_elem) const;
+
+    /// \brief Find all the elements matched by this path in a single
+    /// traversal.
+    /// \param[in] _elem Context element.
+    /// \return All matches in document order, without duplicates.
+    private: ElementPtr_V All(const Element &_elem) const;
+
+    /// \brief Append the elements reached from a context element by one
+    /// step, after applying the predicates of that step.
+    /// \param[in] _ctx Context element.
+    /// \param[in] _step Index of the step.
+    /// \param[out] _out Vector the candidates are appended to.
+    /// \param[out] _walked If not null, the descendants visited by a `//`
+    /// step are appended to it in document order.
+    private: void Collect(const Element &_ctx, std::size_t _step,
+                 ElementPtr_V &_out, ElementPtr_V *_walked = nullptr) const;
+
+    friend class Element;
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<ElementPathPrivate> dataPtr;
+  };
+  }
+}
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_ELEMENTVISITOR_HH_
+#define SDF_ELEMENTVISITOR_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "sdf/Element.hh"
+#include "sdf/sdf_config.h"
+#include "sdf/system_util.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  // Forward declare private data class.
+  class ElementVisitorPrivate;
+
+  /// \brief Action returned by the pre-visit hook of an ElementVisitor.
+  enum class TraversalAction
+  {
+    /// \brief Visit the children of the element.
+    CONTINUE,
+
+    /// \brief Do not visit the children of the element. The post-visit hook
+    /// of the element is still called.
+    SKIP_CHILDREN,
+
+    /// \brief Stop the traversal. No further hooks are called.
+    STOP,
+  };
+
+  /// \brief Hook called when an element is entered, before its children.
+  /// The depth of the element the traversal starts from is 0.
+  using ElementPreVisit = std::function<
+    TraversalAction(const ElementPtr &_elem, std::size_t _depth)>;
+
+  /// \brief Hook called when an element is left, after its children.
+  using ElementPostVisit = std::function<
+    void(const ElementPtr &_elem, std::size_t _depth)>;
+
+  /// \brief Predicate that selects the subtrees that may be visited
+  /// concurrently.
+  using ElementSubtreeFilter = std::function<
+    bool(const ElementPtr &_elem, std::size_t _depth)>;
+
+  /// \brief Depth-first traversal of an Element tree with pre-visit and
+  /// post-visit hooks. The traversal uses an explicit stack, so the depth of
+  /// the tree is not limited by the native stack size.
+  ///
+  /// By default every hook runs on the calling thread, in document order.
+  /// When independent subtrees are set with SetIndependentSubtrees, every
+  /// element selected by the filter (for example the top-level models of a
+  /// world) is visited as a task on a pool of threads after the rest of the
+  /// tree has been entered. Post-visit hooks of the elements that were not
+  /// deferred run on the calling thread once all the tasks are done, so the
+  /// post-visit hook of an element is always called after those of its
+  /// descendants. Hooks must be thread safe when subtrees are independent.
+  class SDFORMAT_VISIBLE ElementVisitor
+  {
+    /// \brief Default constructor. The visitor has no hooks.
+    public: ElementVisitor();
+
+    /// \brief Copy constructor
+    /// \param[in] _visitor ElementVisitor to copy.
+    public: ElementVisitor(const ElementVisitor &_visitor);
+
+    /// \brief Move constructor
+    /// \param[in] _visitor ElementVisitor to move.
+    public: ElementVisitor(ElementVisitor &&_visitor) noexcept;
+
+    /// \brief Copy assignment operator.
+    /// \param[in] _visitor ElementVisitor to copy.
+    /// \return Reference to this.
+    public: ElementVisitor &operator=(const ElementVisitor &_visitor);
+
+    /// \brief Move assignment operator.
+    /// \param[in] _visitor ElementVisitor to move.
+    /// \return Reference to this.
+    public: ElementVisitor &operator=(ElementVisitor &&_visitor) noexcept;
+
+    /// \brief Destructor
+    public: ~ElementVisitor();
+
+    /// \brief Set the hook called when an element is entered.
+    /// \param[in] _pre Pre-visit hook, or nullptr to visit every child.
+    public: void SetPreVisit(const ElementPreVisit &_pre);
+
+    /// \brief Set the hook called when an element is left.
+    /// \param[in] _post Post-visit hook, or nullptr.
+    public: void SetPostVisit(const ElementPostVisit &_post);
+
+    /// \brief Set the subtrees that can be visited concurrently. The filter
+    /// is called for every element below the element the traversal starts
+    /// from, before its pre-visit hook. Subtrees nested in a selected
+    /// subtree are visited by the same task.
+    /// \param[in] _filter Filter, or nullptr to visit everything on the
+    /// calling thread.
+    /// \param[in] _threads Maximum number of threads. 0 uses the number of
+    /// hardware threads.
+    public: void SetIndependentSubtrees(const ElementSubtreeFilter &_filter,
+                unsigned int _threads = 0);
+
+    /// \brief Visit an element and all of its descendants.
+    /// \param[in] _elem Element to start from, at depth 0.
+    /// \return False if a pre-visit hook returned TraversalAction::STOP.
+    public: bool Visit(const ElementPtr &_elem) const;
+
+    /// \brief Visit the descendants of an element, but not the element
+    /// itself. The element does not need to be owned by a shared pointer.
+    /// \param[in] _elem Element whose children are visited at depth 1.
+    /// \return False if a pre-visit hook returned TraversalAction::STOP.
+    public: bool VisitChildren(const Element &_elem) const;
+
+    /// \brief State shared by the walks of one traversal.
+    private: struct WalkState;
+
+    /// \brief Visit a list of subtrees, fanning out independent subtrees
+    /// if a filter is set.
+    /// \param[in] _roots Subtrees to visit.
+    /// \param[in] _depth Depth of the roots.
+    /// \return False if the traversal was stopped.
+    private: bool Run(const ElementPtr_V &_roots, std::size_t _depth) const;
+
+    /// \brief Visit a single subtree on the calling thread.
+    /// \param[in] _root Subtree to visit.
+    /// \param[in] _depth Depth of the root.
+    /// \param[in,out] _state State of the traversal.
+    /// \return False if the traversal was stopped.
+    private: bool Walk(const ElementPtr &_root, std::size_t _depth,
+                 WalkState &_state) const;
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<ElementVisitorPrivate> dataPtr;
+  };
+  }
+}
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif
@@ -134,6 +134,9 @@ namespace sdf
 
     /// \brief The specified placement frame is invalid
     MODEL_PLACEMENT_FRAME_INVALID,
+
+    /// \brief An element path could not be compiled.
+    ELEMENT_PATH_INVALID,
   };
 
   class SDFORMAT_VISIBLE Error
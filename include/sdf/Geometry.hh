@@ -33,8 +33,10 @@ namespace sdf
   class Capsule;
   class Cylinder;
   class Ellipsoid;
+  class Heightmap;
   class Mesh;
   class Plane;
+  class Polyline;
   class Sphere;
 
   /// \enum GeometryType
@@ -64,6 +66,12 @@ namespace sdf
 
     /// \brief An ellipsoid geometry
     ELLIPSOID = 8,
+
+    /// \brief A heightmap geometry.
+    HEIGHTMAP = 9,
+
+    /// \brief A polyline geometry.
+    POLYLINE = 10,
   };
 
   /// \brief Geometry provides access to a shape, such as a Box. Use the
@@ -189,6 +197,28 @@ namespace sdf
     /// \param[in] _mesh The mesh shape.
     public: void SetMeshShape(const Mesh &_mesh);
 
+    /// \brief Get the heightmap geometry, or nullptr if the contained
+    /// geometry is not a heightmap.
+    /// \return Pointer to the heightmap geometry, or nullptr if the geometry
+    /// is not a heightmap.
+    /// \sa GeometryType Type() const
+    public: const Heightmap *HeightmapShape() const;
+
+    /// \brief Set the heightmap shape.
+    /// \param[in] _heightmap The heightmap shape.
+    public: void SetHeightmapShape(const Heightmap &_heightmap);
+
+    /// \brief Get the polyline geometry, or nullptr if the contained
+    /// geometry is not a polyline.
+    /// \return Pointer to the polyline geometry, or nullptr if the geometry
+    /// is not a polyline.
+    /// \sa GeometryType Type() const
+    public: const Polyline *PolylineShape() const;
+
+    /// \brief Set the polyline shape.
+    /// \param[in] _polyline The polyline shape.
+    public: void SetPolylineShape(const Polyline &_polyline);
+
     /// \brief Get a pointer to the SDF element that was used during
     /// load.
     /// \return SDF element pointer. The value will be nullptr if Load has
@@ -0,0 +1,410 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_HEIGHTMAP_HH_
+#define SDF_HEIGHTMAP_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <ignition/math/Vector3.hh>
+#include <sdf/Element.hh>
+#include <sdf/Error.hh>
+#include <sdf/sdf_config.h>
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  // Forward declare private data class.
+  class HeightmapBlendPrivate;
+  class HeightmapDataPrivate;
+  class HeightmapPrivate;
+  class HeightmapTexturePrivate;
+
+  /// \brief Texture to be used on heightmaps.
+  class SDFORMAT_VISIBLE HeightmapTexture
+  {
+    /// \brief Constructor
+    public: HeightmapTexture();
+
+    /// \brief Copy constructor
+    /// \param[in] _texture HeightmapTexture to copy.
+    public: HeightmapTexture(const HeightmapTexture &_texture);
+
+    /// \brief Move constructor
+    /// \param[in] _texture HeightmapTexture to move.
+    public: HeightmapTexture(HeightmapTexture &&_texture) noexcept;
+
+    /// \brief Destructor
+    public: virtual ~HeightmapTexture();
+
+    /// \brief Move assignment operator.
+    /// \param[in] _texture Heightmap texture to move.
+    /// \return Reference to this.
+    public: HeightmapTexture &operator=(HeightmapTexture &&_texture);
+
+    /// \brief Copy Assignment operator.
+    /// \param[in] _texture The heightmap texture to set values from.
+    /// \return *this
+    public: HeightmapTexture &operator=(const HeightmapTexture &_texture);
+
+    /// \brief Load the heightmap texture geometry based on a element pointer.
+    /// This is *not* the usual entry point. Typical usage of the SDF DOM is
+    /// through the Root object.
+    /// \param[in] _sdf The SDF Element pointer
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Load(ElementPtr _sdf);
+
+    /// \brief Get the heightmap texture's size.
+    /// \return The size of the heightmap texture in meters.
+    public: double Size() const;
+
+    /// \brief Set the size of the texture in meters.
+    /// \param[in] _size The size of the texture in meters.
+    public: void SetSize(double _size);
+
+    /// \brief Get the heightmap texture's diffuse map.
+    /// \return The diffuse map of the heightmap texture.
+    public: std::string Diffuse() const;
+
+    /// \brief Set the filename of the diffuse map.
+    /// \param[in] _diffuse The diffuse map of the heightmap texture.
+    public: void SetDiffuse(const std::string &_diffuse);
+
+    /// \brief Get the heightmap texture's normal map.
+    /// \return The normal map of the heightmap texture.
+    public: std::string Normal() const;
+
+    /// \brief Set the filename of the normal map.
+    /// \param[in] _normal The normal map of the heightmap texture.
+    public: void SetNormal(const std::string &_normal);
+
+    /// \brief Get a pointer to the SDF element that was used during load.
+    /// \return SDF element pointer. The value will be nullptr if Load has
+    /// not been called.
+    public: sdf::ElementPtr Element() const;
+
+    /// \brief Private data pointer.
+    private: HeightmapTexturePrivate *dataPtr;
+  };
+
+  /// \brief Blend information to be used between textures on heightmaps.
+  class SDFORMAT_VISIBLE HeightmapBlend
+  {
+    /// \brief Constructor
+    public: HeightmapBlend();
+
+    /// \brief Copy constructor
+    /// \param[in] _blend HeightmapBlend to copy.
+    public: HeightmapBlend(const HeightmapBlend &_blend);
+
+    /// \brief Move constructor
+    /// \param[in] _blend HeightmapBlend to move.
+    public: HeightmapBlend(HeightmapBlend &&_blend) noexcept;
+
+    /// \brief Destructor
+    public: virtual ~HeightmapBlend();
+
+    /// \brief Move assignment operator.
+    /// \param[in] _blend Heightmap blend to move.
+    /// \return Reference to this.
+    public: HeightmapBlend &operator=(HeightmapBlend &&_blend);
+
+    /// \brief Copy Assignment operator.
+    /// \param[in] _blend The heightmap blend to set values from.
+    /// \return *this
+    public: HeightmapBlend &operator=(const HeightmapBlend &_blend);
+
+    /// \brief Load the heightmap blend geometry based on a element pointer.
+    /// This is *not* the usual entry point. Typical usage of the SDF DOM is
+    /// through the Root object.
+    /// \param[in] _sdf The SDF Element pointer
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Load(ElementPtr _sdf);
+
+    /// \brief Get the heightmap blend's minimum height.
+    /// \return The minimum height of the blend layer.
+    public: double MinHeight() const;
+
+    /// \brief Set the minimum height of the blend in meters.
+    /// \param[in] _minHeight The minimum height of the blend layer.
+    public: void SetMinHeight(double _minHeight);
+
+    /// \brief Get the heightmap blend's fade distance.
+    /// \return The distance over which the blend occurs.
+    public: double FadeDistance() const;
+
+    /// \brief Set the distance over which the blend occurs.
+    /// \param[in] _fadeDistance The distance in meters.
+    public: void SetFadeDistance(double _fadeDistance);
+
+    /// \brief Get a pointer to the SDF element that was used during load.
+    /// \return SDF element pointer. The value will be nullptr if Load has
+    /// not been called.
+    public: sdf::ElementPtr Element() const;
+
+    /// \brief Private data pointer.
+    private: HeightmapBlendPrivate *dataPtr;
+  };
+
+  /// \brief Read-only access to the height samples of a heightmap file.
+  ///
+  /// Load only reads the header of the file. The samples are read on demand
+  /// in tiles of TileRows() consecutive rows, which are memory mapped where
+  /// the platform supports it, and at most MaxResidentTiles() tiles are kept,
+  /// the least recently used tile being released first. A sample query on a
+  /// very large terrain therefore only touches the tiles around the sample.
+  ///
+  /// The supported formats are binary PGM images ("P5", 8 or 16 bits per
+  /// sample), and square raw grids of unsigned samples without a header:
+  /// little-endian 16 bits for the .raw and .r16 extensions and 8 bits for
+  /// the .r8 extension. Samples are normalized to [0, 1].
+  ///
+  /// All the functions are thread-safe.
+  class SDFORMAT_VISIBLE HeightmapData
+  {
+    /// \brief Constructor of data with no samples.
+    public: HeightmapData();
+
+    /// \brief Destructor. Releases the mapped tiles and closes the file.
+    public: ~HeightmapData();
+
+    /// \brief Copy constructor, deleted because the tiles refer to an open
+    /// file. Share the data through a std::shared_ptr instead.
+    public: HeightmapData(const HeightmapData &) = delete;
+
+    /// \brief Copy assignment operator, deleted.
+    /// \return Reference to this.
+    public: HeightmapData &operator=(const HeightmapData &) = delete;
+
+    /// \brief Open a heightmap file and read its header. Any previously
+    /// opened file is closed.
+    /// \param[in] _path Path to the file.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Load(const std::string &_path);
+
+    /// \brief Get the path of the opened file.
+    /// \return The path given to Load, or an empty string.
+    public: const std::string &Path() const;
+
+    /// \brief Get the number of samples in each row.
+    /// \return Number of columns, or 0 if no file is open.
+    public: uint64_t Cols() const;
+
+    /// \brief Get the number of rows of samples.
+    /// \return Number of rows, or 0 if no file is open.
+    public: uint64_t Rows() const;
+
+    /// \brief Get a sample of the grid.
+    /// \param[in] _col Column of the sample, less than Cols().
+    /// \param[in] _row Row of the sample, less than Rows(). The first row is
+    /// at the top of an image.
+    /// \return The sample normalized to [0, 1], or 0 if it is out of range.
+    public: double Value(uint64_t _col, uint64_t _row) const;
+
+    /// \brief Get the bilinear interpolation of the samples at a point of the
+    /// grid.
+    /// \param[in] _u Position along the rows, from 0 at the first column to 1
+    /// at the last one. Values outside of [0, 1] are clamped.
+    /// \param[in] _v Position along the columns, from 0 at the first row to 1
+    /// at the last one. Values outside of [0, 1] are clamped.
+    /// \return The interpolated sample, in [0, 1].
+    public: double Sample(double _u, double _v) const;
+
+    /// \brief Get the number of rows in each tile.
+    /// \return Number of rows in each tile. The default is 64.
+    public: uint64_t TileRows() const;
+
+    /// \brief Set the number of rows in each tile. The resident tiles are
+    /// released.
+    /// \param[in] _rows Number of rows in each tile, at least 1.
+    public: void SetTileRows(uint64_t _rows);
+
+    /// \brief Get the maximum number of tiles kept in memory.
+    /// \return Maximum number of resident tiles. The default is 64.
+    public: std::size_t MaxResidentTiles() const;
+
+    /// \brief Set the maximum number of tiles kept in memory. Least recently
+    /// used tiles are released to honor the new limit.
+    /// \param[in] _count Maximum number of resident tiles, at least 1.
+    public: void SetMaxResidentTiles(std::size_t _count);
+
+    /// \brief Get the number of tiles currently in memory.
+    /// \return Number of resident tiles.
+    public: std::size_t ResidentTileCount() const;
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<HeightmapDataPrivate> dataPtr;
+  };
+
+  /// \brief Heightmap represents a shape defined by a 2D field, and is usually
+  /// accessed through a Geometry.
+  class SDFORMAT_VISIBLE Heightmap
+  {
+    /// \brief Constructor
+    public: Heightmap();
+
+    /// \brief Copy constructor
+    /// \param[in] _heightmap Heightmap to copy.
+    public: Heightmap(const Heightmap &_heightmap);
+
+    /// \brief Move constructor
+    /// \param[in] _heightmap Heightmap to move.
+    public: Heightmap(Heightmap &&_heightmap) noexcept;
+
+    /// \brief Destructor
+    public: virtual ~Heightmap();
+
+    /// \brief Move assignment operator.
+    /// \param[in] _heightmap Heightmap to move.
+    /// \return Reference to this.
+    public: Heightmap &operator=(Heightmap &&_heightmap);
+
+    /// \brief Copy Assignment operator.
+    /// \param[in] _heightmap The heightmap to set values from.
+    /// \return *this
+    public: Heightmap &operator=(const Heightmap &_heightmap);
+
+    /// \brief Load the heightmap geometry based on a element pointer.
+    /// This is *not* the usual entry point. Typical usage of the SDF DOM is
+    /// through the Root object. The height data is not read.
+    /// \param[in] _sdf The SDF Element pointer
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Load(ElementPtr _sdf);
+
+    /// \brief Get the heightmap's URI.
+    /// \return The URI of the heightmap data.
+    public: std::string Uri() const;
+
+    /// \brief Set the URI to a grayscale image.
+    /// \param[in] _uri The URI of the heightmap.
+    public: void SetUri(const std::string &_uri);
+
+    /// \brief The path to the file where this element was loaded from.
+    /// \return Full path to the file on disk.
+    public: const std::string &FilePath() const;
+
+    /// \brief Set the path to the file where this element was loaded from.
+    /// \param[in] _filePath Full path to the file on disk.
+    public: void SetFilePath(const std::string &_filePath);
+
+    /// \brief Get the heightmap's scaling factor.
+    /// \return The heightmap's size.
+    public: ignition::math::Vector3d Size() const;
+
+    /// \brief Set the heightmap's scaling factor. Defaults to 1x1x1.
+    /// \param[in] _size The heightmap's size factor.
+    public: void SetSize(const ignition::math::Vector3d &_size);
+
+    /// \brief Get the heightmap's position offset.
+    /// \return The heightmap's position offset.
+    public: ignition::math::Vector3d Position() const;
+
+    /// \brief Set the heightmap's position offset.
+    /// \param[in] _position The heightmap's position offset.
+    public: void SetPosition(const ignition::math::Vector3d &_position);
+
+    /// \brief Get whether the heightmap uses terrain paging.
+    /// \return True if the heightmap uses terrain paging.
+    public: bool UseTerrainPaging() const;
+
+    /// \brief Set whether the heightmap uses terrain paging. Defaults to false.
+    /// \param[in] _use True to use terrain paging.
+    public: void SetUseTerrainPaging(bool _use);
+
+    /// \brief Get the heightmap's sampling per datum.
+    /// \return The heightmap's sampling.
+    public: unsigned int Sampling() const;
+
+    /// \brief Set the heightmap's sampling. Defaults to 2.
+    /// \param[in] _sampling The heightmap's sampling per datum.
+    public: void SetSampling(unsigned int _sampling);
+
+    /// \brief Get the number of heightmap textures.
+    /// \return Number of heightmap textures contained in this Heightmap
+    /// object.
+    public: uint64_t TextureCount() const;
+
+    /// \brief Get a heightmap texture based on an index.
+    /// \param[in] _index Index of the heightmap texture. The index should be in
+    /// the range [0..TextureCount()).
+    /// \return Pointer to the heightmap texture. Nullptr if the index does not
+    /// exist.
+    /// \sa uint64_t TextureCount() const
+    public: const HeightmapTexture *TextureByIndex(uint64_t _index) const;
+
+    /// \brief Add a heightmap texture.
+    /// \param[in] _texture Heightmap texture to add.
+    public: void AddTexture(const HeightmapTexture &_texture);
+
+    /// \brief Get the number of heightmap blends.
+    /// \return Number of heightmap blends contained in this Heightmap object.
+    public: uint64_t BlendCount() const;
+
+    /// \brief Get a heightmap blend based on an index.
+    /// \param[in] _index Index of the heightmap blend. The index should be in
+    /// the range [0..BlendCount()).
+    /// \return Pointer to the heightmap blend. Nullptr if the index does not
+    /// exist.
+    /// \sa uint64_t BlendCount() const
+    public: const HeightmapBlend *BlendByIndex(uint64_t _index) const;
+
+    /// \brief Add a heightmap blend.
+    /// \param[in] _blend Heightmap blend to add.
+    public: void AddBlend(const HeightmapBlend &_blend);
+
+    /// \brief Get the height data. The file is found from the URI the first
+    /// time this function is called, with sdf::findFile and then relative to
+    /// the directory of FilePath(), and only its header is read. Copies of the
+    /// heightmap share the data.
+    /// \return The height data, or nullptr if the file could not be found or
+    /// read.
+    /// \sa HeightmapData
+    public: std::shared_ptr<const HeightmapData> Data() const;
+
+    /// \brief Set the height data, replacing the data of the URI.
+    /// \param[in] _data The height data.
+    public: void SetData(std::shared_ptr<const HeightmapData> _data);
+
+    /// \brief Get the height of the terrain at a point. The samples cover
+    /// Size() in x and y, centered on Position(), with the first row of the
+    /// image along +y, and span Size() in z from Position().
+    /// \param[in] _x Coordinate along x, in the frame of the geometry.
+    /// \param[in] _y Coordinate along y, in the frame of the geometry.
+    /// \return The interpolated height, or std::nullopt if there is no data
+    /// or if the point is outside of the terrain.
+    public: std::optional<double> HeightAt(double _x, double _y) const;
+
+    /// \brief Get a pointer to the SDF element that was used during load.
+    /// \return SDF element pointer. The value will be nullptr if Load has
+    /// not been called.
+    public: sdf::ElementPtr Element() const;
+
+    /// \brief Private data pointer.
+    private: HeightmapPrivate *dataPtr;
+  };
+  }
+}
+#endif
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_KINEMATICTABLES_HH_
+#define SDF_KINEMATICTABLES_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+
+#include "sdf/Error.hh"
+#include "sdf/Joint.hh"
+#include "sdf/sdf_config.h"
+#include "sdf/system_util.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::vector
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  class Model;
+  struct ResolvedPoses;
+  class World;
+
+  /// \brief Kinematic and inertial data of the links and joints of a world
+  /// or model, as flat arrays of numbers.
+  ///
+  /// Links and joints are identified by their position in the tables. The
+  /// arrays of a link or joint attribute with several components store the
+  /// components of each object next to each other, so the data of all the
+  /// objects can be copied at once. For instance the position of link i is
+  /// linkPositions[3*i], linkPositions[3*i+1] and linkPositions[3*i+2].
+  ///
+  /// Poses and axes are expressed in the frame of the exported object: the
+  /// world frame for World::ExportKinematicTables, and the model frame for
+  /// Model::ExportKinematicTables.
+  struct SDFORMAT_VISIBLE KinematicTables
+  {
+    /// \brief Number of values per position: x, y, z.
+    static constexpr std::size_t positionSize = 3;
+
+    /// \brief Number of values per orientation quaternion: w, x, y, z.
+    static constexpr std::size_t orientationSize = 4;
+
+    /// \brief Number of values per inertia tensor: ixx, iyy, izz, ixy, ixz,
+    /// iyz.
+    static constexpr std::size_t inertiaSize = 6;
+
+    /// \brief Index used for the parent of joints attached to the world or
+    /// to a frame that is not attached to an exported link.
+    static constexpr std::int64_t noLink = -1;
+
+    /// \brief Names of the links, scoped with the names of the models that
+    /// contain them, such as "model::nested::link".
+    std::vector<std::string> linkNames;
+
+    /// \brief Position of the origin of each link frame.
+    std::vector<double> linkPositions;
+
+    /// \brief Orientation of each link frame.
+    std::vector<double> linkOrientations;
+
+    /// \brief Mass of each link.
+    std::vector<double> linkMasses;
+
+    /// \brief Position of the center of mass of each link, in the link
+    /// frame.
+    std::vector<double> linkCentersOfMass;
+
+    /// \brief Inertia tensor of each link about its center of mass,
+    /// expressed in the link frame.
+    std::vector<double> linkInertias;
+
+    /// \brief Names of the joints, scoped like the link names.
+    std::vector<std::string> jointNames;
+
+    /// \brief Type of each joint.
+    std::vector<JointType> jointTypes;
+
+    /// \brief Index of the link that each joint is attached to after
+    /// resolving frames, or noLink.
+    std::vector<std::int64_t> jointParents;
+
+    /// \brief Index of the link that each joint moves, or noLink if it
+    /// could not be resolved.
+    std::vector<std::int64_t> jointChildren;
+
+    /// \brief Position of the origin of each joint frame.
+    std::vector<double> jointPositions;
+
+    /// \brief Orientation of each joint frame.
+    std::vector<double> jointOrientations;
+
+    /// \brief Unit vector of the first axis of each joint, or zero for
+    /// joints without axis.
+    std::vector<double> jointAxes;
+
+    /// \brief Lower position limit of the first axis of each joint.
+    std::vector<double> jointLowerLimits;
+
+    /// \brief Upper position limit of the first axis of each joint.
+    std::vector<double> jointUpperLimits;
+
+    /// \brief Effort limit of the first axis of each joint.
+    std::vector<double> jointEffortLimits;
+
+    /// \brief Velocity limit of the first axis of each joint.
+    std::vector<double> jointVelocityLimits;
+
+    /// \brief Get the number of links.
+    /// \return Number of links in the tables.
+    std::size_t LinkCount() const;
+
+    /// \brief Get the number of joints.
+    /// \return Number of joints in the tables.
+    std::size_t JointCount() const;
+
+    /// \brief Remove all the links and joints.
+    void Clear();
+
+    /// \brief Append the links and joints of a model and of its nested
+    /// models. Joints refer to links by their index in the tables.
+    /// \param[in] _model Model to append. Its frame graphs must be set, as
+    /// they are when it is loaded through a Root.
+    /// \param[in] _pose Pose of the model frame in the frame of the tables.
+    /// \param[in] _prefix Prefix of the names of the links and joints of the
+    /// model, such as "model::" or an empty string.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error. Objects
+    /// whose pose cannot be resolved are added with their raw pose.
+    Errors AddModel(const Model &_model,
+                    const ignition::math::Pose3d &_pose,
+                    const std::string &_prefix);
+
+    /// \brief Append the links and joints of a model and of its nested
+    /// models, with poses resolved by a single walk of a graph scope that
+    /// holds the model, such as the scope of its world.
+    /// \param[in] _model Model to append.
+    /// \param[in] _poses Poses of the frames of the scope, relative to the
+    /// frame of the scope.
+    /// \param[in] _scope Prefix of the names of the model in the scope, such
+    /// as "model::" or an empty string.
+    /// \param[in] _pose Pose of the frame of the scope in the frame of the
+    /// tables.
+    /// \param[in] _prefix Prefix of the names of the links and joints of the
+    /// model in the tables.
+    /// \return Errors. Objects whose pose was not resolved are added with
+    /// their raw pose.
+    private: Errors AddModel(const Model &_model,
+                             const ResolvedPoses &_poses,
+                             const std::string &_scope,
+                             const ignition::math::Pose3d &_pose,
+                             const std::string &_prefix);
+
+    /// \brief Allow World::ExportKinematicTables to add its models with
+    /// the poses of a single walk of the world graph.
+    friend class World;
+  };
+  }
+}
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif
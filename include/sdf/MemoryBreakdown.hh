@@ -0,0 +1,88 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_MEMORYBREAKDOWN_HH_
+#define SDF_MEMORYBREAKDOWN_HH_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "sdf/sdf_config.h"
+#include "sdf/system_util.hh"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief Estimate of the memory held by a parsed SDF document, as
+  /// returned by Param::MemoryUsage, Element::MemoryUsage and
+  /// Root::MemoryUsage.
+  ///
+  /// The byte counts are estimates: they include the size of the objects and
+  /// of the storage of their strings and containers, but not the overhead of
+  /// the allocator or of shared pointer control blocks.
+  struct SDFORMAT_VISIBLE MemoryBreakdown
+  {
+    /// \brief Number of elements of the document, not counting the
+    /// element descriptions.
+    std::size_t elementCount = 0;
+
+    /// \brief Number of attributes and values of the elements of the
+    /// document, not counting the element descriptions.
+    std::size_t paramCount = 0;
+
+    /// \brief Heap bytes of the strings of the document: names, keys, type
+    /// names, values and file paths. Strings short enough to be stored inline
+    /// are counted in domBytes.
+    std::size_t stringBytes = 0;
+
+    /// \brief Bytes of schema data: the description strings and the element
+    /// descriptions copied into every element, including their params and
+    /// strings.
+    std::size_t descriptionBytes = 0;
+
+    /// \brief Bytes of the objects themselves: elements, params, DOM objects
+    /// and frame graphs, and the storage of their containers.
+    std::size_t domBytes = 0;
+
+    /// \brief Get the sum of the byte counts.
+    /// \return stringBytes + descriptionBytes + domBytes.
+    std::size_t TotalBytes() const;
+
+    /// \brief Add the counts of another breakdown.
+    /// \param[in] _other Breakdown to add.
+    /// \return Reference to this.
+    MemoryBreakdown &operator+=(const MemoryBreakdown &_other);
+
+    /// \brief Get the heap bytes of a string.
+    /// \param[in] _str String to measure.
+    /// \return Allocated bytes, or zero if the string is stored inline.
+    static std::size_t StringHeapBytes(const std::string &_str);
+  };
+
+  /// \brief Output operator for a memory breakdown, one count per line.
+  /// \param[in,out] _out The output stream.
+  /// \param[in] _usage The breakdown to output.
+  /// \return Reference to the given output stream
+  SDFORMAT_VISIBLE
+  std::ostream &operator<<(std::ostream &_out, const MemoryBreakdown &_usage);
+  }
+}
+
+#endif
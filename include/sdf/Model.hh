@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <ignition/math/Pose3.hh>
 #include "sdf/Element.hh"
@@ -36,10 +37,14 @@ namespace sdf
   // Forward declarations.
   class Frame;
   class Joint;
+  struct KinematicTables;
   class Link;
   class ModelPrivate;
+  struct ModelState;
+  class Population;
   struct PoseRelativeToGraph;
   struct FrameAttachedToGraph;
+  struct ResolvedPoses;
   template <typename T> class ScopedGraph;
 
   class SDFORMAT_VISIBLE Model
@@ -76,6 +81,44 @@ namespace sdf
     /// an error code and message. An empty vector indicates no error.
     public: Errors Load(ElementPtr _sdf);
 
+    /// \brief Load a model that shares the links, joints, frames and nested
+    /// models of a prototype instead of loading its own. Only the name,
+    /// pose, placement frame and static flag are read from _sdf; the other
+    /// properties are copied from the prototype. This saves the memory and
+    /// time of loading models that are included many times, such as by
+    /// World::Load when model instancing is enabled.
+    ///
+    /// The shared objects resolve their poses in the graphs of the
+    /// prototype, which is consistent with the instance since poses
+    /// inside a model do not depend on its name or pose.
+    /// \param[in] _sdf The SDF Element pointer of the instance.
+    /// \param[in] _prototype Loaded model to share. If it is itself an
+    /// instance, its prototype is shared instead.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    /// \sa World::SetModelInstancing
+    public: Errors LoadInstance(ElementPtr _sdf,
+                                std::shared_ptr<const Model> _prototype);
+
+    /// \brief Make this model an instance of a prototype, or make it own
+    /// empty contents if _prototype is nullptr. The links, joints, frames
+    /// and nested models of this model are replaced by those of the
+    /// prototype, and the self collide, auto disable, wind and canonical
+    /// link properties are copied from it. The name, pose, placement frame
+    /// and static flag are kept.
+    /// \param[in] _prototype Loaded model to share. If it is itself an
+    /// instance, its prototype is shared instead.
+    /// \sa LoadInstance
+    public: void SetPrototype(std::shared_ptr<const Model> _prototype);
+
+    /// \brief Check whether this model shares the contents of a prototype.
+    /// \return True if the model was loaded with LoadInstance.
+    public: bool IsInstance() const;
+
+    /// \brief Get the prototype whose contents this model shares.
+    /// \return The prototype, or nullptr if this model is not an instance.
+    public: std::shared_ptr<const Model> Prototype() const;
+
     /// \brief Get the name of the model.
     /// The name of the model should be unique within the scope of a World.
     /// \return Name of the model.
@@ -300,6 +343,16 @@ namespace sdf
     /// not been called.
     public: sdf::ElementPtr Element() const;
 
+    /// \brief Export the kinematic and inertial data of the links and joints
+    /// of the model and of its nested models, with poses and axes expressed
+    /// in the model frame. Names in nested models are scoped with the names
+    /// of the nested models.
+    /// \param[out] _tables Tables to fill. Their previous content is cleared.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    /// \sa KinematicTables
+    public: Errors ExportKinematicTables(KinematicTables &_tables) const;
+
     /// \brief Get SemanticPose object of this object to aid in resolving
     /// poses.
     /// \return SemanticPose object for this link.
@@ -337,9 +390,54 @@ namespace sdf
     private: void SetFrameAttachedToGraph(
         sdf::ScopedGraph<FrameAttachedToGraph> _graph);
 
+    /// \brief Load a model to be shared as the prototype of instances, with
+    /// frame graphs of its own, as Root::Load does for a standalone model.
+    /// \param[in] _sdf The SDF Element pointer of the prototype.
+    /// \param[out] _errors Errors of the load and of the graphs.
+    /// \return The prototype.
+    private: static std::shared_ptr<const Model> LoadPrototype(
+        ElementPtr _sdf, Errors &_errors);
+
+    /// \brief Find a nested model from a scoped name without allocating.
+    /// \param[in] _name Name of the nested model, which may be a sequence of
+    /// nested model names separated by `::`.
+    /// \return The nested model, or nullptr if it does not exist.
+    private: const Model *ModelByScopedName(std::string_view _name) const;
+
+    /// \brief Find the model that holds an object with a scoped name. If the
+    /// part of _name before the last `::` names a nested model, that model
+    /// is returned and _name is reduced to the part after the last `::`.
+    /// Otherwise this model is returned and _name is left unchanged.
+    /// \param[in,out] _name Scoped name of the object.
+    /// \return Model in which to look up _name.
+    private: const Model *ScopeOf(std::string_view &_name) const;
+
+    /// \brief Apply the recorded state of this model: set the raw poses of
+    /// the model, of the links and of the nested models it names, and update
+    /// the matching edges of the PoseRelativeTo graph. Links and nested
+    /// models are found by name, so the cost is proportional to the size of
+    /// the state. This is private and is intended to be called by
+    /// World::ApplyState.
+    /// \param[in] _state State of the model, with the same name as the model.
+    /// \return Errors for entities of the state that are not in the model.
+    private: Errors ApplyState(const ModelState &_state);
+
+    /// \brief Resolve the poses of all the frames of this model and of its
+    /// nested models relative to the model frame, in a single walk down the
+    /// PoseRelativeTo graph of the model. This is private and is intended to
+    /// be called by KinematicTables::AddModel.
+    /// \param[out] _poses Resolved poses, indexed by name in the scope of
+    /// the model, such as "link" or "nested::link".
+    /// \return Errors for the frames whose pose could not be resolved.
+    private: Errors ResolveAllPoses(ResolvedPoses &_poses) const;
+
     /// \brief Allow Root::Load, World::SetPoseRelativeToGraph, or
     /// World::SetFrameAttachedToGraph to call SetPoseRelativeToGraph and
-    /// SetFrameAttachedToGraph
+    /// SetFrameAttachedToGraph, World and Population to call LoadPrototype,
+    /// World to call ApplyState, and KinematicTables to call
+    /// ResolveAllPoses.
+    friend struct KinematicTables;
+    friend class Population;
     friend class Root;
     friend class World;
 
@@ -34,6 +34,7 @@
 #include <ignition/math.hh>
 
 #include "sdf/Console.hh"
+#include "sdf/MemoryBreakdown.hh"
 #include "sdf/sdf_config.h"
 #include "sdf/system_util.hh"
 #include "sdf/Types.hh"
@@ -193,6 +194,17 @@ namespace sdf
     /// \return True if the parameter has been set.
     public: bool GetSet() const;
 
+    /// \brief Get a counter that is incremented whenever the value of the
+    /// parameter may have changed. It can be used to detect changes without
+    /// comparing values.
+    /// \return The revision of the value.
+    public: std::uint64_t Revision() const;
+
+    /// \brief Estimate the memory held by the parameter.
+    /// \return Breakdown with a param count of one. The description is
+    /// counted in the description bytes.
+    public: MemoryBreakdown MemoryUsage() const;
+
     /// \brief Clone the parameter.
     /// \return A new parameter that is the clone of this.
     public: ParamPtr Clone() const;
@@ -310,6 +322,9 @@ namespace sdf
 
     /// \brief This parameter's maximum allowed value
     public: std::optional<ParamVariant> maxValue;
+
+    /// \brief Incremented whenever the value may have changed.
+    public: std::uint64_t revision = 0;
   };
 
   ///////////////////////////////////////////////
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_POLYLINE_HH_
+#define SDF_POLYLINE_HH_
+
+#include <cstdint>
+#include <vector>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+#include <sdf/Element.hh>
+#include <sdf/Error.hh>
+#include <sdf/sdf_config.h>
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  // Forward declare private data class.
+  class PolylinePrivate;
+
+  /// \brief Polyline represents a 2D path extruded along z, and is usually
+  /// accessed through a Geometry. The points are the corners of a polygon,
+  /// which is closed from the last point to the first one.
+  ///
+  /// The points are stored contiguously and read from the <point> elements
+  /// in a single pass. The extruded mesh is computed the first time one of
+  /// ExtrudedVertices or TriangleIndices is called, and kept until the
+  /// points or the height change, so the cost of triangulating a polyline of
+  /// many points is only paid by the users of the mesh.
+  class SDFORMAT_VISIBLE Polyline
+  {
+    /// \brief Constructor
+    public: Polyline();
+
+    /// \brief Copy constructor
+    /// \param[in] _polyline Polyline to copy.
+    public: Polyline(const Polyline &_polyline);
+
+    /// \brief Move constructor
+    /// \param[in] _polyline Polyline to move.
+    public: Polyline(Polyline &&_polyline) noexcept;
+
+    /// \brief Destructor
+    public: virtual ~Polyline();
+
+    /// \brief Move assignment operator.
+    /// \param[in] _polyline Polyline to move.
+    /// \return Reference to this.
+    public: Polyline &operator=(Polyline &&_polyline);
+
+    /// \brief Copy Assignment operator.
+    /// \param[in] _polyline The polyline to set values from.
+    /// \return *this
+    public: Polyline &operator=(const Polyline &_polyline);
+
+    /// \brief Load the polyline geometry based on a element pointer.
+    /// This is *not* the usual entry point. Typical usage of the SDF DOM is
+    /// through the Root object.
+    /// \param[in] _sdf The SDF Element pointer
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Load(ElementPtr _sdf);
+
+    /// \brief Get the polyline's height.
+    /// \return The height of the polyline.
+    public: double Height() const;
+
+    /// \brief Set the polyline's height.
+    /// \param[in] _height The height of the polyline.
+    public: void SetHeight(double _height);
+
+    /// \brief Get the number of points.
+    /// \return Number of points in the polyline.
+    public: uint64_t PointCount() const;
+
+    /// \brief Get a point by its index.
+    /// \param[in] _index Index of the point, in the range
+    /// [0..PointCount()).
+    /// \return Pointer to the point. Nullptr if the index does not exist.
+    /// \sa uint64_t PointCount() const
+    public: const ignition::math::Vector2d *PointByIndex(uint64_t _index) const;
+
+    /// \brief Add a point to the polyline.
+    /// \param[in] _point 2D point to add.
+    public: void AddPoint(const ignition::math::Vector2d &_point);
+
+    /// \brief Replace all the points of the polyline.
+    /// \param[in] _points The new points, in order.
+    public: void SetPoints(std::vector<ignition::math::Vector2d> _points);
+
+    /// \brief Remove all the points.
+    public: void ClearPoints();
+
+    /// \brief Get all the points, in order.
+    /// \return The points of the polyline.
+    public: const std::vector<ignition::math::Vector2d> &Points() const;
+
+    /// \brief Get the bounding box of the extruded polyline. The box is kept
+    /// up to date as points are added, so this does not visit the points.
+    /// \return The box spanning the points in x and y, and [0, Height()] in
+    /// z. An empty box if there are no points.
+    public: ignition::math::AxisAlignedBox BoundingBox() const;
+
+    /// \brief Get the vertices of the extruded polyline. Vertex i is point i
+    /// at z = 0, and vertex PointCount() + i is point i at z = Height().
+    /// \return The vertices. The reference is valid until the polyline is
+    /// modified.
+    public: const std::vector<ignition::math::Vector3d> &ExtrudedVertices()
+            const;
+
+    /// \brief Get the triangles of the extruded polyline: two for each side
+    /// of the polygon, and a triangulation of the bottom and top faces.
+    /// Triangles are counter-clockwise when seen from outside, whichever the
+    /// winding of the points. A polygon that is not simple is triangulated
+    /// on a best effort basis.
+    /// \return Three indices into ExtrudedVertices() per triangle, or no
+    /// indices if there are fewer than 3 points. The reference is valid
+    /// until the polyline is modified.
+    public: const std::vector<uint32_t> &TriangleIndices() const;
+
+    /// \brief Get a pointer to the SDF element that was used during load.
+    /// \return SDF element pointer. The value will be nullptr if Load has
+    /// not been called.
+    public: sdf::ElementPtr Element() const;
+
+    /// \brief Private data pointer.
+    private: PolylinePrivate *dataPtr;
+  };
+  }
+}
+#endif
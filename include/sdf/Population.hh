@@ -0,0 +1,259 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_POPULATION_HH_
+#define SDF_POPULATION_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+#include "sdf/Element.hh"
+#include "sdf/Model.hh"
+#include "sdf/Types.hh"
+#include "sdf/sdf_config.h"
+#include "sdf/system_util.hh"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  // Forward declarations.
+  class Box;
+  class Cylinder;
+  class PopulationPrivate;
+
+  /// \enum PopulationDistributionType
+  /// \brief The ways a population places its models.
+  enum class PopulationDistributionType
+  {
+    /// \brief Models placed at random in the region.
+    RANDOM = 0,
+
+    /// \brief Models spread evenly over the region, in a 2D pattern.
+    UNIFORM = 1,
+
+    /// \brief Models placed in a 2D grid of rows and columns, starting at
+    /// the pose of the population. The region is not used.
+    GRID = 2,
+
+    /// \brief Models evenly placed in a row along the x-axis of the region.
+    LINEAR_X = 3,
+
+    /// \brief Models evenly placed in a row along the y-axis of the region.
+    LINEAR_Y = 4,
+
+    /// \brief Models evenly placed in a row along the z-axis of the region.
+    LINEAR_Z = 5,
+  };
+
+  /// \brief A population places many copies of a model in a region of a
+  /// world. The model is loaded once, as the prototype of the instances
+  /// generated by Instance and Instances, so the copies share its links,
+  /// joints, frames and nested models.
+  ///
+  /// The pose of each instance is computed from its index, so instances can
+  /// be generated one at a time, in any order, or all at once. The random
+  /// distribution is a function of Seed() and of the index of the instance,
+  /// so the poses do not depend on the order in which they are generated.
+  class SDFORMAT_VISIBLE Population
+  {
+    /// \brief Default constructor
+    public: Population();
+
+    /// \brief Copy constructor
+    /// \param[in] _population Population to copy.
+    public: Population(const Population &_population);
+
+    /// \brief Move constructor
+    /// \param[in] _population Population to move.
+    public: Population(Population &&_population) noexcept;
+
+    /// \brief Move assignment operator.
+    /// \param[in] _population Population to move.
+    /// \return Reference to this.
+    public: Population &operator=(Population &&_population);
+
+    /// \brief Copy assignment operator.
+    /// \param[in] _population Population to copy.
+    /// \return Reference to this.
+    public: Population &operator=(const Population &_population);
+
+    /// \brief Destructor
+    public: ~Population();
+
+    /// \brief Load the population based on a element pointer. This is *not*
+    /// the usual entry point. Typical usage of the SDF DOM is through the Root
+    /// object.
+    /// \param[in] _sdf The SDF Element pointer
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Load(ElementPtr _sdf);
+
+    /// \brief Get the name of the population.
+    /// \return Name of the population.
+    public: const std::string &Name() const;
+
+    /// \brief Set the name of the population.
+    /// \param[in] _name Name of the population.
+    public: void SetName(const std::string &_name);
+
+    /// \brief Get the number of models to place. Grid distributions place
+    /// Rows() * Cols() models instead.
+    /// \return Number of models.
+    /// \sa uint64_t InstanceCount() const
+    public: uint64_t ModelCount() const;
+
+    /// \brief Set the number of models to place.
+    /// \param[in] _count Number of models.
+    public: void SetModelCount(uint64_t _count);
+
+    /// \brief Get the distribution of the models.
+    /// \return Distribution type.
+    public: PopulationDistributionType DistributionType() const;
+
+    /// \brief Set the distribution of the models.
+    /// \param[in] _type Distribution type.
+    public: void SetDistributionType(PopulationDistributionType _type);
+
+    /// \brief Get the number of rows of a grid distribution.
+    /// \return Number of rows.
+    public: uint64_t Rows() const;
+
+    /// \brief Set the number of rows of a grid distribution.
+    /// \param[in] _rows Number of rows.
+    public: void SetRows(uint64_t _rows);
+
+    /// \brief Get the number of columns of a grid distribution.
+    /// \return Number of columns.
+    public: uint64_t Cols() const;
+
+    /// \brief Set the number of columns of a grid distribution.
+    /// \param[in] _cols Number of columns.
+    public: void SetCols(uint64_t _cols);
+
+    /// \brief Get the distance between the models of a grid distribution,
+    /// along the rows (x) and the columns (y).
+    /// \return Distance between the models.
+    public: const ignition::math::Vector3d &Step() const;
+
+    /// \brief Set the distance between the models of a grid distribution.
+    /// \param[in] _step Distance between the models.
+    public: void SetStep(const ignition::math::Vector3d &_step);
+
+    /// \brief Get the box region, centered on the pose of the population.
+    /// \return The box, or nullptr if the region is not a box.
+    public: const Box *BoxShape() const;
+
+    /// \brief Set the region to a box, replacing any cylinder region.
+    /// \param[in] _box The box.
+    public: void SetBoxShape(const Box &_box);
+
+    /// \brief Get the cylinder region, centered on the pose of the
+    /// population with its axis along z.
+    /// \return The cylinder, or nullptr if the region is not a cylinder.
+    public: const Cylinder *CylinderShape() const;
+
+    /// \brief Set the region to a cylinder, replacing any box region.
+    /// \param[in] _cylinder The cylinder.
+    public: void SetCylinderShape(const Cylinder &_cylinder);
+
+    /// \brief Get the seed of the random distribution.
+    /// \return The seed. The default is 0.
+    public: uint64_t Seed() const;
+
+    /// \brief Set the seed of the random distribution. The same seed always
+    /// produces the same poses.
+    /// \param[in] _seed The seed.
+    public: void SetSeed(uint64_t _seed);
+
+    /// \brief Get the pose of the population, which is the center of the
+    /// region, or the first position of a grid.
+    /// \return The pose of the population.
+    public: const ignition::math::Pose3d &RawPose() const;
+
+    /// \brief Set the pose of the population.
+    /// \param[in] _pose The pose of the population.
+    public: void SetRawPose(const ignition::math::Pose3d &_pose);
+
+    /// \brief Get the name of the frame relative to which the pose of the
+    /// population and of its instances is expressed. An empty value
+    /// indicates the world frame.
+    /// \return The name of the pose relative-to frame.
+    public: const std::string &PoseRelativeTo() const;
+
+    /// \brief Set the name of the frame relative to which the pose of the
+    /// population is expressed.
+    /// \param[in] _frame The name of the pose relative-to frame.
+    public: void SetPoseRelativeTo(const std::string &_frame);
+
+    /// \brief Get the model that is placed, which is the prototype of the
+    /// instances.
+    /// \return The model, or nullptr if none is set.
+    public: std::shared_ptr<const Model> ModelPrototype() const;
+
+    /// \brief Set the model that is placed.
+    /// \param[in] _model The model, which is shared by the instances.
+    public: void SetModelPrototype(std::shared_ptr<const Model> _model);
+
+    /// \brief Get the number of instances generated by the distribution.
+    /// \return Rows() * Cols() for a grid distribution, ModelCount()
+    /// otherwise.
+    public: uint64_t InstanceCount() const;
+
+    /// \brief Get the pose of an instance, relative to the PoseRelativeTo()
+    /// frame. The pose of the population is composed with the offset of the
+    /// instance from the center of the region.
+    /// \param[in] _index Index of the instance, less than InstanceCount().
+    /// \return Pose of the instance. A region that is missing for the
+    /// distribution type is treated as a point.
+    public: ignition::math::Pose3d InstancePose(uint64_t _index) const;
+
+    /// \brief Get the poses of all the instances.
+    /// \return InstanceCount() poses, as returned by InstancePose.
+    public: std::vector<ignition::math::Pose3d> InstancePoses() const;
+
+    /// \brief Generate an instance of the model. The instance shares the
+    /// contents of ModelPrototype() and is named after it, as
+    /// "<model>_clone_<index>". Its frame graphs are not set, so the pose of
+    /// the instance itself cannot be resolved, while its links, joints and
+    /// frames resolve their poses in the graphs of the prototype.
+    /// \param[in] _index Index of the instance, less than InstanceCount().
+    /// \return The instance. It has no contents if ModelPrototype() is
+    /// nullptr.
+    /// \sa Model::SetPrototype
+    public: Model Instance(uint64_t _index) const;
+
+    /// \brief Generate all the instances of the model.
+    /// \return InstanceCount() instances, as returned by Instance.
+    public: std::vector<Model> Instances() const;
+
+    /// \brief Get a pointer to the SDF element that was used during
+    /// load.
+    /// \return SDF element pointer. The value will be nullptr if Load has
+    /// not been called.
+    public: sdf::ElementPtr Element() const;
+
+    /// \brief Private data pointer.
+    private: PopulationPrivate *dataPtr = nullptr;
+  };
+  }
+}
+#endif
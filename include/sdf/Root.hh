@@ -19,6 +19,7 @@
 
 #include <string>
 
+#include "sdf/MemoryBreakdown.hh"
 #include "sdf/SDFImpl.hh"
 #include "sdf/Types.hh"
 #include "sdf/sdf_config.h"
@@ -36,6 +37,7 @@ namespace sdf
   class Model;
   class RootPrivate;
   class World;
+  class WorldState;
 
   /// \brief Root class that acts as an entry point to the SDF document
   /// model.
@@ -97,6 +99,36 @@ namespace sdf
     /// an error code and message. An empty vector indicates no error.
     public: Errors Load(const SDFPtr _sdf);
 
+    /// \brief Set the number of threads used to load the DOM objects. The
+    /// top-level models, actors and lights, and those of each world, are
+    /// loaded in parallel. The DOM objects and errors are the same as a
+    /// serial load, in document order. Warnings printed to the console while
+    /// loading may be interleaved. The ids of the vertices and edges of the
+    /// frame graphs are not stable across thread counts, see
+    /// World::SetLoadThreads.
+    /// \param[in] _threads Maximum number of threads. 0 uses the number of
+    /// hardware threads. The default is 1, which loads on the calling thread.
+    /// \sa unsigned int LoadThreads() const
+    /// \sa World::SetLoadThreads
+    public: void SetLoadThreads(unsigned int _threads);
+
+    /// \brief Get the number of threads used to load the DOM objects.
+    /// \return Maximum number of threads, 0 for the number of hardware
+    /// threads.
+    /// \sa void SetLoadThreads(unsigned int _threads)
+    public: unsigned int LoadThreads() const;
+
+    /// \brief Set whether the worlds share one prototype between models that
+    /// only differ by name, pose, placement frame and static flag.
+    /// \param[in] _instancing True to share prototypes. The default is
+    /// false.
+    /// \sa World::SetModelInstancing
+    public: void SetModelInstancing(bool _instancing);
+
+    /// \brief Get whether the worlds share prototypes between models.
+    /// \return True if model instancing is enabled.
+    public: bool ModelInstancing() const;
+
     /// \brief Get the SDF version specified in the parsed file or SDF
     /// pointer.
     /// \return SDF version string.
@@ -119,6 +151,17 @@ namespace sdf
     /// \sa uint64_t WorldCount() const
     public: const World *WorldByIndex(const uint64_t _index) const;
 
+    /// \brief Apply a recorded state to the world it names, with
+    /// World::ApplyState. The worlds are only changed through this function,
+    /// so the names of the worlds and the frame graphs held by the root stay
+    /// consistent with them.
+    /// \param[in] _state State to apply. A state without a world name is
+    /// applied to the only world of the root.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    /// \sa World::ApplyState
+    public: Errors ApplyState(const WorldState &_state);
+
     /// \brief Get whether a world name exists.
     /// \param[in] _name Name of the world to check.
     /// \return True if there exists a world with the given name.
@@ -179,6 +222,18 @@ namespace sdf
     /// not been called.
     public: sdf::ElementPtr Element() const;
 
+    /// \brief Estimate the memory held by the loaded document: the Element
+    /// tree returned by Element(), the DOM objects and the frame graphs
+    /// built during load. The DOM objects are counted by their own size,
+    /// most of the data they refer to being the Element tree.
+    /// \return Memory breakdown of the document.
+    /// \sa Element::MemoryUsage
+    public: MemoryBreakdown MemoryUsage() const;
+
+    /// \brief Allow the graph export of `ign sdf --graph` to reuse the
+    /// frame graphs built by Load.
+    friend class RootGraphs;
+
     /// \brief Private data pointer
     private: RootPrivate *dataPtr = nullptr;
   };
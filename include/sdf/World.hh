@@ -37,10 +37,13 @@ namespace sdf
   // Forward declare private data class.
   class Actor;
   class Frame;
+  struct KinematicTables;
   class Light;
   class Model;
   class Physics;
+  class Population;
   class WorldPrivate;
+  class WorldState;
   struct PoseRelativeToGraph;
   struct FrameAttachedToGraph;
   template <typename T> class ScopedGraph;
@@ -79,6 +82,39 @@ namespace sdf
     /// an error code and message. An empty vector indicates no error.
     public: Errors Load(ElementPtr _sdf);
 
+    /// \brief Set the number of threads used by Load to load the models,
+    /// actors and lights of the world. The DOM objects and errors are the
+    /// same as a serial load, in document order. Warnings printed to the
+    /// console while loading may be interleaved. The frame graphs have the
+    /// same frames and poses, but the ids of their vertices and edges, as
+    /// printed by `ign sdf -g`, are not stable across thread counts.
+    /// \param[in] _threads Maximum number of threads. 0 uses the number of
+    /// hardware threads. The default is 1, which loads on the calling thread.
+    /// \sa unsigned int LoadThreads() const
+    public: void SetLoadThreads(unsigned int _threads);
+
+    /// \brief Get the number of threads used by Load.
+    /// \return Maximum number of threads, 0 for the number of hardware
+    /// threads.
+    /// \sa void SetLoadThreads(unsigned int _threads)
+    public: unsigned int LoadThreads() const;
+
+    /// \brief Set whether Load shares one prototype between the models of
+    /// the world that only differ by name, pose, placement frame and static
+    /// flag, such as a model included many times. Each prototype is loaded
+    /// once, and the models that use it are loaded with
+    /// Model::LoadInstance. Instances are returned by ModelByIndex and
+    /// ModelByName like any other model.
+    /// \param[in] _instancing True to share prototypes. The default is
+    /// false, which loads every model separately.
+    /// \sa bool ModelInstancing() const
+    public: void SetModelInstancing(bool _instancing);
+
+    /// \brief Get whether Load shares prototypes between identical models.
+    /// \return True if model instancing is enabled.
+    /// \sa void SetModelInstancing(bool _instancing)
+    public: bool ModelInstancing() const;
+
     /// \brief Get the name of the world.
     /// \return Name of the world.
     public: std::string Name() const;
@@ -202,6 +238,29 @@ namespace sdf
     /// \return True if there exists an explicit frame with the given name.
     public: bool FrameNameExists(const std::string &_name) const;
 
+    /// \brief Get the number of populations.
+    /// \return Number of populations contained in this World object.
+    public: uint64_t PopulationCount() const;
+
+    /// \brief Get a population based on an index.
+    /// \param[in] _index Index of the population. The index should be in the
+    /// range [0..PopulationCount()).
+    /// \return Pointer to the population. Nullptr if the index does not
+    /// exist.
+    /// \sa uint64_t PopulationCount() const
+    public: const Population *PopulationByIndex(const uint64_t _index) const;
+
+    /// \brief Get a population based on a name.
+    /// \param[in] _name Name of the population.
+    /// \return Pointer to the population. Nullptr if the name does not
+    /// exist.
+    public: const Population *PopulationByName(const std::string &_name) const;
+
+    /// \brief Get whether a population name exists.
+    /// \param[in] _name Name of the population to check.
+    /// \return True if there exists a population with the given name.
+    public: bool PopulationNameExists(const std::string &_name) const;
+
     /// \brief Get the number of lights.
     /// \return Number of lights contained in this World object.
     public: uint64_t LightCount() const;
@@ -254,6 +313,34 @@ namespace sdf
     /// not been called.
     public: sdf::ElementPtr Element() const;
 
+    /// \brief Export the kinematic and inertial data of the links and joints
+    /// of all the models in the world, with poses and axes expressed in the
+    /// world frame. Link and joint names are scoped with the model names.
+    /// \param[out] _tables Tables to fill. Their previous content is cleared.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    /// \sa KinematicTables
+    public: Errors ExportKinematicTables(KinematicTables &_tables) const;
+
+    /// \brief Apply a recorded state to the world. The deleted models and
+    /// lights are removed, the inserted ones are added, then the raw poses
+    /// of the models, links and lights named by the model and light states
+    /// are set, and the edges of the PoseRelativeTo graph that hold them are
+    /// updated in place. Entities are found by name, so a state that only
+    /// changes poses is applied in time proportional to its size. The
+    /// vertices of deleted and inserted models are removed from and added
+    /// to the frame graphs of the world in place, in time proportional to
+    /// the size of those models.
+    ///
+    /// Velocities, accelerations, wrenches, joint angles and scales have no
+    /// counterpart in the DOM and are only kept in the state.
+    /// \param[in] _state State to apply.
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    /// Entities of the state that do not match the world are reported and
+    /// skipped.
+    public: Errors ApplyState(const WorldState &_state);
+
     /// \brief Get the number of physics profiles.
     /// \return Number of physics profiles contained in this World object.
     public: uint64_t PhysicsCount() const;
@@ -0,0 +1,294 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDF_WORLDSTATE_HH_
+#define SDF_WORLDSTATE_HH_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+#include "sdf/Element.hh"
+#include "sdf/Error.hh"
+#include "sdf/Types.hh"
+#include "sdf/sdf_config.h"
+#include "sdf/system_util.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::vector
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  // Forward declarations.
+  class Light;
+  class Model;
+  class WorldStatePrivate;
+
+  /// \brief State of a link, read from a <link> element of a model state.
+  /// Only the recorded values are set.
+  struct SDFORMAT_VISIBLE LinkState
+  {
+    /// \brief Name of the link.
+    std::string name;
+
+    /// \brief Pose of the link, in the frame its pose is relative to.
+    std::optional<ignition::math::Pose3d> pose;
+
+    /// \brief Linear velocity as the position, and angular velocity as the
+    /// roll, pitch and yaw of the pose.
+    std::optional<ignition::math::Pose3d> velocity;
+
+    /// \brief Linear acceleration as the position, and angular acceleration
+    /// as the roll, pitch and yaw of the pose.
+    std::optional<ignition::math::Pose3d> acceleration;
+
+    /// \brief Force as the position, and torque as the roll, pitch and yaw
+    /// of the pose.
+    std::optional<ignition::math::Pose3d> wrench;
+  };
+
+  /// \brief State of a joint, read from a <joint> element of a model state.
+  struct SDFORMAT_VISIBLE JointState
+  {
+    /// \brief Name of the joint.
+    std::string name;
+
+    /// \brief Angle of each axis, by axis index.
+    std::vector<double> angles;
+  };
+
+  /// \brief State of a model, read from a <model> element of a world state
+  /// or of a model state. Only the recorded values are set.
+  struct SDFORMAT_VISIBLE ModelState
+  {
+    /// \brief Name of the model.
+    std::string name;
+
+    /// \brief Pose of the model, in the frame its pose is relative to.
+    std::optional<ignition::math::Pose3d> pose;
+
+    /// \brief Scale of the model.
+    std::optional<ignition::math::Vector3d> scale;
+
+    /// \brief States of the joints of the model.
+    std::vector<JointState> joints;
+
+    /// \brief States of the links of the model.
+    std::vector<LinkState> links;
+
+    /// \brief States of the nested models.
+    std::vector<ModelState> models;
+  };
+
+  /// \brief State of a light, read from a <light> element of a world state.
+  struct SDFORMAT_VISIBLE LightState
+  {
+    /// \brief Name of the light.
+    std::string name;
+
+    /// \brief Pose of the light, in the frame its pose is relative to.
+    std::optional<ignition::math::Pose3d> pose;
+  };
+
+  /// \brief A snapshot of a world, or a change to one, as found in the
+  /// <state> elements of a log. A state holds the models and lights that
+  /// were inserted, the names of the entities that were deleted, and the
+  /// new state of the entities that changed.
+  ///
+  /// States are applied to a world with World::ApplyState. The model and
+  /// light states only hold the values that were recorded, so that applying
+  /// a state only touches the entities it names.
+  class SDFORMAT_VISIBLE WorldState
+  {
+    /// \brief Default constructor
+    public: WorldState();
+
+    /// \brief Copy constructor
+    /// \param[in] _state WorldState to copy.
+    public: WorldState(const WorldState &_state);
+
+    /// \brief Move constructor
+    /// \param[in] _state WorldState to move.
+    public: WorldState(WorldState &&_state) noexcept;
+
+    /// \brief Move assignment operator.
+    /// \param[in] _state WorldState to move.
+    /// \return Reference to this.
+    public: WorldState &operator=(WorldState &&_state);
+
+    /// \brief Copy assignment operator.
+    /// \param[in] _state WorldState to copy.
+    /// \return Reference to this.
+    public: WorldState &operator=(const WorldState &_state);
+
+    /// \brief Destructor
+    public: ~WorldState();
+
+    /// \brief Load the state based on an element pointer. This is *not* the
+    /// usual entry point. Typical usage of the SDF DOM is through the Root
+    /// object.
+    /// \param[in] _sdf The SDF Element pointer
+    /// \return Errors, which is a vector of Error objects. Each Error includes
+    /// an error code and message. An empty vector indicates no error.
+    public: Errors Load(ElementPtr _sdf);
+
+    /// \brief Get the name of the world this state applies to.
+    /// \return Name of the world.
+    public: const std::string &WorldName() const;
+
+    /// \brief Set the name of the world this state applies to.
+    /// \param[in] _name Name of the world.
+    public: void SetWorldName(const std::string &_name);
+
+    /// \brief Get the simulation time stamp of the state.
+    /// \return Simulation time.
+    public: const Time &SimTime() const;
+
+    /// \brief Set the simulation time stamp of the state.
+    /// \param[in] _time Simulation time.
+    public: void SetSimTime(const Time &_time);
+
+    /// \brief Get the wall time stamp of the state.
+    /// \return Wall time.
+    public: const Time &WallTime() const;
+
+    /// \brief Set the wall time stamp of the state.
+    /// \param[in] _time Wall time.
+    public: void SetWallTime(const Time &_time);
+
+    /// \brief Get the real time stamp of the state.
+    /// \return Real time.
+    public: const Time &RealTime() const;
+
+    /// \brief Set the real time stamp of the state.
+    /// \param[in] _time Real time.
+    public: void SetRealTime(const Time &_time);
+
+    /// \brief Get the number of simulation iterations.
+    /// \return Number of iterations.
+    public: uint64_t Iterations() const;
+
+    /// \brief Set the number of simulation iterations.
+    /// \param[in] _iterations Number of iterations.
+    public: void SetIterations(uint64_t _iterations);
+
+    /// \brief Get the number of inserted models.
+    /// \return Number of models in the <insertions> element.
+    public: uint64_t InsertedModelCount() const;
+
+    /// \brief Get an inserted model by index.
+    /// \param[in] _index Index of the model, in the range
+    /// [0..InsertedModelCount()).
+    /// \return Pointer to the model. Nullptr if the index does not exist.
+    public: const Model *InsertedModelByIndex(uint64_t _index) const;
+
+    /// \brief Add an inserted model.
+    /// \param[in] _model Model to insert when the state is applied.
+    public: void AddInsertedModel(const Model &_model);
+
+    /// \brief Get the number of inserted lights.
+    /// \return Number of lights in the <insertions> element.
+    public: uint64_t InsertedLightCount() const;
+
+    /// \brief Get an inserted light by index.
+    /// \param[in] _index Index of the light, in the range
+    /// [0..InsertedLightCount()).
+    /// \return Pointer to the light. Nullptr if the index does not exist.
+    public: const Light *InsertedLightByIndex(uint64_t _index) const;
+
+    /// \brief Add an inserted light.
+    /// \param[in] _light Light to insert when the state is applied.
+    public: void AddInsertedLight(const Light &_light);
+
+    /// \brief Get the names of the deleted models and lights.
+    /// \return Names in the <deletions> element.
+    public: const std::vector<std::string> &Deletions() const;
+
+    /// \brief Add the name of a deleted model or light.
+    /// \param[in] _name Name of the entity to delete when the state is
+    /// applied.
+    public: void AddDeletion(const std::string &_name);
+
+    /// \brief Get the number of model states.
+    /// \return Number of models whose state is recorded.
+    public: uint64_t ModelStateCount() const;
+
+    /// \brief Get a model state by index.
+    /// \param[in] _index Index of the model state, in the range
+    /// [0..ModelStateCount()).
+    /// \return Pointer to the model state. Nullptr if the index does not
+    /// exist.
+    public: const ModelState *ModelStateByIndex(uint64_t _index) const;
+
+    /// \brief Get the state of a model by the name of the model.
+    /// \param[in] _name Name of the model.
+    /// \return Pointer to the model state. Nullptr if the state has no
+    /// model with that name.
+    public: const ModelState *ModelStateByName(const std::string &_name) const;
+
+    /// \brief Add the state of a model. The state of a model with the same
+    /// name is replaced.
+    /// \param[in] _state State of the model.
+    public: void AddModelState(const ModelState &_state);
+
+    /// \brief Get the number of light states.
+    /// \return Number of lights whose state is recorded.
+    public: uint64_t LightStateCount() const;
+
+    /// \brief Get a light state by index.
+    /// \param[in] _index Index of the light state, in the range
+    /// [0..LightStateCount()).
+    /// \return Pointer to the light state. Nullptr if the index does not
+    /// exist.
+    public: const LightState *LightStateByIndex(uint64_t _index) const;
+
+    /// \brief Get the state of a light by the name of the light.
+    /// \param[in] _name Name of the light.
+    /// \return Pointer to the light state. Nullptr if the state has no
+    /// light with that name.
+    public: const LightState *LightStateByName(const std::string &_name) const;
+
+    /// \brief Add the state of a light. The state of a light with the same
+    /// name is replaced.
+    /// \param[in] _state State of the light.
+    public: void AddLightState(const LightState &_state);
+
+    /// \brief Get a pointer to the SDF element that was used during load.
+    /// \return SDF element pointer. The value will be nullptr if Load has
+    /// not been called.
+    public: sdf::ElementPtr Element() const;
+
+    /// \brief Private data pointer.
+    private: WorldStatePrivate *dataPtr = nullptr;
+  };
+  }
+}
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif
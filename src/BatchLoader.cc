@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "sdf/BatchLoader.hh"
+#include "sdf/parser.hh"
+
+#include "ParserCache.hh"
+#include "Utils.hh"
+
+using namespace sdf;
+
+/// \brief Private data for sdf::BatchLoader
+class sdf::BatchLoaderPrivate
+{
+  /// \brief Maximum number of threads, 0 for the hardware threads.
+  public: unsigned int threads = 0;
+
+  /// \brief Caches shared by the files.
+  public: ParserCache cache;
+};
+
+/////////////////////////////////////////////////
+BatchLoader::BatchLoader()
+  : dataPtr(new BatchLoaderPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+BatchLoader::~BatchLoader() = default;
+
+/////////////////////////////////////////////////
+void BatchLoader::SetThreads(unsigned int _threads)
+{
+  this->dataPtr->threads = _threads;
+}
+
+/////////////////////////////////////////////////
+unsigned int BatchLoader::Threads() const
+{
+  return this->dataPtr->threads;
+}
+
+/////////////////////////////////////////////////
+std::vector<BatchLoadResult> BatchLoader::Load(
+    const std::vector<std::string> &_filenames)
+{
+  std::vector<BatchLoadResult> results(_filenames.size());
+
+  parallelFor(_filenames.size(), this->dataPtr->threads,
+      [&](std::size_t _i)
+  {
+    BatchLoadResult &result = results[_i];
+    result.filename = _filenames[_i];
+
+    ParserCache::Scope scope(&this->dataPtr->cache);
+
+    // Same as Root::Load(const std::string &), with a copy of the schema
+    // instead of sdf::init.
+    auto start = std::chrono::steady_clock::now();
+    SDFPtr sdfParsed = ParserCache::NewSDF();
+    bool read = readFile(result.filename, sdfParsed, result.errors);
+    auto end = std::chrono::steady_clock::now();
+    result.readTime = end - start;
+
+    if (!read)
+    {
+      result.errors.push_back(
+          {ErrorCode::FILE_READ, "Unable to read file:" + result.filename});
+      return;
+    }
+
+    start = end;
+    Errors loadErrors = result.root.Load(sdfParsed);
+    result.errors.insert(result.errors.end(), loadErrors.begin(),
+        loadErrors.end());
+    result.loadTime = std::chrono::steady_clock::now() - start;
+  });
+
+  return results;
+}
+
+/////////////////////////////////////////////////
+std::size_t BatchLoader::FindFileHits() const
+{
+  return this->dataPtr->cache.FindFileHits();
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <clocale>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "sdf/BatchLoader.hh"
+#include "sdf/Filesystem.hh"
+#include "sdf/Model.hh"
+#include "sdf/Root.hh"
+#include "sdf/World.hh"
+#include "sdf/parser.hh"
+#include "test_config.h"
+
+const auto g_testPath = sdf::filesystem::append(PROJECT_SOURCE_PATH, "test");
+
+/////////////////////////////////////////////////
+TEST(DOMBatchLoader, Construction)
+{
+  sdf::BatchLoader loader;
+  EXPECT_EQ(0u, loader.Threads());
+  EXPECT_EQ(0u, loader.FindFileHits());
+
+  loader.SetThreads(4);
+  EXPECT_EQ(4u, loader.Threads());
+
+  EXPECT_TRUE(loader.Load({}).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMBatchLoader, Load)
+{
+  const std::vector<std::string> filenames = {
+    sdf::filesystem::append(g_testPath, "sdf", "joint_complete.sdf"),
+    sdf::filesystem::append(g_testPath, "sdf", "model_duplicate_links.sdf"),
+    sdf::filesystem::append(g_testPath, "sdf", "does_not_exist.sdf"),
+    sdf::filesystem::append(g_testPath, "sdf", "joint_complete.sdf"),
+  };
+
+  sdf::BatchLoader loader;
+  loader.SetThreads(3);
+  std::vector<sdf::BatchLoadResult> results = loader.Load(filenames);
+  ASSERT_EQ(filenames.size(), results.size());
+
+  // Each result matches a load of the file by a Root.
+  for (std::size_t i = 0; i < filenames.size(); ++i)
+  {
+    EXPECT_EQ(filenames[i], results[i].filename);
+
+    sdf::Root root;
+    sdf::Errors errors = root.Load(filenames[i]);
+    ASSERT_EQ(errors.size(), results[i].errors.size()) << filenames[i];
+    for (std::size_t e = 0; e < errors.size(); ++e)
+    {
+      EXPECT_EQ(errors[e].Code(), results[i].errors[e].Code());
+      EXPECT_EQ(errors[e].Message(), results[i].errors[e].Message());
+    }
+    EXPECT_EQ(root.ModelCount(), results[i].root.ModelCount());
+  }
+
+  EXPECT_TRUE(results[0].errors.empty());
+  ASSERT_EQ(1u, results[0].root.ModelCount());
+  EXPECT_EQ("test", results[0].root.ModelByIndex(0)->Name());
+  EXPECT_GT(results[0].readTime.count(), 0);
+  EXPECT_GT(results[0].loadTime.count(), 0);
+
+  EXPECT_FALSE(results[1].errors.empty());
+
+  ASSERT_FALSE(results[2].errors.empty());
+  EXPECT_EQ(sdf::ErrorCode::FILE_READ, results[2].errors.back().Code());
+  EXPECT_EQ(0, results[2].loadTime.count());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMBatchLoader, SharedIncludes)
+{
+  sdf::setFindCallback([](const std::string &_uri)
+  {
+    return sdf::filesystem::append(g_testPath, "integration", "model", _uri);
+  });
+
+  const std::string includes =
+      sdf::filesystem::append(g_testPath, "sdf", "includes.sdf");
+
+  sdf::BatchLoader loader;
+  loader.SetThreads(1);
+  std::vector<sdf::BatchLoadResult> results = loader.Load({includes});
+  ASSERT_EQ(1u, results.size());
+  EXPECT_TRUE(results[0].errors.empty());
+  ASSERT_EQ(1u, results[0].root.WorldCount());
+  EXPECT_LT(0u, results[0].root.WorldByIndex(0)->ModelCount());
+
+  // Each URI is included twice by the file, so the second lookups hit the
+  // cache.
+  const std::size_t hits = loader.FindFileHits();
+  EXPECT_LT(0u, hits);
+
+  // Lookups are remembered across batches.
+  results = loader.Load({includes, includes});
+  ASSERT_EQ(2u, results.size());
+  EXPECT_TRUE(results[1].errors.empty());
+  EXPECT_LT(hits, loader.FindFileHits());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMBatchLoader, ConcurrentConversions)
+{
+#ifndef _WIN32
+  // Start from a latin locale, whose decimal separator is a comma, if one
+  // is available.
+  FILE *fp = popen("locale -a | grep '^es\\|^pt_\\|^it_' | head -n 1", "r");
+  ASSERT_NE(nullptr, fp);
+  char buffer[1024];
+  char *line = fgets(buffer, sizeof(buffer), fp);
+  pclose(fp);
+  if (line)
+  {
+    std::string locale(line);
+    locale.erase(locale.find_last_not_of(" \n") + 1);
+    std::setlocale(LC_NUMERIC, locale.c_str());
+  }
+#endif
+
+  // The files are converted from SDF 1.6, which writes debug messages, and
+  // their numbers are parsed on several threads at once.
+  const std::string path =
+      sdf::filesystem::append(g_testPath, "sdf", "double_pendulum.sdf");
+  const std::vector<std::string> filenames(8, path);
+
+  sdf::BatchLoader loader;
+  loader.SetThreads(4);
+  std::vector<sdf::BatchLoadResult> results = loader.Load(filenames);
+  ASSERT_EQ(filenames.size(), results.size());
+  for (const auto &result : results)
+  {
+    EXPECT_TRUE(result.errors.empty());
+    ASSERT_EQ(1u, result.root.ModelCount());
+    EXPECT_DOUBLE_EQ(1.0, result.root.ModelByIndex(0)->RawPose().Pos().X());
+  }
+
+  std::setlocale(LC_NUMERIC, "C");
+}
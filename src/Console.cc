@@ -15,6 +15,7 @@
  *
  */
 
+#include <atomic>
 #include <cstdlib>
 #include <memory>
 #include <mutex>
@@ -34,13 +35,57 @@ static std::mutex g_instance_mutex;
 /// \todo Output disabled for windows, to allow tests to pass. We should
 /// disable output just for tests on windows.
 #ifndef _WIN32
-static bool g_quiet = false;
+static std::atomic<bool> g_quiet(false);
 #else
-static bool g_quiet = true;
+static std::atomic<bool> g_quiet(true);
 #endif
 
 static Console::ConsoleStream g_NullStream(nullptr);
 
+namespace
+{
+  /// \brief Text of a message, which tells whether the message ended.
+  class MessageBuffer : public std::stringbuf
+  {
+    /// \brief Check whether no text was written.
+    /// \return True if the buffer is empty.
+    public: bool Empty() const
+    {
+      return this->pptr() == this->pbase();
+    }
+
+    /// \brief Check whether the text ends with a new line.
+    /// \return True if the message ended.
+    public: bool Ended() const
+    {
+      return !this->Empty() && this->pptr()[-1] == '\n';
+    }
+  };
+
+  /// \brief Message being written on a thread.
+  struct ThreadMessage
+  {
+    /// \brief Text of the message, after the prefix.
+    MessageBuffer buffer;
+
+    /// \brief Stream that writes into the buffer.
+    std::ostream body{&this->buffer};
+
+    /// \brief Prefix written to the terminal.
+    std::string prefix;
+
+    /// \brief Prefix written to the log file.
+    std::string logPrefix;
+
+    /// \brief Terminal stream of the message, can be nullptr.
+    std::ostream *stream = nullptr;
+  };
+}
+
+/// \brief Message being written on each thread. Messages are collected
+/// here without locking, and each one is written at once.
+static thread_local ThreadMessage t_message;
+
 //////////////////////////////////////////////////
 Console::Console()
   : dataPtr(new ConsolePrivate)
@@ -136,24 +181,63 @@ void Console::ConsoleStream::Prefix(const std::string &_lbl,
                                     unsigned int _line,
                                     int _color)
 {
+  // A message that did not end with a new line ends here.
+  this->WriteMessage(false);
+  t_message.stream = this->stream;
+
   size_t index = _file.find_last_of("/") + 1;
+  const std::string location = " [" +
+      _file.substr(index , _file.size() - index) + ":" +
+      std::to_string(_line) + "]";
 
   (void)_color;
-  if (this->stream)
-  {
 #ifndef _WIN32
-    *this->stream << "\033[1;" << _color << "m" << _lbl << " [" <<
-      _file.substr(index , _file.size() - index) << ":" << _line <<
-      "]\033[0m ";
+  t_message.prefix = "\033[1;" + std::to_string(_color) + "m" + _lbl +
+      location + "\033[0m ";
 #else
-    *this->stream << _lbl << " [" <<
-      _file.substr(index , _file.size() - index) << ":" << _line << "] ";
+  t_message.prefix = _lbl + location + " ";
 #endif
+  t_message.logPrefix = _lbl + location + " ";
+}
+
+//////////////////////////////////////////////////
+std::ostream &Console::ConsoleStream::MessageStream()
+{
+  if (t_message.stream != this->stream)
+  {
+    this->WriteMessage(false);
+    t_message.stream = this->stream;
+  }
+  return t_message.body;
+}
+
+//////////////////////////////////////////////////
+void Console::ConsoleStream::WriteMessage(bool _ended)
+{
+  ThreadMessage &msg = t_message;
+  if (_ended ? !msg.buffer.Ended() :
+      msg.buffer.Empty() && msg.logPrefix.empty())
+  {
+    return;
   }
 
-  if (Console::Instance()->dataPtr->logFileStream.is_open())
+  const std::string text = msg.buffer.str();
+  ConsolePtr console = Console::Instance();
   {
-    Console::Instance()->dataPtr->logFileStream << _lbl << " [" <<
-      _file.substr(index , _file.size() - index)<< ":" << _line << "] ";
+    std::lock_guard<std::mutex> lock(console->dataPtr->mutex);
+    if (msg.stream)
+    {
+      *msg.stream << msg.prefix << text;
+    }
+
+    if (console->dataPtr->logFileStream.is_open())
+    {
+      console->dataPtr->logFileStream << msg.logPrefix << text;
+      console->dataPtr->logFileStream.flush();
+    }
   }
+
+  msg.buffer.str(std::string());
+  msg.prefix.clear();
+  msg.logPrefix.clear();
 }
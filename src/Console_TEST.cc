@@ -15,7 +15,11 @@
  *
  */
 
+#include <fstream>
+#include <regex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -121,6 +125,52 @@ TEST(Console, quiet)
   con->SetQuiet(false);
 }
 
+////////////////////////////////////////////////////
+/// Messages can be written from several threads, such as those of a
+/// parallel load.
+TEST(Console, Threads)
+{
+#ifndef _WIN32
+  sdf::Console::Clear();
+  std::string temp_dir;
+  ASSERT_TRUE(create_new_temp_dir(temp_dir));
+  ASSERT_EQ(setenv("HOME", temp_dir.c_str(), 1), 0);
+#endif
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([t]()
+    {
+      for (int i = 0; i < 10; ++i)
+      {
+        sdfwarn << "Warning " << t << "." << i << ".\n";
+        sdfdbg << "Debug " << t << "." << i << ".\n";
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+#ifndef _WIN32
+  // Each message is written at once, so the lines of different threads are
+  // not mixed up.
+  std::ifstream log(temp_dir + "/.sdformat/sdformat.log");
+  ASSERT_TRUE(log.is_open());
+  const std::regex pattern(
+      "(Warning \\[Console_TEST.cc:[0-9]+\\] Warning|"
+      "Dbg \\[Console_TEST.cc:[0-9]+\\] Debug) [0-3]\\.[0-9]\\.");
+  std::size_t count = 0;
+  for (std::string line; std::getline(log, line); ++count)
+  {
+    EXPECT_TRUE(std::regex_match(line, pattern)) << line;
+  }
+  EXPECT_EQ(80u, count);
+#endif
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
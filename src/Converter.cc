@@ -40,6 +40,52 @@ bool EndsWith(const std::string& _a, const std::string& _b)
   return (_a.size() >= _b.size()) &&
       (_a.compare(_a.size() - _b.size(), _b.size(), _b) == 0);
 }
+
+/// \brief Decode the strings of a node and of its descendants. tinyxml2
+/// decodes strings when they are first read, so a document is only safe to
+/// read from several threads once this is done.
+/// \param[in] _node Node to process.
+void DecodeStrings(const tinyxml2::XMLNode *_node)
+{
+  for (const tinyxml2::XMLNode *child = _node->FirstChild(); child;
+       child = child->NextSibling())
+  {
+    child->Value();
+    const tinyxml2::XMLElement *elem = child->ToElement();
+    if (elem)
+    {
+      for (const tinyxml2::XMLAttribute *attr = elem->FirstAttribute(); attr;
+           attr = attr->Next())
+      {
+        attr->Name();
+        attr->Value();
+      }
+    }
+    DecodeStrings(child);
+  }
+}
+
+/// \brief Get the conversion recipes of the embedded files database, keyed
+/// by path name. They are parsed on first use and shared by all conversions,
+/// which only read them, so conversions may run on several threads.
+const std::map<std::string, tinyxml2::XMLDocument> &ConvertDocs()
+{
+  static const std::map<std::string, tinyxml2::XMLDocument> docs = []()
+  {
+    std::map<std::string, tinyxml2::XMLDocument> result;
+    for (const auto& [pathname, data] : GetEmbeddedSdf())
+    {
+      if (EndsWith(pathname, ".convert"))
+      {
+        tinyxml2::XMLDocument &doc = result[pathname];
+        doc.Parse(data.c_str());
+        DecodeStrings(&doc);
+      }
+    }
+    return result;
+  }();
+  return docs;
+}
 }
 
 /////////////////////////////////////////////////
@@ -83,7 +129,7 @@ bool Converter::Convert(tinyxml2::XMLDocument *_doc,
 
   // The conversion recipes within the embedded files database are named, e.g.,
   // "1.8/1_7.convert" to upgrade from 1.7 to 1.8.
-  const std::map<std::string, std::string> &embedded = GetEmbeddedSdf();
+  const std::map<std::string, tinyxml2::XMLDocument> &recipes = ConvertDocs();
 
   // Apply the conversions one at a time until we reach the desired _toVersion.
   std::string curVersion = origVersion;
@@ -93,31 +139,32 @@ bool Converter::Convert(tinyxml2::XMLDocument *_doc,
     std::string snakeVersion = curVersion;
     std::replace(snakeVersion.begin(), snakeVersion.end(), '.', '_');
     const std::string suffix = "/" + snakeVersion + ".convert";
-    const char* convertXml = nullptr;
-    for (const auto& [pathname, data] : embedded)
+    const tinyxml2::XMLDocument *xmlDoc = nullptr;
+    for (const auto& [pathname, doc] : recipes)
     {
       if (EndsWith(pathname, suffix))
       {
         curVersion = pathname.substr(0, pathname.size() - suffix.size());
-        convertXml = data.c_str();
+        xmlDoc = &doc;
         break;
       }
     }
-    if (convertXml == nullptr)
+    if (xmlDoc == nullptr)
     {
       break;
     }
 
-    // Parse and apply the conversion XML.
-    tinyxml2::XMLDocument xmlDoc;
-    xmlDoc.Parse(convertXml);
-    if (xmlDoc.Error())
+    // Apply the conversion XML.
+    if (xmlDoc->Error())
     {
       sdferr << "Error parsing XML from string: "
-             << xmlDoc.ErrorStr() << '\n';
+             << xmlDoc->ErrorStr() << '\n';
       return false;
     }
-    ConvertImpl(elem, xmlDoc.FirstChildElement("convert"));
+    // The recipe is not modified, ConvertImpl takes a non-const element for
+    // historical reasons.
+    ConvertImpl(elem, const_cast<tinyxml2::XMLElement *>(
+        xmlDoc->FirstChildElement("convert")));
   }
 
   // Check that we actually converted to the desired final version.
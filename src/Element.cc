@@ -16,15 +16,54 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "sdf/Assert.hh"
 #include "sdf/Element.hh"
+#include "sdf/ElementPath.hh"
+#include "sdf/ElementVisitor.hh"
 #include "sdf/Filesystem.hh"
 
 using namespace sdf;
 
+/////////////////////////////////////////////////
+/// \brief Mark the cached structural hash of an element as stale. This
+/// must be called whenever the name, attributes, value, include file name,
+/// file path or original version of the element change. Changes to the
+/// values of existing parameters are detected with Param::Revision.
+/// \param[in] _data Private data of the element that changed.
+static void invalidateHash(ElementPrivate *_data)
+{
+  _data->hashValid = false;
+}
+
+/////////////////////////////////////////////////
+/// \brief Discard the child index of an element. This must be called
+/// whenever the list of child elements or the name of a child changes.
+/// The structural hash of the element is invalidated as well.
+/// \param[in] _data Private data of the element whose children changed.
+static void resetChildIndex(ElementPrivate *_data)
+{
+  std::atomic_store(&_data->childIndex, decltype(_data->childIndex)());
+  invalidateHash(_data);
+}
+
+/////////////////////////////////////////////////
+/// \brief Combine a hash value into a seed.
+/// \param[in,out] _seed Hash to update.
+/// \param[in] _value Hash to combine into _seed.
+static void hashCombine(std::size_t &_seed, std::size_t _value)
+{
+  _seed ^= _value + 0x9e3779b9 + (_seed << 6) + (_seed >> 2);
+}
+
 /////////////////////////////////////////////////
 Element::Element()
   : dataPtr(new ElementPrivate)
@@ -67,6 +106,13 @@ void Element::SetParent(const ElementPtr _parent)
 void Element::SetName(const std::string &_name)
 {
   this->dataPtr->name = _name;
+  invalidateHash(this->dataPtr.get());
+
+  auto parent = this->dataPtr->parent.lock();
+  if (parent)
+  {
+    resetChildIndex(parent->dataPtr.get());
+  }
 }
 
 /////////////////////////////////////////////////
@@ -119,6 +165,7 @@ void Element::AddValue(const std::string &_type,
 {
   this->dataPtr->value = this->CreateParam(this->dataPtr->name,
       _type, _defaultValue, _required, _description);
+  invalidateHash(this->dataPtr.get());
 }
 
 /////////////////////////////////////////////////
@@ -132,6 +179,7 @@ void Element::AddValue(const std::string &_type,
   this->dataPtr->value =
       std::make_shared<Param>(this->dataPtr->name, _type, _defaultValue,
                               _required, _minValue, _maxValue, _description);
+  invalidateHash(this->dataPtr.get());
 }
 
 /////////////////////////////////////////////////
@@ -154,6 +202,7 @@ void Element::AddAttribute(const std::string &_key,
 {
   this->dataPtr->attributes.push_back(
       this->CreateParam(_key, _type, _defaultValue, _required, _description));
+  invalidateHash(this->dataPtr.get());
 }
 
 /////////////////////////////////////////////////
@@ -242,6 +291,7 @@ void Element::Copy(const ElementPtr _elem)
   }
 
   this->dataPtr->elements.clear();
+  resetChildIndex(this->dataPtr.get());
   for (ElementPtr_V::iterator iter = _elem->dataPtr->elements.begin();
        iter != _elem->dataPtr->elements.end(); ++iter)
   {
@@ -444,47 +494,74 @@ void Element::PrintDocLeftPane(std::string &_html, int _spacing,
 void Element::PrintValuesImpl(const std::string &_prefix,
                               std::ostringstream &_out) const
 {
-  _out << _prefix << "<" << this->dataPtr->name;
-
-  Param_V::const_iterator aiter;
-  for (aiter = this->dataPtr->attributes.begin();
-       aiter != this->dataPtr->attributes.end(); ++aiter)
+  // Print the opening tag of an element. Elements without children are
+  // printed completely.
+  auto printOpen = [&_out](const Element &_elem, const std::string &_indent)
   {
-    // Only print attribute values if they were set
-    // TODO(anyone): GetRequired is added here to support up-conversions where a
-    // new required attribute with a default value is added. We would have
-    // better separation of concerns if the conversion process set the required
-    // attributes with their default values.
-    if ((*aiter)->GetSet() || (*aiter)->GetRequired())
+    _out << _indent << "<" << _elem.dataPtr->name;
+
+    for (const ParamPtr &attr : _elem.dataPtr->attributes)
     {
-      _out << " " << (*aiter)->GetKey() << "='"
-           << (*aiter)->GetAsString() << "'";
+      // Only print attribute values if they were set
+      // TODO(anyone): GetRequired is added here to support up-conversions
+      // where a new required attribute with a default value is added. We
+      // would have better separation of concerns if the conversion process
+      // set the required attributes with their default values.
+      if (attr->GetSet() || attr->GetRequired())
+      {
+        _out << " " << attr->GetKey() << "='"
+             << attr->GetAsString() << "'";
+      }
     }
-  }
 
-  if (this->dataPtr->elements.size() > 0)
-  {
-    _out << ">\n";
-    ElementPtr_V::const_iterator eiter;
-    for (eiter = this->dataPtr->elements.begin();
-         eiter != this->dataPtr->elements.end(); ++eiter)
+    if (_elem.dataPtr->elements.size() > 0)
     {
-      (*eiter)->ToString(_prefix + "  ", _out);
+      _out << ">\n";
     }
-    _out << _prefix << "</" << this->dataPtr->name << ">\n";
-  }
-  else
-  {
-    if (this->dataPtr->value)
+    else if (_elem.dataPtr->value)
     {
-      _out << ">" << this->dataPtr->value->GetAsString()
-           << "</" << this->dataPtr->name << ">\n";
+      _out << ">" << _elem.dataPtr->value->GetAsString()
+           << "</" << _elem.dataPtr->name << ">\n";
     }
     else
     {
       _out << "/>\n";
     }
-  }
+  };
+
+  auto printClose = [&_out](const Element &_elem, const std::string &_indent)
+  {
+    if (_elem.dataPtr->elements.size() > 0)
+      _out << _indent << "</" << _elem.dataPtr->name << ">\n";
+  };
+
+  // Each level of nesting is indented by two more spaces.
+  auto indent = [&_prefix](std::size_t _depth)
+  {
+    return _prefix + std::string(2 * _depth, ' ');
+  };
+
+  ElementVisitor visitor;
+  visitor.SetPreVisit([&](const ElementPtr &_elem, std::size_t _depth)
+  {
+    if (!_elem->dataPtr->includeFilename.empty())
+    {
+      _out << indent(_depth) << "<include filename='"
+           << _elem->dataPtr->includeFilename << "'/>\n";
+      return TraversalAction::SKIP_CHILDREN;
+    }
+    printOpen(*_elem, indent(_depth));
+    return TraversalAction::CONTINUE;
+  });
+  visitor.SetPostVisit([&](const ElementPtr &_elem, std::size_t _depth)
+  {
+    if (_elem->dataPtr->includeFilename.empty())
+      printClose(*_elem, indent(_depth));
+  });
+
+  printOpen(*this, _prefix);
+  visitor.VisitChildren(*this);
+  printClose(*this, _prefix);
 }
 
 /////////////////////////////////////////////////
@@ -683,16 +760,285 @@ ElementPtr Element::GetNextElement(const std::string &_name) const
   return ElementPtr();
 }
 
+/////////////////////////////////////////////////
+ElementPtr Element::Select(const ElementPath &_path) const
+{
+  return _path.First(*this);
+}
+
+/////////////////////////////////////////////////
+ElementPtr_V Element::SelectAll(const ElementPath &_path) const
+{
+  return _path.All(*this);
+}
+
+/////////////////////////////////////////////////
+std::size_t Element::Hash() const
+{
+  // Update the cached hashes of an element. Returns true if the hash of the
+  // subtree was computed again.
+  auto updateHash = [](const Element &_elem, bool _childrenChanged)
+  {
+    ElementPrivate &data = *_elem.dataPtr;
+
+    std::uint64_t revision = data.value ? data.value->Revision() : 0;
+    for (const ParamPtr &attr : data.attributes)
+      revision += attr->Revision();
+
+    const bool ownChanged = !data.hashValid || revision != data.paramRevision;
+    if (!ownChanged && !_childrenChanged)
+      return false;
+
+    if (ownChanged)
+    {
+      std::hash<std::string> hashString;
+      std::size_t own = hashString(data.name);
+      hashCombine(own, hashString(data.includeFilename));
+      hashCombine(own, hashString(data.path));
+      hashCombine(own, hashString(data.originalVersion));
+      for (const ParamPtr &attr : data.attributes)
+      {
+        hashCombine(own, hashString(attr->GetKey()));
+        hashCombine(own, attr->GetSet());
+        hashCombine(own, hashString(attr->GetAsString()));
+      }
+      hashCombine(own, data.value != nullptr);
+      if (data.value)
+      {
+        hashCombine(own, data.value->GetSet());
+        hashCombine(own, hashString(data.value->GetAsString()));
+      }
+      data.ownHash = own;
+      data.paramRevision = revision;
+    }
+
+    std::size_t hash = data.ownHash;
+    for (const ElementPtr &child : data.elements)
+      hashCombine(hash, child->dataPtr->hash);
+    hashCombine(hash, data.elements.size());
+
+    data.hash = hash;
+    data.hashValid = true;
+    return true;
+  };
+
+  // changed[d] is set when a child of the element at depth d was hashed
+  // again, which means the element must combine the hashes of its children
+  // again.
+  std::vector<char> changed(1, 0);
+
+  ElementVisitor visitor;
+  visitor.SetPreVisit([&changed](const ElementPtr &, std::size_t _depth)
+  {
+    if (changed.size() <= _depth)
+      changed.resize(_depth + 1);
+    changed[_depth] = 0;
+    return TraversalAction::CONTINUE;
+  });
+  visitor.SetPostVisit([&](const ElementPtr &_elem, std::size_t _depth)
+  {
+    if (updateHash(*_elem, changed[_depth]))
+      changed[_depth - 1] = 1;
+  });
+
+  visitor.VisitChildren(*this);
+  updateHash(*this, changed[0]);
+  return this->dataPtr->hash;
+}
+
+/////////////////////////////////////////////////
+std::size_t Element::DeduplicateSubtrees(const std::set<std::string> &_names)
+{
+  // Compare two elements and their descendants field by field, to rule out
+  // hash collisions.
+  auto equal = [](const ElementPtr &_a, const ElementPtr &_b)
+  {
+    std::vector<std::pair<const Element *, const Element *>> pending;
+    pending.emplace_back(_a.get(), _b.get());
+    while (!pending.empty())
+    {
+      const ElementPrivate &a = *pending.back().first->dataPtr;
+      const ElementPrivate &b = *pending.back().second->dataPtr;
+      pending.pop_back();
+
+      if (a.name != b.name || a.includeFilename != b.includeFilename ||
+          a.path != b.path || a.originalVersion != b.originalVersion ||
+          a.attributes.size() != b.attributes.size() ||
+          (a.value == nullptr) != (b.value == nullptr) ||
+          a.elements.size() != b.elements.size())
+      {
+        return false;
+      }
+
+      for (std::size_t i = 0; i < a.attributes.size(); ++i)
+      {
+        if (a.attributes[i]->GetKey() != b.attributes[i]->GetKey() ||
+            a.attributes[i]->GetSet() != b.attributes[i]->GetSet() ||
+            a.attributes[i]->GetAsString() != b.attributes[i]->GetAsString())
+        {
+          return false;
+        }
+      }
+
+      if (a.value && (a.value->GetSet() != b.value->GetSet() ||
+          a.value->GetAsString() != b.value->GetAsString()))
+      {
+        return false;
+      }
+
+      for (std::size_t i = 0; i < a.elements.size(); ++i)
+      {
+        if (a.elements[i] != b.elements[i])
+          pending.emplace_back(a.elements[i].get(), b.elements[i].get());
+      }
+    }
+    return true;
+  };
+
+  this->Hash();
+
+  std::unordered_map<std::size_t, ElementPtr_V> candidates;
+  std::unordered_set<const Element *> visited;
+  std::size_t replaced = 0;
+
+  // Children are replaced when their parent is entered, before the visitor
+  // reads them.
+  auto shareChildren = [&](Element &_parent)
+  {
+    for (ElementPtr &child : _parent.dataPtr->elements)
+    {
+      if (!_names.count(child->dataPtr->name))
+        continue;
+
+      ElementPtr_V &sameHash = candidates[child->dataPtr->hash];
+      auto match = std::find_if(sameHash.begin(), sameHash.end(),
+          [&](const ElementPtr &_candidate)
+          {
+            return _candidate == child || equal(_candidate, child);
+          });
+
+      if (match == sameHash.end())
+      {
+        sameHash.push_back(child);
+      }
+      else if (*match != child)
+      {
+        child = *match;
+        ++replaced;
+      }
+    }
+  };
+
+  ElementVisitor visitor;
+  visitor.SetPreVisit([&](const ElementPtr &_elem, std::size_t)
+  {
+    // Shared subtrees are only visited once.
+    if (_names.count(_elem->dataPtr->name) &&
+        !visited.insert(_elem.get()).second)
+    {
+      return TraversalAction::SKIP_CHILDREN;
+    }
+
+    shareChildren(*_elem);
+    return TraversalAction::CONTINUE;
+  });
+
+  shareChildren(*this);
+  visitor.VisitChildren(*this);
+  return replaced;
+}
+
+/////////////////////////////////////////////////
+MemoryBreakdown Element::MemoryUsage() const
+{
+  MemoryBreakdown usage;
+  MemoryBreakdown schema;
+  std::unordered_set<const Element *> visited;
+
+  // Each entry is an element and whether it belongs to an element
+  // description.
+  std::vector<std::pair<const Element *, bool>> pending;
+  pending.emplace_back(this, false);
+  while (!pending.empty())
+  {
+    const Element *elem = pending.back().first;
+    const bool isSchema = pending.back().second;
+    pending.pop_back();
+    if (!visited.insert(elem).second)
+      continue;
+
+    const ElementPrivate &data = *elem->dataPtr;
+    MemoryBreakdown &target = isSchema ? schema : usage;
+    ++target.elementCount;
+
+    target.domBytes += sizeof(Element) + sizeof(ElementPrivate) +
+        data.attributes.capacity() * sizeof(ParamPtr) +
+        data.elements.capacity() * sizeof(ElementPtr) +
+        data.elementDescriptions.capacity() * sizeof(ElementPtr);
+
+    auto index = std::atomic_load(&data.childIndex);
+    if (index)
+    {
+      target.domBytes += sizeof(*index) +
+          index->bucket_count() * sizeof(void *);
+      for (const auto &entry : *index)
+      {
+        target.domBytes += sizeof(entry) + 2 * sizeof(void *) +
+            entry.second.capacity() * sizeof(std::size_t);
+        target.stringBytes += MemoryBreakdown::StringHeapBytes(entry.first);
+      }
+    }
+
+    for (const std::string *str : {&data.name, &data.required,
+         &data.includeFilename, &data.referenceSDF, &data.path,
+         &data.originalVersion})
+    {
+      target.stringBytes += MemoryBreakdown::StringHeapBytes(*str);
+    }
+    target.descriptionBytes +=
+        MemoryBreakdown::StringHeapBytes(data.description);
+
+    for (const ParamPtr &attr : data.attributes)
+      target += attr->MemoryUsage();
+    if (data.value)
+      target += data.value->MemoryUsage();
+
+    for (const ElementPtr &child : data.elements)
+      pending.emplace_back(child.get(), isSchema);
+    for (const ElementPtr &desc : data.elementDescriptions)
+      pending.emplace_back(desc.get(), true);
+  }
+
+  usage.descriptionBytes += schema.TotalBytes();
+  return usage;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<const std::unordered_map<std::string, std::vector<std::size_t>>>
+Element::ChildIndex() const
+{
+  auto index = std::atomic_load(&this->dataPtr->childIndex);
+  if (!index)
+  {
+    auto newIndex = std::make_shared<
+        std::unordered_map<std::string, std::vector<std::size_t>>>();
+    for (std::size_t i = 0; i < this->dataPtr->elements.size(); ++i)
+    {
+      (*newIndex)[this->dataPtr->elements[i]->GetName()].push_back(i);
+    }
+    index = newIndex;
+    std::atomic_store(&this->dataPtr->childIndex, index);
+  }
+  return index;
+}
+
 /////////////////////////////////////////////////
 std::set<std::string> Element::GetElementTypeNames() const
 {
   std::set<std::string> result;
-  auto elem = this->GetFirstElement();
-  while (elem)
+  for (const ElementPtr &elem : this->dataPtr->elements)
   {
-    std::string typeName = elem->GetName();
-    result.insert(typeName);
-    elem = elem->GetNextElement();
+    result.insert(elem->GetName());
   }
   return result;
 }
@@ -717,35 +1063,20 @@ Element::CountNamedElements(const std::string &_type) const
 {
   std::map<std::string, std::size_t> result;
 
-  sdf::ElementPtr elem;
-  if (_type.empty())
+  // The children are read directly, since GetNextElement searches for the
+  // position of each element and would make this quadratic.
+  for (const ElementPtr &elem : this->dataPtr->elements)
   {
-    elem = this->GetFirstElement();
-  }
-  else
-  {
-    elem = this->GetElementImpl(_type);
-  }
+    if (!_type.empty() && elem->GetName() != _type)
+      continue;
 
-  while (elem)
-  {
     if (elem->HasAttribute("name"))
     {
       // Get("name") returns attribute value if it exists before checking
       // for the value of a child element <name>, so it's safe to use
       // here since we've checked HasAttribute("name").
-      std::string childNameAttributeValue = elem->Get<std::string>("name");
-      if (result.find(childNameAttributeValue) == result.end())
-      {
-        result[childNameAttributeValue] = 1;
-      }
-      else
-      {
-        ++result[childNameAttributeValue];
-      }
+      ++result[elem->Get<std::string>("name")];
     }
-
-    elem = elem->GetNextElement(_type);
   }
 
   return result;
@@ -767,6 +1098,16 @@ ElementPtr Element::GetElement(const std::string &_name)
 void Element::InsertElement(ElementPtr _elem)
 {
   this->dataPtr->elements.push_back(_elem);
+  resetChildIndex(this->dataPtr.get());
+}
+
+/////////////////////////////////////////////////
+void Element::InsertElement(ElementPtr _elem, std::size_t _index)
+{
+  auto &elements = this->dataPtr->elements;
+  elements.insert(elements.begin() + std::min(_index, elements.size()),
+      _elem);
+  resetChildIndex(this->dataPtr.get());
 }
 
 /////////////////////////////////////////////////
@@ -801,6 +1142,7 @@ ElementPtr Element::AddElement(const std::string &_name)
       ElementPtr elem = (*iter)->Clone();
       elem->SetParent(shared_from_this());
       this->dataPtr->elements.push_back(elem);
+      resetChildIndex(this->dataPtr.get());
 
       // Add all child elements.
       for (iter2 = elem->dataPtr->elementDescriptions.begin();
@@ -839,57 +1181,79 @@ void Element::ClearElements()
   }
 
   this->dataPtr->elements.clear();
+  resetChildIndex(this->dataPtr.get());
 }
 
 /////////////////////////////////////////////////
 void Element::Update()
 {
-  for (sdf::Param_V::iterator iter = this->dataPtr->attributes.begin();
-      iter != this->dataPtr->attributes.end(); ++iter)
+  // The attributes of an element are updated before its children and its
+  // value after them.
+  auto updateAttributes = [](const Element &_elem)
   {
-    (*iter)->Update();
-  }
-
-  for (sdf::ElementPtr_V::iterator iter = this->dataPtr->elements.begin();
-      iter != this->dataPtr->elements.end(); ++iter)
+    for (const ParamPtr &attr : _elem.dataPtr->attributes)
+      attr->Update();
+  };
+  auto updateValue = [](const Element &_elem)
   {
-    (*iter)->Update();
-  }
+    if (_elem.dataPtr->value)
+      _elem.dataPtr->value->Update();
+  };
 
-  if (this->dataPtr->value)
+  ElementVisitor visitor;
+  visitor.SetPreVisit([&](const ElementPtr &_elem, std::size_t)
   {
-    this->dataPtr->value->Update();
-  }
+    updateAttributes(*_elem);
+    return TraversalAction::CONTINUE;
+  });
+  visitor.SetPostVisit([&](const ElementPtr &_elem, std::size_t)
+  {
+    updateValue(*_elem);
+  });
+
+  updateAttributes(*this);
+  visitor.VisitChildren(*this);
+  updateValue(*this);
 }
 
 /////////////////////////////////////////////////
 void Element::Reset()
 {
-  for (ElementPtr_V::iterator iter = this->dataPtr->elements.begin();
-      iter != this->dataPtr->elements.end(); ++iter)
+  // Element descriptions are separate trees. They are collected while the
+  // elements are reset and reset afterwards, so that no recursion is needed.
+  ElementPtr_V descriptions;
+  auto resetElement = [&descriptions](Element &_elem)
   {
-    if (*iter)
+    for (const ElementPtr &desc : _elem.dataPtr->elementDescriptions)
     {
-      (*iter)->Reset();
+      if (desc)
+        descriptions.push_back(desc);
     }
-    (*iter).reset();
-  }
+    _elem.dataPtr->elements.clear();
+    _elem.dataPtr->elementDescriptions.clear();
+    resetChildIndex(_elem.dataPtr.get());
 
-  for (ElementPtr_V::iterator iter = this->dataPtr->elementDescriptions.begin();
-      iter != this->dataPtr->elementDescriptions.end(); ++iter)
+    _elem.dataPtr->value.reset();
+
+    _elem.dataPtr->parent.reset();
+  };
+
+  // Children are reset in the post-visit hook, after their own children.
+  ElementVisitor visitor;
+  visitor.SetPostVisit([&](const ElementPtr &_elem, std::size_t)
   {
-    if (*iter)
-    {
-      (*iter)->Reset();
-    }
-    (*iter).reset();
-  }
-  this->dataPtr->elements.clear();
-  this->dataPtr->elementDescriptions.clear();
+    resetElement(*_elem);
+  });
 
-  this->dataPtr->value.reset();
+  visitor.VisitChildren(*this);
+  resetElement(*this);
 
-  this->dataPtr->parent.reset();
+  while (!descriptions.empty())
+  {
+    ElementPtr desc = descriptions.back();
+    descriptions.pop_back();
+    visitor.Visit(desc);
+  }
 }
 
 /////////////////////////////////////////////////
@@ -902,6 +1266,7 @@ void Element::AddElementDescription(ElementPtr _elem)
 void Element::SetInclude(const std::string &_filename)
 {
   this->dataPtr->includeFilename = _filename;
+  invalidateHash(this->dataPtr.get());
 }
 
 /////////////////////////////////////////////////
@@ -914,6 +1279,7 @@ std::string Element::GetInclude() const
 void Element::SetFilePath(const std::string &_path)
 {
   this->dataPtr->path = _path;
+  invalidateHash(this->dataPtr.get());
 }
 
 /////////////////////////////////////////////////
@@ -926,6 +1292,7 @@ const std::string &Element::FilePath() const
 void Element::SetOriginalVersion(const std::string &_version)
 {
   this->dataPtr->originalVersion = _version;
+  invalidateHash(this->dataPtr.get());
 }
 
 /////////////////////////////////////////////////
@@ -959,6 +1326,7 @@ void Element::RemoveFromParent()
     if (iter != parent->dataPtr->elements.end())
     {
       parent->dataPtr->elements.erase(iter);
+      resetChildIndex(parent->dataPtr.get());
       parent.reset();
     }
   }
@@ -977,6 +1345,7 @@ void Element::RemoveChild(ElementPtr _child)
   {
     _child->SetParent(ElementPtr());
     this->dataPtr->elements.erase(iter);
+    resetChildIndex(this->dataPtr.get());
   }
 }
 
@@ -0,0 +1,367 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sdf/Element.hh"
+#include "sdf/ElementDiff.hh"
+#include "sdf/ElementPath.hh"
+#include "sdf/Param.hh"
+
+using namespace sdf;
+
+/////////////////////////////////////////////////
+ElementEdit::ElementEdit(ElementEditType _type, const std::string &_path,
+    const std::string &_key, const std::string &_value)
+  : type(_type), path(_path), key(_key), value(_value)
+{
+}
+
+/////////////////////////////////////////////////
+ElementEdit::ElementEdit(const std::string &_path, ElementPtr _elem,
+    std::size_t _index)
+  : type(ElementEditType::INSERT), path(_path), elem(_elem), index(_index)
+{
+}
+
+/////////////////////////////////////////////////
+ElementEditType ElementEdit::Type() const
+{
+  return this->type;
+}
+
+/////////////////////////////////////////////////
+const std::string &ElementEdit::Path() const
+{
+  return this->path;
+}
+
+/////////////////////////////////////////////////
+const std::string &ElementEdit::Key() const
+{
+  return this->key;
+}
+
+/////////////////////////////////////////////////
+const std::string &ElementEdit::Value() const
+{
+  return this->value;
+}
+
+/////////////////////////////////////////////////
+ElementPtr ElementEdit::Element() const
+{
+  return this->elem;
+}
+
+/////////////////////////////////////////////////
+std::size_t ElementEdit::Index() const
+{
+  return this->index;
+}
+
+/////////////////////////////////////////////////
+std::ostream &sdf::operator<<(std::ostream &_out, const ElementEdit &_edit)
+{
+  const std::string path = _edit.Path().empty() ? "." : _edit.Path();
+  switch (_edit.Type())
+  {
+    case ElementEditType::INSERT:
+      _out << "insert " << path << " " << _edit.Index() << "\n";
+      if (_edit.Element())
+        _out << _edit.Element()->ToString("  ");
+      break;
+    case ElementEditType::REMOVE:
+      _out << "remove " << path << "\n";
+      break;
+    case ElementEditType::SET_ATTRIBUTE:
+      _out << "set " << path << " @" << _edit.Key() << " '"
+           << _edit.Value() << "'\n";
+      break;
+    case ElementEditType::SET_VALUE:
+      _out << "set " << path << " '" << _edit.Value() << "'\n";
+      break;
+  }
+  return _out;
+}
+
+/////////////////////////////////////////////////
+/// \brief Compute the path step of each child of an element. Children with
+/// a name attribute that is unique among the siblings with the same element
+/// name are identified by that attribute, the others by their position
+/// among those siblings.
+/// \param[in] _children Child elements.
+/// \return Path step of each child, used both to match children and to
+/// build paths.
+static std::vector<std::string> childSteps(const ElementPtr_V &_children)
+{
+  std::vector<std::string> names(_children.size());
+  std::unordered_map<std::string, std::size_t> nameCounts;
+  for (std::size_t i = 0; i < _children.size(); ++i)
+  {
+    ParamPtr nameAttr = _children[i]->GetAttribute("name");
+    if (!nameAttr || !nameAttr->GetSet())
+      continue;
+
+    const std::string name = nameAttr->GetAsString();
+    if (name.find('\'') != std::string::npos &&
+        name.find('"') != std::string::npos)
+    {
+      continue;
+    }
+    names[i] = name;
+    ++nameCounts[_children[i]->GetName() + '\0' + name];
+  }
+
+  std::vector<std::string> steps(_children.size());
+  std::unordered_map<std::string, std::size_t> positions;
+  for (std::size_t i = 0; i < _children.size(); ++i)
+  {
+    const std::string &tag = _children[i]->GetName();
+    const std::size_t position = ++positions[tag];
+    if (!names[i].empty() && nameCounts[tag + '\0' + names[i]] == 1)
+    {
+      const char quote =
+          names[i].find('\'') == std::string::npos ? '\'' : '"';
+      steps[i] = tag + "[@name=" + quote + names[i] + quote + "]";
+    }
+    else
+    {
+      steps[i] = tag + "[" + std::to_string(position) + "]";
+    }
+  }
+  return steps;
+}
+
+/////////////////////////////////////////////////
+/// \brief Join a parent path and a step.
+/// \param[in] _path Parent path, empty for the root.
+/// \param[in] _step Step of the child.
+/// \return Path of the child.
+static std::string joinPath(const std::string &_path,
+    const std::string &_step)
+{
+  return _path.empty() ? _step : _path + "/" + _step;
+}
+
+/////////////////////////////////////////////////
+ElementPatch sdf::Diff(const ElementPtr &_a, const ElementPtr &_b)
+{
+  ElementPatch patch;
+  if (!_a || !_b)
+    return patch;
+
+  // Fill the hash caches of both trees once, so that the cached hash of any
+  // descendant can be read directly.
+  _a->Hash();
+  _b->Hash();
+
+  /// \brief A pair of matched elements and the path of the element.
+  struct Pending
+  {
+    const sdf::Element *a;
+    const sdf::Element *b;
+    std::string path;
+  };
+  std::vector<Pending> pending;
+  pending.push_back({_a.get(), _b.get(), ""});
+
+  while (!pending.empty())
+  {
+    Pending current = std::move(pending.back());
+    pending.pop_back();
+
+    const ElementPrivate &a = *current.a->dataPtr;
+    const ElementPrivate &b = *current.b->dataPtr;
+    if (a.hash == b.hash)
+      continue;
+
+    for (const ParamPtr &attrB : b.attributes)
+    {
+      ParamPtr attrA = current.a->GetAttribute(attrB->GetKey());
+      const std::string valueB = attrB->GetAsString();
+      if ((!attrA && attrB->GetSet()) ||
+          (attrA && attrA->GetAsString() != valueB))
+      {
+        patch.emplace_back(ElementEditType::SET_ATTRIBUTE, current.path,
+            attrB->GetKey(), valueB);
+      }
+    }
+
+    if (b.value)
+    {
+      const std::string valueB = b.value->GetAsString();
+      if (!a.value || a.value->GetAsString() != valueB)
+      {
+        patch.emplace_back(ElementEditType::SET_VALUE, current.path, "",
+            valueB);
+      }
+    }
+
+    if (a.elements.empty() && b.elements.empty())
+      continue;
+
+    const std::vector<std::string> stepsA = childSteps(a.elements);
+    const std::vector<std::string> stepsB = childSteps(b.elements);
+
+    std::unordered_map<std::string, std::size_t> indexB;
+    for (std::size_t i = 0; i < stepsB.size(); ++i)
+      indexB.emplace(stepsB[i], i);
+
+    // matchA[j] is the index in a.elements matched with b.elements[j].
+    std::vector<std::size_t> matchA(b.elements.size(), a.elements.size());
+    std::vector<std::size_t> removed;
+    for (std::size_t i = 0; i < stepsA.size(); ++i)
+    {
+      auto it = indexB.find(stepsA[i]);
+      if (it != indexB.end())
+      {
+        matchA[it->second] = i;
+      }
+      else
+      {
+        removed.push_back(i);
+      }
+    }
+
+    // Remove from the last child, so that the positions of the previous
+    // siblings are still valid.
+    for (auto it = removed.rbegin(); it != removed.rend(); ++it)
+    {
+      patch.emplace_back(ElementEditType::REMOVE,
+          joinPath(current.path, stepsA[*it]));
+    }
+
+    // Insert in increasing order of position, which yields the order of _b
+    // when the matched children did not move.
+    for (std::size_t j = 0; j < b.elements.size(); ++j)
+    {
+      if (matchA[j] == a.elements.size())
+      {
+        patch.emplace_back(current.path, b.elements[j]->Clone(), j);
+      }
+    }
+
+    // Matched children are compared after the edits of their parent, with
+    // paths of the patched tree. They are pushed in reverse so that edits
+    // come out in document order.
+    for (std::size_t j = b.elements.size(); j-- > 0;)
+    {
+      if (matchA[j] != a.elements.size())
+      {
+        pending.push_back({a.elements[matchA[j]].get(), b.elements[j].get(),
+            joinPath(current.path, stepsB[j])});
+      }
+    }
+  }
+
+  return patch;
+}
+
+/////////////////////////////////////////////////
+Errors sdf::Apply(const ElementPtr &_elem, const ElementPatch &_patch)
+{
+  Errors errors;
+  if (!_elem)
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Unable to apply a patch to a null element."});
+    return errors;
+  }
+
+  for (const ElementEdit &edit : _patch)
+  {
+    ElementPtr target = _elem;
+    if (!edit.Path().empty())
+    {
+      ElementPath path;
+      Errors pathErrors = path.Compile(edit.Path());
+      if (!pathErrors.empty())
+      {
+        errors.insert(errors.end(), pathErrors.begin(), pathErrors.end());
+        continue;
+      }
+      target = _elem->Select(path);
+    }
+
+    if (!target)
+    {
+      errors.push_back({ErrorCode::ELEMENT_MISSING,
+          "Element[" + edit.Path() + "] of a patch edit does not exist."});
+      continue;
+    }
+
+    switch (edit.Type())
+    {
+      case ElementEditType::INSERT:
+      {
+        if (!edit.Element())
+        {
+          errors.push_back({ErrorCode::ELEMENT_MISSING,
+              "Insert edit for element[" + edit.Path() +
+              "] has no element."});
+          break;
+        }
+        ElementPtr child = edit.Element()->Clone();
+        child->SetParent(target);
+        target->InsertElement(child, edit.Index());
+        break;
+      }
+      case ElementEditType::REMOVE:
+      {
+        ElementPtr parent = target->GetParent();
+        if (target == _elem || !parent)
+        {
+          errors.push_back({ErrorCode::ELEMENT_INVALID,
+              "Unable to remove element[" + edit.Path() +
+              "], which has no parent."});
+          break;
+        }
+        parent->RemoveChild(target);
+        break;
+      }
+      case ElementEditType::SET_ATTRIBUTE:
+      {
+        if (!target->HasAttribute(edit.Key()))
+          target->AddAttribute(edit.Key(), "string", "", false);
+        if (!target->GetAttribute(edit.Key())->SetFromString(edit.Value()))
+        {
+          errors.push_back({ErrorCode::ATTRIBUTE_INVALID,
+              "Unable to set attribute[" + edit.Key() + "] of element[" +
+              edit.Path() + "] to [" + edit.Value() + "]."});
+        }
+        break;
+      }
+      case ElementEditType::SET_VALUE:
+      {
+        if (!target->GetValue())
+          target->AddValue("string", "", false);
+        if (!target->GetValue()->SetFromString(edit.Value()))
+        {
+          errors.push_back({ErrorCode::ELEMENT_INVALID,
+              "Unable to set the value of element[" + edit.Path() +
+              "] to [" + edit.Value() + "]."});
+        }
+        break;
+      }
+    }
+  }
+
+  return errors;
+}
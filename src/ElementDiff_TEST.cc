@@ -0,0 +1,178 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "sdf/Element.hh"
+#include "sdf/ElementDiff.hh"
+
+/////////////////////////////////////////////////
+/// \brief Add a child element with an optional name attribute and value.
+sdf::ElementPtr addChild(sdf::ElementPtr _parent, const std::string &_tag,
+    const std::string &_name = "", const std::string &_value = "")
+{
+  sdf::ElementPtr child = std::make_shared<sdf::Element>();
+  child->SetName(_tag);
+  if (!_name.empty())
+  {
+    child->AddAttribute("name", "string", "", true);
+    child->GetAttribute("name")->SetFromString(_name);
+  }
+  if (!_value.empty())
+  {
+    child->AddValue("string", "", false);
+    child->GetValue()->SetFromString(_value);
+  }
+  child->SetParent(_parent);
+  _parent->InsertElement(child);
+  return child;
+}
+
+/////////////////////////////////////////////////
+/// \brief Build a world with a few models.
+sdf::ElementPtr buildWorld()
+{
+  sdf::ElementPtr world = std::make_shared<sdf::Element>();
+  world->SetName("world");
+  world->AddAttribute("name", "string", "", true);
+  world->GetAttribute("name")->SetFromString("default");
+  addChild(world, "gravity", "", "0 0 -9.8");
+  for (const std::string name : {"ground", "box", "sphere"})
+  {
+    auto model = addChild(world, "model", name);
+    addChild(model, "pose", "", "0 0 0 0 0 0");
+    auto link = addChild(model, "link", "link");
+    addChild(link, "visual", "visual");
+  }
+  addChild(world, "plugin", "", "a");
+  addChild(world, "plugin", "", "b");
+  return world;
+}
+
+/////////////////////////////////////////////////
+TEST(ElementDiff, Identical)
+{
+  sdf::ElementPtr a = buildWorld();
+  sdf::ElementPtr b = buildWorld();
+  EXPECT_TRUE(sdf::Diff(a, b).empty());
+  EXPECT_TRUE(sdf::Diff(a, a).empty());
+  EXPECT_TRUE(sdf::Diff(a, nullptr).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(ElementDiff, Edits)
+{
+  sdf::ElementPtr a = buildWorld();
+  sdf::ElementPtr b = buildWorld();
+
+  // Change a pose, remove a model, add a light and rename the world.
+  auto box = b->GetElement("model")->GetNextElement("model");
+  box->GetElement("pose")->GetValue()->SetFromString("1 2 3 0 0 0");
+  b->RemoveChild(box->GetNextElement("model"));
+  auto light = addChild(b, "light", "sun");
+  addChild(light, "cast_shadows", "", "true");
+  b->GetAttribute("name")->SetFromString("edited");
+
+  sdf::ElementPatch patch = sdf::Diff(a, b);
+  ASSERT_EQ(4u, patch.size());
+
+  EXPECT_EQ(sdf::ElementEditType::SET_ATTRIBUTE, patch[0].Type());
+  EXPECT_EQ("", patch[0].Path());
+  EXPECT_EQ("name", patch[0].Key());
+  EXPECT_EQ("edited", patch[0].Value());
+
+  EXPECT_EQ(sdf::ElementEditType::REMOVE, patch[1].Type());
+  EXPECT_EQ("model[@name='sphere']", patch[1].Path());
+
+  EXPECT_EQ(sdf::ElementEditType::INSERT, patch[2].Type());
+  EXPECT_EQ("", patch[2].Path());
+  EXPECT_EQ(5u, patch[2].Index());
+  ASSERT_NE(nullptr, patch[2].Element());
+  EXPECT_EQ("light", patch[2].Element()->GetName());
+
+  EXPECT_EQ(sdf::ElementEditType::SET_VALUE, patch[3].Type());
+  EXPECT_EQ("model[@name='box']/pose[1]", patch[3].Path());
+  EXPECT_EQ("1 2 3 0 0 0", patch[3].Value());
+
+  std::ostringstream stream;
+  for (const auto &edit : patch)
+    stream << edit;
+  EXPECT_NE(std::string::npos,
+      stream.str().find("remove model[@name='sphere']"));
+
+  EXPECT_TRUE(sdf::Apply(a, patch).empty());
+  EXPECT_EQ(b->ToString(""), a->ToString(""));
+  EXPECT_EQ(b->Hash(), a->Hash());
+  EXPECT_TRUE(sdf::Diff(a, b).empty());
+
+  // The patch can't be applied twice.
+  EXPECT_FALSE(sdf::Apply(a, patch).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(ElementDiff, UnnamedSiblings)
+{
+  sdf::ElementPtr a = buildWorld();
+  sdf::ElementPtr b = buildWorld();
+
+  // Unnamed elements are matched by position among same-name siblings, so
+  // removing the first plugin changes the value of the first one and
+  // removes the second one.
+  b->RemoveChild(b->GetElement("plugin"));
+
+  sdf::ElementPatch patch = sdf::Diff(a, b);
+  ASSERT_EQ(2u, patch.size());
+  EXPECT_EQ(sdf::ElementEditType::REMOVE, patch[0].Type());
+  EXPECT_EQ("plugin[2]", patch[0].Path());
+  EXPECT_EQ(sdf::ElementEditType::SET_VALUE, patch[1].Type());
+  EXPECT_EQ("plugin[1]", patch[1].Path());
+  EXPECT_EQ("b", patch[1].Value());
+
+  EXPECT_TRUE(sdf::Apply(a, patch).empty());
+  EXPECT_EQ(b->ToString(""), a->ToString(""));
+}
+
+/////////////////////////////////////////////////
+TEST(ElementDiff, ApplyErrors)
+{
+  sdf::ElementPtr a = buildWorld();
+
+  sdf::ElementPatch patch;
+  patch.emplace_back(sdf::ElementEditType::REMOVE, "model[@name='none']");
+  patch.emplace_back(sdf::ElementEditType::REMOVE, "");
+  patch.emplace_back(sdf::ElementEditType::SET_VALUE, "/bad");
+  patch.emplace_back("", nullptr, 0);
+  patch.emplace_back(sdf::ElementEditType::SET_ATTRIBUTE, "gravity", "unit",
+      "m/s^2");
+
+  sdf::Errors errors = sdf::Apply(a, patch);
+  ASSERT_EQ(4u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_MISSING, errors[0].Code());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_INVALID, errors[1].Code());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_PATH_INVALID, errors[2].Code());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_MISSING, errors[3].Code());
+
+  // The last edit is applied despite the previous errors.
+  ASSERT_TRUE(a->GetElement("gravity")->HasAttribute("unit"));
+  EXPECT_EQ("m/s^2",
+      a->GetElement("gravity")->GetAttribute("unit")->GetAsString());
+
+  EXPECT_FALSE(sdf::Apply(nullptr, patch).empty());
+}
@@ -0,0 +1,664 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sdf/Element.hh"
+#include "sdf/ElementPath.hh"
+#include "sdf/Error.hh"
+#include "sdf/Param.hh"
+#include "sdf/Types.hh"
+
+#include "Utils.hh"
+
+using namespace sdf;
+
+/// \brief Element count at which a step with a name test uses the child
+/// index of the context element instead of scanning all children.
+static const std::size_t kMinIndexedChildren = 8;
+
+/// \brief A filter applied to the candidates of a path step.
+struct PathPredicate
+{
+  /// \brief The kind of filter.
+  enum class Kind
+  {
+    /// \brief [@key]
+    HAS_ATTRIBUTE,
+
+    /// \brief [@key='value']
+    ATTRIBUTE_EQUALS,
+
+    /// \brief [key='value']
+    KEY_EQUALS,
+
+    /// \brief [N]
+    POSITION,
+  };
+
+  /// \brief Kind of filter.
+  Kind kind = Kind::POSITION;
+
+  /// \brief Attribute or child element name.
+  std::string key;
+
+  /// \brief Value to compare against.
+  std::string value;
+
+  /// \brief The value read as numbers, parsed when the path is compiled.
+  /// Empty if the value is not a list of numbers.
+  std::vector<double> numbers;
+
+  /// \brief 1-based position for Kind::POSITION.
+  std::size_t position = 0;
+};
+
+/// \brief A single step of a compiled path.
+struct PathStep
+{
+  /// \brief True if the step was preceded by "//".
+  bool descendant = false;
+
+  /// \brief Element name to match, or "*" to match any name.
+  std::string name;
+
+  /// \brief Filters applied in order to the candidates of this step.
+  std::vector<PathPredicate> predicates;
+};
+
+/// \brief Private data for ElementPath.
+class sdf::ElementPathPrivate
+{
+  /// \brief The compiled source string.
+  public: std::string str;
+
+  /// \brief The compiled steps.
+  public: std::vector<PathStep> steps;
+
+  /// \brief True if the path compiled without errors.
+  public: bool valid = false;
+};
+
+/////////////////////////////////////////////////
+/// \brief Read the next number of a value, after any white space. The words
+/// true and false are read as 1 and 0, as bool parameters store them.
+/// \param[in,out] _str Position in the value, moved past the number.
+/// \param[out] _number The number.
+/// \return True if a number was read.
+static bool readNumber(const char *&_str, double &_number)
+{
+  while (std::isspace(static_cast<unsigned char>(*_str)))
+    ++_str;
+
+  for (const char *word : {"false", "true"})
+  {
+    std::size_t i = 0;
+    while (word[i] && std::tolower(static_cast<unsigned char>(_str[i])) ==
+        word[i])
+    {
+      ++i;
+    }
+    if (!word[i])
+    {
+      _number = word[0] == 't' ? 1 : 0;
+      _str += i;
+      return true;
+    }
+  }
+
+  char *end = nullptr;
+  _number = std::strtod(_str, &end);
+  if (end == _str)
+    return false;
+  _str = end;
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a value as a list of numbers separated by white space.
+/// \param[in] _value Value to read.
+/// \param[out] _numbers The numbers, or empty if the value is not only made
+/// of numbers.
+static void readNumbers(const std::string &_value,
+    std::vector<double> &_numbers)
+{
+  _numbers.clear();
+  const char *str = _value.c_str();
+  double number;
+  while (readNumber(str, number))
+    _numbers.push_back(number);
+
+  while (std::isspace(static_cast<unsigned char>(*str)))
+    ++str;
+  if (*str != '\0')
+    _numbers.clear();
+}
+
+/////////////////////////////////////////////////
+/// \brief Parse the content between the brackets of a predicate.
+/// \param[in] _text Predicate content.
+/// \param[out] _predicate Parsed predicate.
+/// \return True on success.
+static bool parsePredicate(const std::string &_text, PathPredicate &_predicate)
+{
+  const std::string text = sdf::trim(_text);
+  if (text.empty())
+    return false;
+
+  if (std::all_of(text.begin(), text.end(),
+        [](unsigned char _c) {return std::isdigit(_c);}))
+  {
+    _predicate.kind = PathPredicate::Kind::POSITION;
+    _predicate.position = std::stoul(text);
+    return _predicate.position > 0;
+  }
+
+  const bool attribute = text[0] == '@';
+  const std::size_t eq = text.find('=');
+  const std::size_t keyStart = attribute ? 1 : 0;
+  _predicate.key = sdf::trim(text.substr(keyStart,
+      eq == std::string::npos ? std::string::npos : eq - keyStart));
+  if (_predicate.key.empty())
+    return false;
+
+  if (eq == std::string::npos)
+  {
+    _predicate.kind = PathPredicate::Kind::HAS_ATTRIBUTE;
+    return attribute;
+  }
+
+  const std::string quoted = sdf::trim(text.substr(eq + 1));
+  if (quoted.size() < 2 || (quoted[0] != '\'' && quoted[0] != '"') ||
+      quoted.back() != quoted[0])
+  {
+    return false;
+  }
+  _predicate.value = quoted.substr(1, quoted.size() - 2);
+  readNumbers(_predicate.value, _predicate.numbers);
+  _predicate.kind = attribute ? PathPredicate::Kind::ATTRIBUTE_EQUALS :
+                                PathPredicate::Kind::KEY_EQUALS;
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Compare a parameter with the value of a predicate. Values of
+/// other types than string are compared as numbers when the value of the
+/// predicate is a list of numbers, so that e.g. `true` matches a bool
+/// stored as `1`, and `1.0` matches a double stored as `1`.
+/// \param[in] _param Parameter to compare, may be nullptr.
+/// \param[in] _predicate Predicate with the value from the path.
+/// \return True if the parameter is set and equal to the value.
+static bool paramEquals(const ParamPtr &_param,
+    const PathPredicate &_predicate)
+{
+  if (!_param)
+    return false;
+
+  const std::string current = _param->GetAsString();
+  if (current == _predicate.value || _predicate.numbers.empty() ||
+      _param->GetTypeName() == "string")
+  {
+    return current == _predicate.value;
+  }
+
+  // Read the numbers of the parameter one at a time, without allocating.
+  const char *str = current.c_str();
+  double number;
+  for (double expected : _predicate.numbers)
+  {
+    if (!readNumber(str, number) || number != expected)
+      return false;
+  }
+  while (std::isspace(static_cast<unsigned char>(*str)))
+    ++str;
+  return *str == '\0';
+}
+
+/////////////////////////////////////////////////
+/// \brief Check a non-positional predicate against an element.
+/// \param[in] _elem Element to check.
+/// \param[in] _predicate Predicate to apply.
+/// \return True if the element passes the filter.
+static bool matchesPredicate(const Element &_elem,
+    const PathPredicate &_predicate)
+{
+  switch (_predicate.kind)
+  {
+    case PathPredicate::Kind::HAS_ATTRIBUTE:
+      return _elem.HasAttribute(_predicate.key);
+    case PathPredicate::Kind::ATTRIBUTE_EQUALS:
+      return paramEquals(_elem.GetAttribute(_predicate.key), _predicate);
+    case PathPredicate::Kind::KEY_EQUALS:
+    {
+      ParamPtr attr = _elem.GetAttribute(_predicate.key);
+      if (attr)
+        return paramEquals(attr, _predicate);
+      ElementPtr child = _elem.GetElementImpl(_predicate.key);
+      return child && paramEquals(child->GetValue(), _predicate);
+    }
+    default:
+      return true;
+  }
+}
+
+/////////////////////////////////////////////////
+void ElementPath::Collect(const Element &_ctx, std::size_t _step,
+    ElementPtr_V &_out, ElementPtr_V *_walked) const
+{
+  const PathStep &step = this->dataPtr->steps[_step];
+  const std::size_t begin = _out.size();
+  const bool anyName = step.name == "*";
+
+  if (step.descendant)
+  {
+    // Pre-order walk of the subtree without recursion.
+    const auto &children = _ctx.dataPtr->elements;
+    std::vector<ElementPtr> stack(children.rbegin(), children.rend());
+    while (!stack.empty())
+    {
+      ElementPtr elem = stack.back();
+      stack.pop_back();
+      if (anyName || elem->GetName() == step.name)
+        _out.push_back(elem);
+      if (_walked)
+        _walked->push_back(elem);
+
+      const auto &grandChildren = elem->dataPtr->elements;
+      stack.insert(stack.end(), grandChildren.rbegin(), grandChildren.rend());
+    }
+  }
+  else if (!anyName && _ctx.dataPtr->elements.size() >= kMinIndexedChildren)
+  {
+    auto index = _ctx.ChildIndex();
+    auto it = index->find(step.name);
+    if (it != index->end())
+    {
+      for (std::size_t i : it->second)
+        _out.push_back(_ctx.dataPtr->elements[i]);
+    }
+  }
+  else
+  {
+    for (const ElementPtr &child : _ctx.dataPtr->elements)
+    {
+      if (anyName || child->GetName() == step.name)
+        _out.push_back(child);
+    }
+  }
+
+  // Apply the predicates to the candidates of this context in order.
+  for (const PathPredicate &predicate : step.predicates)
+  {
+    if (predicate.kind == PathPredicate::Kind::POSITION)
+    {
+      const std::size_t count = _out.size() - begin;
+      if (predicate.position > count)
+      {
+        _out.resize(begin);
+      }
+      else
+      {
+        ElementPtr keep = _out[begin + predicate.position - 1];
+        _out.resize(begin);
+        _out.push_back(keep);
+      }
+    }
+    else
+    {
+      _out.erase(std::remove_if(_out.begin() + begin, _out.end(),
+          [&predicate](const ElementPtr &_elem)
+          {
+            return !matchesPredicate(*_elem, predicate);
+          }), _out.end());
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+ElementPath::ElementPath()
+  : dataPtr(std::make_unique<ElementPathPrivate>())
+{
+}
+
+/////////////////////////////////////////////////
+ElementPath::ElementPath(const std::string &_path)
+  : dataPtr(std::make_unique<ElementPathPrivate>())
+{
+  this->Compile(_path);
+}
+
+/////////////////////////////////////////////////
+ElementPath::ElementPath(const ElementPath &_path)
+  : dataPtr(std::make_unique<ElementPathPrivate>(*_path.dataPtr))
+{
+}
+
+/////////////////////////////////////////////////
+ElementPath::ElementPath(ElementPath &&_path) noexcept = default;
+
+/////////////////////////////////////////////////
+ElementPath &ElementPath::operator=(const ElementPath &_path)
+{
+  return *this = ElementPath(_path);
+}
+
+/////////////////////////////////////////////////
+ElementPath &ElementPath::operator=(ElementPath &&_path) noexcept = default;
+
+/////////////////////////////////////////////////
+ElementPath::~ElementPath() = default;
+
+/////////////////////////////////////////////////
+Errors ElementPath::Compile(const std::string &_path)
+{
+  Errors errors;
+
+  this->dataPtr->str = _path;
+  this->dataPtr->steps.clear();
+  this->dataPtr->valid = false;
+
+  // The values of the predicates, and of the parameters they are compared
+  // with, are read as numbers with a dot as decimal separator.
+  useClassicNumericLocale();
+
+  auto fail = [&](const std::string &_msg)
+  {
+    this->dataPtr->steps.clear();
+    errors.push_back({ErrorCode::ELEMENT_PATH_INVALID,
+        "Unable to compile element path[" + _path + "]: " + _msg});
+    return errors;
+  };
+
+  std::size_t i = 0;
+  const std::size_t size = _path.size();
+  if (size == 0)
+    return fail("the path is empty.");
+
+  while (i < size)
+  {
+    PathStep step;
+
+    if (_path[i] == '/')
+    {
+      if (_path.compare(i, 2, "//") == 0)
+      {
+        step.descendant = true;
+        i += 2;
+      }
+      else if (this->dataPtr->steps.empty())
+      {
+        return fail("absolute paths are not supported.");
+      }
+      else
+      {
+        ++i;
+      }
+    }
+    else if (!this->dataPtr->steps.empty())
+    {
+      return fail("expected '/' at position " + std::to_string(i) + ".");
+    }
+
+    // Element name test
+    const std::size_t nameStart = i;
+    while (i < size && _path[i] != '/' && _path[i] != '[' &&
+        !std::isspace(static_cast<unsigned char>(_path[i])))
+    {
+      ++i;
+    }
+    step.name = _path.substr(nameStart, i - nameStart);
+    if (step.name.empty())
+      return fail("missing element name at position " +
+          std::to_string(nameStart) + ".");
+
+    // Predicates
+    while (i < size && _path[i] == '[')
+    {
+      const std::size_t start = ++i;
+      char quote = '\0';
+      while (i < size && (quote != '\0' || _path[i] != ']'))
+      {
+        if (quote == '\0' && (_path[i] == '\'' || _path[i] == '"'))
+          quote = _path[i];
+        else if (_path[i] == quote)
+          quote = '\0';
+        ++i;
+      }
+      if (i >= size)
+        return fail("unterminated '['.");
+
+      PathPredicate predicate;
+      if (!parsePredicate(_path.substr(start, i - start), predicate))
+      {
+        return fail("invalid predicate[" + _path.substr(start, i - start) +
+            "].");
+      }
+      step.predicates.push_back(std::move(predicate));
+      ++i;
+    }
+
+    if (i < size && _path[i] != '/')
+      return fail("unexpected character at position " + std::to_string(i) +
+          ".");
+
+    this->dataPtr->steps.push_back(std::move(step));
+  }
+
+  this->dataPtr->valid = true;
+  return errors;
+}
+
+/////////////////////////////////////////////////
+bool ElementPath::Valid() const
+{
+  return this->dataPtr->valid && !this->dataPtr->steps.empty();
+}
+
+/////////////////////////////////////////////////
+const std::string &ElementPath::Str() const
+{
+  return this->dataPtr->str;
+}
+
+/////////////////////////////////////////////////
+ElementPtr ElementPath::First(const Element &_elem) const
+{
+  if (!this->Valid())
+    return nullptr;
+
+  // Depth-first search over (step, candidate) pairs. The stack holds the
+  // candidates of each step that have not been expanded yet.
+  const auto &steps = this->dataPtr->steps;
+  std::vector<ElementPtr_V> stack(1);
+  this->Collect(_elem, 0, stack[0]);
+  std::reverse(stack[0].begin(), stack[0].end());
+
+  while (!stack.empty())
+  {
+    ElementPtr_V &candidates = stack.back();
+    if (candidates.empty())
+    {
+      stack.pop_back();
+      continue;
+    }
+
+    ElementPtr elem = candidates.back();
+    candidates.pop_back();
+    if (stack.size() == steps.size())
+      return elem;
+
+    ElementPtr_V next;
+    this->Collect(*elem, stack.size(), next);
+    std::reverse(next.begin(), next.end());
+    stack.push_back(std::move(next));
+  }
+
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the ancestor-or-self of an element that is a child of
+/// another element.
+/// \param[in] _elem Element.
+/// \param[in] _parent Possible ancestor of _elem.
+/// \return The child of _parent on the path to _elem, or nullptr if _elem
+/// is not a descendant of _parent.
+static const Element *childOnPath(const Element &_elem,
+    const Element &_parent)
+{
+  const Element *elem = &_elem;
+  for (ElementPtr parent = elem->GetParent(); parent;
+       elem = parent.get(), parent = parent->GetParent())
+  {
+    if (parent.get() == &_parent)
+      return elem;
+  }
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+ElementPtr_V ElementPath::All(const Element &_elem) const
+{
+  ElementPtr_V result;
+  if (!this->Valid())
+    return result;
+
+  // The matches of each step are kept in document order and without
+  // duplicates, so that they can be the contexts of the next step. A `//`
+  // step can match an element and one of its descendants, so contexts can
+  // be nested in one another.
+  const auto &steps = this->dataPtr->steps;
+  this->Collect(_elem, 0, result);
+
+  for (std::size_t s = 1; s < steps.size() && !result.empty(); ++s)
+  {
+    const PathStep &step = steps[s];
+    ElementPtr_V next;
+
+    if (step.descendant)
+    {
+      const bool positional = std::any_of(step.predicates.begin(),
+          step.predicates.end(), [](const PathPredicate &_predicate)
+          {
+            return _predicate.kind == PathPredicate::Kind::POSITION;
+          });
+
+      // The walk of a context also visits the contexts nested in it, so
+      // those are skipped, unless positions select candidates per context.
+      // The candidates of nested contexts are then merged into those of
+      // the outermost one, in the order of its walk.
+      const Element *outer = nullptr;
+      ElementPtr_V walked;
+      std::size_t groupBegin = 0;
+      bool merge = false;
+      auto mergeGroup = [&]()
+      {
+        if (!merge)
+          return;
+        std::unordered_map<const Element *, std::size_t> order;
+        for (std::size_t i = 0; i < walked.size(); ++i)
+          order.emplace(walked[i].get(), i);
+        std::stable_sort(next.begin() + groupBegin, next.end(),
+            [&order](const ElementPtr &_a, const ElementPtr &_b)
+            {
+              return order.at(_a.get()) < order.at(_b.get());
+            });
+        next.erase(std::unique(next.begin() + groupBegin, next.end()),
+            next.end());
+        merge = false;
+      };
+
+      for (const ElementPtr &ctx : result)
+      {
+        if (outer && childOnPath(*ctx, *outer))
+        {
+          if (positional)
+          {
+            this->Collect(*ctx, s, next);
+            merge = true;
+          }
+          continue;
+        }
+
+        mergeGroup();
+        outer = ctx.get();
+        groupBegin = next.size();
+        walked.clear();
+        this->Collect(*ctx, s, next, positional ? &walked : nullptr);
+      }
+      mergeGroup();
+    }
+    else
+    {
+      // Contexts whose candidates have not all been emitted, each nested in
+      // the previous one. The candidates of a context are emitted up to the
+      // child that contains the next context, whose candidates follow.
+      struct OpenContext
+      {
+        const Element *elem;
+        ElementPtr_V candidates;
+        std::size_t emitted;
+        std::size_t child;
+      };
+      std::vector<OpenContext> open;
+
+      // Emit the candidates of a context up to and including a child, or
+      // all of them when the child is nullptr.
+      auto emit = [&next](OpenContext &_ctx, const Element *_child)
+      {
+        const auto &children = _ctx.elem->dataPtr->elements;
+        while (_ctx.emitted < _ctx.candidates.size() &&
+            _ctx.child < children.size())
+        {
+          const Element *child = children[_ctx.child++].get();
+          if (child == _ctx.candidates[_ctx.emitted].get())
+            next.push_back(_ctx.candidates[_ctx.emitted++]);
+          if (child == _child)
+            return;
+        }
+      };
+
+      for (const ElementPtr &ctx : result)
+      {
+        while (!open.empty())
+        {
+          const Element *child = childOnPath(*ctx, *open.back().elem);
+          emit(open.back(), child);
+          if (child)
+            break;
+          open.pop_back();
+        }
+
+        open.push_back({ctx.get(), {}, 0, 0});
+        this->Collect(*ctx, s, open.back().candidates);
+      }
+
+      for (auto it = open.rbegin(); it != open.rend(); ++it)
+        emit(*it, nullptr);
+    }
+
+    result = std::move(next);
+  }
+
+  return result;
+}
@@ -0,0 +1,264 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "sdf/Element.hh"
+#include "sdf/ElementPath.hh"
+
+/////////////////////////////////////////////////
+/// \brief Add a child element with an optional name attribute.
+sdf::ElementPtr addChild(sdf::ElementPtr _parent, const std::string &_tag,
+    const std::string &_name = "")
+{
+  sdf::ElementPtr child = std::make_shared<sdf::Element>();
+  child->SetName(_tag);
+  if (!_name.empty())
+  {
+    child->AddAttribute("name", "string", "", true);
+    child->GetAttribute("name")->SetFromString(_name);
+  }
+  child->SetParent(_parent);
+  _parent->InsertElement(child);
+  return child;
+}
+
+/////////////////////////////////////////////////
+/// \brief Build:
+/// <sdf>
+///   <world name="w">
+///     <model name="m1">
+///       <link name="a"><sensor name="s1" type="camera"/></link>
+///       <link name="b"><sensor name="s2" type="imu"/></link>
+///       <model name="nested"><link name="c"/></model>
+///     </model>
+///     <model name="m2"><static>true</static><link name="d"/></model>
+///   </world>
+/// </sdf>
+sdf::ElementPtr buildTree()
+{
+  sdf::ElementPtr root = std::make_shared<sdf::Element>();
+  root->SetName("sdf");
+  auto world = addChild(root, "world", "w");
+
+  auto m1 = addChild(world, "model", "m1");
+  auto a = addChild(m1, "link", "a");
+  auto s1 = addChild(a, "sensor", "s1");
+  s1->AddAttribute("type", "string", "", true);
+  s1->GetAttribute("type")->SetFromString("camera");
+  auto b = addChild(m1, "link", "b");
+  auto s2 = addChild(b, "sensor", "s2");
+  s2->AddAttribute("type", "string", "", true);
+  s2->GetAttribute("type")->SetFromString("imu");
+  auto nested = addChild(m1, "model", "nested");
+  addChild(nested, "link", "c");
+
+  auto m2 = addChild(world, "model", "m2");
+  auto isStatic = addChild(m2, "static");
+  isStatic->AddValue("bool", "false", false);
+  isStatic->GetValue()->SetFromString("true");
+  addChild(m2, "link", "d");
+
+  return root;
+}
+
+/////////////////////////////////////////////////
+std::string nameOf(const sdf::ElementPtr &_elem)
+{
+  return _elem ? _elem->GetAttribute("name")->GetAsString() : "";
+}
+
+/////////////////////////////////////////////////
+TEST(ElementPath, Compile)
+{
+  sdf::ElementPath empty;
+  EXPECT_FALSE(empty.Valid());
+  EXPECT_TRUE(empty.Str().empty());
+
+  sdf::ElementPath path("world/model[@name='m1']/link[2]");
+  EXPECT_TRUE(path.Valid());
+  EXPECT_EQ("world/model[@name='m1']/link[2]", path.Str());
+
+  for (const std::string bad : {"", "/world", "world/", "world[",
+        "world[0]", "world[@]", "world[@name=m1]", "world//", "a b"})
+  {
+    sdf::ElementPath badPath;
+    sdf::Errors errors = badPath.Compile(bad);
+    ASSERT_EQ(1u, errors.size()) << bad;
+    EXPECT_EQ(sdf::ErrorCode::ELEMENT_PATH_INVALID, errors[0].Code()) << bad;
+    EXPECT_FALSE(badPath.Valid()) << bad;
+  }
+
+  // Brackets inside quoted values are part of the value.
+  EXPECT_TRUE(sdf::ElementPath("model[@name='a]b']").Valid());
+
+  // Copy and move keep the compiled steps.
+  sdf::ElementPath copy(path);
+  EXPECT_TRUE(copy.Valid());
+  sdf::ElementPath moved(std::move(copy));
+  EXPECT_TRUE(moved.Valid());
+  EXPECT_EQ(path.Str(), moved.Str());
+}
+
+/////////////////////////////////////////////////
+TEST(ElementPath, ChildSteps)
+{
+  sdf::ElementPtr root = buildTree();
+
+  EXPECT_EQ("w", nameOf(root->Select(sdf::ElementPath("world"))));
+  EXPECT_EQ("m1", nameOf(root->Select(sdf::ElementPath("world/model"))));
+  EXPECT_EQ("m2",
+      nameOf(root->Select(sdf::ElementPath("world/model[@name='m2']"))));
+  EXPECT_EQ("b", nameOf(root->Select(sdf::ElementPath(
+      "world/model[@name='m1']/link[2]"))));
+  EXPECT_EQ("s1", nameOf(root->Select(sdf::ElementPath(
+      "world/model/link/sensor[@type='camera']"))));
+  EXPECT_EQ("m2", nameOf(root->Select(sdf::ElementPath(
+      "world/model[static='true']"))));
+  EXPECT_EQ("m2", nameOf(root->Select(sdf::ElementPath(
+      "world/model[static='1']"))));
+  EXPECT_EQ(nullptr, root->Select(sdf::ElementPath(
+      "world/model[static='1 1']")));
+  EXPECT_EQ(nullptr, root->Select(sdf::ElementPath("world/light")));
+  EXPECT_EQ(nullptr, root->Select(sdf::ElementPath("world/model[9]")));
+  EXPECT_EQ(nullptr, root->Select(sdf::ElementPath()));
+
+  // The first match is found even when it is not under the first candidate.
+  EXPECT_EQ("d", nameOf(root->Select(sdf::ElementPath(
+      "world/model[static='true']/link"))));
+
+  auto links = root->SelectAll(sdf::ElementPath("world/model/link"));
+  ASSERT_EQ(3u, links.size());
+  EXPECT_EQ("a", nameOf(links[0]));
+  EXPECT_EQ("b", nameOf(links[1]));
+  EXPECT_EQ("d", nameOf(links[2]));
+
+  // Positions apply per context element.
+  auto firstLinks = root->SelectAll(sdf::ElementPath("world/model/link[1]"));
+  ASSERT_EQ(2u, firstLinks.size());
+  EXPECT_EQ("a", nameOf(firstLinks[0]));
+  EXPECT_EQ("d", nameOf(firstLinks[1]));
+
+  auto any = root->SelectAll(sdf::ElementPath("world/model[@name='m1']/*"));
+  EXPECT_EQ(3u, any.size());
+
+  auto named = root->SelectAll(sdf::ElementPath("world/*[@name]"));
+  EXPECT_EQ(2u, named.size());
+}
+
+/////////////////////////////////////////////////
+TEST(ElementPath, DescendantSteps)
+{
+  sdf::ElementPtr root = buildTree();
+
+  auto links = root->SelectAll(sdf::ElementPath("//link"));
+  ASSERT_EQ(4u, links.size());
+  EXPECT_EQ("a", nameOf(links[0]));
+  EXPECT_EQ("b", nameOf(links[1]));
+  EXPECT_EQ("c", nameOf(links[2]));
+  EXPECT_EQ("d", nameOf(links[3]));
+
+  // Nested models reach the same links twice; results are unique and in
+  // document order.
+  auto modelLinks = root->SelectAll(sdf::ElementPath("//model//link"));
+  ASSERT_EQ(4u, modelLinks.size());
+  EXPECT_EQ("a", nameOf(modelLinks[0]));
+  EXPECT_EQ("c", nameOf(modelLinks[2]));
+
+  // A child step after a descendant step stays in document order.
+  auto childLinks = root->SelectAll(sdf::ElementPath("//model/link"));
+  ASSERT_EQ(4u, childLinks.size());
+  EXPECT_EQ("b", nameOf(childLinks[1]));
+  EXPECT_EQ("c", nameOf(childLinks[2]));
+
+  EXPECT_EQ("c", nameOf(root->Select(sdf::ElementPath(
+      "world//model[@name='nested']/link"))));
+  EXPECT_EQ("s2", nameOf(root->Select(sdf::ElementPath(
+      "//sensor[@type='imu']"))));
+}
+
+/////////////////////////////////////////////////
+TEST(ElementPath, NestedContexts)
+{
+  // <model name="outer">
+  //   <model name="inner"><link name="x"/></model>
+  //   <link name="y" mass="2"/>
+  // </model>
+  sdf::ElementPtr root = std::make_shared<sdf::Element>();
+  root->SetName("sdf");
+  auto outer = addChild(root, "model", "outer");
+  auto inner = addChild(outer, "model", "inner");
+  addChild(inner, "link", "x");
+  auto y = addChild(outer, "link", "y");
+  y->AddAttribute("mass", "double", "0", false);
+  y->GetAttribute("mass")->SetFromString("2");
+
+  // The links of the inner model come before the later links of the outer
+  // one.
+  auto links = root->SelectAll(sdf::ElementPath("//model/link"));
+  ASSERT_EQ(2u, links.size());
+  EXPECT_EQ("x", nameOf(links[0]));
+  EXPECT_EQ("y", nameOf(links[1]));
+
+  // Positions apply per context, and the candidates of both models are
+  // merged without duplicates.
+  auto first = root->SelectAll(sdf::ElementPath("//model//link[1]"));
+  ASSERT_EQ(1u, first.size());
+  EXPECT_EQ("x", nameOf(first[0]));
+  auto second = root->SelectAll(sdf::ElementPath("//model//link[2]"));
+  ASSERT_EQ(1u, second.size());
+  EXPECT_EQ("y", nameOf(second[0]));
+
+  // Numbers are compared by value.
+  EXPECT_EQ("y", nameOf(root->Select(sdf::ElementPath(
+      "//link[@mass='2.0']"))));
+  EXPECT_EQ(nullptr, root->Select(sdf::ElementPath("//link[@mass='2.5']")));
+}
+
+/////////////////////////////////////////////////
+TEST(ElementPath, IndexedChildren)
+{
+  sdf::ElementPtr root = std::make_shared<sdf::Element>();
+  root->SetName("model");
+  for (int i = 0; i < 64; ++i)
+  {
+    addChild(root, i % 2 ? "link" : "joint", "e" + std::to_string(i));
+  }
+
+  sdf::ElementPath path("link[@name='e33']");
+  EXPECT_EQ("e33", nameOf(root->Select(path)));
+  EXPECT_EQ(32u, root->SelectAll(sdf::ElementPath("link")).size());
+
+  // The index follows changes to the children.
+  auto removed = root->Select(path);
+  root->RemoveChild(removed);
+  EXPECT_EQ(nullptr, root->Select(path));
+  EXPECT_EQ(31u, root->SelectAll(sdf::ElementPath("link")).size());
+
+  addChild(root, "link", "e33");
+  EXPECT_EQ("e33", nameOf(root->Select(path)));
+
+  auto renamed = root->Select(sdf::ElementPath("joint[1]"));
+  renamed->SetName("link");
+  EXPECT_EQ(33u, root->SelectAll(sdf::ElementPath("link")).size());
+  EXPECT_EQ(31u, root->SelectAll(sdf::ElementPath("joint")).size());
+
+  root->ClearElements();
+  EXPECT_TRUE(root->SelectAll(sdf::ElementPath("link")).empty());
+}
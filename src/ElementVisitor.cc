@@ -0,0 +1,289 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "sdf/Element.hh"
+#include "sdf/ElementVisitor.hh"
+
+using namespace sdf;
+
+/// \brief An element and its depth in the traversal.
+using VisitEntry = std::pair<ElementPtr, std::size_t>;
+
+/// \brief Private data for ElementVisitor.
+class sdf::ElementVisitorPrivate
+{
+  /// \brief Pre-visit hook.
+  public: ElementPreVisit pre;
+
+  /// \brief Post-visit hook.
+  public: ElementPostVisit post;
+
+  /// \brief Selects the subtrees visited concurrently.
+  public: ElementSubtreeFilter independent;
+
+  /// \brief Maximum number of threads, 0 for the hardware concurrency.
+  public: unsigned int threads = 0;
+};
+
+/// \brief State shared by the walks of one traversal.
+struct ElementVisitor::WalkState
+{
+  /// \brief Set when a pre-visit hook returns TraversalAction::STOP.
+  std::atomic<bool> *stop = nullptr;
+
+  /// \brief If not null, independent subtrees are appended here instead of
+  /// being visited.
+  std::vector<VisitEntry> *deferred = nullptr;
+
+  /// \brief If not null, post-visits are appended here instead of being
+  /// called.
+  std::vector<VisitEntry> *posts = nullptr;
+};
+
+/////////////////////////////////////////////////
+ElementVisitor::ElementVisitor()
+  : dataPtr(std::make_unique<ElementVisitorPrivate>())
+{
+}
+
+/////////////////////////////////////////////////
+ElementVisitor::ElementVisitor(const ElementVisitor &_visitor)
+  : dataPtr(std::make_unique<ElementVisitorPrivate>(*_visitor.dataPtr))
+{
+}
+
+/////////////////////////////////////////////////
+ElementVisitor::ElementVisitor(ElementVisitor &&_visitor) noexcept = default;
+
+/////////////////////////////////////////////////
+ElementVisitor &ElementVisitor::operator=(const ElementVisitor &_visitor)
+{
+  return *this = ElementVisitor(_visitor);
+}
+
+/////////////////////////////////////////////////
+ElementVisitor &ElementVisitor::operator=(ElementVisitor &&_visitor) noexcept
+  = default;
+
+/////////////////////////////////////////////////
+ElementVisitor::~ElementVisitor() = default;
+
+/////////////////////////////////////////////////
+void ElementVisitor::SetPreVisit(const ElementPreVisit &_pre)
+{
+  this->dataPtr->pre = _pre;
+}
+
+/////////////////////////////////////////////////
+void ElementVisitor::SetPostVisit(const ElementPostVisit &_post)
+{
+  this->dataPtr->post = _post;
+}
+
+/////////////////////////////////////////////////
+void ElementVisitor::SetIndependentSubtrees(
+    const ElementSubtreeFilter &_filter, unsigned int _threads)
+{
+  this->dataPtr->independent = _filter;
+  this->dataPtr->threads = _threads;
+}
+
+/////////////////////////////////////////////////
+bool ElementVisitor::Visit(const ElementPtr &_elem) const
+{
+  if (!_elem)
+    return true;
+  return this->Run({_elem}, 0);
+}
+
+/////////////////////////////////////////////////
+bool ElementVisitor::VisitChildren(const Element &_elem) const
+{
+  return this->Run(_elem.dataPtr->elements, 1);
+}
+
+/////////////////////////////////////////////////
+bool ElementVisitor::Run(const ElementPtr_V &_roots, std::size_t _depth) const
+{
+  std::atomic<bool> stop(false);
+  WalkState state;
+  state.stop = &stop;
+
+  if (!this->dataPtr->independent)
+  {
+    // Index based so that hooks may append to the list of roots.
+    for (std::size_t i = 0; i < _roots.size(); ++i)
+    {
+      ElementPtr root = _roots[i];
+      if (!this->Walk(root, _depth, state))
+        return false;
+    }
+    return true;
+  }
+
+  std::vector<VisitEntry> deferred;
+  std::vector<VisitEntry> posts;
+  state.deferred = &deferred;
+  state.posts = &posts;
+  for (std::size_t i = 0; i < _roots.size(); ++i)
+  {
+    ElementPtr root = _roots[i];
+    if (!this->Walk(root, _depth, state))
+      return false;
+  }
+
+  unsigned int threads = this->dataPtr->threads;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned int>(
+      std::min<std::size_t>(threads, deferred.size()));
+
+  std::atomic<std::size_t> next(0);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto work = [&]()
+  {
+    WalkState taskState;
+    taskState.stop = &stop;
+    for (std::size_t i = next++; i < deferred.size() && !stop; i = next++)
+    {
+      try
+      {
+        this->Walk(deferred[i].first, deferred[i].second, taskState);
+      }
+      catch(...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+          error = std::current_exception();
+        stop = true;
+      }
+    }
+  };
+
+  if (threads <= 1)
+  {
+    work();
+  }
+  else
+  {
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned int t = 1; t < threads; ++t)
+      workers.emplace_back(work);
+    work();
+    for (std::thread &worker : workers)
+      worker.join();
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+  if (stop)
+    return false;
+
+  // The post-visits recorded above are already in post-order.
+  if (this->dataPtr->post)
+  {
+    for (const VisitEntry &entry : posts)
+      this->dataPtr->post(entry.first, entry.second);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool ElementVisitor::Walk(const ElementPtr &_root, std::size_t _depth,
+    WalkState &_state) const
+{
+  /// \brief An element whose children are being visited.
+  struct Frame
+  {
+    ElementPtr elem;
+    std::size_t depth;
+    std::size_t next;
+  };
+  std::vector<Frame> stack;
+
+  const ElementVisitorPrivate &data = *this->dataPtr;
+
+  auto leave = [&](const ElementPtr &_elem, std::size_t _elemDepth)
+  {
+    if (_state.posts)
+      _state.posts->emplace_back(_elem, _elemDepth);
+    else if (data.post)
+      data.post(_elem, _elemDepth);
+  };
+
+  // Returns false if the traversal must stop.
+  auto enter = [&](const ElementPtr &_elem, std::size_t _elemDepth)
+  {
+    if (_state.deferred && _elemDepth > 0 &&
+        data.independent(_elem, _elemDepth))
+    {
+      _state.deferred->emplace_back(_elem, _elemDepth);
+      return true;
+    }
+
+    const TraversalAction action = data.pre ?
+        data.pre(_elem, _elemDepth) : TraversalAction::CONTINUE;
+    if (action == TraversalAction::STOP)
+    {
+      *_state.stop = true;
+      return false;
+    }
+    if (action == TraversalAction::SKIP_CHILDREN)
+      leave(_elem, _elemDepth);
+    else
+      stack.push_back({_elem, _elemDepth, 0});
+    return true;
+  };
+
+  if (!_root || !enter(_root, _depth))
+    return !*_state.stop;
+
+  while (!stack.empty())
+  {
+    if (*_state.stop)
+      return false;
+
+    // The children are read through the frame on every iteration, since
+    // hooks may add or remove children of elements that were entered.
+    Frame &frame = stack.back();
+    const ElementPtr_V &children = frame.elem->dataPtr->elements;
+    if (frame.next < children.size())
+    {
+      ElementPtr child = children[frame.next++];
+      if (child && !enter(child, frame.depth + 1))
+        return false;
+    }
+    else
+    {
+      Frame done = std::move(frame);
+      stack.pop_back();
+      leave(done.elem, done.depth);
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "sdf/Element.hh"
+#include "sdf/ElementVisitor.hh"
+
+/////////////////////////////////////////////////
+/// \brief Add a child element.
+sdf::ElementPtr addChild(sdf::ElementPtr _parent, const std::string &_tag)
+{
+  sdf::ElementPtr child = std::make_shared<sdf::Element>();
+  child->SetName(_tag);
+  child->SetParent(_parent);
+  _parent->InsertElement(child);
+  return child;
+}
+
+/////////////////////////////////////////////////
+/// \brief Build <a><b><c/><d/></b><e/></a>
+sdf::ElementPtr buildTree()
+{
+  sdf::ElementPtr a = std::make_shared<sdf::Element>();
+  a->SetName("a");
+  auto b = addChild(a, "b");
+  addChild(b, "c");
+  addChild(b, "d");
+  addChild(a, "e");
+  return a;
+}
+
+/////////////////////////////////////////////////
+TEST(ElementVisitor, Order)
+{
+  sdf::ElementPtr root = buildTree();
+
+  std::string order;
+  sdf::ElementVisitor visitor;
+  visitor.SetPreVisit([&order](const sdf::ElementPtr &_elem, std::size_t _d)
+  {
+    order += "+" + _elem->GetName() + std::to_string(_d);
+    return sdf::TraversalAction::CONTINUE;
+  });
+  visitor.SetPostVisit([&order](const sdf::ElementPtr &_elem, std::size_t)
+  {
+    order += "-" + _elem->GetName();
+  });
+
+  EXPECT_TRUE(visitor.Visit(root));
+  EXPECT_EQ("+a0+b1+c2-c+d2-d-b+e1-e-a", order);
+
+  order.clear();
+  EXPECT_TRUE(visitor.VisitChildren(*root));
+  EXPECT_EQ("+b1+c2-c+d2-d-b+e1-e", order);
+
+  // Copies keep the hooks.
+  order.clear();
+  sdf::ElementVisitor copy(visitor);
+  EXPECT_TRUE(copy.Visit(root->GetFirstElement()));
+  EXPECT_EQ("+b0+c1-c+d1-d-b", order);
+
+  // No hooks.
+  EXPECT_TRUE(sdf::ElementVisitor().Visit(root));
+  EXPECT_TRUE(sdf::ElementVisitor().Visit(nullptr));
+}
+
+/////////////////////////////////////////////////
+TEST(ElementVisitor, SkipAndStop)
+{
+  sdf::ElementPtr root = buildTree();
+
+  std::string order;
+  sdf::ElementVisitor visitor;
+  visitor.SetPreVisit([&order](const sdf::ElementPtr &_elem, std::size_t)
+  {
+    order += "+" + _elem->GetName();
+    return _elem->GetName() == "b" ? sdf::TraversalAction::SKIP_CHILDREN :
+        sdf::TraversalAction::CONTINUE;
+  });
+  visitor.SetPostVisit([&order](const sdf::ElementPtr &_elem, std::size_t)
+  {
+    order += "-" + _elem->GetName();
+  });
+  EXPECT_TRUE(visitor.Visit(root));
+  EXPECT_EQ("+a+b-b+e-e-a", order);
+
+  order.clear();
+  visitor.SetPreVisit([&order](const sdf::ElementPtr &_elem, std::size_t)
+  {
+    order += "+" + _elem->GetName();
+    return _elem->GetName() == "d" ? sdf::TraversalAction::STOP :
+        sdf::TraversalAction::CONTINUE;
+  });
+  EXPECT_FALSE(visitor.Visit(root));
+  EXPECT_EQ("+a+b+c-c+d", order);
+}
+
+/////////////////////////////////////////////////
+TEST(ElementVisitor, Deep)
+{
+  // Deep enough to overflow the native stack with one frame per level.
+  const std::size_t depth = 200000;
+  sdf::ElementPtr root = std::make_shared<sdf::Element>();
+  root->SetName("model");
+  sdf::ElementPtr leaf = root;
+  for (std::size_t i = 0; i < depth; ++i)
+    leaf = addChild(leaf, "model");
+
+  std::size_t maxDepth = 0;
+  std::size_t count = 0;
+  sdf::ElementVisitor visitor;
+  visitor.SetPreVisit([&](const sdf::ElementPtr &, std::size_t _depth)
+  {
+    maxDepth = std::max(maxDepth, _depth);
+    ++count;
+    return sdf::TraversalAction::CONTINUE;
+  });
+  EXPECT_TRUE(visitor.Visit(root));
+  EXPECT_EQ(depth, maxDepth);
+  EXPECT_EQ(depth + 1, count);
+
+  // Reset the tree without recursion, which also avoids a recursive
+  // destruction of the shared pointers.
+  root->Reset();
+  EXPECT_EQ(nullptr, root->GetFirstElement());
+}
+
+/////////////////////////////////////////////////
+TEST(ElementVisitor, IndependentSubtrees)
+{
+  sdf::ElementPtr world = std::make_shared<sdf::Element>();
+  world->SetName("world");
+  addChild(world, "gravity");
+  for (int m = 0; m < 16; ++m)
+  {
+    auto model = addChild(world, "model");
+    for (int l = 0; l < 10; ++l)
+      addChild(addChild(model, "link"), "visual");
+  }
+
+  std::mutex mutex;
+  std::vector<std::string> pres;
+  std::vector<std::string> posts;
+  std::atomic<int> visuals(0);
+
+  sdf::ElementVisitor visitor;
+  visitor.SetPreVisit([&](const sdf::ElementPtr &_elem, std::size_t)
+  {
+    if (_elem->GetName() == "visual")
+      ++visuals;
+    std::lock_guard<std::mutex> lock(mutex);
+    pres.push_back(_elem->GetName());
+    return sdf::TraversalAction::CONTINUE;
+  });
+  visitor.SetPostVisit([&](const sdf::ElementPtr &_elem, std::size_t)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    posts.push_back(_elem->GetName());
+  });
+  visitor.SetIndependentSubtrees(
+      [](const sdf::ElementPtr &_elem, std::size_t _depth)
+      {
+        return _depth == 1 && _elem->GetName() == "model";
+      }, 4);
+
+  EXPECT_TRUE(visitor.Visit(world));
+  EXPECT_EQ(16 * 10, visuals);
+  EXPECT_EQ(1u + 1u + 16u * 21u, pres.size());
+  EXPECT_EQ(pres.size(), posts.size());
+
+  // Elements outside the independent subtrees are entered first, and the
+  // root is left last.
+  EXPECT_EQ("world", pres[0]);
+  EXPECT_EQ("gravity", pres[1]);
+  EXPECT_EQ("world", posts.back());
+
+  // Stopping from a task stops the traversal.
+  visitor.SetPreVisit([](const sdf::ElementPtr &_elem, std::size_t)
+  {
+    return _elem->GetName() == "visual" ? sdf::TraversalAction::STOP :
+        sdf::TraversalAction::CONTINUE;
+  });
+  EXPECT_FALSE(visitor.Visit(world));
+}
+
+/////////////////////////////////////////////////
+TEST(ElementVisitor, ToString)
+{
+  sdf::ElementPtr root = buildTree();
+  root->GetFirstElement()->GetFirstElement()->AddValue("string", "", false);
+  root->GetFirstElement()->GetFirstElement()->GetValue()->SetFromString("x");
+
+  sdf::ElementPtr include = addChild(root, "model");
+  include->SetInclude("model://box");
+  addChild(include, "ignored");
+
+  EXPECT_EQ(
+      "<a>\n"
+      "  <b>\n"
+      "    <c>x</c>\n"
+      "    <d/>\n"
+      "  </b>\n"
+      "  <e/>\n"
+      "  <include filename='model://box'/>\n"
+      "</a>\n", root->ToString(""));
+}
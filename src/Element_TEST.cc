@@ -718,6 +718,155 @@ TEST(Element, CountNamedElements)
   EXPECT_EQ(allMap.at("child3"), 1u);
 }
 
+/////////////////////////////////////////////////
+/// \brief Build <visual><material><ambient>_color</ambient></material>
+/// <geometry><box/></geometry></visual>
+sdf::ElementPtr makeVisual(const std::string &_color)
+{
+  auto add = [](sdf::ElementPtr _parent, const std::string &_name)
+  {
+    sdf::ElementPtr child(new sdf::Element);
+    child->SetName(_name);
+    child->SetParent(_parent);
+    _parent->InsertElement(child);
+    return child;
+  };
+
+  sdf::ElementPtr visual(new sdf::Element);
+  visual->SetName("visual");
+  auto material = add(visual, "material");
+  auto ambient = add(material, "ambient");
+  ambient->AddValue("string", "", false);
+  ambient->GetValue()->SetFromString(_color);
+  add(add(visual, "geometry"), "box");
+  return visual;
+}
+
+/////////////////////////////////////////////////
+TEST(Element, Hash)
+{
+  sdf::ElementPtr a = makeVisual("1 0 0 1");
+  sdf::ElementPtr b = makeVisual("1 0 0 1");
+  sdf::ElementPtr c = makeVisual("0 1 0 1");
+
+  EXPECT_EQ(a->Hash(), b->Hash());
+  EXPECT_NE(a->Hash(), c->Hash());
+  EXPECT_EQ(a->Hash(), a->Clone()->Hash());
+
+  // Changing a parameter value deep in the tree changes the hash.
+  const std::size_t hash = a->Hash();
+  auto ambient = a->GetElement("material")->GetElement("ambient");
+  ambient->GetValue()->SetFromString("0 1 0 1");
+  EXPECT_EQ(c->Hash(), a->Hash());
+  ambient->GetValue()->SetFromString("1 0 0 1");
+  EXPECT_EQ(hash, a->Hash());
+
+  // Structural changes invalidate the hash too.
+  a->GetElement("geometry")->GetFirstElement()->SetName("sphere");
+  EXPECT_NE(hash, a->Hash());
+  a->GetElement("geometry")->GetFirstElement()->SetName("box");
+  EXPECT_EQ(hash, a->Hash());
+
+  a->AddAttribute("name", "string", "", false);
+  EXPECT_NE(hash, a->Hash());
+  a->GetAttribute("name")->SetFromString("v");
+  const std::size_t named = a->Hash();
+  a->GetAttribute("name")->SetFromString("w");
+  EXPECT_NE(named, a->Hash());
+
+  auto material = a->GetElement("material");
+  a->RemoveChild(material);
+  EXPECT_NE(named, a->Hash());
+}
+
+/////////////////////////////////////////////////
+TEST(Element, DeduplicateSubtrees)
+{
+  sdf::ElementPtr link(new sdf::Element);
+  link->SetName("link");
+  for (int i = 0; i < 6; ++i)
+  {
+    sdf::ElementPtr visual = makeVisual(i < 4 ? "1 0 0 1" : "0 0 1 1");
+    visual->SetParent(link);
+    link->InsertElement(visual);
+  }
+  const std::size_t hash = link->Hash();
+  const std::string str = link->ToString("");
+
+  // Visuals 1-3 share visual 0, and visual 5 shares visual 4.
+  EXPECT_EQ(4u, link->DeduplicateSubtrees({"visual", "material"}));
+  EXPECT_EQ(hash, link->Hash());
+  EXPECT_EQ(str, link->ToString(""));
+
+  sdf::ElementPtr first = link->GetFirstElement();
+  sdf::ElementPtr second = first->GetNextElement();
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(link, first->GetParent());
+
+  // Running it again finds nothing new.
+  EXPECT_EQ(0u, link->DeduplicateSubtrees({"visual", "material"}));
+
+  // Only elements with the given names are shared.
+  sdf::ElementPtr model(new sdf::Element);
+  model->SetName("model");
+  for (int i = 0; i < 2; ++i)
+  {
+    sdf::ElementPtr visual = makeVisual("1 0 0 1");
+    visual->GetElement("geometry")->GetFirstElement()->SetName(
+        i == 0 ? "box" : "sphere");
+    visual->SetParent(model);
+    model->InsertElement(visual);
+  }
+  EXPECT_EQ(0u, model->DeduplicateSubtrees({"visual"}));
+  EXPECT_EQ(1u, model->DeduplicateSubtrees({"material"}));
+}
+
+/////////////////////////////////////////////////
+TEST(Element, MemoryUsage)
+{
+  sdf::ElementPtr link(new sdf::Element);
+  link->SetName("link");
+  link->AddAttribute("name", "string", "link", true);
+  link->SetDescription(std::string(100, 'd'));
+
+  sdf::MemoryBreakdown empty = link->MemoryUsage();
+  EXPECT_EQ(1u, empty.elementCount);
+  EXPECT_EQ(1u, empty.paramCount);
+  EXPECT_GT(empty.descriptionBytes, 100u);
+  EXPECT_GT(empty.domBytes, 0u);
+
+  // Element descriptions are counted as description bytes only.
+  sdf::ElementPtr visualDesc(new sdf::Element);
+  visualDesc->SetName("visual");
+  visualDesc->AddAttribute("name", "string", "__default__", true);
+  link->AddElementDescription(visualDesc);
+
+  sdf::MemoryBreakdown withSchema = link->MemoryUsage();
+  EXPECT_EQ(1u, withSchema.elementCount);
+  EXPECT_EQ(1u, withSchema.paramCount);
+  EXPECT_GT(withSchema.descriptionBytes, empty.descriptionBytes);
+
+  // Each added child is a clone of its description.
+  link->AddElement("visual");
+  sdf::MemoryBreakdown oneChild = link->MemoryUsage();
+  EXPECT_EQ(2u, oneChild.elementCount);
+  EXPECT_EQ(2u, oneChild.paramCount);
+  EXPECT_GT(oneChild.domBytes, withSchema.domBytes);
+
+  link->AddElement("visual");
+  sdf::MemoryBreakdown twoChildren = link->MemoryUsage();
+  EXPECT_EQ(3u, twoChildren.elementCount);
+
+  // Shared subtrees are counted once.
+  EXPECT_EQ(1u, link->DeduplicateSubtrees({"visual"}));
+  sdf::MemoryBreakdown shared = link->MemoryUsage();
+  EXPECT_EQ(2u, shared.elementCount);
+  EXPECT_LT(shared.TotalBytes(), twoChildren.TotalBytes());
+
+  // A clone copies the shared subtree again.
+  EXPECT_EQ(3u, link->Clone()->MemoryUsage().elementCount);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
@@ -15,7 +15,13 @@
  *
 */
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -29,12 +35,205 @@
 #include "sdf/World.hh"
 
 #include "FrameSemantics.hh"
+#include "FrozenGraph.hh"
+#include "PoseBatch.hh"
 #include "ScopedGraph.hh"
+#include "Utils.hh"
 
 namespace sdf
 {
 inline namespace SDF_VERSION_NAMESPACE {
 
+/////////////////////////////////////////////////
+std::size_t ScopedName::Hash::operator()(const ScopedName &_name) const
+{
+  // Hash the full name 8 bytes at a time. The bytes are gathered across the
+  // parts of the name, so a lookup key and the full name hash the same way
+  // wherever the name is split.
+  std::uint64_t hash = 0;
+  std::size_t length = 0;
+  auto mix = [&hash](std::uint64_t _word)
+  {
+    hash ^= _word * 0xff51afd7ed558ccdULL;
+    hash = ((hash << 31) | (hash >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+  };
+
+  unsigned char buffer[8];
+  std::size_t filled = 0;
+  std::uint64_t word;
+  for (const auto part : _name.Parts())
+  {
+    const char *data = part.data();
+    std::size_t size = part.size();
+    length += size;
+    while (size > 0)
+    {
+      if (filled == 0 && size >= sizeof(word))
+      {
+        std::memcpy(&word, data, sizeof(word));
+        mix(word);
+        data += sizeof(word);
+        size -= sizeof(word);
+        continue;
+      }
+      const std::size_t count = std::min(sizeof(buffer) - filled, size);
+      std::memcpy(buffer + filled, data, count);
+      filled += count;
+      data += count;
+      size -= count;
+      if (filled == sizeof(buffer))
+      {
+        std::memcpy(&word, buffer, sizeof(word));
+        mix(word);
+        filled = 0;
+      }
+    }
+  }
+  std::memset(buffer + filled, 0, sizeof(buffer) - filled);
+  std::memcpy(&word, buffer, sizeof(word));
+  mix(word ^ length);
+
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return static_cast<std::size_t>(hash);
+}
+
+/////////////////////////////////////////////////
+ScopedName::ScopedName(std::string _name)
+  : name(std::move(_name))
+{
+}
+
+/////////////////////////////////////////////////
+ScopedName::ScopedName(std::string_view _prefix, std::string_view _localName)
+  : prefix(_prefix), localName(_localName)
+{
+}
+
+/////////////////////////////////////////////////
+const std::string &ScopedName::Name() const
+{
+  return this->name;
+}
+
+/////////////////////////////////////////////////
+std::array<std::string_view, 3> ScopedName::Parts() const
+{
+  if (this->prefix.empty())
+  {
+    return {this->name, this->localName, std::string_view()};
+  }
+  return {this->prefix, "::", this->localName};
+}
+
+/////////////////////////////////////////////////
+bool ScopedName::operator==(const ScopedName &_other) const
+{
+  const auto parts = this->Parts();
+  const auto otherParts = _other.Parts();
+
+  // Compare the parts piece by piece, as they may be split at different
+  // places in each name.
+  std::size_t i = 0;
+  std::size_t offset = 0;
+  std::size_t otherI = 0;
+  std::size_t otherOffset = 0;
+  while (true)
+  {
+    while (i < parts.size() && offset == parts[i].size())
+    {
+      ++i;
+      offset = 0;
+    }
+    while (otherI < otherParts.size() &&
+           otherOffset == otherParts[otherI].size())
+    {
+      ++otherI;
+      otherOffset = 0;
+    }
+    if (i == parts.size() || otherI == otherParts.size())
+    {
+      return i == parts.size() && otherI == otherParts.size();
+    }
+    const std::size_t length = std::min(parts[i].size() - offset,
+        otherParts[otherI].size() - otherOffset);
+    if (parts[i].compare(offset, length,
+          otherParts[otherI], otherOffset, length) != 0)
+    {
+      return false;
+    }
+    offset += length;
+    otherOffset += length;
+  }
+}
+
+/////////////////////////////////////////////////
+bool PoseRelativeToCache::Find(VertexId _scopeId, VertexId _vertexId,
+    ignition::math::Pose3d &_pose) const
+{
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  auto it = this->poses.find(_vertexId);
+  if (it == this->poses.end())
+  {
+    return false;
+  }
+  for (const auto &scopePose : it->second)
+  {
+    if (scopePose.first == _scopeId)
+    {
+      _pose = scopePose.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+void PoseRelativeToCache::Insert(VertexId _scopeId, VertexId _vertexId,
+    const ignition::math::Pose3d &_pose)
+{
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  auto &scopePoses = this->poses[_vertexId];
+  for (auto &scopePose : scopePoses)
+  {
+    if (scopePose.first == _scopeId)
+    {
+      scopePose.second = _pose;
+      return;
+    }
+  }
+  scopePoses.emplace_back(_scopeId, _pose);
+  ++this->count;
+}
+
+/////////////////////////////////////////////////
+void PoseRelativeToCache::Erase(VertexId _vertexId)
+{
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  auto it = this->poses.find(_vertexId);
+  if (it != this->poses.end())
+  {
+    this->count -= it->second.size();
+    this->poses.erase(it);
+  }
+}
+
+/////////////////////////////////////////////////
+void PoseRelativeToCache::Clear()
+{
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  this->poses.clear();
+  this->count = 0;
+}
+
+/////////////////////////////////////////////////
+std::size_t PoseRelativeToCache::Size() const
+{
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  return this->count;
+}
+
 // Helpful functions when debugging in gdb
 void printGraph(const ScopedGraph<PoseRelativeToGraph> &_graph)
 {
@@ -57,16 +256,21 @@ void printGraph(const ScopedGraph<FrameAttachedToGraph> &_graph)
 /// if a vertex with multiple incoming edges is found.
 /// Otherwise, this function returns the first source Vertex that is found.
 /// It also returns the sequence of edges leading to the source vertex.
+/// The traversal also stops early at any vertex for which _isKnown returns
+/// true, which lets callers reuse results already computed for that vertex.
 /// \param[in] _graph A directed graph.
 /// \param[in] _id VertexId of the starting vertex.
+/// \param[in] _isKnown Predicate that returns true for vertices at which
+/// the traversal can stop without reaching the scope vertex.
 /// \return A source vertex paired with a vector of the edges leading the
 /// source to the starting vertex, or a NullVertex paired with an empty
 /// vector if a cycle or vertex with multiple incoming edges are detected.
-template <typename T>
+template <typename T, typename Predicate>
 std::pair<const typename ScopedGraph<T>::Vertex &,
     std::vector<typename ScopedGraph<T>::Edge>>
 FindSourceVertex(const ScopedGraph<T> &_graph,
-    const ignition::math::graph::VertexId _id, Errors &_errors)
+    const ignition::math::graph::VertexId _id, Errors &_errors,
+    const Predicate &_isKnown)
 {
   using DirectedEdge = typename ScopedGraph<T>::Edge;
   using Vertex = typename ScopedGraph<T>::Vertex;
@@ -83,7 +287,7 @@ FindSourceVertex(const ScopedGraph<T> &_graph,
     return PairType(Vertex::NullVertex, EdgesType());
   }
 
-  if (_id == _graph.ScopeVertexId())
+  if (_id == _graph.ScopeVertexId() || _isKnown(_id))
   {
     // This is the source.
     return PairType(vertex, EdgesType());
@@ -112,7 +316,8 @@ FindSourceVertex(const ScopedGraph<T> &_graph,
           vertex.get().Name() + "]."});
       return PairType(Vertex::NullVertex, EdgesType());
     }
-    if (vertex.get().Id() == _graph.ScopeVertexId())
+    if (vertex.get().Id() == _graph.ScopeVertexId() ||
+        _isKnown(vertex.get().Id()))
     {
       // This is the source.
       break;
@@ -120,7 +325,8 @@ FindSourceVertex(const ScopedGraph<T> &_graph,
     visited.insert(vertex.get().Id());
     incidentsTo = _graph.Graph().IncidentsTo(vertex);
   }
-  if (vertex.get().Id() != _graph.ScopeVertexId())
+  if (vertex.get().Id() != _graph.ScopeVertexId() &&
+      !_isKnown(vertex.get().Id()))
   {
     // Error, the root vertex is not the same as the the source
     return PairType(Vertex::NullVertex, EdgesType());
@@ -492,6 +698,65 @@ Errors buildFrameAttachedToGraph(
   return errors;
 }
 
+/////////////////////////////////////////////////
+/// \brief Graph of a model of a world, built on its own.
+template <typename T>
+struct ModelSubgraph
+{
+  /// \brief Scope of the graph, which holds only the model.
+  ScopedGraph<T> graph;
+
+  /// \brief Errors from building the graph.
+  Errors errors;
+};
+
+/////////////////////////////////////////////////
+/// \brief Build a graph for each model of a world, on a pool of threads
+/// of up to World::LoadThreads threads. Models are independent of each
+/// other until they are added to the world scope, so each one is built in
+/// a graph of its own, which ScopedGraph::AddGraph then adds to the world
+/// graph. Models whose name is already used in the world scope, or by an
+/// earlier model, are not built, since they are not added.
+/// \param[in] _out World scope of the graph the models are added to.
+/// \param[in] _world World whose models are built.
+/// \param[in] _build Function that builds the graph of a nested model.
+/// \return The graph of each model, by model index, or nothing if the
+/// world loads on one thread or has less than two models, in which case the
+/// models are better built in place. Models that are not added have no
+/// graph.
+template <typename T>
+static std::vector<ModelSubgraph<T>> buildModelSubgraphs(
+    const ScopedGraph<T> &_out, const World *_world,
+    Errors (*_build)(ScopedGraph<T> &, const Model *, bool))
+{
+  std::vector<ModelSubgraph<T>> subgraphs;
+  if (_world->LoadThreads() == 1 || _world->ModelCount() < 2)
+  {
+    return subgraphs;
+  }
+
+  std::vector<std::size_t> added;
+  std::unordered_set<std::string> names;
+  for (std::size_t m = 0; m < _world->ModelCount(); ++m)
+  {
+    const std::string &name = _world->ModelByIndex(m)->Name();
+    if (_out.Count(name) == 0 && names.insert(name).second)
+    {
+      added.push_back(m);
+    }
+  }
+
+  subgraphs.resize(_world->ModelCount());
+  parallelFor(added.size(), _world->LoadThreads(), [&](std::size_t _i)
+  {
+    auto &subgraph = subgraphs[added[_i]];
+    subgraph.graph = ScopedGraph<T>(std::make_shared<T>());
+    subgraph.errors =
+        _build(subgraph.graph, _world->ModelByIndex(added[_i]), false);
+  });
+  return subgraphs;
+}
+
 /////////////////////////////////////////////////
 Errors buildFrameAttachedToGraph(
             ScopedGraph<FrameAttachedToGraph> &_out, const World *_world)
@@ -516,7 +781,9 @@ Errors buildFrameAttachedToGraph(
   _out = _out.AddScopeVertex(
       "", scopeContextName, scopeContextName, sdf::FrameType::WORLD);
 
-  // add model vertices
+  // add model vertices, from graphs built in parallel if possible
+  auto subgraphs = buildModelSubgraphs<FrameAttachedToGraph>(
+      _out, _world, buildFrameAttachedToGraph);
   for (uint64_t m = 0; m < _world->ModelCount(); ++m)
   {
     auto model = _world->ModelByIndex(m);
@@ -528,7 +795,14 @@ Errors buildFrameAttachedToGraph(
           "]."});
       continue;
     }
-    auto modelErrors = buildFrameAttachedToGraph(_out, model, false);
+    if (subgraphs.empty())
+    {
+      auto modelErrors = buildFrameAttachedToGraph(_out, model, false);
+      errors.insert(errors.end(), modelErrors.begin(), modelErrors.end());
+      continue;
+    }
+    _out.AddGraph(subgraphs[m].graph);
+    const auto &modelErrors = subgraphs[m].errors;
     errors.insert(errors.end(), modelErrors.begin(), modelErrors.end());
   }
 
@@ -921,7 +1195,9 @@ Errors buildPoseRelativeToGraph(
   auto worldFrameId = _out.ScopeVertexId();
 
   _out.AddEdge({rootId, worldFrameId}, {});
-  // add model vertices and default edge if relative_to is empty
+  // add model vertices, from graphs built in parallel if possible
+  auto subgraphs = buildModelSubgraphs<PoseRelativeToGraph>(
+      _out, _world, buildPoseRelativeToGraph);
   for (uint64_t m = 0; m < _world->ModelCount(); ++m)
   {
     auto model = _world->ModelByIndex(m);
@@ -934,8 +1210,15 @@ Errors buildPoseRelativeToGraph(
       continue;
     }
 
-    auto modelErrors = buildPoseRelativeToGraph(_out , model, false);
-    errors.insert(errors.end(), modelErrors .begin(), modelErrors .end());
+    if (subgraphs.empty())
+    {
+      auto modelErrors = buildPoseRelativeToGraph(_out, model, false);
+      errors.insert(errors.end(), modelErrors.begin(), modelErrors.end());
+      continue;
+    }
+    _out.AddGraph(subgraphs[m].graph);
+    const auto &modelErrors = subgraphs[m].errors;
+    errors.insert(errors.end(), modelErrors.begin(), modelErrors.end());
   }
 
   // add frame vertices and default edge if both
@@ -1059,9 +1342,120 @@ Errors buildPoseRelativeToGraph(
   return errors;
 }
 
+/////////////////////////////////////////////////
+/// \brief Follow a path from each vertex of a frozen graph, visiting each
+/// vertex once. Vertices are colored as they are visited: a path that gets
+/// to a vertex of the current path has found a cycle, and a path that gets
+/// to a vertex of an earlier path ends where that path ends.
+/// \param[out] _out The end of the path of each vertex and the cycles.
+/// \param[in] _graph Frozen graph.
+/// \param[in] _next Function that returns the index of the next vertex of
+/// a path, or kNullIndex if the path stops at the given vertex.
+template <typename T, typename Next>
+static void findPathEnds(FramePathEnds &_out, const FrozenGraph<T> &_graph,
+    const Next &_next)
+{
+  const std::size_t kNullIndex = FrozenGraph<T>::kNullIndex;
+  const std::size_t count = _graph.VertexCount();
+  enum class PathState : unsigned char { UNVISITED, ON_PATH, DONE };
+  std::vector<PathState> states(count, PathState::UNVISITED);
+  _out.ends.assign(count, kNullIndex);
+  _out.cycles.clear();
+
+  std::vector<std::size_t> path;
+  for (std::size_t start = 0; start < count; ++start)
+  {
+    if (states[start] != PathState::UNVISITED)
+    {
+      continue;
+    }
+
+    path.clear();
+    std::size_t vertex = start;
+    std::size_t end = kNullIndex;
+    while (true)
+    {
+      if (states[vertex] == PathState::DONE)
+      {
+        end = _out.ends[vertex];
+        break;
+      }
+      if (states[vertex] == PathState::ON_PATH)
+      {
+        // The path came back to one of its vertices.
+        auto first = std::find(path.begin(), path.end(), vertex);
+        _out.cycles.emplace_back(first, path.end());
+        break;
+      }
+      states[vertex] = PathState::ON_PATH;
+      path.push_back(vertex);
+      const std::size_t next = _next(vertex);
+      if (next == kNullIndex)
+      {
+        end = vertex;
+        break;
+      }
+      vertex = next;
+    }
+
+    for (const std::size_t index : path)
+    {
+      states[index] = PathState::DONE;
+      _out.ends[index] = end;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void findSinkVertices(FramePathEnds &_out,
+    const FrozenGraph<FrameAttachedToGraph> &_graph)
+{
+  findPathEnds(_out, _graph, [&_graph](std::size_t _index)
+  {
+    const auto edges = _graph.OutEdges(_index);
+    return edges.size() == 1 ? edges.begin()->vertex :
+        FrozenGraph<FrameAttachedToGraph>::kNullIndex;
+  });
+}
+
+/////////////////////////////////////////////////
+void findSourceVertices(FramePathEnds &_out,
+    const FrozenGraph<PoseRelativeToGraph> &_graph)
+{
+  const std::size_t scopeIndex = _graph.ScopeIndex();
+  findPathEnds(_out, _graph, [&_graph, scopeIndex](std::size_t _index)
+  {
+    const auto edges = _graph.InEdges(_index);
+    return _index != scopeIndex && edges.size() == 1 ?
+        edges.begin()->vertex : FrozenGraph<PoseRelativeToGraph>::kNullIndex;
+  });
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether a vertex of a frozen FrameAttachedToGraph is a sink
+/// to which frames can be attached in the scope of the graph.
+/// \param[in] _graph Frozen graph.
+/// \param[in] _index Index of the vertex.
+/// \return True if the vertex is a valid sink.
+static bool isBodySink(const FrozenGraph<FrameAttachedToGraph> &_graph,
+    std::size_t _index)
+{
+  if (_index >= _graph.VertexCount() || !_graph.OutEdges(_index).empty())
+  {
+    return false;
+  }
+  const std::string &scopeContextName = _graph.Scope().ScopeContextName();
+  const FrameType type = _graph.Data(_index);
+  return (scopeContextName == "world" &&
+          (type == FrameType::WORLD || type == FrameType::STATIC_MODEL ||
+           type == FrameType::LINK)) ||
+         (scopeContextName == "__model__" &&
+          (type == FrameType::LINK || type == FrameType::STATIC_MODEL));
+}
+
 /////////////////////////////////////////////////
 Errors validateFrameAttachedToGraph(
-    const ScopedGraph<FrameAttachedToGraph> &_in)
+    const ScopedGraph<FrameAttachedToGraph> &_in, unsigned int _threads)
 {
   Errors errors;
 
@@ -1107,10 +1501,10 @@ Errors validateFrameAttachedToGraph(
   }
 
   // Check number of outgoing edges for each vertex
-  auto vertices = _in.Graph().Vertices();
-  for (auto vertexPair : vertices)
+  const FrozenGraph<FrameAttachedToGraph> frozen(_in);
+  for (std::size_t index = 0; index < frozen.VertexCount(); ++index)
   {
-    const std::string vertexName = _in.VertexLocalName(vertexPair.second.get());
+    const std::string &vertexName = frozen.LocalName(index);
     // Vertex names should not be empty
     if (vertexName.empty())
     {
@@ -1118,7 +1512,8 @@ Errors validateFrameAttachedToGraph(
           "FrameAttachedToGraph error, "
           "vertex with empty name detected."});
     }
-    auto outDegree = _in.Graph().OutDegree(vertexPair.first);
+    const auto outEdges = frozen.OutEdges(index);
+    auto outDegree = outEdges.size();
 
     if (outDegree > 1)
     {
@@ -1149,7 +1544,7 @@ Errors validateFrameAttachedToGraph(
     else if (sdf::FrameType::MODEL == scopeFrameType ||
         sdf::FrameType::STATIC_MODEL == scopeFrameType)
     {
-      switch (vertexPair.second.get().Data())
+      switch (frozen.Data(index))
       {
         case sdf::FrameType::WORLD:
           errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
@@ -1171,12 +1566,11 @@ Errors validateFrameAttachedToGraph(
         case sdf::FrameType::STATIC_MODEL:
           if (outDegree != 0)
           {
-            auto edges = _in.Graph().IncidentsFrom(vertexPair.first);
             // Filter out alias edges (edge with a weight of 0)
             auto outDegreeNoAliases = std::count_if(
-                edges.begin(), edges.end(), [](const auto &_edge)
+                outEdges.begin(), outEdges.end(), [](const auto &_edge)
                 {
-                  return _edge.second.get().Weight() >= 1.0;
+                  return _edge.weight >= 1.0;
                 });
             if (outDegreeNoAliases)
             {
@@ -1215,7 +1609,7 @@ Errors validateFrameAttachedToGraph(
     else
     {
       // scopeFrameType must be sdf::FrameType::WORLD
-      switch (vertexPair.second.get().Data())
+      switch (frozen.Data(index))
       {
         case sdf::FrameType::WORLD:
           if (outDegree != 0)
@@ -1240,12 +1634,11 @@ Errors validateFrameAttachedToGraph(
         case sdf::FrameType::STATIC_MODEL:
           if (outDegree != 0)
           {
-            auto edges = _in.Graph().IncidentsFrom(vertexPair.first);
             // Filter out alias edges (edge with a weight of 0)
             auto outDegreeNoAliases = std::count_if(
-                edges.begin(), edges.end(), [](const auto &_edge)
+                outEdges.begin(), outEdges.end(), [](const auto &_edge)
                 {
-                  return _edge.second.get().Weight() >= 1.0;
+                  return _edge.weight >= 1.0;
                 });
             if (outDegreeNoAliases)
             {
@@ -1274,11 +1667,28 @@ Errors validateFrameAttachedToGraph(
     }
   }
 
-  // check graph for cycles by finding sink from each vertex
-  for (auto const &name : _in.VertexNames())
+  // check graph for cycles by finding the sink of every vertex in one pass.
+  // Vertices without a valid sink are resolved on their own, on several
+  // threads, to report the errors of resolveFrameAttachedToBody in order.
+  FramePathEnds sinks;
+  findSinkVertices(sinks, frozen);
+  std::vector<std::size_t> invalid;
+  for (const auto index : frozen.ScopeIndices())
+  {
+    if (!isBodySink(frozen, sinks.ends[index]))
+    {
+      invalid.push_back(index);
+    }
+  }
+  std::vector<Errors> sinkErrors(invalid.size());
+  parallelFor(invalid.size(), _threads, [&](std::size_t _i)
   {
     std::string resolvedBody;
-    Errors e = resolveFrameAttachedToBody(resolvedBody, _in, name);
+    sinkErrors[_i] = resolveFrameAttachedToBody(
+        resolvedBody, _in, frozen.LocalName(invalid[_i]));
+  });
+  for (const auto &e : sinkErrors)
+  {
     errors.insert(errors.end(), e.begin(), e.end());
   }
 
@@ -1287,7 +1697,7 @@ Errors validateFrameAttachedToGraph(
 
 /////////////////////////////////////////////////
 Errors validatePoseRelativeToGraph(
-    const ScopedGraph<PoseRelativeToGraph> &_in)
+    const ScopedGraph<PoseRelativeToGraph> &_in, unsigned int _threads)
 {
   Errors errors;
 
@@ -1331,10 +1741,10 @@ Errors validatePoseRelativeToGraph(
   }
 
   // Check number of incoming edges for each vertex
-  auto vertices = _in.Graph().Vertices();
-  for (auto vertexPair : vertices)
+  const FrozenGraph<PoseRelativeToGraph> frozen(_in);
+  for (std::size_t index = 0; index < frozen.VertexCount(); ++index)
   {
-    const std::string vertexName = _in.VertexLocalName(vertexPair.second.get());
+    const std::string &vertexName = frozen.LocalName(index);
     // Vertex names should not be empty
     if (vertexName.empty())
     {
@@ -1343,7 +1753,7 @@ Errors validatePoseRelativeToGraph(
           "vertex with empty name detected."});
     }
 
-    std::size_t inDegree = _in.Graph().InDegree(vertexPair.first);
+    std::size_t inDegree = frozen.InEdges(index).size();
 
     if (inDegree > 1)
     {
@@ -1374,7 +1784,7 @@ Errors validatePoseRelativeToGraph(
     }
     else if (sdf::FrameType::MODEL == sourceFrameType)
     {
-      switch (vertexPair.second.get().Data())
+      switch (frozen.Data(index))
       {
         case sdf::FrameType::WORLD:
           errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
@@ -1383,7 +1793,7 @@ Errors validatePoseRelativeToGraph(
               "should not have type WORLD in MODEL relative_to graph."});
           break;
         case sdf::FrameType::MODEL:
-          if (_in.ScopeVertexId() == vertexPair.first)
+          if (frozen.ScopeIndex() == index)
           {
             if (inDegree != 0)
             {
@@ -1423,7 +1833,7 @@ Errors validatePoseRelativeToGraph(
     else
     {
       // sourceFrameType must be sdf::FrameType::WORLD
-      switch (vertexPair.second.get().Data())
+      switch (frozen.Data(index))
       {
         case sdf::FrameType::WORLD:
           if (inDegree != 1)
@@ -1459,13 +1869,30 @@ Errors validatePoseRelativeToGraph(
     }
   }
 
-  // check graph for cycles by resolving pose of each vertex relative to root
-  for (auto const &name : _in.VertexNames())
+  // check graph for cycles by finding the source of every vertex in one
+  // pass. Vertices that do not lead to the scope vertex are resolved on
+  // their own, on several threads, to report the errors of
+  // resolvePoseRelativeToRoot in order.
+  FramePathEnds sources;
+  findSourceVertices(sources, frozen);
+  std::vector<std::size_t> invalid;
+  for (const auto index : frozen.ScopeIndices())
+  {
+    if (sources.ends[index] != frozen.ScopeIndex() &&
+        frozen.LocalName(index) != "__root__")
+    {
+      invalid.push_back(index);
+    }
+  }
+  std::vector<Errors> resolveErrors(invalid.size());
+  parallelFor(invalid.size(), _threads, [&](std::size_t _i)
   {
-    if (name == "__root__")
-      continue;
     ignition::math::Pose3d pose;
-    Errors e = resolvePoseRelativeToRoot(pose, _in, name);
+    resolveErrors[_i] =
+        resolvePoseRelativeToRoot(pose, _in, frozen.Id(invalid[_i]));
+  });
+  for (const auto &e : resolveErrors)
+  {
     errors.insert(errors.end(), e.begin(), e.end());
   }
 
@@ -1473,129 +1900,695 @@ Errors validatePoseRelativeToGraph(
 }
 
 /////////////////////////////////////////////////
-Errors resolveFrameAttachedToBody(
-    std::string &_attachedToBody,
-    const ScopedGraph<FrameAttachedToGraph> &_in,
-    const std::string &_vertexName)
+Errors updatePoseRelativeToGraph(ScopedGraph<PoseRelativeToGraph> &_graph,
+    const std::string &_name, const ignition::math::Pose3d &_pose)
 {
   Errors errors;
 
-  if (_in.ScopeContextName() != "__model__" &&
-      _in.ScopeContextName() != "world")
+  const auto vertexId = _graph.VertexIdByName(_name);
+  if (vertexId == ignition::math::graph::kNullId)
   {
-    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
-        "FrameAttachedToGraph error: scope context name[" +
-            _in.ScopeContextName() + "] does not match __model__ or world."});
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "PoseRelativeToGraph unable to find unique frame with name [" +
+        _name + "] in graph."});
     return errors;
   }
 
-  if (_in.Count(_vertexName) != 1)
+  const auto incidentsTo = _graph.Graph().IncidentsTo(vertexId);
+  if (incidentsTo.size() != 1)
   {
-    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_INVALID,
-        "FrameAttachedToGraph unable to find unique frame with name [" +
-        _vertexName + "] in graph."});
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "PoseRelativeToGraph frame with name [" + _name +
+        "] should have exactly one incoming edge, but has " +
+        std::to_string(incidentsTo.size()) + "."});
     return errors;
   }
-  auto vertexId = _in.VertexIdByName(_vertexName);
 
-  auto sinkVertexEdges = FindSinkVertex(_in, vertexId, errors);
-  auto sinkVertex = sinkVertexEdges.first;
+  auto edge = incidentsTo.begin()->second.get();
+  _graph.UpdateEdge(edge, _pose);
+  return errors;
+}
 
-  if (!errors.empty())
+/////////////////////////////////////////////////
+Errors updatePoseRelativeToGraph(ScopedGraph<PoseRelativeToGraph> &_graph,
+    const Model &_model)
+{
+  ignition::math::Pose3d resolvedModelPose = _model.RawPose();
+  Errors errors = resolveModelPoseWithPlacementFrame(_model,
+      _graph.ChildModelScope(_model.Name()), resolvedModelPose);
+
+  Errors updateErrors =
+      updatePoseRelativeToGraph(_graph, _model.Name(), resolvedModelPose);
+  errors.insert(errors.end(), updateErrors.begin(), updateErrors.end());
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors updatePoseRelativeToGraph(ScopedGraph<PoseRelativeToGraph> &_graph,
+    const std::string &_name, const std::string &_relativeTo,
+    const ignition::math::Pose3d &_pose)
+{
+  Errors errors;
+
+  const auto vertexId = _graph.VertexIdByName(_name);
+  if (vertexId == ignition::math::graph::kNullId)
   {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "PoseRelativeToGraph unable to find unique frame with name [" +
+        _name + "] in graph."});
     return errors;
   }
 
-  if (!sinkVertex.Valid())
+  const auto relativeToId = _graph.VertexIdByName(_relativeTo);
+  if (relativeToId == ignition::math::graph::kNullId)
   {
-    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
-        "FrameAttachedToGraph unable to find sink vertex when starting "
-        "from vertex with name [" + _vertexName + "]."});
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
+        "relative_to name[" + _relativeTo +
+        "] specified by frame with name[" + _name +
+        "] does not match a frame name in graph."});
     return errors;
   }
 
-  if (_in.ScopeContextName() == "world" &&
-      !(sinkVertex.Data() == FrameType::WORLD ||
-          sinkVertex.Data() == FrameType::STATIC_MODEL ||
-          sinkVertex.Data() == FrameType::LINK))
+  const auto incidentsTo = _graph.Graph().IncidentsTo(vertexId);
+  if (incidentsTo.size() != 1)
   {
-    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
-        "Graph has world scope but sink vertex named [" + sinkVertex.Name() +
-            "] does not have FrameType WORLD, LINK or STATIC_MODEL "
-            "when starting from vertex with name [" +
-            _vertexName + "]."});
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "PoseRelativeToGraph frame with name [" + _name +
+        "] should have exactly one incoming edge, but has " +
+        std::to_string(incidentsTo.size()) + "."});
     return errors;
   }
 
-  if (_in.ScopeContextName() == "__model__")
+  // Replace the edge, and put the old one back if the new one makes the
+  // vertex or the vertices below it invalid.
+  const auto &oldEdge = incidentsTo.begin()->second.get();
+  const auto oldRelativeToId = oldEdge.Tail();
+  const auto oldPose = oldEdge.Data();
+  _graph.RemoveEdge(oldEdge);
+  auto &newEdge = _graph.AddEdge({relativeToId, vertexId}, _pose);
+
+  errors = validatePoseRelativeToSubgraph(_graph, _name);
+  if (!errors.empty())
   {
-    if (sinkVertex.Data() == FrameType::MODEL &&
-        sinkVertex.Name() == "__model__")
-    {
-      errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
-          "Graph with __model__ scope has sink vertex named [__model__] "
-          "when starting from vertex with name [" + _vertexName + "], "
-          "which is not permitted."});
-      return errors;
-    }
-    else if (sinkVertex.Data() != FrameType::LINK &&
-             sinkVertex.Data() != FrameType::STATIC_MODEL)
-    {
-      errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
-          "Graph has __model__ scope but sink vertex named [" +
-          sinkVertex.Name() + "] does not have FrameType LINK OR STATIC_MODEL "
-          "when starting from vertex with name [" + _vertexName + "]."});
-      return errors;
-    }
+    _graph.RemoveEdge(newEdge);
+    _graph.AddEdge({oldRelativeToId, vertexId}, oldPose);
   }
-
-  _attachedToBody = _in.VertexLocalName(sinkVertex);
-
   return errors;
 }
 
 /////////////////////////////////////////////////
-Errors resolvePoseRelativeToRoot(
-      ignition::math::Pose3d &_pose,
-      const ScopedGraph<PoseRelativeToGraph> &_graph,
-      const std::string &_vertexName)
+Errors updateFrameAttachedToGraph(ScopedGraph<FrameAttachedToGraph> &_graph,
+    const std::string &_name, const std::string &_attachedTo)
 {
   Errors errors;
 
-  if (_graph.Count(_vertexName) != 1)
+  const auto vertexId = _graph.VertexIdByName(_name);
+  if (vertexId == ignition::math::graph::kNullId)
   {
-    errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
-        "PoseRelativeToGraph unable to find unique frame with name [" +
-        _vertexName + "] in graph."});
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+        "FrameAttachedToGraph unable to find unique frame with name [" +
+        _name + "] in graph."});
     return errors;
   }
 
-  return resolvePoseRelativeToRoot(
-      _pose, _graph, _graph.VertexIdByName(_vertexName));
-}
-/////////////////////////////////////////////////
-Errors resolvePoseRelativeToRoot(
-      ignition::math::Pose3d &_pose,
-      const ScopedGraph<PoseRelativeToGraph> &_graph,
-      const ignition::math::graph::VertexId &_vertexId)
-{
-  Errors errors;
-
-  auto incomingVertexEdges = FindSourceVertex(_graph, _vertexId, errors);
-
-  if (!errors.empty())
+  const auto attachedToId = _graph.VertexIdByName(_attachedTo);
+  if (attachedToId == ignition::math::graph::kNullId)
   {
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_INVALID,
+        "attached_to name[" + _attachedTo +
+        "] specified by frame with name[" + _name +
+        "] does not match a frame name in graph."});
     return errors;
   }
-  else if (!incomingVertexEdges.first.Valid())
+
+  const auto incidentsFrom = _graph.Graph().IncidentsFrom(vertexId);
+  if (incidentsFrom.size() != 1)
   {
-    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
-        "PoseRelativeToGraph unable to find path to source vertex "
-        "when starting from vertex with id [" +
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+        "FrameAttachedToGraph frame with name [" + _name +
+        "] should have exactly one outgoing edge, but has " +
+        std::to_string(incidentsFrom.size()) + "."});
+    return errors;
+  }
+
+  // Replace the edge, and put the old one back if the new one makes the
+  // vertex or the vertices attached to it invalid.
+  const auto &oldEdge = incidentsFrom.begin()->second.get();
+  const auto oldAttachedToId = oldEdge.Head();
+  _graph.RemoveEdge(oldEdge);
+  auto &newEdge = _graph.AddEdge({vertexId, attachedToId}, true);
+
+  errors = validateFrameAttachedToSubgraph(_graph, _name);
+  if (!errors.empty())
+  {
+    _graph.RemoveEdge(newEdge);
+    _graph.AddEdge({vertexId, oldAttachedToId}, true);
+  }
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors addFrameToGraphs(
+    ScopedGraph<FrameAttachedToGraph> &_attachedToGraph,
+    ScopedGraph<PoseRelativeToGraph> &_poseGraph,
+    const std::string &_name, const std::string &_attachedTo,
+    const std::string &_relativeTo, const ignition::math::Pose3d &_pose)
+{
+  Errors errors;
+
+  if (_attachedToGraph.Count(_name) > 0 || _poseGraph.Count(_name) > 0)
+  {
+    errors.push_back({ErrorCode::DUPLICATE_NAME,
+        "Frame with non-unique name [" + _name + "] detected in graph."});
+    return errors;
+  }
+
+  // Same defaults as buildFrameAttachedToGraph and buildPoseRelativeToGraph.
+  const std::string attachedTo = _attachedTo.empty() ?
+      _attachedToGraph.ScopeContextName() : _attachedTo;
+  const std::string relativeTo = _relativeTo.empty() ?
+      attachedTo : _relativeTo;
+
+  if (_name == attachedTo)
+  {
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_CYCLE,
+        "attached_to name[" + attachedTo +
+        "] is identical to frame name[" + _name +
+        "], causing a graph cycle."});
+  }
+  else if (_attachedToGraph.Count(attachedTo) != 1)
+  {
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_INVALID,
+        "attached_to name[" + attachedTo +
+        "] specified by frame with name[" + _name +
+        "] does not match a frame name in graph."});
+  }
+
+  if (_name == relativeTo)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_CYCLE,
+        "relative_to name[" + relativeTo +
+        "] is identical to frame name[" + _name +
+        "], causing a graph cycle."});
+  }
+  else if (_poseGraph.Count(relativeTo) != 1)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
+        "relative_to name[" + relativeTo +
+        "] specified by frame with name[" + _name +
+        "] does not match a frame name in graph."});
+  }
+
+  if (!errors.empty())
+  {
+    return errors;
+  }
+
+  const auto attachedToFrameId =
+      _attachedToGraph.AddVertex(_name, sdf::FrameType::FRAME).Id();
+  _attachedToGraph.AddEdge(
+      {attachedToFrameId, _attachedToGraph.VertexIdByName(attachedTo)}, true);
+
+  const auto poseFrameId =
+      _poseGraph.AddVertex(_name, sdf::FrameType::FRAME).Id();
+  _poseGraph.AddEdge(
+      {_poseGraph.VertexIdByName(relativeTo), poseFrameId}, _pose);
+
+  // Nothing depends on the new frame yet, so only the frame itself can be
+  // invalid, when the frames it refers to are.
+  errors = validateFrameAttachedToSubgraph(_attachedToGraph, _name);
+  Errors poseErrors = validatePoseRelativeToSubgraph(_poseGraph, _name);
+  errors.insert(errors.end(), poseErrors.begin(), poseErrors.end());
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors removeFrameFromGraphs(
+    ScopedGraph<FrameAttachedToGraph> &_attachedToGraph,
+    ScopedGraph<PoseRelativeToGraph> &_poseGraph,
+    const std::string &_name)
+{
+  Errors errors;
+
+  const auto attachedToFrameId = _attachedToGraph.VertexIdByName(_name);
+  const auto poseFrameId = _poseGraph.VertexIdByName(_name);
+  if (attachedToFrameId == ignition::math::graph::kNullId ||
+      poseFrameId == ignition::math::graph::kNullId)
+  {
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+        "Unable to find frame with name [" + _name + "] in graphs."});
+    return errors;
+  }
+
+  for (const auto &edgePair :
+      _attachedToGraph.Graph().IncidentsTo(attachedToFrameId))
+  {
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+        "Frame with name [" + _name + "] cannot be removed, because "
+        "frame with name [" +
+        _attachedToGraph.VertexLocalName(edgePair.second.get().Tail()) +
+        "] is attached to it."});
+  }
+  for (const auto &edgePair : _poseGraph.Graph().IncidentsFrom(poseFrameId))
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "Frame with name [" + _name + "] cannot be removed, because "
+        "the pose of frame with name [" +
+        _poseGraph.VertexLocalName(edgePair.second.get().Head()) +
+        "] is relative to it."});
+  }
+
+  if (errors.empty())
+  {
+    _attachedToGraph.RemoveVertex(_name);
+    _poseGraph.RemoveVertex(_name);
+  }
+  return errors;
+}
+
+/////////////////////////////////////////////////
+/// \brief Append the names of the vertices that buildFrameAttachedToGraph
+/// and buildPoseRelativeToGraph add for a model and its nested models.
+/// \param[in] _model Model.
+/// \param[in] _prefix Prefix of the name of the model in the graphs.
+/// \param[out] _names Names to append to.
+static void appendModelVertexNames(const Model &_model,
+    const std::string &_prefix, std::vector<std::string> &_names)
+{
+  const std::string name = _prefix + _model.Name();
+  const std::string scope = name + "::";
+  _names.push_back(name);
+  _names.push_back(scope + "__model__");
+  for (uint64_t l = 0; l < _model.LinkCount(); ++l)
+  {
+    _names.push_back(scope + _model.LinkByIndex(l)->Name());
+  }
+  for (uint64_t j = 0; j < _model.JointCount(); ++j)
+  {
+    _names.push_back(scope + _model.JointByIndex(j)->Name());
+  }
+  for (uint64_t f = 0; f < _model.FrameCount(); ++f)
+  {
+    _names.push_back(scope + _model.FrameByIndex(f)->Name());
+  }
+  for (uint64_t m = 0; m < _model.ModelCount(); ++m)
+  {
+    appendModelVertexNames(*_model.ModelByIndex(m), scope, _names);
+  }
+}
+
+/////////////////////////////////////////////////
+Errors addModelToGraphs(
+    ScopedGraph<FrameAttachedToGraph> &_attachedToGraph,
+    ScopedGraph<PoseRelativeToGraph> &_poseGraph,
+    const Model &_model)
+{
+  Errors errors;
+  const std::string &name = _model.Name();
+  if (_attachedToGraph.Count(name) > 0 || _poseGraph.Count(name) > 0)
+  {
+    errors.push_back({ErrorCode::DUPLICATE_NAME,
+        "Model with non-unique name [" + name + "] detected in graph."});
+    return errors;
+  }
+
+  // The vertices of the model are added in place, as buildModelSubgraphs
+  // would add them for a model of a world.
+  Errors buildErrors =
+      buildFrameAttachedToGraph(_attachedToGraph, &_model, false);
+  errors.insert(errors.end(), buildErrors.begin(), buildErrors.end());
+  buildErrors = buildPoseRelativeToGraph(_poseGraph, &_model, false);
+  errors.insert(errors.end(), buildErrors.begin(), buildErrors.end());
+  if (_poseGraph.Count(name) != 1)
+  {
+    return errors;
+  }
+
+  // Same edge as buildPoseRelativeToGraph adds for a model of a world.
+  auto relativeToId = _poseGraph.ScopeVertexId();
+  const std::string &relativeTo = _model.PoseRelativeTo();
+  if (!relativeTo.empty())
+  {
+    if (_poseGraph.Count(relativeTo) != 1)
+    {
+      errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
+          "relative_to name[" + relativeTo +
+          "] specified by model with name[" + name +
+          "] does not match a model or frame name in graph."});
+      return errors;
+    }
+    relativeToId = _poseGraph.VertexIdByName(relativeTo);
+    if (name == relativeTo)
+    {
+      errors.push_back({ErrorCode::POSE_RELATIVE_TO_CYCLE,
+          "relative_to name[" + relativeTo +
+          "] is identical to model name[" + name +
+          "], causing a graph cycle."});
+    }
+  }
+
+  ignition::math::Pose3d resolvedModelPose = _model.RawPose();
+  Errors resolveErrors = resolveModelPoseWithPlacementFrame(_model,
+      _poseGraph.ChildModelScope(name), resolvedModelPose);
+  errors.insert(errors.end(), resolveErrors.begin(), resolveErrors.end());
+  _poseGraph.AddEdge(
+      {relativeToId, _poseGraph.VertexIdByName(name)}, resolvedModelPose);
+  if (!errors.empty())
+  {
+    return errors;
+  }
+
+  // Nothing outside of the model depends on it yet, so only its vertices
+  // are validated. Each one must lead to a body, and the poses of the model
+  // vertex and of the vertices below it are resolved.
+  std::vector<std::string> names;
+  appendModelVertexNames(_model, "", names);
+  std::string attachedToBody;
+  for (const std::string &vertexName : names)
+  {
+    if (_attachedToGraph.Count(vertexName) != 1)
+    {
+      continue;
+    }
+    Errors vertexErrors =
+        resolveFrameAttachedToBody(attachedToBody, _attachedToGraph,
+            vertexName);
+    errors.insert(errors.end(), vertexErrors.begin(), vertexErrors.end());
+  }
+  Errors poseErrors = validatePoseRelativeToSubgraph(_poseGraph, name);
+  errors.insert(errors.end(), poseErrors.begin(), poseErrors.end());
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors removeModelFromGraphs(
+    ScopedGraph<FrameAttachedToGraph> &_attachedToGraph,
+    ScopedGraph<PoseRelativeToGraph> &_poseGraph,
+    const Model &_model)
+{
+  using VertexId = ignition::math::graph::VertexId;
+
+  std::vector<std::string> names;
+  appendModelVertexNames(_model, "", names);
+
+  std::set<VertexId> attachedToIds;
+  std::set<VertexId> poseIds;
+  for (const std::string &name : names)
+  {
+    attachedToIds.insert(_attachedToGraph.VertexIdByName(name));
+    poseIds.insert(_poseGraph.VertexIdByName(name));
+  }
+
+  // The vertices outside of the model that are attached to it, or whose
+  // poses are relative to it, lose their edges.
+  std::vector<std::string> attachedToDependents;
+  for (const VertexId id : attachedToIds)
+  {
+    if (id == ignition::math::graph::kNullId)
+    {
+      continue;
+    }
+    for (const auto &edgePair : _attachedToGraph.Graph().IncidentsTo(id))
+    {
+      const VertexId tailId = edgePair.second.get().Tail();
+      if (!attachedToIds.count(tailId))
+      {
+        attachedToDependents.push_back(
+            _attachedToGraph.VertexLocalName(tailId));
+      }
+    }
+  }
+  std::vector<std::string> poseDependents;
+  for (const VertexId id : poseIds)
+  {
+    if (id == ignition::math::graph::kNullId)
+    {
+      continue;
+    }
+    for (const auto &edgePair : _poseGraph.Graph().IncidentsFrom(id))
+    {
+      const VertexId headId = edgePair.second.get().Head();
+      if (!poseIds.count(headId))
+      {
+        poseDependents.push_back(_poseGraph.VertexLocalName(headId));
+      }
+    }
+  }
+
+  for (const std::string &name : names)
+  {
+    _attachedToGraph.RemoveVertex(name);
+    _poseGraph.RemoveVertex(name);
+  }
+
+  Errors errors;
+  for (const std::string &name : attachedToDependents)
+  {
+    Errors dependentErrors =
+        validateFrameAttachedToSubgraph(_attachedToGraph, name);
+    errors.insert(errors.end(), dependentErrors.begin(),
+        dependentErrors.end());
+  }
+  for (const std::string &name : poseDependents)
+  {
+    Errors dependentErrors =
+        validatePoseRelativeToSubgraph(_poseGraph, name);
+    errors.insert(errors.end(), dependentErrors.begin(),
+        dependentErrors.end());
+  }
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors validateFrameAttachedToSubgraph(
+    const ScopedGraph<FrameAttachedToGraph> &_in,
+    const std::string &_vertexName)
+{
+  std::string attachedToBody;
+  Errors errors = resolveFrameAttachedToBody(attachedToBody, _in, _vertexName);
+  if (!errors.empty())
+  {
+    return errors;
+  }
+
+  // The vertex leads to a body, so the vertices attached to it do as well,
+  // unless they have other outgoing edges.
+  const auto &graph = _in.Graph();
+  std::set<ignition::math::graph::VertexId> visited;
+  std::vector<ignition::math::graph::VertexId> stack{
+      _in.VertexIdByName(_vertexName)};
+  while (!stack.empty())
+  {
+    const auto vertexId = stack.back();
+    stack.pop_back();
+    for (const auto &edgePair : graph.IncidentsTo(vertexId))
+    {
+      const auto tailId = edgePair.second.get().Tail();
+      const auto localName =
+          _in.FindAndRemovePrefix(graph.VertexFromId(tailId).Name());
+      if (!localName.second || !visited.insert(tailId).second)
+      {
+        continue;
+      }
+      if (graph.OutDegree(tailId) != 1)
+      {
+        Errors tailErrors =
+            resolveFrameAttachedToBody(attachedToBody, _in, localName.first);
+        errors.insert(errors.end(), tailErrors.begin(), tailErrors.end());
+        continue;
+      }
+      stack.push_back(tailId);
+    }
+  }
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors validatePoseRelativeToSubgraph(
+    const ScopedGraph<PoseRelativeToGraph> &_in,
+    const std::string &_vertexName)
+{
+  ignition::math::Pose3d pose;
+  Errors errors = resolvePoseRelativeToRoot(pose, _in, _vertexName);
+  if (!errors.empty())
+  {
+    return errors;
+  }
+
+  // The vertex leads to the scope vertex, so the vertices below it do as
+  // well, unless they have other incoming edges. Their poses are composed
+  // top-down and cached, as resolvePoseRelativeToRoot would.
+  const auto &graph = _in.Graph();
+  auto &cache = _in.PoseCache();
+  const auto scopeId = _in.ScopeVertexId();
+  std::set<ignition::math::graph::VertexId> reported;
+  std::vector<std::pair<ignition::math::graph::VertexId,
+      ignition::math::Pose3d>> stack{{_in.VertexIdByName(_vertexName), pose}};
+  while (!stack.empty())
+  {
+    const auto [vertexId, vertexPose] = stack.back();
+    stack.pop_back();
+    for (const auto &edgePair : graph.IncidentsFrom(vertexId))
+    {
+      const auto &edge = edgePair.second.get();
+      const auto headId = edge.Head();
+      if (graph.InDegree(headId) != 1)
+      {
+        if (reported.insert(headId).second)
+        {
+          Errors headErrors = resolvePoseRelativeToRoot(pose, _in, headId);
+          errors.insert(errors.end(), headErrors.begin(), headErrors.end());
+        }
+        continue;
+      }
+      const ignition::math::Pose3d headPose = vertexPose * edge.Data();
+      cache.Insert(scopeId, headId, headPose);
+      stack.emplace_back(headId, headPose);
+    }
+  }
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors resolveFrameAttachedToBody(
+    std::string &_attachedToBody,
+    const ScopedGraph<FrameAttachedToGraph> &_in,
+    const std::string &_vertexName)
+{
+  Errors errors;
+
+  if (_in.ScopeContextName() != "__model__" &&
+      _in.ScopeContextName() != "world")
+  {
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+        "FrameAttachedToGraph error: scope context name[" +
+            _in.ScopeContextName() + "] does not match __model__ or world."});
+    return errors;
+  }
+
+  if (_in.Count(_vertexName) != 1)
+  {
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_INVALID,
+        "FrameAttachedToGraph unable to find unique frame with name [" +
+        _vertexName + "] in graph."});
+    return errors;
+  }
+  auto vertexId = _in.VertexIdByName(_vertexName);
+
+  auto sinkVertexEdges = FindSinkVertex(_in, vertexId, errors);
+  auto sinkVertex = sinkVertexEdges.first;
+
+  if (!errors.empty())
+  {
+    return errors;
+  }
+
+  if (!sinkVertex.Valid())
+  {
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+        "FrameAttachedToGraph unable to find sink vertex when starting "
+        "from vertex with name [" + _vertexName + "]."});
+    return errors;
+  }
+
+  if (_in.ScopeContextName() == "world" &&
+      !(sinkVertex.Data() == FrameType::WORLD ||
+          sinkVertex.Data() == FrameType::STATIC_MODEL ||
+          sinkVertex.Data() == FrameType::LINK))
+  {
+    errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+        "Graph has world scope but sink vertex named [" + sinkVertex.Name() +
+            "] does not have FrameType WORLD, LINK or STATIC_MODEL "
+            "when starting from vertex with name [" +
+            _vertexName + "]."});
+    return errors;
+  }
+
+  if (_in.ScopeContextName() == "__model__")
+  {
+    if (sinkVertex.Data() == FrameType::MODEL &&
+        sinkVertex.Name() == "__model__")
+    {
+      errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+          "Graph with __model__ scope has sink vertex named [__model__] "
+          "when starting from vertex with name [" + _vertexName + "], "
+          "which is not permitted."});
+      return errors;
+    }
+    else if (sinkVertex.Data() != FrameType::LINK &&
+             sinkVertex.Data() != FrameType::STATIC_MODEL)
+    {
+      errors.push_back({ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR,
+          "Graph has __model__ scope but sink vertex named [" +
+          sinkVertex.Name() + "] does not have FrameType LINK OR STATIC_MODEL "
+          "when starting from vertex with name [" + _vertexName + "]."});
+      return errors;
+    }
+  }
+
+  _attachedToBody = _in.VertexLocalName(sinkVertex);
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors resolvePoseRelativeToRoot(
+      ignition::math::Pose3d &_pose,
+      const ScopedGraph<PoseRelativeToGraph> &_graph,
+      const std::string &_vertexName)
+{
+  Errors errors;
+
+  if (_graph.Count(_vertexName) != 1)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
+        "PoseRelativeToGraph unable to find unique frame with name [" +
+        _vertexName + "] in graph."});
+    return errors;
+  }
+
+  return resolvePoseRelativeToRoot(
+      _pose, _graph, _graph.VertexIdByName(_vertexName));
+}
+/////////////////////////////////////////////////
+Errors resolvePoseRelativeToRoot(
+      ignition::math::Pose3d &_pose,
+      const ScopedGraph<PoseRelativeToGraph> &_graph,
+      const ignition::math::graph::VertexId &_vertexId)
+{
+  Errors errors;
+
+  auto &cache = _graph.PoseCache();
+  const auto scopeId = _graph.ScopeVertexId();
+  if (cache.Find(scopeId, _vertexId, _pose))
+  {
+    return errors;
+  }
+
+  // Stop at the first ancestor whose pose has already been resolved, and
+  // remember that pose to compose the remaining edges onto it.
+  ignition::math::Pose3d pose;
+  auto isCached = [&](ignition::math::graph::VertexId _id)
+  {
+    return cache.Find(scopeId, _id, pose);
+  };
+  auto incomingVertexEdges =
+      FindSourceVertex(_graph, _vertexId, errors, isCached);
+
+  if (!errors.empty())
+  {
+    return errors;
+  }
+  else if (!incomingVertexEdges.first.Valid())
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "PoseRelativeToGraph unable to find path to source vertex "
+        "when starting from vertex with id [" +
             std::to_string(_vertexId) + "]."});
     return errors;
   }
-  else if (incomingVertexEdges.first.Id() != _graph.ScopeVertex().Id())
+  else if (incomingVertexEdges.first.Id() != _graph.ScopeVertex().Id() &&
+           !cache.Find(scopeId, incomingVertexEdges.first.Id(), pose))
   {
     errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
         "PoseRelativeToGraph frame with name [" + std::to_string(_vertexId) +
@@ -1605,17 +2598,22 @@ Errors resolvePoseRelativeToRoot(
     return errors;
   }
 
-  ignition::math::Pose3d pose;
-  for (auto const &edge : incomingVertexEdges.second)
+  if (incomingVertexEdges.first.Id() == scopeId)
   {
-    pose = edge.Data() * pose;
+    pose = ignition::math::Pose3d::Zero;
   }
 
-  if (errors.empty())
+  // The edges are ordered from _vertexId up to the source, so walk them in
+  // reverse to resolve, and cache, every vertex on the path.
+  const auto &edges = incomingVertexEdges.second;
+  for (auto edge = edges.rbegin(); edge != edges.rend(); ++edge)
   {
-    _pose = pose;
+    pose = pose * edge->Data();
+    cache.Insert(scopeId, edge->Vertices().second, pose);
   }
 
+  _pose = pose;
+
   return errors;
 }
 
@@ -1652,14 +2650,16 @@ Errors resolvePose(
     const std::string &_resolveTo)
 {
   Errors errors;
-  if (_graph.Count(_frameName) != 1)
+  const auto frameVertexId = _graph.VertexIdByName(_frameName);
+  if (frameVertexId == ignition::math::graph::kNullId)
   {
     errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
         "PoseRelativeToGraph unable to find unique frame with name [" +
         _frameName + "] in graph."});
     return errors;
   }
-  if (_graph.Count(_resolveTo) != 1)
+  const auto resolveToVertexId = _graph.VertexIdByName(_resolveTo);
+  if (resolveToVertexId == ignition::math::graph::kNullId)
   {
     errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
         "PoseRelativeToGraph unable to find unique frame with name [" +
@@ -1667,8 +2667,328 @@ Errors resolvePose(
     return errors;
   }
 
-  return resolvePose(_pose, _graph, _graph.VertexIdByName(_frameName),
-      _graph.VertexIdByName(_resolveTo));
+  return resolvePose(_pose, _graph, frameVertexId, resolveToVertexId);
+}
+
+/////////////////////////////////////////////////
+Errors resolveFrameAttachedToBody(
+    std::string &_attachedToBody,
+    const FrozenGraph<FrameAttachedToGraph> &_in,
+    const std::size_t _index)
+{
+  const std::size_t count = _in.VertexCount();
+
+  // Follow the outgoing edges to the sink. A path with as many edges as
+  // there are vertices goes around a cycle.
+  std::size_t vertex = _index;
+  for (std::size_t steps = 0; vertex < count && steps < count; ++steps)
+  {
+    const auto edges = _in.OutEdges(vertex);
+    if (edges.size() != 1)
+    {
+      break;
+    }
+    vertex = edges.begin()->vertex;
+  }
+
+  if (isBodySink(_in, vertex))
+  {
+    _attachedToBody = _in.LocalName(vertex);
+    return Errors();
+  }
+
+  // Resolve the frame in the original graph to report the same errors.
+  return resolveFrameAttachedToBody(_attachedToBody, _in.Scope(),
+      _index < count ? _in.LocalName(_index) : "");
+}
+
+/////////////////////////////////////////////////
+Errors resolvePoseRelativeToRoot(
+    ignition::math::Pose3d &_pose,
+    const FrozenGraph<PoseRelativeToGraph> &_graph,
+    const std::size_t _index)
+{
+  const std::size_t count = _graph.VertexCount();
+  const std::size_t scopeIndex = _graph.ScopeIndex();
+
+  // Follow the incoming edges up to the scope vertex. A path with as many
+  // edges as there are vertices goes around a cycle.
+  ignition::math::Pose3d pose;
+  std::size_t vertex = _index;
+  for (std::size_t steps = 0;
+       vertex < count && vertex != scopeIndex && steps < count; ++steps)
+  {
+    const auto edges = _graph.InEdges(vertex);
+    if (edges.size() != 1)
+    {
+      break;
+    }
+    pose = edges.begin()->data * pose;
+    vertex = edges.begin()->vertex;
+  }
+
+  if (vertex < count && vertex == scopeIndex)
+  {
+    _pose = pose;
+    return Errors();
+  }
+
+  // Resolve the vertex in the original graph to report the same errors.
+  return resolvePoseRelativeToRoot(_pose, _graph.Scope(),
+      _index < count ? _graph.Id(_index) : ignition::math::graph::kNullId);
+}
+
+/////////////////////////////////////////////////
+Errors resolvePose(
+    ignition::math::Pose3d &_pose,
+    const FrozenGraph<PoseRelativeToGraph> &_graph,
+    const std::string &_frameName,
+    const std::string &_resolveTo)
+{
+  Errors errors;
+  const std::size_t frameIndex = _graph.IndexByName(_frameName);
+  if (frameIndex == FrozenGraph<PoseRelativeToGraph>::kNullIndex)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
+        "PoseRelativeToGraph unable to find unique frame with name [" +
+        _frameName + "] in graph."});
+    return errors;
+  }
+  const std::size_t resolveToIndex = _graph.IndexByName(_resolveTo);
+  if (resolveToIndex == FrozenGraph<PoseRelativeToGraph>::kNullIndex)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_INVALID,
+        "PoseRelativeToGraph unable to find unique frame with name [" +
+        _resolveTo + "] in graph."});
+    return errors;
+  }
+
+  errors = resolvePoseRelativeToRoot(_pose, _graph, frameIndex);
+  ignition::math::Pose3d poseR;
+  Errors errorsR = resolvePoseRelativeToRoot(poseR, _graph, resolveToIndex);
+  errors.insert(errors.end(), errorsR.begin(), errorsR.end());
+
+  if (errors.empty())
+  {
+    _pose = poseR.Inverse() * _pose;
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the number of elements needed to index the vertices of a
+/// graph by vertex id.
+/// \param[in] _graph Graph whose vertices are indexed.
+/// \return One more than the largest vertex id of the graph.
+template <typename T>
+static std::size_t vertexIdBound(const ScopedGraph<T> &_graph)
+{
+  std::size_t bound = 0;
+  for (const auto &namePair : _graph.Map())
+  {
+    bound = std::max<std::size_t>(bound, namePair.second + 1);
+  }
+  return bound;
+}
+
+/////////////////////////////////////////////////
+Errors resolveAllPoses(
+    ResolvedPoses &_out,
+    const ScopedGraph<PoseRelativeToGraph> &_graph)
+{
+  using VertexId = ignition::math::graph::VertexId;
+  Errors errors;
+
+  const std::size_t bound = vertexIdBound(_graph);
+  _out.poses.assign(bound, ignition::math::Pose3d::Zero);
+  _out.resolved.assign(bound, false);
+  _out.index.clear();
+  _out.attachedToBodies.clear();
+
+  const VertexId scopeId = _graph.ScopeVertexId();
+  if (scopeId >= bound)
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "PoseRelativeToGraph error: source frame[" +
+        _graph.ScopeContextName() + "] not found in graph."});
+    return errors;
+  }
+
+  // Walk the tree down from the scope vertex, one level at a time. A vertex
+  // is only reached through its single incoming edge, so the poses of a
+  // level only depend on the poses of the level above, and are composed in
+  // batches.
+  auto &cache = _graph.PoseCache();
+  _out.resolved[scopeId] = true;
+  std::vector<VertexId> level{scopeId};
+  std::vector<VertexId> nextLevel;
+  std::vector<VertexId> children;
+  PoseBatch poses;
+  PoseBatch edgePoses;
+  auto composeChildren = [&]()
+  {
+    composePoses(poses, poses, edgePoses);
+    for (std::size_t i = 0; i < children.size(); ++i)
+    {
+      _out.poses[children[i]] = poses.Pose(i);
+      cache.Insert(scopeId, children[i], _out.poses[children[i]]);
+    }
+    nextLevel.insert(nextLevel.end(), children.begin(), children.end());
+    children.clear();
+    poses.Clear();
+    edgePoses.Clear();
+  };
+  while (!level.empty())
+  {
+    for (const VertexId parentId : level)
+    {
+      for (const auto &edgePair : _graph.Graph().IncidentsFrom(parentId))
+      {
+        const auto &edge = edgePair.second.get();
+        const VertexId childId = edge.Head();
+        // Vertices with several incoming edges are left unresolved, and are
+        // reported below.
+        if (_out.resolved[childId] || _graph.Graph().InDegree(childId) != 1)
+        {
+          continue;
+        }
+        _out.resolved[childId] = true;
+        children.push_back(childId);
+        poses.PushBack(_out.poses[parentId]);
+        edgePoses.PushBack(edge.Data());
+        if (children.size() == kPoseBatchSize)
+        {
+          composeChildren();
+        }
+      }
+    }
+    composeChildren();
+    level.swap(nextLevel);
+    nextLevel.clear();
+  }
+
+  for (const auto &name : _graph.VertexNames())
+  {
+    if (name == "__root__")
+    {
+      continue;
+    }
+
+    const VertexId vertexId = _graph.VertexIdByName(name);
+    if (!_out.resolved[vertexId])
+    {
+      // The vertex was not reached from the scope vertex, so resolving it on
+      // its own reports why.
+      Errors vertexErrors = resolvePoseRelativeToRoot(
+          _out.poses[vertexId], _graph, vertexId);
+      if (!vertexErrors.empty())
+      {
+        errors.insert(errors.end(), vertexErrors.begin(), vertexErrors.end());
+        continue;
+      }
+      _out.resolved[vertexId] = true;
+    }
+    _out.index[name] = vertexId;
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors resolveAllPoses(
+    ResolvedPoses &_out,
+    const ScopedGraph<PoseRelativeToGraph> &_graph,
+    const ScopedGraph<FrameAttachedToGraph> &_attachedToGraph)
+{
+  using VertexId = ignition::math::graph::VertexId;
+  Errors errors = resolveAllPoses(_out, _graph);
+  _out.attachedToBodies.assign(_out.poses.size(), "");
+
+  // Sink of each vertex of the attached-to graph, filled in as chains are
+  // followed so that each edge is only followed once.
+  const std::size_t bound = vertexIdBound(_attachedToGraph);
+  std::vector<VertexId> sinks(bound, ignition::math::graph::kNullId);
+  std::vector<bool> onPath(bound, false);
+  std::vector<VertexId> path;
+
+  // Attached-to body of each sink, or false if the sink is not a valid body.
+  std::map<VertexId, std::pair<bool, std::string>> sinkBodies;
+
+  for (const auto &name : _graph.VertexNames())
+  {
+    // Only frames have attached-to bodies.
+    if (name == "__root__" || _attachedToGraph.Count(name) != 1)
+    {
+      continue;
+    }
+
+    path.clear();
+    VertexId vertexId = _attachedToGraph.VertexIdByName(name);
+    bool validPath = true;
+    while (sinks[vertexId] == ignition::math::graph::kNullId)
+    {
+      const auto incidentsFrom =
+          _attachedToGraph.Graph().IncidentsFrom(vertexId);
+      if (incidentsFrom.empty())
+      {
+        sinks[vertexId] = vertexId;
+        break;
+      }
+      if (incidentsFrom.size() != 1 || onPath[vertexId])
+      {
+        validPath = false;
+        break;
+      }
+      onPath[vertexId] = true;
+      path.push_back(vertexId);
+      vertexId = incidentsFrom.begin()->second.get().Head();
+    }
+    for (const auto pathId : path)
+    {
+      onPath[pathId] = false;
+      if (validPath)
+      {
+        sinks[pathId] = sinks[vertexId];
+      }
+    }
+
+    std::pair<bool, std::string> body{false, ""};
+    if (validPath)
+    {
+      const VertexId sinkId = sinks[vertexId];
+      auto sinkBody = sinkBodies.find(sinkId);
+      if (sinkBody == sinkBodies.end())
+      {
+        // A sink is attached to itself, so resolving it checks that its
+        // frame type is a valid body in this scope.
+        const std::string sinkName = _attachedToGraph.VertexLocalName(sinkId);
+        std::string bodyName;
+        const bool valid = _attachedToGraph.Count(sinkName) == 1 &&
+            resolveFrameAttachedToBody(
+                bodyName, _attachedToGraph, sinkName).empty();
+        sinkBody = sinkBodies.emplace(
+            sinkId, std::make_pair(valid, bodyName)).first;
+      }
+      body = sinkBody->second;
+    }
+
+    if (!body.first)
+    {
+      // Resolve the frame on its own to report the same errors as
+      // resolveFrameAttachedToBody.
+      Errors bodyErrors =
+          resolveFrameAttachedToBody(body.second, _attachedToGraph, name);
+      errors.insert(errors.end(), bodyErrors.begin(), bodyErrors.end());
+      if (!bodyErrors.empty())
+      {
+        continue;
+      }
+    }
+    _out.attachedToBodies[_graph.VertexIdByName(name)] = body.second;
+  }
+
+  return errors;
 }
 }
 }
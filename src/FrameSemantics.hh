@@ -17,9 +17,16 @@
 #ifndef SDF_FRAMESEMANTICS_HH_
 #define SDF_FRAMESEMANTICS_HH_
 
+#include <array>
+#include <cstddef>
 #include <map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/graph/Graph.hh>
@@ -46,6 +53,7 @@ namespace sdf
   // Forward declaration.
   class Model;
   class World;
+  template <typename T> class FrozenGraph;
   template <typename T> class ScopedGraph;
 
   /// \enum FrameType
@@ -72,6 +80,55 @@ namespace sdf
     STATIC_MODEL = 5,
   };
 
+  /// \brief Key of the name index of a frame graph. The index owns the full
+  /// names of the vertices, such as model::link, while the keys of lookups
+  /// refer to the prefix of a scope and to a name local to that scope, so
+  /// that ScopedGraph can look up a vertex without building its full name.
+  /// Both kinds of keys hash and compare equal to the full name.
+  class ScopedName
+  {
+    /// \brief Hash function of the name index.
+    public: struct Hash
+    {
+      /// \brief Hash a name.
+      /// \param[in] _name Name.
+      /// \return Hash of the full name.
+      std::size_t operator()(const ScopedName &_name) const;
+    };
+
+    /// \brief Constructor of a full name owned by the index.
+    /// \param[in] _name Full name.
+    public: explicit ScopedName(std::string _name);
+
+    /// \brief Constructor of a lookup key, which refers to the given strings
+    /// instead of copying them.
+    /// \param[in] _prefix Prefix of the scope, empty at the top scope.
+    /// \param[in] _localName Name local to the scope.
+    public: ScopedName(std::string_view _prefix, std::string_view _localName);
+
+    /// \brief Get the full name owned by the index.
+    /// \return The full name, or an empty string for a lookup key.
+    public: const std::string &Name() const;
+
+    /// \brief Compare the full names of two keys.
+    /// \param[in] _other Other key.
+    /// \return True if the full names are equal.
+    public: bool operator==(const ScopedName &_other) const;
+
+    /// \brief Get the parts whose concatenation is the full name.
+    /// \return The parts.
+    private: std::array<std::string_view, 3> Parts() const;
+
+    /// \brief Full name owned by the index.
+    private: std::string name;
+
+    /// \brief Prefix of the scope of a lookup key.
+    private: std::string_view prefix;
+
+    /// \brief Local name of a lookup key.
+    private: std::string_view localName;
+  };
+
   /// \brief Data structure for frame attached_to graphs for Model or World.
   struct FrameAttachedToGraph
   {
@@ -82,13 +139,67 @@ namespace sdf
     GraphType graph;
 
     /// \brief A Map from Vertex names to Vertex Ids.
-    using MapType = std::map<std::string, ignition::math::graph::VertexId>;
+    using MapType = std::unordered_map<ScopedName,
+        ignition::math::graph::VertexId, ScopedName::Hash>;
     MapType map;
 
     /// \brief Name of scope vertex, either __model__ or world.
     std::string scopeName;
   };
 
+  /// \brief Poses of the vertices of a PoseRelativeToGraph relative to the
+  /// scope vertices in which they were resolved. resolvePoseRelativeToRoot
+  /// fills the cache as it resolves poses, and ScopedGraph erases the poses
+  /// of the vertices below an edge when the edge is added, updated or
+  /// removed. Once a vertex is cached, the poses of its
+  /// descendants are composed from it instead of walking up to the scope
+  /// vertex, so resolving every vertex of a tree costs O(1) per vertex.
+  /// The cache can be used from several threads.
+  class PoseRelativeToCache
+  {
+    /// \brief Vertex id type.
+    public: using VertexId = ignition::math::graph::VertexId;
+
+    /// \brief Find the pose of a vertex.
+    /// \param[in] _scopeId Id of the scope vertex the pose is relative to.
+    /// \param[in] _vertexId Id of the vertex.
+    /// \param[out] _pose The pose, if it is cached.
+    /// \return True if the pose is cached.
+    public: bool Find(VertexId _scopeId, VertexId _vertexId,
+                ignition::math::Pose3d &_pose) const;
+
+    /// \brief Store the pose of a vertex.
+    /// \param[in] _scopeId Id of the scope vertex the pose is relative to.
+    /// \param[in] _vertexId Id of the vertex.
+    /// \param[in] _pose The pose.
+    public: void Insert(VertexId _scopeId, VertexId _vertexId,
+                const ignition::math::Pose3d &_pose);
+
+    /// \brief Remove the poses of a vertex relative to all scope vertices.
+    /// \param[in] _vertexId Id of the vertex.
+    public: void Erase(VertexId _vertexId);
+
+    /// \brief Remove all the poses.
+    public: void Clear();
+
+    /// \brief Get the number of cached poses.
+    /// \return Number of poses.
+    public: std::size_t Size() const;
+
+    /// \brief Protects poses and count.
+    private: mutable std::shared_mutex mutex;
+
+    /// \brief Poses of each vertex, with the ids of the scope vertices they
+    /// are relative to. A vertex is resolved in few scopes, one per level of
+    /// model nesting at most.
+    private: std::unordered_map<VertexId,
+                 std::vector<std::pair<VertexId, ignition::math::Pose3d>>>
+                 poses;
+
+    /// \brief Number of cached poses.
+    private: std::size_t count = 0;
+  };
+
   /// \brief Data structure for pose relative_to graphs for Model or World.
   struct PoseRelativeToGraph
   {
@@ -102,13 +213,85 @@ namespace sdf
     GraphType graph;
 
     /// \brief A Map from Vertex names to Vertex Ids.
-    using MapType = std::map<std::string, ignition::math::graph::VertexId>;
+    using MapType = std::unordered_map<ScopedName,
+        ignition::math::graph::VertexId, ScopedName::Hash>;
     MapType map;
 
     /// \brief Name of source vertex, either __model__ or world.
     std::string sourceName;
+
+    /// \brief Poses resolved so far.
+    PoseRelativeToCache cache;
+
+    /// \brief Vertices left to visit by ScopedGraph::InvalidateCaches,
+    /// kept between calls so that they don't allocate.
+    std::vector<ignition::math::graph::VertexId> invalidateStack;
+
+    /// \brief Stamp of the last InvalidateCaches call that visited each
+    /// vertex, indexed by vertex id.
+    std::vector<std::size_t> invalidateVisited;
+
+    /// \brief Stamp of the last InvalidateCaches call.
+    std::size_t invalidateStamp = 0;
+  };
+
+  /// \brief Poses of all the vertices of one scope of a PoseRelativeToGraph,
+  /// computed by resolveAllPoses.
+  struct ResolvedPoses
+  {
+    /// \brief Pose of each vertex relative to the scope vertex, indexed by
+    /// vertex id.
+    std::vector<ignition::math::Pose3d> poses;
+
+    /// \brief Whether the pose at the same index in poses was resolved.
+    /// Vertices outside the scope and vertices with errors are not resolved.
+    std::vector<bool> resolved;
+
+    /// \brief Local names of the resolved vertices and their indices in
+    /// poses.
+    std::map<std::string, ignition::math::graph::VertexId> index;
+
+    /// \brief Local name of the body each vertex is attached to, indexed by
+    /// vertex id of the PoseRelativeToGraph. Only filled by the
+    /// resolveAllPoses overload that takes a FrameAttachedToGraph, and empty
+    /// for vertices whose body could not be resolved.
+    std::vector<std::string> attachedToBodies;
+  };
+
+  /// \brief Ends of the paths that start at each vertex of a frozen frame
+  /// graph, computed by findSinkVertices or findSourceVertices. A path
+  /// follows the outgoing edges of a FrameAttachedToGraph or the incoming
+  /// edges of a PoseRelativeToGraph, and stops at a vertex that has no such
+  /// edge, that has more than one, or that is the scope vertex of a
+  /// PoseRelativeToGraph.
+  struct FramePathEnds
+  {
+    /// \brief Index of the vertex at which the path from each vertex stops,
+    /// indexed by vertex index, or FrozenGraph::kNullIndex for the vertices
+    /// of a cycle and the vertices whose path leads to a cycle.
+    std::vector<std::size_t> ends;
+
+    /// \brief Vertex indices of each cycle, in the order the path visits
+    /// them.
+    std::vector<std::vector<std::size_t>> cycles;
   };
 
+  /// \brief Follow the outgoing edges of every vertex of a frozen
+  /// FrameAttachedToGraph to its sink, in a single pass that visits each
+  /// vertex once.
+  /// \param[out] _out The sink of each vertex and the cycles of the graph.
+  /// \param[in] _graph Frozen graph.
+  void findSinkVertices(FramePathEnds &_out,
+      const FrozenGraph<FrameAttachedToGraph> &_graph);
+
+  /// \brief Follow the incoming edges of every vertex of a frozen
+  /// PoseRelativeToGraph to its source, in a single pass that visits each
+  /// vertex once. Paths stop at the scope vertex.
+  /// \param[out] _out The source of each vertex and the cycles of the graph.
+  /// \param[in] _graph Frozen graph.
+  void findSourceVertices(FramePathEnds &_out,
+      const FrozenGraph<PoseRelativeToGraph> &_graph);
+
   /// \brief Build a FrameAttachedToGraph for a model.
   /// \param[out] _out Graph object to write.
   /// \param[in] _model Model from which to build attached_to graph.
@@ -141,16 +324,156 @@ namespace sdf
   /// \brief Confirm that FrameAttachedToGraph is valid by checking the number
   /// of outbound edges for each vertex and checking for graph cycles.
   /// \param[in] _in Graph object to validate.
+  /// \param[in] _threads Maximum number of threads that check for cycles,
+  /// see parallelFor. The errors are the same for any number of threads.
   /// \return Errors.
   Errors validateFrameAttachedToGraph(
-      const ScopedGraph<FrameAttachedToGraph> &_in);
+      const ScopedGraph<FrameAttachedToGraph> &_in,
+      unsigned int _threads = 1);
 
   /// \brief Confirm that PoseRelativeToGraph is valid by checking the number
   /// of outbound edges for each vertex and checking for graph cycles.
   /// \param[in] _in Graph object to validate.
+  /// \param[in] _threads Maximum number of threads that check for cycles,
+  /// see parallelFor. The errors are the same for any number of threads.
   /// \return Errors.
   Errors validatePoseRelativeToGraph(
-      const ScopedGraph<PoseRelativeToGraph> &_in);
+      const ScopedGraph<PoseRelativeToGraph> &_in,
+      unsigned int _threads = 1);
+
+  /// \brief Update the pose of the edge that points to a vertex of a
+  /// PoseRelativeToGraph, after the raw pose of the link or frame of the
+  /// vertex changed. The edge keeps its source vertex.
+  /// \param[in,out] _graph Scope of the graph that holds the vertex.
+  /// \param[in] _name Local name of the vertex.
+  /// \param[in] _pose New raw pose of the link or frame.
+  /// \return Errors if the vertex does not have exactly one incoming edge.
+  Errors updatePoseRelativeToGraph(ScopedGraph<PoseRelativeToGraph> &_graph,
+      const std::string &_name, const ignition::math::Pose3d &_pose);
+
+  /// \brief Update the pose of the edge that points to the vertex of a
+  /// model in a PoseRelativeToGraph, after the raw pose of the model
+  /// changed. The placement frame of the model is accounted for as in
+  /// buildPoseRelativeToGraph.
+  /// \param[in,out] _graph Scope of the graph that holds the model vertex.
+  /// \param[in] _model Model whose pose changed.
+  /// \return Errors.
+  Errors updatePoseRelativeToGraph(ScopedGraph<PoseRelativeToGraph> &_graph,
+      const Model &_model);
+
+  /// \brief Change the frame relative to which the pose of a vertex of a
+  /// PoseRelativeToGraph is expressed, as well as the pose. Only the vertex
+  /// and the vertices below it are validated, with
+  /// validatePoseRelativeToSubgraph. The graph is left unchanged if there
+  /// are errors.
+  /// \param[in,out] _graph Scope of the graph that holds the vertex.
+  /// \param[in] _name Local name of the vertex.
+  /// \param[in] _relativeTo Local name of the new relative-to vertex.
+  /// \param[in] _pose New pose of the vertex relative to _relativeTo.
+  /// \return Errors.
+  Errors updatePoseRelativeToGraph(ScopedGraph<PoseRelativeToGraph> &_graph,
+      const std::string &_name, const std::string &_relativeTo,
+      const ignition::math::Pose3d &_pose);
+
+  /// \brief Change the vertex to which a vertex of a FrameAttachedToGraph is
+  /// attached. Only the vertex and the vertices attached to it are
+  /// validated, with validateFrameAttachedToSubgraph. The graph is left
+  /// unchanged if there are errors.
+  /// \param[in,out] _graph Scope of the graph that holds the vertex.
+  /// \param[in] _name Local name of the vertex.
+  /// \param[in] _attachedTo Local name of the new attached-to vertex.
+  /// \return Errors.
+  Errors updateFrameAttachedToGraph(ScopedGraph<FrameAttachedToGraph> &_graph,
+      const std::string &_name, const std::string &_attachedTo);
+
+  /// \brief Add a frame to the graphs of a model or world scope without
+  /// rebuilding them. The vertices and edges are the same as those
+  /// buildFrameAttachedToGraph and buildPoseRelativeToGraph add for a
+  /// sdf::Frame with the same attributes, and only the new vertices are
+  /// validated. Nothing is added if the name of the frame or of the frames
+  /// it refers to are invalid.
+  /// \param[in,out] _attachedToGraph Scope of the FrameAttachedToGraph.
+  /// \param[in,out] _poseGraph Scope of the PoseRelativeToGraph.
+  /// \param[in] _name Name of the frame.
+  /// \param[in] _attachedTo Name of the frame to which the frame is attached,
+  /// or empty for the scope frame.
+  /// \param[in] _relativeTo Name of the frame relative to which the pose is
+  /// expressed, or empty for the attached-to frame.
+  /// \param[in] _pose Raw pose of the frame.
+  /// \return Errors.
+  Errors addFrameToGraphs(
+      ScopedGraph<FrameAttachedToGraph> &_attachedToGraph,
+      ScopedGraph<PoseRelativeToGraph> &_poseGraph,
+      const std::string &_name, const std::string &_attachedTo,
+      const std::string &_relativeTo, const ignition::math::Pose3d &_pose);
+
+  /// \brief Remove a frame from the graphs of a model or world scope without
+  /// rebuilding them. A frame to which other frames are attached, or
+  /// relative to which other poses are expressed, is not removed.
+  /// \param[in,out] _attachedToGraph Scope of the FrameAttachedToGraph.
+  /// \param[in,out] _poseGraph Scope of the PoseRelativeToGraph.
+  /// \param[in] _name Name of the frame.
+  /// \return Errors.
+  Errors removeFrameFromGraphs(
+      ScopedGraph<FrameAttachedToGraph> &_attachedToGraph,
+      ScopedGraph<PoseRelativeToGraph> &_poseGraph,
+      const std::string &_name);
+
+  /// \brief Add a model to the graphs of a world scope without rebuilding
+  /// them. The vertices and edges are the same as those
+  /// buildFrameAttachedToGraph and buildPoseRelativeToGraph add for a model
+  /// of a world, and only the vertices of the model are validated, so the
+  /// work is proportional to the size of the model.
+  /// \param[in,out] _attachedToGraph Scope of the FrameAttachedToGraph of
+  /// the world.
+  /// \param[in,out] _poseGraph Scope of the PoseRelativeToGraph of the
+  /// world.
+  /// \param[in] _model Model to add.
+  /// \return Errors.
+  Errors addModelToGraphs(
+      ScopedGraph<FrameAttachedToGraph> &_attachedToGraph,
+      ScopedGraph<PoseRelativeToGraph> &_poseGraph,
+      const Model &_model);
+
+  /// \brief Remove the vertices of a model and of its nested models from
+  /// the graphs of a world scope without rebuilding them. Unlike
+  /// removeFrameFromGraphs, the model is always removed. The frames and
+  /// models of the world whose poses are relative to it, or that are
+  /// attached to it, are validated again and reported.
+  /// \param[in,out] _attachedToGraph Scope of the FrameAttachedToGraph of
+  /// the world.
+  /// \param[in,out] _poseGraph Scope of the PoseRelativeToGraph of the
+  /// world.
+  /// \param[in] _model Model to remove, which must still hold the links,
+  /// joints, frames and nested models it was added with.
+  /// \return Errors of the vertices that referred to the model.
+  Errors removeModelFromGraphs(
+      ScopedGraph<FrameAttachedToGraph> &_attachedToGraph,
+      ScopedGraph<PoseRelativeToGraph> &_poseGraph,
+      const Model &_model);
+
+  /// \brief Validate the part of a FrameAttachedToGraph that depends on the
+  /// outgoing edge of a vertex: the vertex itself and the vertices attached
+  /// to it, directly or through other vertices. After a local change, this
+  /// finds the same errors as validateFrameAttachedToGraph would in that
+  /// part of the graph, without visiting the rest of it.
+  /// \param[in] _in Scope of the graph to validate.
+  /// \param[in] _vertexName Local name of the vertex.
+  /// \return Errors, as reported by resolveFrameAttachedToBody.
+  Errors validateFrameAttachedToSubgraph(
+      const ScopedGraph<FrameAttachedToGraph> &_in,
+      const std::string &_vertexName);
+
+  /// \brief Validate the part of a PoseRelativeToGraph that depends on the
+  /// incoming edge of a vertex: the vertex itself and the vertices below it.
+  /// The poses of those vertices are resolved and stored in the pose cache
+  /// of the graph.
+  /// \param[in] _in Scope of the graph to validate.
+  /// \param[in] _vertexName Local name of the vertex.
+  /// \return Errors, as reported by resolvePoseRelativeToRoot.
+  Errors validatePoseRelativeToSubgraph(
+      const ScopedGraph<PoseRelativeToGraph> &_in,
+      const std::string &_vertexName);
 
   /// \brief Resolve the attached-to body for a given frame. Following the
   /// edges of the frame attached-to graph from a given frame must lead
@@ -201,6 +524,72 @@ namespace sdf
       const ScopedGraph<PoseRelativeToGraph> &_graph,
       const ignition::math::graph::VertexId &_frameVertexId,
       const ignition::math::graph::VertexId &_resolveToVertexId);
+
+  /// \brief Resolve the attached-to body of a vertex of a frozen graph,
+  /// without allocating unless there are errors.
+  /// \param[out] _attachedToBody Name of link to which this frame is
+  /// attached or "world" if frame is attached to the world.
+  /// \param[in] _in Frozen graph to use for resolving the body.
+  /// \param[in] _index Index of the vertex in the frozen graph.
+  /// \return Errors, which match those of the overload that takes a
+  /// ScopedGraph.
+  Errors resolveFrameAttachedToBody(
+      std::string &_attachedToBody,
+      const FrozenGraph<FrameAttachedToGraph> &_in,
+      const std::size_t _index);
+
+  /// \brief Resolve pose of a vertex of a frozen graph relative to the scope
+  /// vertex, without allocating unless there are errors.
+  /// \param[out] _pose Pose object to write.
+  /// \param[in] _graph Frozen graph to read from.
+  /// \param[in] _index Index of the vertex in the frozen graph.
+  /// \return Errors, which match those of the overload that takes a
+  /// ScopedGraph.
+  Errors resolvePoseRelativeToRoot(
+      ignition::math::Pose3d &_pose,
+      const FrozenGraph<PoseRelativeToGraph> &_graph,
+      const std::size_t _index);
+
+  /// \brief Resolve pose of a frame of a frozen graph relative to named
+  /// frame.
+  /// \param[out] _pose Pose object to write.
+  /// \param[in] _graph Frozen graph to read from.
+  /// \param[in] _frameName Name of frame whose pose is to be resolved.
+  /// \param[in] _resolveTo Name of frame relative to which the pose is
+  /// to be resolved.
+  /// \return Errors.
+  Errors resolvePose(
+      ignition::math::Pose3d &_pose,
+      const FrozenGraph<PoseRelativeToGraph> &_graph,
+      const std::string &_frameName,
+      const std::string &_resolveTo);
+
+  /// \brief Resolve the poses of all the vertices of a scope relative to the
+  /// scope vertex in a single sweep down the graph, which is cheaper than
+  /// calling resolvePoseRelativeToRoot for every vertex. The resolved poses
+  /// are also added to the pose cache of the graph.
+  /// \param[out] _out Resolved poses to write.
+  /// \param[in] _graph PoseRelativeToGraph to read from.
+  /// \return Errors for the vertices whose pose could not be resolved. They
+  /// match the errors of resolvePoseRelativeToRoot.
+  Errors resolveAllPoses(
+      ResolvedPoses &_out,
+      const ScopedGraph<PoseRelativeToGraph> &_graph);
+
+  /// \brief Resolve the poses of all the vertices of a scope as above, and
+  /// the attached-to body of each of them, which fills
+  /// ResolvedPoses::attachedToBodies. Bodies are resolved once per
+  /// attached-to chain rather than once per frame.
+  /// \param[out] _out Resolved poses and bodies to write.
+  /// \param[in] _graph PoseRelativeToGraph to read from.
+  /// \param[in] _attachedToGraph FrameAttachedToGraph of the same scope.
+  /// \return Errors for the vertices whose pose or body could not be
+  /// resolved. They match the errors of resolvePoseRelativeToRoot and
+  /// resolveFrameAttachedToBody.
+  Errors resolveAllPoses(
+      ResolvedPoses &_out,
+      const ScopedGraph<PoseRelativeToGraph> &_graph,
+      const ScopedGraph<FrameAttachedToGraph> &_attachedToGraph);
   }
 }
 #endif
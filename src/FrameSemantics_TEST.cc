@@ -15,6 +15,8 @@
  *
  */
 
+#include <map>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -32,6 +34,7 @@
 #include "sdf/sdf_config.h"
 
 #include "FrameSemantics.hh"
+#include "FrozenGraph.hh"
 #include "ScopedGraph.hh"
 #include "test_config.h"
 
@@ -300,6 +303,424 @@ TEST(FrameSemantics, buildPoseRelativeToGraph)
         "invalid] in graph."));
 }
 
+/////////////////////////////////////////////////
+TEST(FrameSemantics, resolvePoseRelativeToRootCache)
+{
+  using Pose = ignition::math::Pose3d;
+
+  auto ownedGraph = std::make_shared<sdf::PoseRelativeToGraph>();
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> root(ownedGraph);
+  auto graph = root.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  const auto modelId = graph.ScopeVertexId();
+  const auto aId = graph.AddVertex("A", sdf::FrameType::LINK).Id();
+  const auto bId = graph.AddVertex("B", sdf::FrameType::FRAME).Id();
+  const auto cId = graph.AddVertex("C", sdf::FrameType::FRAME).Id();
+  graph.AddEdge({modelId, aId}, Pose(1, 0, 0, 0, 0, 0));
+  graph.AddEdge({aId, bId}, Pose(0, 2, 0, 0, 0, IGN_PI/2));
+  graph.AddEdge({bId, cId}, Pose(3, 0, 0, 0, 0, 0));
+  EXPECT_TRUE(sdf::validatePoseRelativeToGraph(graph).empty());
+
+  // Resolving the deepest frame caches every frame above it.
+  auto &cache = graph.PoseCache();
+  cache.Clear();
+  Pose pose;
+  EXPECT_TRUE(sdf::resolvePoseRelativeToRoot(pose, graph, "C").empty());
+  EXPECT_EQ(Pose(1, 5, 0, 0, 0, IGN_PI/2), pose);
+  EXPECT_EQ(3u, cache.Size());
+
+  Pose cached;
+  EXPECT_TRUE(cache.Find(modelId, aId, cached));
+  EXPECT_EQ(Pose(1, 0, 0, 0, 0, 0), cached);
+  EXPECT_TRUE(cache.Find(modelId, bId, cached));
+  EXPECT_EQ(Pose(1, 2, 0, 0, 0, IGN_PI/2), cached);
+  EXPECT_FALSE(cache.Find(aId, bId, cached));
+
+  EXPECT_TRUE(sdf::resolvePoseRelativeToRoot(pose, graph, "B").empty());
+  EXPECT_EQ(Pose(1, 2, 0, 0, 0, IGN_PI/2), pose);
+  EXPECT_TRUE(sdf::resolvePose(pose, graph, "C", "A").empty());
+  EXPECT_EQ(Pose(0, 5, 0, 0, 0, IGN_PI/2), pose);
+
+  // A frame added below a cached one is composed onto the cached pose, and
+  // the frames above it stay cached.
+  const auto dId = graph.AddVertex("D", sdf::FrameType::FRAME).Id();
+  graph.AddEdge({cId, dId}, Pose(0, 0, 1, 0, 0, 0));
+  EXPECT_EQ(3u, cache.Size());
+  EXPECT_TRUE(sdf::resolvePoseRelativeToRoot(pose, graph, "D").empty());
+  EXPECT_EQ(Pose(1, 5, 1, 0, 0, IGN_PI/2), pose);
+
+  // Updating an edge invalidates the poses of every frame below it.
+  auto edge = graph.Graph().IncidentsTo(aId).begin()->second.get();
+  graph.UpdateEdge(edge, Pose(-1, 0, 0, 0, 0, 0));
+  EXPECT_EQ(0u, cache.Size());
+  EXPECT_TRUE(sdf::resolvePoseRelativeToRoot(pose, graph, "D").empty());
+  EXPECT_EQ(Pose(-1, 5, 1, 0, 0, IGN_PI/2), pose);
+  EXPECT_TRUE(sdf::resolvePoseRelativeToRoot(pose, graph, "A").empty());
+  EXPECT_EQ(Pose(-1, 0, 0, 0, 0, 0), pose);
+
+  // Errors are not cached.
+  const auto eId = graph.AddVertex("E", sdf::FrameType::FRAME).Id();
+  auto errors = sdf::resolvePoseRelativeToRoot(pose, graph, eId);
+  EXPECT_FALSE(errors.empty());
+  EXPECT_FALSE(cache.Find(modelId, eId, cached));
+}
+
+/////////////////////////////////////////////////
+TEST(FrameSemantics, resolveAllPoses)
+{
+  using Pose = ignition::math::Pose3d;
+
+  auto ownedPoseGraph = std::make_shared<sdf::PoseRelativeToGraph>();
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> poseGraph(ownedPoseGraph);
+  poseGraph = poseGraph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  auto poseId = [&](const std::string &_name, sdf::FrameType _type)
+  {
+    return poseGraph.AddVertex(_name, _type).Id();
+  };
+  const auto modelId = poseGraph.ScopeVertexId();
+  const auto lId = poseId("L", sdf::FrameType::LINK);
+  const auto fId = poseId("F", sdf::FrameType::FRAME);
+  const auto gId = poseId("G", sdf::FrameType::FRAME);
+  const auto hId = poseId("H", sdf::FrameType::FRAME);
+  const auto kId = poseId("K", sdf::FrameType::FRAME);
+  const auto xId = poseId("X", sdf::FrameType::FRAME);
+  poseGraph.AddEdge({modelId, lId}, Pose(1, 0, 0, 0, 0, 0));
+  poseGraph.AddEdge({lId, fId}, Pose(0, 1, 0, 0, IGN_PI/2, 0));
+  poseGraph.AddEdge({fId, gId}, Pose(0, 0, 1, 0, 0, 0));
+  poseGraph.AddEdge({modelId, hId}, Pose(0, 0, 2, 0, 0, 0));
+  poseGraph.AddEdge({hId, kId}, Pose(0, 0, 3, 0, 0, 0));
+
+  auto ownedAttachedToGraph = std::make_shared<sdf::FrameAttachedToGraph>();
+  sdf::ScopedGraph<sdf::FrameAttachedToGraph> attachedToGraph(
+      ownedAttachedToGraph);
+  attachedToGraph = attachedToGraph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  auto attachedId = [&](const std::string &_name, sdf::FrameType _type)
+  {
+    return attachedToGraph.AddVertex(_name, _type).Id();
+  };
+  const auto modelAttachedId = attachedToGraph.ScopeVertexId();
+  const auto lAttachedId = attachedId("L", sdf::FrameType::LINK);
+  const auto fAttachedId = attachedId("F", sdf::FrameType::FRAME);
+  const auto gAttachedId = attachedId("G", sdf::FrameType::FRAME);
+  const auto hAttachedId = attachedId("H", sdf::FrameType::FRAME);
+  const auto kAttachedId = attachedId("K", sdf::FrameType::FRAME);
+  attachedToGraph.AddEdge({modelAttachedId, lAttachedId}, true);
+  attachedToGraph.AddEdge({fAttachedId, lAttachedId}, true);
+  attachedToGraph.AddEdge({gAttachedId, fAttachedId}, true);
+  attachedToGraph.AddEdge({hAttachedId, kAttachedId}, true);
+  attachedToGraph.AddEdge({kAttachedId, hAttachedId}, true);
+
+  sdf::ResolvedPoses resolved;
+  sdf::Errors errors =
+      sdf::resolveAllPoses(resolved, poseGraph, attachedToGraph);
+
+  // X is disconnected, and H and K are attached to each other.
+  ASSERT_EQ(3u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR, errors[0].Code());
+  EXPECT_NE(std::string::npos,
+      errors[0].Message().find("unable to find path to source vertex"));
+  EXPECT_EQ(sdf::ErrorCode::FRAME_ATTACHED_TO_CYCLE, errors[1].Code());
+  EXPECT_EQ(sdf::ErrorCode::FRAME_ATTACHED_TO_CYCLE, errors[2].Code());
+
+  ASSERT_LT(xId, resolved.poses.size());
+  EXPECT_EQ(resolved.poses.size(), resolved.resolved.size());
+  EXPECT_EQ(resolved.poses.size(), resolved.attachedToBodies.size());
+  EXPECT_FALSE(resolved.resolved[xId]);
+  EXPECT_EQ(0u, resolved.index.count("X"));
+  EXPECT_EQ(6u, resolved.index.size());
+
+  // Every resolved pose and body matches the one resolved on its own.
+  for (const auto &[name, id] : resolved.index)
+  {
+    EXPECT_EQ(poseGraph.VertexIdByName(name), id);
+    ASSERT_TRUE(resolved.resolved[id]);
+    Pose pose;
+    EXPECT_TRUE(sdf::resolvePoseRelativeToRoot(pose, poseGraph, name).empty());
+    EXPECT_EQ(pose, resolved.poses[id]) << name;
+
+    std::string body;
+    if (sdf::resolveFrameAttachedToBody(body, attachedToGraph, name).empty())
+    {
+      EXPECT_EQ(body, resolved.attachedToBodies[id]) << name;
+    }
+    else
+    {
+      EXPECT_TRUE(resolved.attachedToBodies[id].empty()) << name;
+    }
+  }
+  EXPECT_EQ(Pose(2, 1, 0, 0, IGN_PI/2, 0), resolved.poses[gId]);
+  EXPECT_EQ(Pose(0, 0, 5, 0, 0, 0), resolved.poses[kId]);
+  EXPECT_EQ("L", resolved.attachedToBodies[modelId]);
+  EXPECT_EQ("L", resolved.attachedToBodies[gId]);
+  EXPECT_TRUE(resolved.attachedToBodies[hId].empty());
+
+  // The poses are cached for later queries.
+  Pose cached;
+  EXPECT_TRUE(poseGraph.PoseCache().Find(modelId, gId, cached));
+  EXPECT_EQ(resolved.poses[gId], cached);
+
+  // Without a FrameAttachedToGraph only the poses are resolved.
+  errors = sdf::resolveAllPoses(resolved, poseGraph);
+  EXPECT_EQ(1u, errors.size());
+  EXPECT_EQ(6u, resolved.index.size());
+  EXPECT_TRUE(resolved.attachedToBodies.empty());
+}
+
+/////////////////////////////////////////////////
+TEST(FrameSemantics, IncrementalUpdates)
+{
+  using Pose = ignition::math::Pose3d;
+
+  auto ownedPoseGraph = std::make_shared<sdf::PoseRelativeToGraph>();
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> poseGraph(ownedPoseGraph);
+  poseGraph = poseGraph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  const auto modelId = poseGraph.ScopeVertexId();
+  const auto lId = poseGraph.AddVertex("L", sdf::FrameType::LINK).Id();
+  const auto mId = poseGraph.AddVertex("M", sdf::FrameType::LINK).Id();
+  poseGraph.AddEdge({modelId, lId}, Pose(1, 0, 0, 0, 0, 0));
+  poseGraph.AddEdge({modelId, mId}, Pose(0, 1, 0, 0, 0, 0));
+
+  auto ownedAttachedToGraph = std::make_shared<sdf::FrameAttachedToGraph>();
+  sdf::ScopedGraph<sdf::FrameAttachedToGraph> attachedToGraph(
+      ownedAttachedToGraph);
+  attachedToGraph = attachedToGraph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  const auto lAttachedId =
+      attachedToGraph.AddVertex("L", sdf::FrameType::LINK).Id();
+  attachedToGraph.AddVertex("M", sdf::FrameType::LINK);
+  attachedToGraph.AddEdge(
+      {attachedToGraph.ScopeVertexId(), lAttachedId}, true);
+
+  // F is attached to the model frame and G to F, H is relative to G.
+  EXPECT_TRUE(sdf::addFrameToGraphs(attachedToGraph, poseGraph,
+      "F", "", "L", Pose(0, 0, 1, 0, 0, 0)).empty());
+  EXPECT_TRUE(sdf::addFrameToGraphs(attachedToGraph, poseGraph,
+      "G", "F", "", Pose(0, 0, 2, 0, 0, 0)).empty());
+  EXPECT_TRUE(sdf::addFrameToGraphs(attachedToGraph, poseGraph,
+      "H", "M", "G", Pose(0, 0, 3, 0, 0, 0)).empty());
+  EXPECT_TRUE(sdf::validateFrameAttachedToGraph(attachedToGraph).empty());
+  EXPECT_TRUE(sdf::validatePoseRelativeToGraph(poseGraph).empty());
+
+  // The new frames are validated and cached as they are added.
+  auto &cache = poseGraph.PoseCache();
+  const auto hId = poseGraph.VertexIdByName("H");
+  Pose pose;
+  EXPECT_TRUE(cache.Find(modelId, hId, pose));
+  EXPECT_EQ(Pose(1, 0, 6, 0, 0, 0), pose);
+  std::string body;
+  EXPECT_TRUE(
+      sdf::resolveFrameAttachedToBody(body, attachedToGraph, "G").empty());
+  EXPECT_EQ("L", body);
+
+  // Invalid frames are not added.
+  auto errors = sdf::addFrameToGraphs(
+      attachedToGraph, poseGraph, "F", "", "", Pose::Zero);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::DUPLICATE_NAME, errors[0].Code());
+  errors = sdf::addFrameToGraphs(
+      attachedToGraph, poseGraph, "X", "missing", "X", Pose::Zero);
+  ASSERT_EQ(2u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::FRAME_ATTACHED_TO_INVALID, errors[0].Code());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_CYCLE, errors[1].Code());
+  EXPECT_EQ(0u, poseGraph.Count("X"));
+  EXPECT_EQ(0u, attachedToGraph.Count("X"));
+
+  // Moving a frame only invalidates the poses of the frames below it.
+  const auto fId = poseGraph.VertexIdByName("F");
+  const auto gId = poseGraph.VertexIdByName("G");
+  EXPECT_TRUE(cache.Find(modelId, lId, pose));
+  EXPECT_TRUE(sdf::updatePoseRelativeToGraph(
+      poseGraph, "G", Pose(0, 0, -2, 0, 0, 0)).empty());
+  EXPECT_TRUE(cache.Find(modelId, fId, pose));
+  EXPECT_FALSE(cache.Find(modelId, gId, pose));
+  EXPECT_FALSE(cache.Find(modelId, hId, pose));
+  EXPECT_TRUE(sdf::resolvePoseRelativeToRoot(pose, poseGraph, "H").empty());
+  EXPECT_EQ(Pose(1, 0, 2, 0, 0, 0), pose);
+
+  // Re-parenting a frame revalidates and caches the frames below it.
+  EXPECT_TRUE(sdf::updatePoseRelativeToGraph(
+      poseGraph, "G", "M", Pose(0, 0, 2, 0, 0, 0)).empty());
+  EXPECT_TRUE(cache.Find(modelId, hId, pose));
+  EXPECT_EQ(Pose(0, 1, 5, 0, 0, 0), pose);
+  EXPECT_TRUE(sdf::validatePoseRelativeToGraph(poseGraph).empty());
+
+  // A change that would make a cycle is rejected and rolled back.
+  errors = sdf::updatePoseRelativeToGraph(
+      poseGraph, "G", "H", Pose::Zero);
+  ASSERT_FALSE(errors.empty());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_CYCLE, errors[0].Code());
+  EXPECT_TRUE(sdf::validatePoseRelativeToGraph(poseGraph).empty());
+  EXPECT_TRUE(sdf::resolvePoseRelativeToRoot(pose, poseGraph, "H").empty());
+  EXPECT_EQ(Pose(0, 1, 5, 0, 0, 0), pose);
+
+  errors = sdf::updateFrameAttachedToGraph(attachedToGraph, "F", "G");
+  ASSERT_FALSE(errors.empty());
+  EXPECT_EQ(sdf::ErrorCode::FRAME_ATTACHED_TO_CYCLE, errors[0].Code());
+  EXPECT_TRUE(sdf::validateFrameAttachedToGraph(attachedToGraph).empty());
+
+  // Attaching F to M also moves G.
+  EXPECT_TRUE(
+      sdf::updateFrameAttachedToGraph(attachedToGraph, "F", "M").empty());
+  EXPECT_TRUE(
+      sdf::resolveFrameAttachedToBody(body, attachedToGraph, "G").empty());
+  EXPECT_EQ("M", body);
+
+  // Frames that others depend on cannot be removed.
+  errors = sdf::removeFrameFromGraphs(attachedToGraph, poseGraph, "G");
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR, errors[0].Code());
+  errors = sdf::removeFrameFromGraphs(attachedToGraph, poseGraph, "F");
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR, errors[0].Code());
+
+  EXPECT_TRUE(
+      sdf::removeFrameFromGraphs(attachedToGraph, poseGraph, "H").empty());
+  EXPECT_TRUE(
+      sdf::removeFrameFromGraphs(attachedToGraph, poseGraph, "G").empty());
+  EXPECT_TRUE(
+      sdf::removeFrameFromGraphs(attachedToGraph, poseGraph, "F").empty());
+  EXPECT_EQ(0u, poseGraph.Count("H"));
+  EXPECT_FALSE(cache.Find(modelId, hId, pose));
+  EXPECT_TRUE(sdf::validateFrameAttachedToGraph(attachedToGraph).empty());
+  EXPECT_TRUE(sdf::validatePoseRelativeToGraph(poseGraph).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(FrameSemantics, ScopedNameLookup)
+{
+  // Keys that split the same full name at different places are equal.
+  const sdf::ScopedName::Hash hash;
+  const sdf::ScopedName full("M::N::L");
+  for (const auto &key : {sdf::ScopedName("M::N", "L"),
+                          sdf::ScopedName("M", "N::L"),
+                          sdf::ScopedName("", "M::N::L")})
+  {
+    EXPECT_TRUE(full == key);
+    EXPECT_TRUE(key == full);
+    EXPECT_EQ(hash(full), hash(key));
+  }
+  EXPECT_FALSE(full == sdf::ScopedName("M::N", "L2"));
+  EXPECT_FALSE(full == sdf::ScopedName("M", "N"));
+  EXPECT_FALSE(full == sdf::ScopedName("M:", ":N::L"));
+  EXPECT_TRUE(sdf::ScopedName("") == sdf::ScopedName("", ""));
+
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> graph(
+      std::make_shared<sdf::PoseRelativeToGraph>());
+  graph = graph.AddScopeVertex("", "world", "world", sdf::FrameType::WORLD);
+  auto modelGraph = graph.AddScopeVertex(
+      "M", "__model__", "__model__", sdf::FrameType::MODEL);
+  const auto linkId = modelGraph.AddVertex("L", sdf::FrameType::LINK).Id();
+  graph.AddVertex("L", sdf::FrameType::FRAME);
+
+  // The same vertex can be looked up from each scope.
+  EXPECT_EQ(linkId, modelGraph.VertexIdByName("L"));
+  EXPECT_EQ(linkId, graph.VertexIdByName("M::L"));
+  EXPECT_NE(linkId, graph.VertexIdByName("L"));
+  EXPECT_EQ(1u, graph.Count("M::L"));
+  EXPECT_EQ(0u, modelGraph.Count("M::L"));
+  EXPECT_EQ(ignition::math::graph::kNullId, graph.VertexIdByName("M"));
+
+  EXPECT_EQ(std::vector<std::string>({"L", "__model__"}),
+      modelGraph.VertexNames());
+  EXPECT_TRUE(modelGraph.RemoveVertex("L"));
+  EXPECT_EQ(0u, graph.Count("M::L"));
+  EXPECT_EQ(1u, graph.Count("L"));
+}
+
+/////////////////////////////////////////////////
+TEST(FrameSemantics, findPathEnds)
+{
+  using Pose = ignition::math::Pose3d;
+
+  // L is attached to the model frame and F to L, C1 -> C2 -> C3 -> C1 is a
+  // cycle that T leads to, and D is attached to nothing.
+  sdf::ScopedGraph<sdf::FrameAttachedToGraph> attachedToGraph(
+      std::make_shared<sdf::FrameAttachedToGraph>());
+  attachedToGraph = attachedToGraph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  std::map<std::string, ignition::math::graph::VertexId> ids;
+  for (const std::string name : {"L", "F", "C1", "C2", "C3", "T", "D"})
+  {
+    ids[name] = attachedToGraph.AddVertex(name,
+        name == "L" ? sdf::FrameType::LINK : sdf::FrameType::FRAME).Id();
+  }
+  attachedToGraph.AddEdge(
+      {attachedToGraph.ScopeVertexId(), ids["L"]}, true);
+  attachedToGraph.AddEdge({ids["F"], ids["L"]}, true);
+  attachedToGraph.AddEdge({ids["C1"], ids["C2"]}, true);
+  attachedToGraph.AddEdge({ids["C2"], ids["C3"]}, true);
+  attachedToGraph.AddEdge({ids["C3"], ids["C1"]}, true);
+  attachedToGraph.AddEdge({ids["T"], ids["C2"]}, true);
+
+  const sdf::FrozenGraph<sdf::FrameAttachedToGraph> attachedTo(
+      attachedToGraph);
+  const std::size_t kNullIndex =
+      sdf::FrozenGraph<sdf::FrameAttachedToGraph>::kNullIndex;
+  sdf::FramePathEnds sinks;
+  sdf::findSinkVertices(sinks, attachedTo);
+  ASSERT_EQ(attachedTo.VertexCount(), sinks.ends.size());
+  auto sink = [&](const std::string &_name)
+  {
+    return sinks.ends[attachedTo.IndexByName(_name)];
+  };
+  EXPECT_EQ(attachedTo.IndexByName("L"), sink("__model__"));
+  EXPECT_EQ(attachedTo.IndexByName("L"), sink("F"));
+  EXPECT_EQ(attachedTo.IndexByName("D"), sink("D"));
+  for (const std::string name : {"C1", "C2", "C3", "T"})
+  {
+    EXPECT_EQ(kNullIndex, sink(name)) << name;
+  }
+  ASSERT_EQ(1u, sinks.cycles.size());
+  std::set<std::string> members;
+  for (const auto index : sinks.cycles[0])
+  {
+    members.insert(attachedTo.LocalName(index));
+  }
+  EXPECT_EQ(std::set<std::string>({"C1", "C2", "C3"}), members);
+
+  // The errors of the single pass match the errors of resolving each frame.
+  const auto errors = sdf::validateFrameAttachedToGraph(attachedToGraph);
+  std::size_t cycleErrors = 0;
+  for (const auto &error : errors)
+  {
+    cycleErrors += error.Code() == sdf::ErrorCode::FRAME_ATTACHED_TO_CYCLE;
+  }
+  EXPECT_EQ(4u, cycleErrors);
+
+  // A has two incoming edges, so B below it has no source either.
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> poseGraph(
+      std::make_shared<sdf::PoseRelativeToGraph>());
+  poseGraph = poseGraph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  const auto lId = poseGraph.AddVertex("L", sdf::FrameType::LINK).Id();
+  const auto mId = poseGraph.AddVertex("M", sdf::FrameType::LINK).Id();
+  const auto aId = poseGraph.AddVertex("A", sdf::FrameType::FRAME).Id();
+  const auto bId = poseGraph.AddVertex("B", sdf::FrameType::FRAME).Id();
+  poseGraph.AddEdge({poseGraph.ScopeVertexId(), lId}, Pose::Zero);
+  poseGraph.AddEdge({lId, mId}, Pose::Zero);
+  poseGraph.AddEdge({lId, aId}, Pose::Zero);
+  poseGraph.AddEdge({mId, aId}, Pose::Zero);
+  poseGraph.AddEdge({aId, bId}, Pose::Zero);
+
+  const sdf::FrozenGraph<sdf::PoseRelativeToGraph> relativeTo(poseGraph);
+  sdf::FramePathEnds sources;
+  sdf::findSourceVertices(sources, relativeTo);
+  auto source = [&](const std::string &_name)
+  {
+    return sources.ends[relativeTo.IndexByName(_name)];
+  };
+  EXPECT_EQ(relativeTo.ScopeIndex(), source("__model__"));
+  EXPECT_EQ(relativeTo.ScopeIndex(), source("L"));
+  EXPECT_EQ(relativeTo.ScopeIndex(), source("M"));
+  EXPECT_EQ(relativeTo.IndexByName("A"), source("A"));
+  EXPECT_EQ(relativeTo.IndexByName("A"), source("B"));
+  EXPECT_TRUE(sources.cycles.empty());
+  EXPECT_FALSE(sdf::validatePoseRelativeToGraph(poseGraph).empty());
+}
+
 /////////////////////////////////////////////////
 TEST(NestedFrameSemantics, buildFrameAttachedToGraph_Model)
 {
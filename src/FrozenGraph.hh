@@ -0,0 +1,373 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef SDF_FROZEN_GRAPH_HH
+#define SDF_FROZEN_GRAPH_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/graph/Graph.hh>
+
+#include "sdf/sdf_config.h"
+#include "ScopedGraph.hh"
+
+namespace sdf
+{
+// Inline bracket to help doxygen filtering.
+inline namespace SDF_VERSION_NAMESPACE {
+
+/// \brief Read-only copy of a FrameAttachedToGraph or PoseRelativeToGraph in
+/// compressed sparse row (CSR) form.
+///
+/// ignition::math::graph::DirectedGraph keeps its vertices and edges in
+/// std::maps, and IncidentsTo / IncidentsFrom build a new map on every call.
+/// A FrozenGraph renumbers the vertices with dense indices and stores the
+/// incoming and outgoing edges of each vertex in contiguous arrays, so
+/// following edges neither allocates nor searches. It is meant for the
+/// read-mostly phase after a graph has been built, and does not track later
+/// changes to the graph: it has to be frozen again after those.
+///
+/// The whole graph is frozen, but name lookups are relative to the scope of
+/// the ScopedGraph it was frozen from, as with ScopedGraph.
+template <typename T>
+class FrozenGraph
+{
+  // Type aliases
+  public: using VertexId = ignition::math::graph::VertexId;
+  public: using VertexType = typename ScopedGraph<T>::VertexType;
+  public: using EdgeType = typename ScopedGraph<T>::EdgeType;
+
+  /// \brief Dense index of a vertex.
+  public: using Index = std::size_t;
+
+  /// \brief Index of a vertex that is not in the graph.
+  public: static constexpr Index kNullIndex =
+              std::numeric_limits<Index>::max();
+
+  /// \brief An edge as seen from one of its vertices.
+  public: struct Edge
+  {
+    /// \brief Index of the vertex at the other end of the edge.
+    Index vertex;
+
+    /// \brief Weight of the edge.
+    double weight;
+
+    /// \brief Edge data.
+    EdgeType data;
+  };
+
+  /// \brief Contiguous range of the edges of a vertex.
+  public: class EdgeRange
+  {
+    /// \brief Constructor.
+    /// \param[in] _begin First edge of the range.
+    /// \param[in] _end One past the last edge of the range.
+    public: EdgeRange(const Edge *_begin, const Edge *_end)
+        : first(_begin), last(_end)
+    {
+    }
+
+    /// \brief First edge of the range.
+    public: const Edge *begin() const { return this->first; }
+
+    /// \brief One past the last edge of the range.
+    public: const Edge *end() const { return this->last; }
+
+    /// \brief Number of edges in the range.
+    public: std::size_t size() const
+    {
+      return static_cast<std::size_t>(this->last - this->first);
+    }
+
+    /// \brief Whether the range is empty.
+    public: bool empty() const { return this->first == this->last; }
+
+    /// \brief First edge of the range.
+    private: const Edge *first;
+
+    /// \brief One past the last edge of the range.
+    private: const Edge *last;
+  };
+
+  /// \brief Default constructor. The constructed graph is empty.
+  public: FrozenGraph() = default;
+
+  /// \brief Freeze the graph of a scope.
+  /// \param[in] _graph Scope whose underlying graph is frozen.
+  public: explicit FrozenGraph(const ScopedGraph<T> &_graph);
+
+  /// \brief Get the scope the graph was frozen from.
+  /// \return The scope.
+  public: const ScopedGraph<T> &Scope() const;
+
+  /// \brief Get the number of vertices.
+  /// \return Number of vertices in the whole graph.
+  public: std::size_t VertexCount() const;
+
+  /// \brief Get the index of the scope vertex.
+  /// \return Index of the scope vertex, or kNullIndex if the scope has none.
+  public: Index ScopeIndex() const;
+
+  /// \brief Get the index of a vertex from its id.
+  /// \param[in] _id Id of the vertex in the frozen graph.
+  /// \return Index of the vertex, or kNullIndex if there is none.
+  public: Index IndexOf(VertexId _id) const;
+
+  /// \brief Get the index of a vertex from its local name in the scope.
+  /// \param[in] _name Local name of the vertex.
+  /// \return Index of the vertex, or kNullIndex if there is none.
+  public: Index IndexByName(const std::string &_name) const;
+
+  /// \brief Get the indices of the vertices of the scope, in the same order
+  /// as ScopedGraph::VertexNames.
+  /// \return Indices of the vertices of the scope.
+  public: const std::vector<Index> &ScopeIndices() const;
+
+  /// \brief Get the id of a vertex.
+  /// \param[in] _index Index of the vertex.
+  /// \return Id of the vertex in the frozen graph.
+  public: VertexId Id(Index _index) const;
+
+  /// \brief Get the local name of a vertex, as ScopedGraph::VertexLocalName.
+  /// \param[in] _index Index of the vertex.
+  /// \return Local name of the vertex.
+  public: const std::string &LocalName(Index _index) const;
+
+  /// \brief Get the data of a vertex.
+  /// \param[in] _index Index of the vertex.
+  /// \return Vertex data.
+  public: const VertexType &Data(Index _index) const;
+
+  /// \brief Get the incoming edges of a vertex.
+  /// \param[in] _index Index of the vertex.
+  /// \return Incoming edges, whose vertex is the tail of the edge.
+  public: EdgeRange InEdges(Index _index) const;
+
+  /// \brief Get the outgoing edges of a vertex.
+  /// \param[in] _index Index of the vertex.
+  /// \return Outgoing edges, whose vertex is the head of the edge.
+  public: EdgeRange OutEdges(Index _index) const;
+
+  /// \brief Scope the graph was frozen from.
+  private: ScopedGraph<T> scope;
+
+  /// \brief Index of the scope vertex.
+  private: Index scopeIndex = kNullIndex;
+
+  /// \brief Vertex id of each index.
+  private: std::vector<VertexId> ids;
+
+  /// \brief Index of each vertex id.
+  private: std::vector<Index> indices;
+
+  /// \brief Local name of each vertex.
+  private: std::vector<std::string> localNames;
+
+  /// \brief Data of each vertex.
+  private: std::vector<VertexType> vertexData;
+
+  /// \brief Indices of the vertices of the scope, ordered by name.
+  private: std::vector<Index> scopeIndices;
+
+  /// \brief Index of each local name of the scope.
+  private: std::unordered_map<std::string, Index> nameIndices;
+
+  /// \brief The incoming edges of vertex i are
+  /// inEdges[inOffsets[i], inOffsets[i + 1]).
+  private: std::vector<std::size_t> inOffsets;
+
+  /// \brief Incoming edges of all the vertices.
+  private: std::vector<Edge> inEdges;
+
+  /// \brief The outgoing edges of vertex i are
+  /// outEdges[outOffsets[i], outOffsets[i + 1]).
+  private: std::vector<std::size_t> outOffsets;
+
+  /// \brief Outgoing edges of all the vertices.
+  private: std::vector<Edge> outEdges;
+};
+
+/////////////////////////////////////////////////
+template <typename T>
+FrozenGraph<T>::FrozenGraph(const ScopedGraph<T> &_graph)
+    : scope(_graph)
+{
+  const auto &graph = _graph.Graph();
+
+  for (const auto &vertexPair : graph.Vertices())
+  {
+    const auto &vertex = vertexPair.second.get();
+    if (vertex.Id() >= this->indices.size())
+    {
+      this->indices.resize(vertex.Id() + 1, kNullIndex);
+    }
+    this->indices[vertex.Id()] = this->ids.size();
+    this->ids.push_back(vertex.Id());
+    this->localNames.push_back(_graph.VertexLocalName(vertex));
+    this->vertexData.push_back(vertex.Data());
+  }
+  this->scopeIndex = this->IndexOf(_graph.ScopeVertexId());
+
+  for (const auto &namePair : _graph.Map())
+  {
+    auto localName = _graph.FindAndRemovePrefix(namePair.first.Name());
+    const Index index = this->IndexOf(namePair.second);
+    if (localName.second && index != kNullIndex)
+    {
+      this->scopeIndices.push_back(index);
+      this->nameIndices.emplace(std::move(localName.first), index);
+    }
+  }
+  std::sort(this->scopeIndices.begin(), this->scopeIndices.end(),
+      [this](Index _first, Index _second)
+      {
+        return this->localNames[_first] < this->localNames[_second];
+      });
+
+  // Count the edges of each vertex, then turn the counts into offsets.
+  const std::size_t count = this->ids.size();
+  this->inOffsets.assign(count + 1, 0);
+  this->outOffsets.assign(count + 1, 0);
+  const auto edges = graph.Edges();
+  for (const auto &edgePair : edges)
+  {
+    const auto &edge = edgePair.second.get();
+    ++this->inOffsets[this->IndexOf(edge.Head()) + 1];
+    ++this->outOffsets[this->IndexOf(edge.Tail()) + 1];
+  }
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    this->inOffsets[i + 1] += this->inOffsets[i];
+    this->outOffsets[i + 1] += this->outOffsets[i];
+  }
+
+  // Fill the edges in order of edge id, which keeps the edges of each vertex
+  // in the order IncidentsTo and IncidentsFrom return them.
+  std::vector<std::size_t> inNext(
+      this->inOffsets.begin(), this->inOffsets.end() - 1);
+  std::vector<std::size_t> outNext(
+      this->outOffsets.begin(), this->outOffsets.end() - 1);
+  this->inEdges.resize(edges.size(), {kNullIndex, 0.0, EdgeType()});
+  this->outEdges.resize(edges.size(), {kNullIndex, 0.0, EdgeType()});
+  for (const auto &edgePair : edges)
+  {
+    const auto &edge = edgePair.second.get();
+    const Index tail = this->IndexOf(edge.Tail());
+    const Index head = this->IndexOf(edge.Head());
+    this->inEdges[inNext[head]++] = {tail, edge.Weight(), edge.Data()};
+    this->outEdges[outNext[tail]++] = {head, edge.Weight(), edge.Data()};
+  }
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+const ScopedGraph<T> &FrozenGraph<T>::Scope() const
+{
+  return this->scope;
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+std::size_t FrozenGraph<T>::VertexCount() const
+{
+  return this->ids.size();
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+auto FrozenGraph<T>::ScopeIndex() const -> Index
+{
+  return this->scopeIndex;
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+auto FrozenGraph<T>::IndexOf(VertexId _id) const -> Index
+{
+  if (_id >= this->indices.size())
+  {
+    return kNullIndex;
+  }
+  return this->indices[_id];
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+auto FrozenGraph<T>::IndexByName(const std::string &_name) const -> Index
+{
+  auto it = this->nameIndices.find(_name);
+  if (it == this->nameIndices.end())
+  {
+    return kNullIndex;
+  }
+  return it->second;
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+auto FrozenGraph<T>::ScopeIndices() const -> const std::vector<Index> &
+{
+  return this->scopeIndices;
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+auto FrozenGraph<T>::Id(Index _index) const -> VertexId
+{
+  return this->ids[_index];
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+const std::string &FrozenGraph<T>::LocalName(Index _index) const
+{
+  return this->localNames[_index];
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+auto FrozenGraph<T>::Data(Index _index) const -> const VertexType &
+{
+  return this->vertexData[_index];
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+auto FrozenGraph<T>::InEdges(Index _index) const -> EdgeRange
+{
+  const Edge *edges = this->inEdges.data();
+  return EdgeRange(edges + this->inOffsets[_index],
+      edges + this->inOffsets[_index + 1]);
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+auto FrozenGraph<T>::OutEdges(Index _index) const -> EdgeRange
+{
+  const Edge *edges = this->outEdges.data();
+  return EdgeRange(edges + this->outOffsets[_index],
+      edges + this->outOffsets[_index + 1]);
+}
+}
+}
+#endif
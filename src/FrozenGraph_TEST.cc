@@ -0,0 +1,239 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "FrameSemantics.hh"
+#include "FrozenGraph.hh"
+#include "ScopedGraph.hh"
+
+using Pose = ignition::math::Pose3d;
+
+/////////////////////////////////////////////////
+/// \brief Graphs of a model whose frames form a binary tree below a link.
+struct ModelGraphs
+{
+  /// \brief Constructor.
+  /// \param[in] _frameCount Number of frames.
+  explicit ModelGraphs(std::size_t _frameCount)
+  {
+    this->pose = this->pose.AddScopeVertex(
+        "", "__model__", "__model__", sdf::FrameType::MODEL);
+    this->attachedTo = this->attachedTo.AddScopeVertex(
+        "", "__model__", "__model__", sdf::FrameType::MODEL);
+
+    const auto linkPoseId =
+        this->pose.AddVertex("L", sdf::FrameType::LINK).Id();
+    const auto linkAttachedToId =
+        this->attachedTo.AddVertex("L", sdf::FrameType::LINK).Id();
+    this->pose.AddEdge(
+        {this->pose.ScopeVertexId(), linkPoseId}, Pose(1, 0, 0, 0, 0, 0));
+    this->attachedTo.AddEdge(
+        {this->attachedTo.ScopeVertexId(), linkAttachedToId}, true);
+
+    std::vector<ignition::math::graph::VertexId> poseIds;
+    std::vector<ignition::math::graph::VertexId> attachedToIds;
+    for (std::size_t i = 0; i < _frameCount; ++i)
+    {
+      const std::string name = "F" + std::to_string(i);
+      poseIds.push_back(
+          this->pose.AddVertex(name, sdf::FrameType::FRAME).Id());
+      attachedToIds.push_back(
+          this->attachedTo.AddVertex(name, sdf::FrameType::FRAME).Id());
+      const auto poseParent = i == 0 ? linkPoseId : poseIds[(i - 1) / 2];
+      const auto attachedToParent =
+          i == 0 ? linkAttachedToId : attachedToIds[(i - 1) / 2];
+      this->pose.AddEdge({poseParent, poseIds.back()},
+          Pose(0.1, 0, 0, 0, 0, IGN_PI / 8));
+      this->attachedTo.AddEdge({attachedToIds.back(), attachedToParent}, true);
+    }
+  }
+
+  /// \brief PoseRelativeTo graph.
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> pose{
+      std::make_shared<sdf::PoseRelativeToGraph>()};
+
+  /// \brief FrameAttachedTo graph.
+  sdf::ScopedGraph<sdf::FrameAttachedToGraph> attachedTo{
+      std::make_shared<sdf::FrameAttachedToGraph>()};
+};
+
+/////////////////////////////////////////////////
+TEST(FrozenGraph, Construction)
+{
+  sdf::FrozenGraph<sdf::PoseRelativeToGraph> empty;
+  EXPECT_EQ(0u, empty.VertexCount());
+  EXPECT_EQ(sdf::FrozenGraph<sdf::PoseRelativeToGraph>::kNullIndex,
+      empty.ScopeIndex());
+  EXPECT_EQ(sdf::FrozenGraph<sdf::PoseRelativeToGraph>::kNullIndex,
+      empty.IndexByName("__model__"));
+
+  ModelGraphs graphs(6);
+  sdf::FrozenGraph<sdf::PoseRelativeToGraph> frozen(graphs.pose);
+  EXPECT_EQ(8u, frozen.VertexCount());
+  EXPECT_EQ(8u, frozen.ScopeIndices().size());
+
+  const auto modelIndex = frozen.ScopeIndex();
+  EXPECT_EQ(modelIndex, frozen.IndexByName("__model__"));
+  EXPECT_EQ(graphs.pose.ScopeVertexId(), frozen.Id(modelIndex));
+  EXPECT_EQ("__model__", frozen.LocalName(modelIndex));
+  EXPECT_EQ(sdf::FrameType::MODEL, frozen.Data(modelIndex));
+  EXPECT_TRUE(frozen.InEdges(modelIndex).empty());
+  ASSERT_EQ(1u, frozen.OutEdges(modelIndex).size());
+
+  const auto linkIndex = frozen.IndexByName("L");
+  EXPECT_EQ(linkIndex, frozen.OutEdges(modelIndex).begin()->vertex);
+  EXPECT_EQ(Pose(1, 0, 0, 0, 0, 0),
+      frozen.OutEdges(modelIndex).begin()->data);
+  EXPECT_EQ(linkIndex, frozen.IndexOf(graphs.pose.VertexIdByName("L")));
+
+  // F0 has children F1 and F2, in order of edge id.
+  const auto f0Index = frozen.IndexByName("F0");
+  ASSERT_EQ(1u, frozen.InEdges(f0Index).size());
+  EXPECT_EQ(linkIndex, frozen.InEdges(f0Index).begin()->vertex);
+  ASSERT_EQ(2u, frozen.OutEdges(f0Index).size());
+  EXPECT_EQ(frozen.IndexByName("F1"),
+      frozen.OutEdges(f0Index).begin()[0].vertex);
+  EXPECT_EQ(frozen.IndexByName("F2"),
+      frozen.OutEdges(f0Index).begin()[1].vertex);
+  EXPECT_TRUE(frozen.OutEdges(frozen.IndexByName("F5")).empty());
+
+  EXPECT_EQ(sdf::FrozenGraph<sdf::PoseRelativeToGraph>::kNullIndex,
+      frozen.IndexByName("F6"));
+  EXPECT_EQ(sdf::FrozenGraph<sdf::PoseRelativeToGraph>::kNullIndex,
+      frozen.IndexOf(ignition::math::graph::kNullId));
+}
+
+/////////////////////////////////////////////////
+TEST(FrozenGraph, Resolve)
+{
+  ModelGraphs graphs(20);
+  EXPECT_TRUE(sdf::validatePoseRelativeToGraph(graphs.pose).empty());
+  EXPECT_TRUE(sdf::validateFrameAttachedToGraph(graphs.attachedTo).empty());
+
+  sdf::FrozenGraph<sdf::PoseRelativeToGraph> frozenPose(graphs.pose);
+  sdf::FrozenGraph<sdf::FrameAttachedToGraph> frozenAttachedTo(
+      graphs.attachedTo);
+
+  for (const auto &name : graphs.pose.VertexNames())
+  {
+    Pose pose;
+    Pose frozenPoseValue;
+    EXPECT_TRUE(
+        sdf::resolvePoseRelativeToRoot(pose, graphs.pose, name).empty());
+    EXPECT_TRUE(sdf::resolvePoseRelativeToRoot(frozenPoseValue, frozenPose,
+          frozenPose.IndexByName(name)).empty());
+    EXPECT_EQ(pose, frozenPoseValue) << name;
+
+    EXPECT_TRUE(sdf::resolvePose(pose, graphs.pose, name, "F3").empty());
+    EXPECT_TRUE(
+        sdf::resolvePose(frozenPoseValue, frozenPose, name, "F3").empty());
+    EXPECT_EQ(pose, frozenPoseValue) << name;
+
+    std::string body;
+    std::string frozenBody;
+    EXPECT_TRUE(sdf::resolveFrameAttachedToBody(
+          body, graphs.attachedTo, name).empty());
+    EXPECT_TRUE(sdf::resolveFrameAttachedToBody(frozenBody, frozenAttachedTo,
+          frozenAttachedTo.IndexByName(name)).empty());
+    EXPECT_EQ("L", frozenBody);
+    EXPECT_EQ(body, frozenBody) << name;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(FrozenGraph, Errors)
+{
+  ModelGraphs graphs(2);
+
+  // F2 and F3 are relative to and attached to each other, F4 is not
+  // connected, and F5 is relative to and attached to two frames.
+  const auto f0PoseId = graphs.pose.VertexIdByName("F0");
+  const auto f1PoseId = graphs.pose.VertexIdByName("F1");
+  const auto f0AttachedToId = graphs.attachedTo.VertexIdByName("F0");
+  const auto f1AttachedToId = graphs.attachedTo.VertexIdByName("F1");
+  std::vector<ignition::math::graph::VertexId> poseIds;
+  std::vector<ignition::math::graph::VertexId> attachedToIds;
+  for (const std::string name : {"F2", "F3", "F4", "F5"})
+  {
+    poseIds.push_back(
+        graphs.pose.AddVertex(name, sdf::FrameType::FRAME).Id());
+    attachedToIds.push_back(
+        graphs.attachedTo.AddVertex(name, sdf::FrameType::FRAME).Id());
+  }
+  graphs.pose.AddEdge({poseIds[0], poseIds[1]}, Pose::Zero);
+  graphs.pose.AddEdge({poseIds[1], poseIds[0]}, Pose::Zero);
+  graphs.pose.AddEdge({f0PoseId, poseIds[3]}, Pose::Zero);
+  graphs.pose.AddEdge({f1PoseId, poseIds[3]}, Pose::Zero);
+  graphs.attachedTo.AddEdge({attachedToIds[0], attachedToIds[1]}, true);
+  graphs.attachedTo.AddEdge({attachedToIds[1], attachedToIds[0]}, true);
+  graphs.attachedTo.AddEdge({attachedToIds[3], f0AttachedToId}, true);
+  graphs.attachedTo.AddEdge({attachedToIds[3], f1AttachedToId}, true);
+
+  sdf::FrozenGraph<sdf::PoseRelativeToGraph> frozenPose(graphs.pose);
+  sdf::FrozenGraph<sdf::FrameAttachedToGraph> frozenAttachedTo(
+      graphs.attachedTo);
+
+  // The frozen graphs report the same errors as the original ones.
+  std::size_t poseErrorCount = 0;
+  std::size_t bodyErrorCount = 0;
+  for (const auto &name : graphs.pose.VertexNames())
+  {
+    Pose pose;
+    auto errors = sdf::resolvePoseRelativeToRoot(pose, graphs.pose, name);
+    auto frozenErrors = sdf::resolvePoseRelativeToRoot(
+        pose, frozenPose, frozenPose.IndexByName(name));
+    ASSERT_EQ(errors.size(), frozenErrors.size()) << name;
+    for (std::size_t i = 0; i < errors.size(); ++i)
+    {
+      EXPECT_EQ(errors[i].Code(), frozenErrors[i].Code());
+      EXPECT_EQ(errors[i].Message(), frozenErrors[i].Message());
+    }
+    poseErrorCount += errors.size();
+
+    std::string body;
+    errors = sdf::resolveFrameAttachedToBody(body, graphs.attachedTo, name);
+    frozenErrors = sdf::resolveFrameAttachedToBody(
+        body, frozenAttachedTo, frozenAttachedTo.IndexByName(name));
+    ASSERT_EQ(errors.size(), frozenErrors.size()) << name;
+    for (std::size_t i = 0; i < errors.size(); ++i)
+    {
+      EXPECT_EQ(errors[i].Code(), frozenErrors[i].Code());
+      EXPECT_EQ(errors[i].Message(), frozenErrors[i].Message());
+    }
+    bodyErrorCount += errors.size();
+  }
+  EXPECT_EQ(4u, poseErrorCount);
+  EXPECT_EQ(4u, bodyErrorCount);
+
+  Pose pose;
+  auto errors = sdf::resolvePoseRelativeToRoot(pose, frozenPose,
+      sdf::FrozenGraph<sdf::PoseRelativeToGraph>::kNullIndex);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_INVALID, errors[0].Code());
+
+  errors = sdf::resolvePose(pose, frozenPose, "F0", "missing");
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_INVALID, errors[0].Code());
+  EXPECT_NE(std::string::npos, errors[0].Message().find("[missing]"));
+}
@@ -19,8 +19,10 @@
 #include "sdf/Capsule.hh"
 #include "sdf/Cylinder.hh"
 #include "sdf/Ellipsoid.hh"
+#include "sdf/Heightmap.hh"
 #include "sdf/Mesh.hh"
 #include "sdf/Plane.hh"
+#include "sdf/Polyline.hh"
 #include "sdf/Sphere.hh"
 
 using namespace sdf;
@@ -52,6 +54,12 @@ class sdf::GeometryPrivate
   /// \brief Pointer to a mesh.
   public: std::unique_ptr<Mesh> mesh;
 
+  /// \brief Pointer to a heightmap.
+  public: std::unique_ptr<Heightmap> heightmap;
+
+  /// \brief Pointer to a polyline.
+  public: std::unique_ptr<Polyline> polyline;
+
   /// \brief The SDF element pointer used during load.
   public: sdf::ElementPtr sdf;
 };
@@ -115,6 +123,18 @@ Geometry::Geometry(const Geometry &_geometry)
     this->dataPtr->mesh = std::make_unique<sdf::Mesh>(*_geometry.dataPtr->mesh);
   }
 
+  if (_geometry.dataPtr->heightmap)
+  {
+    this->dataPtr->heightmap = std::make_unique<sdf::Heightmap>(
+        *_geometry.dataPtr->heightmap);
+  }
+
+  if (_geometry.dataPtr->polyline)
+  {
+    this->dataPtr->polyline = std::make_unique<sdf::Polyline>(
+        *_geometry.dataPtr->polyline);
+  }
+
   this->dataPtr->sdf = _geometry.dataPtr->sdf;
 }
 
@@ -212,6 +232,21 @@ Errors Geometry::Load(ElementPtr _sdf)
     Errors err = this->dataPtr->mesh->Load(_sdf->GetElement("mesh"));
     errors.insert(errors.end(), err.begin(), err.end());
   }
+  else if (_sdf->HasElement("heightmap"))
+  {
+    this->dataPtr->type = GeometryType::HEIGHTMAP;
+    this->dataPtr->heightmap.reset(new Heightmap());
+    Errors err = this->dataPtr->heightmap->Load(
+        _sdf->GetElement("heightmap"));
+    errors.insert(errors.end(), err.begin(), err.end());
+  }
+  else if (_sdf->HasElement("polyline"))
+  {
+    this->dataPtr->type = GeometryType::POLYLINE;
+    this->dataPtr->polyline.reset(new Polyline());
+    Errors err = this->dataPtr->polyline->Load(_sdf->GetElement("polyline"));
+    errors.insert(errors.end(), err.begin(), err.end());
+  }
 
   return errors;
 }
@@ -312,6 +347,30 @@ void Geometry::SetMeshShape(const Mesh &_mesh)
   this->dataPtr->mesh = std::make_unique<Mesh>(_mesh);
 }
 
+/////////////////////////////////////////////////
+const Heightmap *Geometry::HeightmapShape() const
+{
+  return this->dataPtr->heightmap.get();
+}
+
+/////////////////////////////////////////////////
+void Geometry::SetHeightmapShape(const Heightmap &_heightmap)
+{
+  this->dataPtr->heightmap = std::make_unique<Heightmap>(_heightmap);
+}
+
+/////////////////////////////////////////////////
+const Polyline *Geometry::PolylineShape() const
+{
+  return this->dataPtr->polyline.get();
+}
+
+/////////////////////////////////////////////////
+void Geometry::SetPolylineShape(const Polyline &_polyline)
+{
+  this->dataPtr->polyline = std::make_unique<Polyline>(_polyline);
+}
+
 /////////////////////////////////////////////////
 sdf::ElementPtr Geometry::Element() const
 {
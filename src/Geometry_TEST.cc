@@ -21,7 +21,9 @@
 #include "sdf/Cylinder.hh"
 #include "sdf/Ellipsoid.hh"
 #include "sdf/Geometry.hh"
+#include "sdf/Heightmap.hh"
 #include "sdf/Mesh.hh"
+#include "sdf/Polyline.hh"
 #include "sdf/Plane.hh"
 #include "sdf/Sphere.hh"
 
@@ -243,6 +245,49 @@ TEST(DOMGeometry, Mesh)
   EXPECT_TRUE(geom.MeshShape()->CenterSubmesh());
 }
 
+/////////////////////////////////////////////////
+TEST(DOMGeometry, Heightmap)
+{
+  sdf::Geometry geom;
+  geom.SetType(sdf::GeometryType::HEIGHTMAP);
+
+  sdf::Heightmap heightmap;
+  heightmap.SetUri("banana");
+  heightmap.SetSize(ignition::math::Vector3d(1, 2, 3));
+  heightmap.SetPosition(ignition::math::Vector3d(4, 5, 6));
+  geom.SetHeightmapShape(heightmap);
+
+  EXPECT_EQ(sdf::GeometryType::HEIGHTMAP, geom.Type());
+  ASSERT_NE(nullptr, geom.HeightmapShape());
+  EXPECT_EQ("banana", geom.HeightmapShape()->Uri());
+  EXPECT_EQ(ignition::math::Vector3d(1, 2, 3), geom.HeightmapShape()->Size());
+  EXPECT_EQ(ignition::math::Vector3d(4, 5, 6),
+      geom.HeightmapShape()->Position());
+
+  sdf::Geometry geom2(geom);
+  ASSERT_NE(nullptr, geom2.HeightmapShape());
+  EXPECT_EQ("banana", geom2.HeightmapShape()->Uri());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMGeometry, Polyline)
+{
+  sdf::Geometry geom;
+  geom.SetType(sdf::GeometryType::POLYLINE);
+
+  sdf::Polyline polyline;
+  polyline.SetHeight(1.2);
+  polyline.AddPoint({3.4, 5.6});
+  geom.SetPolylineShape(polyline);
+
+  EXPECT_EQ(sdf::GeometryType::POLYLINE, geom.Type());
+  ASSERT_NE(nullptr, geom.PolylineShape());
+  EXPECT_DOUBLE_EQ(1.2, geom.PolylineShape()->Height());
+  ASSERT_EQ(1u, geom.PolylineShape()->PointCount());
+  EXPECT_EQ(ignition::math::Vector2d(3.4, 5.6),
+      *geom.PolylineShape()->PointByIndex(0));
+}
+
 /////////////////////////////////////////////////
 TEST(DOMGeometry, Plane)
 {
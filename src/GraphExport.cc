@@ -0,0 +1,344 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+
+#include "GraphExport.hh"
+
+namespace sdf
+{
+// Inline bracket to help doxygen filtering.
+inline namespace SDF_VERSION_NAMESPACE {
+
+/////////////////////////////////////////////////
+/// \brief Get the name of a frame type.
+/// \param[in] _type Frame type.
+/// \return Name of the enumerator.
+static const char *frameTypeName(FrameType _type)
+{
+  switch (_type)
+  {
+    case FrameType::WORLD:
+      return "WORLD";
+    case FrameType::MODEL:
+      return "MODEL";
+    case FrameType::LINK:
+      return "LINK";
+    case FrameType::JOINT:
+      return "JOINT";
+    case FrameType::FRAME:
+      return "FRAME";
+    case FrameType::STATIC_MODEL:
+      return "STATIC_MODEL";
+    default:
+      return "INVALID";
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a string inside double quotes, escaping the quotes and
+/// backslashes it contains, as well as control characters in JSON.
+/// \param[out] _out Stream to write to.
+/// \param[in] _str String to write.
+/// \param[in] _format Format whose escapes are used.
+static void writeEscaped(std::ostream &_out, std::string_view _str,
+    GraphFormat _format)
+{
+  for (const char c : _str)
+  {
+    if (c == '"' || c == '\\')
+    {
+      _out << '\\' << c;
+    }
+    else if (_format == GraphFormat::JSON &&
+        static_cast<unsigned char>(c) < 0x20)
+    {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x",
+          static_cast<unsigned int>(c));
+      _out << escaped;
+    }
+    else
+    {
+      _out << c;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the JSON members of the data of a PoseRelativeTo edge.
+/// \param[out] _out Stream to write to.
+/// \param[in] _pose Pose of the edge.
+static void writeEdgeData(std::ostream &_out,
+    const ignition::math::Pose3d &_pose)
+{
+  const auto euler = _pose.Rot().Euler();
+  _out << ", \"pose\": [" << _pose.Pos().X() << ", " << _pose.Pos().Y()
+       << ", " << _pose.Pos().Z() << ", " << euler.X() << ", " << euler.Y()
+       << ", " << euler.Z() << "]";
+}
+
+/////////////////////////////////////////////////
+/// \brief The edges of FrameAttachedTo graphs have no data worth writing.
+static void writeEdgeData(std::ostream &, bool)
+{
+}
+
+/////////////////////////////////////////////////
+/// \brief Streams the vertices, then the edges, of a graph in a format.
+template <typename T>
+class GraphWriter
+{
+  /// \brief Constructor, which writes the beginning of the graph.
+  /// \param[out] _out Stream to write to.
+  /// \param[in] _format Output format.
+  public: GraphWriter(std::ostream &_out, GraphFormat _format)
+      : out(_out), format(_format)
+  {
+    if (this->format == GraphFormat::JSON)
+      this->out << "{\"vertices\": [";
+    else
+      this->out << "digraph {\n";
+  }
+
+  /// \brief Write a vertex. All the vertices are written before the edges.
+  /// \param[in] _vertex Vertex to write.
+  public: void WriteVertex(const typename ScopedGraph<T>::Vertex &_vertex)
+  {
+    if (this->format == GraphFormat::JSON)
+    {
+      this->out << (this->count++ ? ",\n" : "\n") << "  {\"id\": "
+                << _vertex.Id() << ", \"name\": \"";
+      writeEscaped(this->out, _vertex.Name(), this->format);
+      this->out << "\", \"type\": \"" << frameTypeName(_vertex.Data())
+                << "\"}";
+    }
+    else
+    {
+      this->out << "  " << _vertex.Id() << " [label=\"";
+      writeEscaped(this->out, _vertex.Name(), this->format);
+      this->out << " (" << _vertex.Id() << ")\"];\n";
+    }
+  }
+
+  /// \brief Write an edge.
+  /// \param[in] _edge Edge to write.
+  public: void WriteEdge(const typename ScopedGraph<T>::Edge &_edge)
+  {
+    if (this->format == GraphFormat::JSON)
+    {
+      if (!this->inEdges)
+      {
+        this->out << (this->count ? "\n" : "") << "], \"edges\": [";
+        this->inEdges = true;
+        this->count = 0;
+      }
+      this->out << (this->count++ ? ",\n" : "\n") << "  {\"id\": "
+                << _edge.Id() << ", \"tail\": " << _edge.Tail()
+                << ", \"head\": " << _edge.Head() << ", \"weight\": "
+                << _edge.Weight();
+      writeEdgeData(this->out, _edge.Data());
+      this->out << "}";
+    }
+    else
+    {
+      this->out << "  " << _edge.Tail() << " -> " << _edge.Head()
+                << " [label=" << _edge.Weight() << "];\n";
+    }
+  }
+
+  /// \brief Write the end of the graph.
+  public: void End()
+  {
+    if (this->format == GraphFormat::JSON)
+    {
+      if (!this->inEdges)
+        this->out << (this->count ? "\n" : "") << "], \"edges\": [";
+      else if (this->count)
+        this->out << "\n";
+      this->out << "]}\n";
+    }
+    else
+    {
+      this->out << "}\n";
+    }
+  }
+
+  /// \brief Stream to write to.
+  private: std::ostream &out;
+
+  /// \brief Output format.
+  private: GraphFormat format;
+
+  /// \brief Number of elements written in the current JSON array.
+  private: std::size_t count = 0;
+
+  /// \brief Whether the JSON edge array has begun.
+  private: bool inEdges = false;
+};
+
+/////////////////////////////////////////////////
+/// \brief Export a graph, or a subtree of it.
+/// \param[out] _out Stream to write to.
+/// \param[in] _graph Graph to export.
+/// \param[in] _options Format and filter of the export.
+/// \param[in] _reverse True if the edges of the graph point from the
+/// children to the parents of the subtrees, false if they point from the
+/// parents to the children.
+/// \param[in] _code Error code for a missing scope vertex.
+/// \return Errors.
+template <typename T>
+static Errors exportGraphImpl(std::ostream &_out,
+    const ScopedGraph<T> &_graph, const GraphExportOptions &_options,
+    bool _reverse, ErrorCode _code)
+{
+  using VertexId = ignition::math::graph::VertexId;
+  using EdgeId = ignition::math::graph::EdgeId;
+
+  Errors errors;
+  if (!_graph)
+  {
+    errors.push_back({_code, "Unable to export an empty graph."});
+    return errors;
+  }
+  const auto &graph = _graph.Graph();
+
+  // The whole graph is streamed straight from the graph, in the order of
+  // its operator<<.
+  if (_options.scope.empty() && _options.depth < 0)
+  {
+    GraphWriter<T> writer(_out, _options.format);
+    for (const auto &vertexPair : graph.Vertices())
+    {
+      writer.WriteVertex(vertexPair.second);
+    }
+    for (const auto &edgePair : graph.Edges())
+    {
+      writer.WriteEdge(edgePair.second);
+    }
+    writer.End();
+    return errors;
+  }
+
+  // The children of a vertex in the subtree.
+  auto childEdges = [&](VertexId _id)
+  {
+    return _reverse ? graph.IncidentsTo(_id) : graph.IncidentsFrom(_id);
+  };
+
+  // The walk starts at the scope vertex, or at the roots of the graph.
+  std::vector<VertexId> frontier;
+  if (!_options.scope.empty())
+  {
+    auto it = _graph.Map().find(ScopedName(std::string_view(),
+        _options.scope));
+    if (it == _graph.Map().end())
+    {
+      errors.push_back({_code, "Unable to find vertex with name [" +
+          _options.scope + "] in graph."});
+      return errors;
+    }
+    frontier.push_back(it->second);
+  }
+  else
+  {
+    for (const auto &vertexPair : graph.Vertices())
+    {
+      const VertexId id = vertexPair.first;
+      if ((_reverse ? graph.OutDegree(id) : graph.InDegree(id)) == 0)
+        frontier.push_back(id);
+    }
+  }
+
+  // Walk the subtree level by level, down to the maximum depth, visiting
+  // each vertex once even if the graph has cycles.
+  std::unordered_set<VertexId> visited(frontier.begin(), frontier.end());
+  std::vector<VertexId> vertexIds(frontier.begin(), frontier.end());
+  std::vector<VertexId> next;
+  for (int depth = 0; !frontier.empty() &&
+      (_options.depth < 0 || depth < _options.depth); ++depth)
+  {
+    next.clear();
+    for (const VertexId id : frontier)
+    {
+      for (const auto &edgePair : childEdges(id))
+      {
+        const auto &edge = edgePair.second.get();
+        const VertexId child = _reverse ? edge.Tail() : edge.Head();
+        if (visited.insert(child).second)
+          next.push_back(child);
+      }
+    }
+    vertexIds.insert(vertexIds.end(), next.begin(), next.end());
+    frontier.swap(next);
+  }
+
+  // Keep the edges between the exported vertices, in the order of the
+  // whole graph.
+  std::vector<EdgeId> edgeIds;
+  for (const VertexId id : vertexIds)
+  {
+    for (const auto &edgePair : graph.IncidentsFrom(id))
+    {
+      if (visited.count(edgePair.second.get().Head()))
+        edgeIds.push_back(edgePair.first);
+    }
+  }
+  std::sort(vertexIds.begin(), vertexIds.end());
+  std::sort(edgeIds.begin(), edgeIds.end());
+
+  GraphWriter<T> writer(_out, _options.format);
+  for (const VertexId id : vertexIds)
+  {
+    writer.WriteVertex(graph.VertexFromId(id));
+  }
+  for (const EdgeId id : edgeIds)
+  {
+    writer.WriteEdge(graph.EdgeFromId(id));
+  }
+  writer.End();
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors exportGraph(std::ostream &_out,
+    const ScopedGraph<PoseRelativeToGraph> &_graph,
+    const GraphExportOptions &_options)
+{
+  // Edges point from the frames that poses are relative to.
+  return exportGraphImpl(_out, _graph, _options, false,
+      ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR);
+}
+
+/////////////////////////////////////////////////
+Errors exportGraph(std::ostream &_out,
+    const ScopedGraph<FrameAttachedToGraph> &_graph,
+    const GraphExportOptions &_options)
+{
+  // Edges point to the frames that frames are attached to.
+  return exportGraphImpl(_out, _graph, _options, true,
+      ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR);
+}
+}
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef SDF_GRAPH_EXPORT_HH
+#define SDF_GRAPH_EXPORT_HH
+
+#include <ostream>
+#include <string>
+
+#include "sdf/Error.hh"
+#include "sdf/Root.hh"
+#include "sdf/Types.hh"
+#include "sdf/sdf_config.h"
+
+#include "FrameSemantics.hh"
+#include "ScopedGraph.hh"
+
+namespace sdf
+{
+// Inline bracket to help doxygen filtering.
+inline namespace SDF_VERSION_NAMESPACE {
+
+/// \enum GraphFormat
+/// \brief Output formats of the frame graph exporters.
+enum class GraphFormat
+{
+  /// \brief Graphviz DOT, the same as the output of the graph's
+  /// operator<< when the whole graph is exported.
+  DOT = 0,
+
+  /// \brief JSON object with a "vertices" and an "edges" array.
+  JSON = 1
+};
+
+/// \brief Options of the frame graph exporters.
+struct GraphExportOptions
+{
+  /// \brief Output format.
+  GraphFormat format = GraphFormat::DOT;
+
+  /// \brief Full name of the vertex whose subtree is exported, such as
+  /// "model::nested_model". The whole graph is exported when it is empty.
+  std::string scope;
+
+  /// \brief Maximum number of edges between the scope vertex, or the roots
+  /// of the graph when the scope is empty, and the exported vertices. A
+  /// negative depth exports the whole subtree.
+  int depth = -1;
+};
+
+/// \brief Write a PoseRelativeTo graph to a stream. The vertices and edges
+/// are written as they are visited, so the output is never held in memory.
+/// The subtree of a scope vertex holds the frames whose poses are expressed
+/// relative to it, directly or through other frames.
+/// \param[out] _out Stream to which the graph is written.
+/// \param[in] _graph Graph to export.
+/// \param[in] _options Format and filter of the export.
+/// \return Errors, which is empty when the graph was exported. Nothing is
+/// written when the scope vertex is not found.
+Errors exportGraph(std::ostream &_out,
+    const ScopedGraph<PoseRelativeToGraph> &_graph,
+    const GraphExportOptions &_options);
+
+/// \brief Write a FrameAttachedTo graph to a stream. The vertices and edges
+/// are written as they are visited, so the output is never held in memory.
+/// The subtree of a scope vertex holds the frames that are attached to it,
+/// directly or through other frames.
+/// \param[out] _out Stream to which the graph is written.
+/// \param[in] _graph Graph to export.
+/// \param[in] _options Format and filter of the export.
+/// \return Errors, which is empty when the graph was exported. Nothing is
+/// written when the scope vertex is not found.
+Errors exportGraph(std::ostream &_out,
+    const ScopedGraph<FrameAttachedToGraph> &_graph,
+    const GraphExportOptions &_options);
+
+/// \brief Access to the frame graphs built by Root::Load, so that tools
+/// don't have to build them again.
+class RootGraphs
+{
+  /// \brief Get the PoseRelativeTo graph of a world or of a model of a
+  /// root.
+  /// \param[in] _root Loaded root.
+  /// \param[in] _name Name of the world or model. The first world, or the
+  /// first model when there is no world, is used when it is empty.
+  /// \return The graph, which is false when it is not found.
+  public: static ScopedGraph<PoseRelativeToGraph> PoseRelativeTo(
+      const Root &_root, const std::string &_name);
+
+  /// \brief Get the FrameAttachedTo graph of a world or of a model of a
+  /// root.
+  /// \param[in] _root Loaded root.
+  /// \param[in] _name Name of the world or model. The first world, or the
+  /// first model when there is no world, is used when it is empty.
+  /// \return The graph, which is false when it is not found.
+  public: static ScopedGraph<FrameAttachedToGraph> FrameAttachedTo(
+      const Root &_root, const std::string &_name);
+};
+}
+}
+#endif
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <ignition/math/Pose3.hh>
+
+#include "FrameSemantics.hh"
+#include "GraphExport.hh"
+#include "ScopedGraph.hh"
+
+using Pose = ignition::math::Pose3d;
+
+/////////////////////////////////////////////////
+/// \brief Export a graph to a string.
+/// \param[in] _graph Graph to export.
+/// \param[in] _format Output format.
+/// \param[in] _scope Name of the scope vertex.
+/// \param[in] _depth Maximum depth.
+/// \return The output, or the messages of the errors.
+template <typename T>
+std::string exportToString(const sdf::ScopedGraph<T> &_graph,
+    sdf::GraphFormat _format, const std::string &_scope = "",
+    int _depth = -1)
+{
+  sdf::GraphExportOptions options;
+  options.format = _format;
+  options.scope = _scope;
+  options.depth = _depth;
+  std::ostringstream out;
+  const sdf::Errors errors = sdf::exportGraph(out, _graph, options);
+  for (const auto &error : errors)
+  {
+    out << "Error: " << error.Message() << "\n";
+  }
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+TEST(GraphExport, PoseRelativeTo)
+{
+  auto ownedGraph = std::make_shared<sdf::PoseRelativeToGraph>();
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> graph(ownedGraph);
+  graph = graph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  const auto modelId = graph.ScopeVertexId();
+  const auto lId = graph.AddVertex("L", sdf::FrameType::LINK).Id();
+  const auto fId = graph.AddVertex("F", sdf::FrameType::FRAME).Id();
+  const auto gId = graph.AddVertex("G", sdf::FrameType::FRAME).Id();
+  graph.AddVertex("X", sdf::FrameType::FRAME);
+  graph.AddEdge({modelId, lId}, Pose(1, 0, 0, 0, 0, 0));
+  graph.AddEdge({lId, fId}, Pose(0, 2, 0, 0, 0, 0));
+  graph.AddEdge({fId, gId}, Pose(0, 0, 3, 0, 0, 0));
+
+  // The whole graph.
+  EXPECT_EQ(
+      "digraph {\n"
+      "  0 [label=\"__model__ (0)\"];\n"
+      "  1 [label=\"L (1)\"];\n"
+      "  2 [label=\"F (2)\"];\n"
+      "  3 [label=\"G (3)\"];\n"
+      "  4 [label=\"X (4)\"];\n"
+      "  0 -> 1 [label=1];\n"
+      "  1 -> 2 [label=1];\n"
+      "  2 -> 3 [label=1];\n"
+      "}\n",
+      exportToString(graph, sdf::GraphFormat::DOT));
+
+  EXPECT_EQ(
+      "{\"vertices\": [\n"
+      "  {\"id\": 0, \"name\": \"__model__\", \"type\": \"MODEL\"},\n"
+      "  {\"id\": 1, \"name\": \"L\", \"type\": \"LINK\"},\n"
+      "  {\"id\": 2, \"name\": \"F\", \"type\": \"FRAME\"},\n"
+      "  {\"id\": 3, \"name\": \"G\", \"type\": \"FRAME\"},\n"
+      "  {\"id\": 4, \"name\": \"X\", \"type\": \"FRAME\"}\n"
+      "], \"edges\": [\n"
+      "  {\"id\": 0, \"tail\": 0, \"head\": 1, \"weight\": 1, "
+      "\"pose\": [1, 0, 0, 0, 0, 0]},\n"
+      "  {\"id\": 1, \"tail\": 1, \"head\": 2, \"weight\": 1, "
+      "\"pose\": [0, 2, 0, 0, 0, 0]},\n"
+      "  {\"id\": 2, \"tail\": 2, \"head\": 3, \"weight\": 1, "
+      "\"pose\": [0, 0, 3, 0, 0, 0]}\n"
+      "]}\n",
+      exportToString(graph, sdf::GraphFormat::JSON));
+
+  // The frames whose poses are relative to L.
+  EXPECT_EQ(
+      "digraph {\n"
+      "  1 [label=\"L (1)\"];\n"
+      "  2 [label=\"F (2)\"];\n"
+      "  3 [label=\"G (3)\"];\n"
+      "  1 -> 2 [label=1];\n"
+      "  2 -> 3 [label=1];\n"
+      "}\n",
+      exportToString(graph, sdf::GraphFormat::DOT, "L"));
+
+  // The same, one edge deep.
+  EXPECT_EQ(
+      "{\"vertices\": [\n"
+      "  {\"id\": 1, \"name\": \"L\", \"type\": \"LINK\"},\n"
+      "  {\"id\": 2, \"name\": \"F\", \"type\": \"FRAME\"}\n"
+      "], \"edges\": [\n"
+      "  {\"id\": 1, \"tail\": 1, \"head\": 2, \"weight\": 1, "
+      "\"pose\": [0, 2, 0, 0, 0, 0]}\n"
+      "]}\n",
+      exportToString(graph, sdf::GraphFormat::JSON, "L", 1));
+
+  // The roots of the graph, without edges.
+  EXPECT_EQ(
+      "{\"vertices\": [\n"
+      "  {\"id\": 0, \"name\": \"__model__\", \"type\": \"MODEL\"},\n"
+      "  {\"id\": 4, \"name\": \"X\", \"type\": \"FRAME\"}\n"
+      "], \"edges\": []}\n",
+      exportToString(graph, sdf::GraphFormat::JSON, "", 0));
+
+  // A missing scope vertex writes nothing.
+  EXPECT_EQ(
+      "Error: Unable to find vertex with name [missing] in graph.\n",
+      exportToString(graph, sdf::GraphFormat::DOT, "missing"));
+
+  // An empty graph.
+  EXPECT_EQ(
+      "Error: Unable to export an empty graph.\n",
+      exportToString(sdf::ScopedGraph<sdf::PoseRelativeToGraph>(),
+          sdf::GraphFormat::JSON));
+}
+
+/////////////////////////////////////////////////
+TEST(GraphExport, FrameAttachedTo)
+{
+  auto ownedGraph = std::make_shared<sdf::FrameAttachedToGraph>();
+  sdf::ScopedGraph<sdf::FrameAttachedToGraph> graph(ownedGraph);
+  graph = graph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  const auto modelId = graph.ScopeVertexId();
+  const auto lId = graph.AddVertex("L", sdf::FrameType::LINK).Id();
+  const auto fId = graph.AddVertex("F", sdf::FrameType::FRAME).Id();
+  const auto gId = graph.AddVertex("G", sdf::FrameType::FRAME).Id();
+  const auto hId = graph.AddVertex("H \"quoted\"", sdf::FrameType::FRAME).Id();
+  const auto kId = graph.AddVertex("K", sdf::FrameType::FRAME).Id();
+  graph.AddEdge({modelId, lId}, true);
+  graph.AddEdge({fId, lId}, true);
+  graph.AddEdge({gId, fId}, true);
+  graph.AddEdge({hId, kId}, true);
+  graph.AddEdge({kId, hId}, true);
+
+  // The frames attached to L.
+  EXPECT_EQ(
+      "digraph {\n"
+      "  0 [label=\"__model__ (0)\"];\n"
+      "  1 [label=\"L (1)\"];\n"
+      "  2 [label=\"F (2)\"];\n"
+      "  3 [label=\"G (3)\"];\n"
+      "  0 -> 1 [label=1];\n"
+      "  2 -> 1 [label=1];\n"
+      "  3 -> 2 [label=1];\n"
+      "}\n",
+      exportToString(graph, sdf::GraphFormat::DOT, "L"));
+
+  // The sinks of the graph, and the frames directly attached to them. H and
+  // K, which are attached to each other, have no sink.
+  EXPECT_EQ(
+      "digraph {\n"
+      "  0 [label=\"__model__ (0)\"];\n"
+      "  1 [label=\"L (1)\"];\n"
+      "  2 [label=\"F (2)\"];\n"
+      "  0 -> 1 [label=1];\n"
+      "  2 -> 1 [label=1];\n"
+      "}\n",
+      exportToString(graph, sdf::GraphFormat::DOT, "", 1));
+
+  // Cycles are walked once, and names are escaped.
+  EXPECT_EQ(
+      "{\"vertices\": [\n"
+      "  {\"id\": 4, \"name\": \"H \\\"quoted\\\"\", \"type\": \"FRAME\"},\n"
+      "  {\"id\": 5, \"name\": \"K\", \"type\": \"FRAME\"}\n"
+      "], \"edges\": [\n"
+      "  {\"id\": 3, \"tail\": 4, \"head\": 5, \"weight\": 1},\n"
+      "  {\"id\": 4, \"tail\": 5, \"head\": 4, \"weight\": 1}\n"
+      "]}\n",
+      exportToString(graph, sdf::GraphFormat::JSON, "K"));
+}
@@ -0,0 +1,1105 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "sdf/Filesystem.hh"
+#include "sdf/Heightmap.hh"
+#include "sdf/SDFImpl.hh"
+#include "Utils.hh"
+
+using namespace sdf;
+
+/// \brief Number of rows in a tile, unless set otherwise.
+static const uint64_t kDefaultTileRows = 64;
+
+/// \brief Number of resident tiles, unless set otherwise.
+static const std::size_t kDefaultMaxResidentTiles = 64;
+
+// Private data class
+class sdf::HeightmapTexturePrivate
+{
+  /// \brief Size of the applied texture in meters.
+  public: double size{10.0};
+
+  /// \brief The diffuse map.
+  public: std::string diffuse{""};
+
+  /// \brief The normal map.
+  public: std::string normal{""};
+
+  /// \brief The SDF element pointer used during load.
+  public: sdf::ElementPtr sdf{nullptr};
+};
+
+// Private data class
+class sdf::HeightmapBlendPrivate
+{
+  /// \brief Minimum height of the blend layer.
+  public: double minHeight{0.0};
+
+  /// \brief Distance over which the blend occurs.
+  public: double fadeDistance{0.0};
+
+  /// \brief The SDF element pointer used during load.
+  public: sdf::ElementPtr sdf{nullptr};
+};
+
+/// \brief A tile of consecutive rows of samples, either mapped from the
+/// file or read into a buffer.
+class HeightmapTile
+{
+  /// \brief Constructor.
+  public: HeightmapTile() = default;
+
+  /// \brief Copy constructor, deleted because the tile owns its mapping.
+  public: HeightmapTile(const HeightmapTile &) = delete;
+
+  /// \brief Copy assignment operator, deleted.
+  /// \return Reference to this.
+  public: HeightmapTile &operator=(const HeightmapTile &) = delete;
+
+  /// \brief Destructor. Unmaps the tile.
+  public: ~HeightmapTile()
+  {
+#ifndef _WIN32
+    if (this->mapping)
+      munmap(this->mapping, this->mappingSize);
+#endif
+  }
+
+  /// \brief The first sample of the tile.
+  public: const unsigned char *samples = nullptr;
+
+  /// \brief Start of the mapping, which is aligned on a page and may begin
+  /// before the first sample.
+  public: void *mapping = nullptr;
+
+  /// \brief Size of the mapping in bytes.
+  public: std::size_t mappingSize = 0;
+
+  /// \brief Samples read from the file when the tile is not mapped.
+  public: std::vector<unsigned char> buffer;
+
+  /// \brief Position of the tile in the list of recently used tiles.
+  public: std::list<uint64_t>::iterator use;
+};
+
+// Private data class
+class sdf::HeightmapDataPrivate
+{
+  /// \brief Get a tile, reading it if needed, and mark it as the most
+  /// recently used one. The mutex must be locked.
+  /// \param[in] _tile Index of the tile.
+  /// \return The tile, or nullptr if it could not be read.
+  public: const HeightmapTile *Tile(uint64_t _tile);
+
+  /// \brief Release the least recently used tiles until at most maxTiles
+  /// are resident. The mutex must be locked.
+  /// \param[in] _maxTiles Number of tiles that may stay resident.
+  public: void Evict(std::size_t _maxTiles);
+
+  /// \brief Get a sample. The mutex must be locked.
+  /// \param[in] _col Column of the sample, less than cols.
+  /// \param[in] _row Row of the sample, less than rows.
+  /// \return The normalized sample.
+  public: double Value(uint64_t _col, uint64_t _row);
+
+  /// \brief Close the file and release the tiles.
+  public: void Close();
+
+  /// \brief Path to the file.
+  public: std::string path;
+
+  /// \brief Number of samples in each row.
+  public: uint64_t cols = 0;
+
+  /// \brief Number of rows.
+  public: uint64_t rows = 0;
+
+  /// \brief Bytes per sample, 1 or 2.
+  public: unsigned int sampleBytes = 1;
+
+  /// \brief True if 2-byte samples are big-endian, as in PGM images.
+  public: bool bigEndian = false;
+
+  /// \brief Largest sample value, which is normalized to 1.
+  public: double maxValue = 255.0;
+
+  /// \brief Offset of the first sample in the file.
+  public: uint64_t dataOffset = 0;
+
+  /// \brief Number of rows in each tile.
+  public: uint64_t tileRows = kDefaultTileRows;
+
+  /// \brief Maximum number of resident tiles.
+  public: std::size_t maxTiles = kDefaultMaxResidentTiles;
+
+  /// \brief Resident tiles by index.
+  public: std::unordered_map<uint64_t, std::unique_ptr<HeightmapTile>> tiles;
+
+  /// \brief Indices of the resident tiles, most recently used first.
+  public: std::list<uint64_t> recentTiles;
+
+#ifndef _WIN32
+  /// \brief File descriptor of the open file, or -1.
+  public: int fd = -1;
+#endif
+
+  /// \brief Mutex protecting the tiles.
+  public: mutable std::mutex mutex;
+};
+
+/////////////////////////////////////////////////
+const HeightmapTile *HeightmapDataPrivate::Tile(uint64_t _tile)
+{
+  auto it = this->tiles.find(_tile);
+  if (it != this->tiles.end())
+  {
+    HeightmapTile *tile = it->second.get();
+    this->recentTiles.splice(
+        this->recentTiles.begin(), this->recentTiles, tile->use);
+    return tile;
+  }
+
+  const uint64_t rowBytes = this->cols * this->sampleBytes;
+  const uint64_t firstRow = _tile * this->tileRows;
+  if (firstRow >= this->rows)
+    return nullptr;
+  const uint64_t tileRowCount = std::min(this->tileRows,
+      this->rows - firstRow);
+  const uint64_t offset = this->dataOffset + firstRow * rowBytes;
+  const std::size_t size = static_cast<std::size_t>(tileRowCount * rowBytes);
+
+  // Make room before reading, so the limit holds at all times.
+  this->Evict(this->maxTiles - 1);
+
+  auto tile = std::make_unique<HeightmapTile>();
+#ifndef _WIN32
+  if (this->fd >= 0)
+  {
+    static const uint64_t pageSize =
+        static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t pageOffset = offset % pageSize;
+    void *mapping = mmap(nullptr, size + pageOffset, PROT_READ, MAP_PRIVATE,
+        this->fd, static_cast<off_t>(offset - pageOffset));
+    if (mapping != MAP_FAILED)
+    {
+      tile->mapping = mapping;
+      tile->mappingSize = size + pageOffset;
+      tile->samples = static_cast<const unsigned char *>(mapping) + pageOffset;
+    }
+  }
+#endif
+
+  if (!tile->samples)
+  {
+    std::ifstream file(this->path, std::ios::binary);
+    tile->buffer.resize(size);
+    if (!file.seekg(static_cast<std::streamoff>(offset)) ||
+        !file.read(reinterpret_cast<char *>(tile->buffer.data()),
+            static_cast<std::streamsize>(size)))
+    {
+      return nullptr;
+    }
+    tile->samples = tile->buffer.data();
+  }
+
+  this->recentTiles.push_front(_tile);
+  tile->use = this->recentTiles.begin();
+  return this->tiles.emplace(_tile, std::move(tile)).first->second.get();
+}
+
+/////////////////////////////////////////////////
+void HeightmapDataPrivate::Evict(std::size_t _maxTiles)
+{
+  while (this->recentTiles.size() > _maxTiles)
+  {
+    this->tiles.erase(this->recentTiles.back());
+    this->recentTiles.pop_back();
+  }
+}
+
+/////////////////////////////////////////////////
+double HeightmapDataPrivate::Value(uint64_t _col, uint64_t _row)
+{
+  const HeightmapTile *tile = this->Tile(_row / this->tileRows);
+  if (!tile)
+    return 0.0;
+
+  const unsigned char *sample = tile->samples +
+      ((_row % this->tileRows) * this->cols + _col) * this->sampleBytes;
+  unsigned int value = sample[0];
+  if (this->sampleBytes == 2)
+  {
+    value = this->bigEndian ? (value << 8) | sample[1] :
+        value | (static_cast<unsigned int>(sample[1]) << 8);
+  }
+  return std::min(value / this->maxValue, 1.0);
+}
+
+/////////////////////////////////////////////////
+void HeightmapDataPrivate::Close()
+{
+  this->tiles.clear();
+  this->recentTiles.clear();
+#ifndef _WIN32
+  if (this->fd >= 0)
+  {
+    close(this->fd);
+    this->fd = -1;
+  }
+#endif
+  this->path.clear();
+  this->cols = 0;
+  this->rows = 0;
+}
+
+/// \brief Read the next token of a PGM header, skipping whitespace and
+/// comments.
+/// \param[in] _file The file, positioned in the header.
+/// \return The token, or an empty string at the end of the file.
+static std::string readPgmToken(std::istream &_file)
+{
+  std::string token;
+  int c = _file.get();
+  while (c != EOF)
+  {
+    if (c == '#')
+    {
+      while (c != EOF && c != '\n')
+        c = _file.get();
+    }
+    else if (std::isspace(c))
+    {
+      if (!token.empty())
+        break;
+    }
+    else
+    {
+      token += static_cast<char>(c);
+    }
+    c = _file.get();
+  }
+  return token;
+}
+
+/////////////////////////////////////////////////
+HeightmapData::HeightmapData()
+  : dataPtr(new HeightmapDataPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+HeightmapData::~HeightmapData()
+{
+  this->dataPtr->Close();
+}
+
+/////////////////////////////////////////////////
+Errors HeightmapData::Load(const std::string &_path)
+{
+  Errors errors;
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Close();
+
+  std::ifstream file(_path, std::ios::binary);
+  if (!file)
+  {
+    errors.push_back({ErrorCode::FILE_READ,
+        "Unable to open heightmap file[" + _path + "]."});
+    return errors;
+  }
+  file.seekg(0, std::ios::end);
+  const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+  file.seekg(0);
+
+  std::string extension;
+  const std::size_t dot = _path.rfind('.');
+  if (dot != std::string::npos)
+  {
+    extension = _path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char _c) {return std::tolower(_c);});
+  }
+
+  uint64_t cols = 0;
+  uint64_t rows = 0;
+  if (extension == "raw" || extension == "r16" || extension == "r8")
+  {
+    this->dataPtr->sampleBytes = extension == "r8" ? 1 : 2;
+    this->dataPtr->bigEndian = false;
+    this->dataPtr->maxValue = extension == "r8" ? 255.0 : 65535.0;
+    this->dataPtr->dataOffset = 0;
+
+    const uint64_t samples = fileSize / this->dataPtr->sampleBytes;
+    cols = static_cast<uint64_t>(std::llround(std::sqrt(
+        static_cast<double>(samples))));
+    rows = cols;
+    if (cols == 0 || cols * rows * this->dataPtr->sampleBytes != fileSize)
+    {
+      errors.push_back({ErrorCode::FILE_READ,
+          "Raw heightmap file[" + _path + "] is not a square grid of " +
+          std::to_string(this->dataPtr->sampleBytes * 8) + "-bit samples."});
+      return errors;
+    }
+  }
+  else
+  {
+    if (readPgmToken(file) != "P5")
+    {
+      errors.push_back({ErrorCode::FILE_READ,
+          "Heightmap file[" + _path + "] is not a binary PGM image or a raw "
+          "grid with a .raw, .r16 or .r8 extension."});
+      return errors;
+    }
+
+    uint64_t maxValue = 0;
+    try
+    {
+      cols = std::stoull(readPgmToken(file));
+      rows = std::stoull(readPgmToken(file));
+      maxValue = std::stoull(readPgmToken(file));
+    }
+    catch(...)
+    {
+      cols = 0;
+    }
+
+    this->dataPtr->sampleBytes = maxValue < 256 ? 1 : 2;
+    this->dataPtr->bigEndian = true;
+    this->dataPtr->maxValue = static_cast<double>(maxValue);
+    this->dataPtr->dataOffset = file ? static_cast<uint64_t>(file.tellg()) : 0;
+
+    if (cols == 0 || rows == 0 || maxValue == 0 || maxValue > 65535 ||
+        this->dataPtr->dataOffset +
+        cols * rows * this->dataPtr->sampleBytes > fileSize)
+    {
+      errors.push_back({ErrorCode::FILE_READ,
+          "Heightmap file[" + _path + "] has an invalid or truncated PGM "
+          "header or sample data."});
+      return errors;
+    }
+  }
+
+#ifndef _WIN32
+  // A failure to open the file for mapping falls back to reading tiles.
+  this->dataPtr->fd = open(_path.c_str(), O_RDONLY);
+#endif
+  this->dataPtr->path = _path;
+  this->dataPtr->cols = cols;
+  this->dataPtr->rows = rows;
+  return errors;
+}
+
+/////////////////////////////////////////////////
+const std::string &HeightmapData::Path() const
+{
+  return this->dataPtr->path;
+}
+
+/////////////////////////////////////////////////
+uint64_t HeightmapData::Cols() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->cols;
+}
+
+/////////////////////////////////////////////////
+uint64_t HeightmapData::Rows() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->rows;
+}
+
+/////////////////////////////////////////////////
+double HeightmapData::Value(uint64_t _col, uint64_t _row) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (_col >= this->dataPtr->cols || _row >= this->dataPtr->rows)
+    return 0.0;
+
+  return this->dataPtr->Value(_col, _row);
+}
+
+/////////////////////////////////////////////////
+double HeightmapData::Sample(double _u, double _v) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->cols == 0 || this->dataPtr->rows == 0)
+    return 0.0;
+
+  const double x = std::clamp(_u, 0.0, 1.0) * (this->dataPtr->cols - 1);
+  const double y = std::clamp(_v, 0.0, 1.0) * (this->dataPtr->rows - 1);
+  const uint64_t col0 = static_cast<uint64_t>(x);
+  const uint64_t row0 = static_cast<uint64_t>(y);
+  const uint64_t col1 = std::min(col0 + 1, this->dataPtr->cols - 1);
+  const uint64_t row1 = std::min(row0 + 1, this->dataPtr->rows - 1);
+  const double fx = x - col0;
+  const double fy = y - row0;
+
+  const double top = this->dataPtr->Value(col0, row0) * (1 - fx) +
+      this->dataPtr->Value(col1, row0) * fx;
+  const double bottom = this->dataPtr->Value(col0, row1) * (1 - fx) +
+      this->dataPtr->Value(col1, row1) * fx;
+  return top * (1 - fy) + bottom * fy;
+}
+
+/////////////////////////////////////////////////
+uint64_t HeightmapData::TileRows() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->tileRows;
+}
+
+/////////////////////////////////////////////////
+void HeightmapData::SetTileRows(uint64_t _rows)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Evict(0);
+  this->dataPtr->tileRows = std::max<uint64_t>(_rows, 1);
+}
+
+/////////////////////////////////////////////////
+std::size_t HeightmapData::MaxResidentTiles() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->maxTiles;
+}
+
+/////////////////////////////////////////////////
+void HeightmapData::SetMaxResidentTiles(std::size_t _count)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->maxTiles = std::max<std::size_t>(_count, 1);
+  this->dataPtr->Evict(this->dataPtr->maxTiles);
+}
+
+/////////////////////////////////////////////////
+std::size_t HeightmapData::ResidentTileCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->tiles.size();
+}
+
+// Private data class
+class sdf::HeightmapPrivate
+{
+  /// \brief URI of 2D grayscale image.
+  public: std::string uri{""};
+
+  /// \brief The path to the file where this heightmap was defined.
+  public: std::string filePath{""};
+
+  /// \brief Size of the heightmap in meters.
+  public: ignition::math::Vector3d size{1, 1, 1};
+
+  /// \brief Position offset of the heightmap.
+  public: ignition::math::Vector3d position{ignition::math::Vector3d::Zero};
+
+  /// \brief Whether to use terrain paging.
+  public: bool useTerrainPaging{false};
+
+  /// \brief Number of samples per heightmap datum.
+  public: unsigned int sampling{2u};
+
+  /// \brief Textures on the heightmap.
+  public: std::vector<HeightmapTexture> textures;
+
+  /// \brief Blends between the textures.
+  public: std::vector<HeightmapBlend> blends;
+
+  /// \brief The height data, which is read the first time it is needed and
+  /// accessed with the atomic functions of std::shared_ptr.
+  public: std::shared_ptr<const HeightmapData> data;
+
+  /// \brief The SDF element pointer used during load.
+  public: sdf::ElementPtr sdf{nullptr};
+};
+
+/////////////////////////////////////////////////
+HeightmapTexture::HeightmapTexture()
+  : dataPtr(new HeightmapTexturePrivate)
+{
+}
+
+/////////////////////////////////////////////////
+HeightmapTexture::~HeightmapTexture()
+{
+  delete this->dataPtr;
+  this->dataPtr = nullptr;
+}
+
+//////////////////////////////////////////////////
+HeightmapTexture::HeightmapTexture(const HeightmapTexture &_texture)
+  : dataPtr(new HeightmapTexturePrivate(*_texture.dataPtr))
+{
+}
+
+//////////////////////////////////////////////////
+HeightmapTexture::HeightmapTexture(HeightmapTexture &&_texture) noexcept
+  : dataPtr(std::exchange(_texture.dataPtr, nullptr))
+{
+}
+
+/////////////////////////////////////////////////
+HeightmapTexture &HeightmapTexture::operator=(
+    const HeightmapTexture &_texture)
+{
+  return *this = HeightmapTexture(_texture);
+}
+
+/////////////////////////////////////////////////
+HeightmapTexture &HeightmapTexture::operator=(HeightmapTexture &&_texture)
+{
+  std::swap(this->dataPtr, _texture.dataPtr);
+  return *this;
+}
+
+/////////////////////////////////////////////////
+Errors HeightmapTexture::Load(ElementPtr _sdf)
+{
+  Errors errors;
+
+  this->dataPtr->sdf = _sdf;
+
+  // Check that sdf is a valid pointer
+  if (!_sdf)
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Attempting to load a heightmap texture, but the provided SDF "
+        "element is null."});
+    return errors;
+  }
+
+  // We need a heightmap texture element
+  if (_sdf->GetName() != "texture")
+  {
+    errors.push_back({ErrorCode::ELEMENT_INCORRECT_TYPE,
+        "Attempting to load a heightmap texture, but the provided SDF "
+        "element is not a <texture>."});
+    return errors;
+  }
+
+  if (_sdf->HasElement("size"))
+  {
+    this->dataPtr->size = _sdf->Get<double>("size", this->dataPtr->size).first;
+  }
+  else
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Heightmap texture is missing a <size> child element."});
+  }
+
+  if (_sdf->HasElement("diffuse"))
+  {
+    this->dataPtr->diffuse = _sdf->Get<std::string>("diffuse",
+        this->dataPtr->diffuse).first;
+  }
+  else
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Heightmap texture is missing a <diffuse> child element."});
+  }
+
+  if (_sdf->HasElement("normal"))
+  {
+    this->dataPtr->normal = _sdf->Get<std::string>("normal",
+        this->dataPtr->normal).first;
+  }
+  else
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Heightmap texture is missing a <normal> child element."});
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+sdf::ElementPtr HeightmapTexture::Element() const
+{
+  return this->dataPtr->sdf;
+}
+
+//////////////////////////////////////////////////
+double HeightmapTexture::Size() const
+{
+  return this->dataPtr->size;
+}
+
+//////////////////////////////////////////////////
+void HeightmapTexture::SetSize(double _size)
+{
+  this->dataPtr->size = _size;
+}
+
+//////////////////////////////////////////////////
+std::string HeightmapTexture::Diffuse() const
+{
+  return this->dataPtr->diffuse;
+}
+
+//////////////////////////////////////////////////
+void HeightmapTexture::SetDiffuse(const std::string &_diffuse)
+{
+  this->dataPtr->diffuse = _diffuse;
+}
+
+//////////////////////////////////////////////////
+std::string HeightmapTexture::Normal() const
+{
+  return this->dataPtr->normal;
+}
+
+//////////////////////////////////////////////////
+void HeightmapTexture::SetNormal(const std::string &_normal)
+{
+  this->dataPtr->normal = _normal;
+}
+
+/////////////////////////////////////////////////
+HeightmapBlend::HeightmapBlend()
+  : dataPtr(new HeightmapBlendPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+HeightmapBlend::~HeightmapBlend()
+{
+  delete this->dataPtr;
+  this->dataPtr = nullptr;
+}
+
+//////////////////////////////////////////////////
+HeightmapBlend::HeightmapBlend(const HeightmapBlend &_blend)
+  : dataPtr(new HeightmapBlendPrivate(*_blend.dataPtr))
+{
+}
+
+//////////////////////////////////////////////////
+HeightmapBlend::HeightmapBlend(HeightmapBlend &&_blend) noexcept
+  : dataPtr(std::exchange(_blend.dataPtr, nullptr))
+{
+}
+
+/////////////////////////////////////////////////
+HeightmapBlend &HeightmapBlend::operator=(const HeightmapBlend &_blend)
+{
+  return *this = HeightmapBlend(_blend);
+}
+
+/////////////////////////////////////////////////
+HeightmapBlend &HeightmapBlend::operator=(HeightmapBlend &&_blend)
+{
+  std::swap(this->dataPtr, _blend.dataPtr);
+  return *this;
+}
+
+/////////////////////////////////////////////////
+Errors HeightmapBlend::Load(ElementPtr _sdf)
+{
+  Errors errors;
+
+  this->dataPtr->sdf = _sdf;
+
+  // Check that sdf is a valid pointer
+  if (!_sdf)
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Attempting to load a heightmap blend, but the provided SDF "
+        "element is null."});
+    return errors;
+  }
+
+  // We need a heightmap blend element
+  if (_sdf->GetName() != "blend")
+  {
+    errors.push_back({ErrorCode::ELEMENT_INCORRECT_TYPE,
+        "Attempting to load a heightmap blend, but the provided SDF "
+        "element is not a <blend>."});
+    return errors;
+  }
+
+  if (_sdf->HasElement("min_height"))
+  {
+    this->dataPtr->minHeight = _sdf->Get<double>("min_height",
+        this->dataPtr->minHeight).first;
+  }
+  else
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Heightmap blend is missing a <min_height> child element."});
+  }
+
+  if (_sdf->HasElement("fade_dist"))
+  {
+    this->dataPtr->fadeDistance = _sdf->Get<double>("fade_dist",
+        this->dataPtr->fadeDistance).first;
+  }
+  else
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Heightmap blend is missing a <fade_dist> child element."});
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+sdf::ElementPtr HeightmapBlend::Element() const
+{
+  return this->dataPtr->sdf;
+}
+
+//////////////////////////////////////////////////
+double HeightmapBlend::MinHeight() const
+{
+  return this->dataPtr->minHeight;
+}
+
+//////////////////////////////////////////////////
+void HeightmapBlend::SetMinHeight(double _minHeight)
+{
+  this->dataPtr->minHeight = _minHeight;
+}
+
+//////////////////////////////////////////////////
+double HeightmapBlend::FadeDistance() const
+{
+  return this->dataPtr->fadeDistance;
+}
+
+//////////////////////////////////////////////////
+void HeightmapBlend::SetFadeDistance(double _fadeDistance)
+{
+  this->dataPtr->fadeDistance = _fadeDistance;
+}
+
+/////////////////////////////////////////////////
+Heightmap::Heightmap()
+  : dataPtr(new HeightmapPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+Heightmap::~Heightmap()
+{
+  delete this->dataPtr;
+  this->dataPtr = nullptr;
+}
+
+//////////////////////////////////////////////////
+Heightmap::Heightmap(const Heightmap &_heightmap)
+  : dataPtr(new HeightmapPrivate)
+{
+  this->dataPtr->uri = _heightmap.dataPtr->uri;
+  this->dataPtr->filePath = _heightmap.dataPtr->filePath;
+  this->dataPtr->size = _heightmap.dataPtr->size;
+  this->dataPtr->position = _heightmap.dataPtr->position;
+  this->dataPtr->useTerrainPaging = _heightmap.dataPtr->useTerrainPaging;
+  this->dataPtr->sampling = _heightmap.dataPtr->sampling;
+  this->dataPtr->textures = _heightmap.dataPtr->textures;
+  this->dataPtr->blends = _heightmap.dataPtr->blends;
+  this->dataPtr->data = std::atomic_load(&_heightmap.dataPtr->data);
+  this->dataPtr->sdf = _heightmap.dataPtr->sdf;
+}
+
+//////////////////////////////////////////////////
+Heightmap::Heightmap(Heightmap &&_heightmap) noexcept
+  : dataPtr(std::exchange(_heightmap.dataPtr, nullptr))
+{
+}
+
+/////////////////////////////////////////////////
+Heightmap &Heightmap::operator=(const Heightmap &_heightmap)
+{
+  return *this = Heightmap(_heightmap);
+}
+
+/////////////////////////////////////////////////
+Heightmap &Heightmap::operator=(Heightmap &&_heightmap)
+{
+  std::swap(this->dataPtr, _heightmap.dataPtr);
+  return *this;
+}
+
+/////////////////////////////////////////////////
+Errors Heightmap::Load(ElementPtr _sdf)
+{
+  Errors errors;
+
+  this->dataPtr->sdf = _sdf;
+
+  // Check that sdf is a valid pointer
+  if (!_sdf)
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Attempting to load a heightmap, but the provided SDF element is "
+        "null."});
+    return errors;
+  }
+
+  this->dataPtr->filePath = _sdf->FilePath();
+
+  // We need a heightmap element
+  if (_sdf->GetName() != "heightmap")
+  {
+    errors.push_back({ErrorCode::ELEMENT_INCORRECT_TYPE,
+        "Attempting to load a heightmap geometry, but the provided SDF "
+        "element is not a <heightmap>."});
+    return errors;
+  }
+
+  if (_sdf->HasElement("uri"))
+  {
+    this->dataPtr->uri = _sdf->Get<std::string>("uri", "").first;
+  }
+  else
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Heightmap geometry is missing a <uri> child element."});
+  }
+
+  this->dataPtr->size = _sdf->Get<ignition::math::Vector3d>("size",
+      this->dataPtr->size).first;
+
+  this->dataPtr->position = _sdf->Get<ignition::math::Vector3d>("pos",
+      this->dataPtr->position).first;
+
+  this->dataPtr->useTerrainPaging = _sdf->Get<bool>("use_terrain_paging",
+      this->dataPtr->useTerrainPaging).first;
+
+  this->dataPtr->sampling = _sdf->Get<unsigned int>("sampling",
+      this->dataPtr->sampling).first;
+
+  Errors textureLoadErrors = loadRepeated<HeightmapTexture>(_sdf,
+    "texture", this->dataPtr->textures);
+  errors.insert(errors.end(), textureLoadErrors.begin(),
+      textureLoadErrors.end());
+
+  Errors blendLoadErrors = loadRepeated<HeightmapBlend>(_sdf,
+    "blend", this->dataPtr->blends);
+  errors.insert(errors.end(), blendLoadErrors.begin(), blendLoadErrors.end());
+
+  std::atomic_store(&this->dataPtr->data,
+      std::shared_ptr<const HeightmapData>());
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+sdf::ElementPtr Heightmap::Element() const
+{
+  return this->dataPtr->sdf;
+}
+
+//////////////////////////////////////////////////
+std::string Heightmap::Uri() const
+{
+  return this->dataPtr->uri;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::SetUri(const std::string &_uri)
+{
+  this->dataPtr->uri = _uri;
+  std::atomic_store(&this->dataPtr->data,
+      std::shared_ptr<const HeightmapData>());
+}
+
+//////////////////////////////////////////////////
+const std::string &Heightmap::FilePath() const
+{
+  return this->dataPtr->filePath;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::SetFilePath(const std::string &_filePath)
+{
+  this->dataPtr->filePath = _filePath;
+}
+
+//////////////////////////////////////////////////
+ignition::math::Vector3d Heightmap::Size() const
+{
+  return this->dataPtr->size;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::SetSize(const ignition::math::Vector3d &_size)
+{
+  this->dataPtr->size = _size;
+}
+
+//////////////////////////////////////////////////
+ignition::math::Vector3d Heightmap::Position() const
+{
+  return this->dataPtr->position;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::SetPosition(const ignition::math::Vector3d &_position)
+{
+  this->dataPtr->position = _position;
+}
+
+//////////////////////////////////////////////////
+bool Heightmap::UseTerrainPaging() const
+{
+  return this->dataPtr->useTerrainPaging;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::SetUseTerrainPaging(bool _useTerrainPaging)
+{
+  this->dataPtr->useTerrainPaging = _useTerrainPaging;
+}
+
+//////////////////////////////////////////////////
+unsigned int Heightmap::Sampling() const
+{
+  return this->dataPtr->sampling;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::SetSampling(unsigned int _sampling)
+{
+  this->dataPtr->sampling = _sampling;
+}
+
+//////////////////////////////////////////////////
+uint64_t Heightmap::TextureCount() const
+{
+  return this->dataPtr->textures.size();
+}
+
+/////////////////////////////////////////////////
+const HeightmapTexture *Heightmap::TextureByIndex(uint64_t _index) const
+{
+  if (_index < this->dataPtr->textures.size())
+    return &this->dataPtr->textures[_index];
+  return nullptr;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::AddTexture(const HeightmapTexture &_texture)
+{
+  this->dataPtr->textures.push_back(_texture);
+}
+
+//////////////////////////////////////////////////
+uint64_t Heightmap::BlendCount() const
+{
+  return this->dataPtr->blends.size();
+}
+
+/////////////////////////////////////////////////
+const HeightmapBlend *Heightmap::BlendByIndex(uint64_t _index) const
+{
+  if (_index < this->dataPtr->blends.size())
+    return &this->dataPtr->blends[_index];
+  return nullptr;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::AddBlend(const HeightmapBlend &_blend)
+{
+  this->dataPtr->blends.push_back(_blend);
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<const HeightmapData> Heightmap::Data() const
+{
+  std::shared_ptr<const HeightmapData> data =
+      std::atomic_load(&this->dataPtr->data);
+  if (data || this->dataPtr->uri.empty())
+    return data;
+
+  std::string path = sdf::findFile(this->dataPtr->uri, true, false);
+  if (path.empty() && !this->dataPtr->filePath.empty())
+  {
+    // Look for a relative URI next to the file of the heightmap.
+    std::string relative = this->dataPtr->uri;
+    const std::size_t scheme = relative.find("://");
+    if (scheme != std::string::npos)
+      relative = relative.substr(scheme + 3);
+
+    const std::size_t sep = this->dataPtr->filePath.find_last_of("/\\");
+    if (sep != std::string::npos)
+    {
+      std::string candidate = sdf::filesystem::append(
+          this->dataPtr->filePath.substr(0, sep), relative);
+      if (sdf::filesystem::exists(candidate))
+        path = candidate;
+    }
+  }
+  if (path.empty())
+    return nullptr;
+
+  auto newData = std::make_shared<HeightmapData>();
+  if (!newData->Load(path).empty())
+    return nullptr;
+
+  // Another thread may have loaded the data first, in which case its data
+  // is kept so that all the callers share it.
+  std::shared_ptr<const HeightmapData> expected;
+  std::shared_ptr<const HeightmapData> desired = std::move(newData);
+  if (std::atomic_compare_exchange_strong(
+        &this->dataPtr->data, &expected, desired))
+  {
+    return desired;
+  }
+  return expected;
+}
+
+/////////////////////////////////////////////////
+void Heightmap::SetData(std::shared_ptr<const HeightmapData> _data)
+{
+  std::atomic_store(&this->dataPtr->data, std::move(_data));
+}
+
+/////////////////////////////////////////////////
+std::optional<double> Heightmap::HeightAt(double _x, double _y) const
+{
+  std::shared_ptr<const HeightmapData> data = this->Data();
+  if (!data || data->Cols() == 0 || data->Rows() == 0)
+    return std::nullopt;
+
+  const ignition::math::Vector3d &size = this->dataPtr->size;
+  const ignition::math::Vector3d &position = this->dataPtr->position;
+  const double u = (_x - position.X()) / size.X() + 0.5;
+  const double v = 0.5 - (_y - position.Y()) / size.Y();
+  if (!(u >= 0.0 && u <= 1.0 && v >= 0.0 && v <= 1.0))
+    return std::nullopt;
+
+  return position.Z() + size.Z() * data->Sample(u, v);
+}
@@ -0,0 +1,341 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "sdf/Filesystem.hh"
+#include "sdf/Heightmap.hh"
+#include "test_config.h"
+
+/// \brief Write a 16-bit PGM image whose samples are col + row * cols.
+/// \param[in] _path Path of the image.
+/// \param[in] _cols Number of columns.
+/// \param[in] _rows Number of rows.
+void writePgm(const std::string &_path, unsigned int _cols,
+    unsigned int _rows)
+{
+  std::ofstream file(_path, std::ios::binary);
+  file << "P5\n# test image\n" << _cols << " " << _rows << "\n65535\n";
+  for (unsigned int i = 0; i < _cols * _rows; ++i)
+  {
+    file.put(static_cast<char>(i >> 8));
+    file.put(static_cast<char>(i & 0xff));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(DOMHeightmap, Construction)
+{
+  sdf::Heightmap heightmap;
+  EXPECT_EQ(nullptr, heightmap.Element());
+
+  EXPECT_EQ(std::string(), heightmap.FilePath());
+  EXPECT_EQ(std::string(), heightmap.Uri());
+  EXPECT_EQ(ignition::math::Vector3d::One, heightmap.Size());
+  EXPECT_EQ(ignition::math::Vector3d::Zero, heightmap.Position());
+  EXPECT_FALSE(heightmap.UseTerrainPaging());
+  EXPECT_EQ(2u, heightmap.Sampling());
+  EXPECT_EQ(0u, heightmap.TextureCount());
+  EXPECT_EQ(0u, heightmap.BlendCount());
+  EXPECT_EQ(nullptr, heightmap.TextureByIndex(0u));
+  EXPECT_EQ(nullptr, heightmap.BlendByIndex(0u));
+  EXPECT_EQ(nullptr, heightmap.Data());
+  EXPECT_FALSE(heightmap.HeightAt(0, 0));
+
+  sdf::HeightmapTexture heightmapTexture;
+  EXPECT_EQ(nullptr, heightmapTexture.Element());
+  EXPECT_DOUBLE_EQ(10.0, heightmapTexture.Size());
+  EXPECT_TRUE(heightmapTexture.Diffuse().empty());
+  EXPECT_TRUE(heightmapTexture.Normal().empty());
+
+  sdf::HeightmapBlend heightmapBlend;
+  EXPECT_EQ(nullptr, heightmapBlend.Element());
+  EXPECT_DOUBLE_EQ(0.0, heightmapBlend.MinHeight());
+  EXPECT_DOUBLE_EQ(0.0, heightmapBlend.FadeDistance());
+
+  sdf::HeightmapData data;
+  EXPECT_TRUE(data.Path().empty());
+  EXPECT_EQ(0u, data.Cols());
+  EXPECT_EQ(0u, data.Rows());
+  EXPECT_DOUBLE_EQ(0.0, data.Value(0, 0));
+  EXPECT_DOUBLE_EQ(0.0, data.Sample(0.5, 0.5));
+  EXPECT_EQ(64u, data.TileRows());
+  EXPECT_EQ(64u, data.MaxResidentTiles());
+  EXPECT_EQ(0u, data.ResidentTileCount());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMHeightmap, CopyAndMove)
+{
+  sdf::Heightmap heightmap;
+  heightmap.SetUri("banana");
+  heightmap.SetFilePath("/pear");
+  heightmap.SetSize({0.1, 0.2, 0.3});
+  heightmap.SetPosition({0.5, 0.6, 0.7});
+  heightmap.SetUseTerrainPaging(true);
+  heightmap.SetSampling(123u);
+
+  sdf::HeightmapTexture texture;
+  texture.SetSize(4.0);
+  texture.SetDiffuse("apple");
+  texture.SetNormal("grape");
+  heightmap.AddTexture(texture);
+
+  sdf::HeightmapBlend blend;
+  blend.SetMinHeight(1.5);
+  blend.SetFadeDistance(2.5);
+  heightmap.AddBlend(blend);
+
+  sdf::Heightmap heightmap2(heightmap);
+  EXPECT_EQ("banana", heightmap2.Uri());
+  EXPECT_EQ("/pear", heightmap2.FilePath());
+  EXPECT_EQ(ignition::math::Vector3d(0.1, 0.2, 0.3), heightmap2.Size());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 0.6, 0.7), heightmap2.Position());
+  EXPECT_TRUE(heightmap2.UseTerrainPaging());
+  EXPECT_EQ(123u, heightmap2.Sampling());
+  ASSERT_EQ(1u, heightmap2.TextureCount());
+  ASSERT_NE(nullptr, heightmap2.TextureByIndex(0u));
+  EXPECT_DOUBLE_EQ(4.0, heightmap2.TextureByIndex(0u)->Size());
+  EXPECT_EQ("apple", heightmap2.TextureByIndex(0u)->Diffuse());
+  EXPECT_EQ("grape", heightmap2.TextureByIndex(0u)->Normal());
+  ASSERT_EQ(1u, heightmap2.BlendCount());
+  ASSERT_NE(nullptr, heightmap2.BlendByIndex(0u));
+  EXPECT_DOUBLE_EQ(1.5, heightmap2.BlendByIndex(0u)->MinHeight());
+  EXPECT_DOUBLE_EQ(2.5, heightmap2.BlendByIndex(0u)->FadeDistance());
+
+  sdf::Heightmap heightmap3(std::move(heightmap2));
+  EXPECT_EQ("banana", heightmap3.Uri());
+  EXPECT_EQ(1u, heightmap3.TextureCount());
+
+  sdf::Heightmap heightmap4;
+  heightmap4 = heightmap3;
+  EXPECT_EQ("banana", heightmap4.Uri());
+  EXPECT_EQ(1u, heightmap4.BlendCount());
+
+  sdf::Heightmap heightmap5;
+  heightmap5 = std::move(heightmap4);
+  EXPECT_EQ("banana", heightmap5.Uri());
+
+  // Copy assignment after move
+  heightmap4 = heightmap5;
+  EXPECT_EQ("banana", heightmap4.Uri());
+
+  sdf::HeightmapTexture texture2;
+  texture2 = texture;
+  EXPECT_EQ("apple", texture2.Diffuse());
+  sdf::HeightmapTexture texture3(std::move(texture2));
+  EXPECT_EQ("grape", texture3.Normal());
+
+  sdf::HeightmapBlend blend2;
+  blend2 = blend;
+  EXPECT_DOUBLE_EQ(1.5, blend2.MinHeight());
+  sdf::HeightmapBlend blend3(std::move(blend2));
+  EXPECT_DOUBLE_EQ(2.5, blend3.FadeDistance());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMHeightmap, Load)
+{
+  sdf::Heightmap heightmap;
+  sdf::Errors errors;
+
+  // Null element name
+  errors = heightmap.Load(nullptr);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_MISSING, errors[0].Code());
+  EXPECT_EQ(nullptr, heightmap.Element());
+
+  // Bad element name
+  sdf::ElementPtr sdf(new sdf::Element());
+  sdf->SetName("bad");
+  errors = heightmap.Load(sdf);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_INCORRECT_TYPE, errors[0].Code());
+  EXPECT_NE(nullptr, heightmap.Element());
+
+  // Missing <uri> element
+  sdf->SetName("heightmap");
+  errors = heightmap.Load(sdf);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_MISSING, errors[0].Code());
+  EXPECT_NE(std::string::npos, errors[0].Message().find("missing a <uri>"));
+
+  sdf::HeightmapTexture texture;
+  errors = texture.Load(nullptr);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_MISSING, errors[0].Code());
+
+  errors = texture.Load(sdf);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_INCORRECT_TYPE, errors[0].Code());
+
+  // Missing <size>, <diffuse> and <normal> elements
+  sdf->SetName("texture");
+  errors = texture.Load(sdf);
+  ASSERT_EQ(3u, errors.size());
+  EXPECT_NE(std::string::npos, errors[0].Message().find("missing a <size>"));
+
+  sdf::HeightmapBlend blend;
+  errors = blend.Load(nullptr);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_MISSING, errors[0].Code());
+
+  errors = blend.Load(sdf);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_INCORRECT_TYPE, errors[0].Code());
+
+  // Missing <min_height> and <fade_dist> elements
+  sdf->SetName("blend");
+  errors = blend.Load(sdf);
+  ASSERT_EQ(2u, errors.size());
+  EXPECT_NE(std::string::npos,
+      errors[1].Message().find("missing a <fade_dist>"));
+}
+
+/////////////////////////////////////////////////
+TEST(DOMHeightmap, Data)
+{
+  const std::string pgmPath =
+      sdf::filesystem::append(PROJECT_BINARY_DIR, "heightmap_test.pgm");
+  writePgm(pgmPath, 10, 20);
+
+  sdf::HeightmapData data;
+  sdf::Errors errors = data.Load(pgmPath);
+  ASSERT_TRUE(errors.empty()) << errors[0].Message();
+  EXPECT_EQ(pgmPath, data.Path());
+  EXPECT_EQ(10u, data.Cols());
+  EXPECT_EQ(20u, data.Rows());
+
+  // Only the header is read by Load.
+  EXPECT_EQ(0u, data.ResidentTileCount());
+
+  data.SetTileRows(3);
+  data.SetMaxResidentTiles(2);
+  EXPECT_EQ(3u, data.TileRows());
+  EXPECT_EQ(2u, data.MaxResidentTiles());
+
+  EXPECT_DOUBLE_EQ(0.0, data.Value(0, 0));
+  EXPECT_DOUBLE_EQ(13 / 65535.0, data.Value(3, 1));
+  EXPECT_EQ(1u, data.ResidentTileCount());
+  EXPECT_DOUBLE_EQ(199 / 65535.0, data.Value(9, 19));
+  EXPECT_EQ(2u, data.ResidentTileCount());
+
+  // A third tile evicts the least recently used one.
+  EXPECT_DOUBLE_EQ(105 / 65535.0, data.Value(5, 10));
+  EXPECT_EQ(2u, data.ResidentTileCount());
+  EXPECT_DOUBLE_EQ(13 / 65535.0, data.Value(3, 1));
+  EXPECT_EQ(2u, data.ResidentTileCount());
+
+  // Out of range samples
+  EXPECT_DOUBLE_EQ(0.0, data.Value(10, 0));
+  EXPECT_DOUBLE_EQ(0.0, data.Value(0, 20));
+
+  // Bilinear interpolation, which is exact on a linear ramp.
+  EXPECT_DOUBLE_EQ(0.0, data.Sample(0, 0));
+  EXPECT_DOUBLE_EQ(199 / 65535.0, data.Sample(1, 1));
+  EXPECT_NEAR(4.5 / 65535.0, data.Sample(0.5, 0), 1e-12);
+  EXPECT_NEAR(99.5 / 65535.0, data.Sample(0.5, 0.5), 1e-12);
+  EXPECT_NEAR(199 / 65535.0, data.Sample(2, 3), 1e-12);
+
+  data.SetMaxResidentTiles(1);
+  EXPECT_EQ(1u, data.ResidentTileCount());
+
+  // Heightmap resolves a URI relative to its file.
+  sdf::Heightmap heightmap;
+  heightmap.SetUri("file://heightmap_test.pgm");
+  heightmap.SetFilePath(
+      sdf::filesystem::append(PROJECT_BINARY_DIR, "world.sdf"));
+  heightmap.SetSize({10, 20, 65535});
+  heightmap.SetPosition({0, 0, 1});
+  auto heightmapData = heightmap.Data();
+  ASSERT_NE(nullptr, heightmapData);
+  EXPECT_EQ(pgmPath, heightmapData->Path());
+  EXPECT_EQ(heightmapData, heightmap.Data());
+
+  // The first row is along +y, the first column along -x.
+  auto height = heightmap.HeightAt(-5, 10);
+  ASSERT_TRUE(height);
+  EXPECT_NEAR(1.0, *height, 1e-9);
+  height = heightmap.HeightAt(5, -10);
+  ASSERT_TRUE(height);
+  EXPECT_NEAR(200.0, *height, 1e-9);
+  EXPECT_FALSE(heightmap.HeightAt(5.1, 0));
+
+  // Copies share the data.
+  sdf::Heightmap heightmap2(heightmap);
+  EXPECT_EQ(heightmapData, heightmap2.Data());
+
+  heightmap2.SetUri("file://does_not_exist.pgm");
+  EXPECT_EQ(nullptr, heightmap2.Data());
+  EXPECT_FALSE(heightmap2.HeightAt(0, 0));
+  heightmap2.SetData(heightmapData);
+  EXPECT_EQ(heightmapData, heightmap2.Data());
+
+  std::remove(pgmPath.c_str());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMHeightmap, RawData)
+{
+  const std::string rawPath =
+      sdf::filesystem::append(PROJECT_BINARY_DIR, "heightmap_test.r8");
+  {
+    std::ofstream file(rawPath, std::ios::binary);
+    for (int i = 0; i < 16; ++i)
+      file.put(static_cast<char>(i * 17));
+  }
+
+  sdf::HeightmapData data;
+  sdf::Errors errors = data.Load(rawPath);
+  ASSERT_TRUE(errors.empty()) << errors[0].Message();
+  EXPECT_EQ(4u, data.Cols());
+  EXPECT_EQ(4u, data.Rows());
+  EXPECT_DOUBLE_EQ(0.0, data.Value(0, 0));
+  EXPECT_DOUBLE_EQ(1.0, data.Value(3, 3));
+  EXPECT_DOUBLE_EQ(6 * 17 / 255.0, data.Value(2, 1));
+
+  // A raw file that is not a square grid
+  {
+    std::ofstream file(rawPath, std::ios::binary);
+    file << "abc";
+  }
+  errors = data.Load(rawPath);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::FILE_READ, errors[0].Code());
+  EXPECT_EQ(0u, data.Cols());
+
+  // A truncated PGM image
+  const std::string pgmPath =
+      sdf::filesystem::append(PROJECT_BINARY_DIR, "heightmap_test.pgm");
+  {
+    std::ofstream file(pgmPath, std::ios::binary);
+    file << "P5 4 4 255\n" << "abc";
+  }
+  errors = data.Load(pgmPath);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::FILE_READ, errors[0].Code());
+
+  // A missing file
+  errors = data.Load(rawPath + ".missing");
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::FILE_READ, errors[0].Code());
+
+  std::remove(rawPath.c_str());
+  std::remove(pgmPath.c_str());
+}
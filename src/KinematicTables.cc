@@ -0,0 +1,306 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/Inertial.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "sdf/Joint.hh"
+#include "sdf/JointAxis.hh"
+#include "sdf/KinematicTables.hh"
+#include "sdf/Link.hh"
+#include "sdf/Model.hh"
+
+#include "FrameSemantics.hh"
+
+using namespace sdf;
+
+namespace
+{
+/// \brief Positions of the links added by a call to AddModel, by scoped
+/// name.
+using LinkIndices = std::unordered_map<std::string, std::int64_t>;
+
+/////////////////////////////////////////////////
+/// \brief Append a pose to position and orientation arrays.
+/// \param[in] _pose Pose to append.
+/// \param[in,out] _positions Position array.
+/// \param[in,out] _orientations Orientation array.
+void appendPose(const ignition::math::Pose3d &_pose,
+    std::vector<double> &_positions, std::vector<double> &_orientations)
+{
+  _positions.insert(_positions.end(),
+      {_pose.Pos().X(), _pose.Pos().Y(), _pose.Pos().Z()});
+  _orientations.insert(_orientations.end(),
+      {_pose.Rot().W(), _pose.Rot().X(), _pose.Rot().Y(), _pose.Rot().Z()});
+}
+
+/////////////////////////////////////////////////
+/// \brief Append the inertia tensor of a link, rotated from the inertial
+/// frame to the link frame: R * I * R^T.
+/// \param[in] _inertial Inertial of the link.
+/// \param[in,out] _inertias Inertia array.
+void appendInertia(const ignition::math::Inertiald &_inertial,
+    std::vector<double> &_inertias)
+{
+  const auto &mm = _inertial.MassMatrix();
+  const double inertia[3][3] = {
+    {mm.Ixx(), mm.Ixy(), mm.Ixz()},
+    {mm.Ixy(), mm.Iyy(), mm.Iyz()},
+    {mm.Ixz(), mm.Iyz(), mm.Izz()}};
+
+  ignition::math::Quaterniond q = _inertial.Pose().Rot();
+  q.Normalize();
+  const double w = q.W(), x = q.X(), y = q.Y(), z = q.Z();
+  const double rot[3][3] = {
+    {1 - 2*(y*y + z*z), 2*(x*y - w*z), 2*(x*z + w*y)},
+    {2*(x*y + w*z), 1 - 2*(x*x + z*z), 2*(y*z - w*x)},
+    {2*(x*z - w*y), 2*(y*z + w*x), 1 - 2*(x*x + y*y)}};
+
+  double rotated[3][3];
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = i; j < 3; ++j)
+    {
+      double sum = 0;
+      for (int k = 0; k < 3; ++k)
+      {
+        for (int l = 0; l < 3; ++l)
+          sum += rot[i][k] * inertia[k][l] * rot[j][l];
+      }
+      rotated[i][j] = sum;
+    }
+  }
+
+  _inertias.insert(_inertias.end(),
+      {rotated[0][0], rotated[1][1], rotated[2][2],
+       rotated[0][1], rotated[0][2], rotated[1][2]});
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the index of a link resolved by a joint.
+/// \param[in] _links Indices of the links.
+/// \param[in] _prefix Scope prefix of the model of the joint.
+/// \param[in] _name Name of the link in the scope of the model.
+/// \return Index of the link, or KinematicTables::noLink.
+std::int64_t linkIndex(const LinkIndices &_links, const std::string &_prefix,
+    const std::string &_name)
+{
+  auto it = _links.find(_prefix + _name);
+  return it == _links.end() ? KinematicTables::noLink : it->second;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the pose of a frame resolved by resolveAllPoses.
+/// \param[in] _poses Resolved poses.
+/// \param[in] _name Name of the frame in the resolved scope.
+/// \param[in] _rawPose Pose returned if the frame was not resolved, in
+/// which case resolveAllPoses reported why.
+/// \return The resolved pose, or _rawPose.
+ignition::math::Pose3d resolvedPose(const ResolvedPoses &_poses,
+    const std::string &_name, const ignition::math::Pose3d &_rawPose)
+{
+  auto it = _poses.index.find(_name);
+  return it == _poses.index.end() ? _rawPose : _poses.poses[it->second];
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the name of a frame of a model in a resolved scope.
+/// \param[in] _scope Prefix of the names of the model in the scope.
+/// \param[in] _name Name of the frame in the model.
+/// \return Name of the frame in the scope. The implicit "__model__" frame is
+/// the vertex of the model itself, unless the model is the scope.
+std::string scopedFrameName(const std::string &_scope,
+    const std::string &_name)
+{
+  if (_name == "__model__" && !_scope.empty())
+    return _scope.substr(0, _scope.size() - 2);
+  return _scope + _name;
+}
+
+/////////////////////////////////////////////////
+/// \brief Append the links and joints of a model and of its nested models.
+/// \param[in,out] _tables Tables to append to.
+/// \param[in] _model Model to append.
+/// \param[in] _poses Poses of the frames of a scope that holds the model,
+/// resolved relative to the frame of the scope.
+/// \param[in] _scope Prefix of the names of the model in that scope.
+/// \param[in] _pose Pose of the frame of the scope in the frame of the
+/// tables.
+/// \param[in] _prefix Scope prefix of the names of the model.
+/// \param[in,out] _links Indices of the links added so far.
+/// \param[out] _errors Errors encountered.
+void addModel(KinematicTables &_tables, const Model &_model,
+    const ResolvedPoses &_poses, const std::string &_scope,
+    const ignition::math::Pose3d &_pose, const std::string &_prefix,
+    LinkIndices &_links, Errors &_errors)
+{
+  for (uint64_t i = 0; i < _model.LinkCount(); ++i)
+  {
+    const Link *link = _model.LinkByIndex(i);
+
+    const ignition::math::Pose3d pose =
+        resolvedPose(_poses, _scope + link->Name(), link->RawPose());
+
+    const std::string name = _prefix + link->Name();
+    _links.emplace(name, static_cast<std::int64_t>(_tables.linkNames.size()));
+    _tables.linkNames.push_back(name);
+    appendPose(_pose * pose, _tables.linkPositions, _tables.linkOrientations);
+
+    const ignition::math::Inertiald &inertial = link->Inertial();
+    _tables.linkMasses.push_back(inertial.MassMatrix().Mass());
+    const ignition::math::Vector3d &com = inertial.Pose().Pos();
+    _tables.linkCentersOfMass.insert(_tables.linkCentersOfMass.end(),
+        {com.X(), com.Y(), com.Z()});
+    appendInertia(inertial, _tables.linkInertias);
+  }
+
+  // Nested models are added before the joints, which may refer to their
+  // links.
+  for (uint64_t i = 0; i < _model.ModelCount(); ++i)
+  {
+    const Model *nested = _model.ModelByIndex(i);
+    addModel(_tables, *nested, _poses, _scope + nested->Name() + "::", _pose,
+        _prefix + nested->Name() + "::", _links, _errors);
+  }
+
+  // Limits of joints without axis.
+  static const JointAxis defaultAxis;
+
+  for (uint64_t i = 0; i < _model.JointCount(); ++i)
+  {
+    const Joint *joint = _model.JointByIndex(i);
+    _tables.jointNames.push_back(_prefix + joint->Name());
+    _tables.jointTypes.push_back(joint->Type());
+
+    std::string parent;
+    Errors linkErrors = joint->ResolveParentLink(parent);
+    _errors.insert(_errors.end(), linkErrors.begin(), linkErrors.end());
+    _tables.jointParents.push_back(linkErrors.empty() ?
+        linkIndex(_links, _prefix, parent) : KinematicTables::noLink);
+
+    std::string child;
+    linkErrors = joint->ResolveChildLink(child);
+    _errors.insert(_errors.end(), linkErrors.begin(), linkErrors.end());
+    _tables.jointChildren.push_back(linkErrors.empty() ?
+        linkIndex(_links, _prefix, child) : KinematicTables::noLink);
+
+    const ignition::math::Pose3d pose =
+        resolvedPose(_poses, _scope + joint->Name(), joint->RawPose());
+    appendPose(_pose * pose, _tables.jointPositions,
+        _tables.jointOrientations);
+
+    const JointAxis *axis = joint->Axis(0);
+    ignition::math::Vector3d xyz = ignition::math::Vector3d::Zero;
+    if (axis)
+    {
+      // The axis is expressed in the joint frame unless it names another
+      // frame of the model.
+      const std::string expressedIn = axis->XyzExpressedIn().empty() ?
+          joint->Name() : axis->XyzExpressedIn();
+      auto it = _poses.index.find(scopedFrameName(_scope, expressedIn));
+      if (it != _poses.index.end())
+      {
+        xyz = (_pose.Rot() * _poses.poses[it->second].Rot()).RotateVector(
+            axis->Xyz());
+      }
+      else
+      {
+        // An unresolved joint frame was already reported by
+        // resolveAllPoses.
+        xyz = _pose.Rot().RotateVector(axis->Xyz());
+        if (!axis->XyzExpressedIn().empty())
+        {
+          _errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+              "Unable to resolve the axis of joint [" + _prefix +
+              joint->Name() + "] expressed in frame [" + expressedIn +
+              "]."});
+        }
+      }
+    }
+    else
+    {
+      axis = &defaultAxis;
+    }
+    _tables.jointAxes.insert(_tables.jointAxes.end(),
+        {xyz.X(), xyz.Y(), xyz.Z()});
+    _tables.jointLowerLimits.push_back(axis->Lower());
+    _tables.jointUpperLimits.push_back(axis->Upper());
+    _tables.jointEffortLimits.push_back(axis->Effort());
+    _tables.jointVelocityLimits.push_back(axis->MaxVelocity());
+  }
+}
+}
+
+/////////////////////////////////////////////////
+std::size_t KinematicTables::LinkCount() const
+{
+  return this->linkNames.size();
+}
+
+/////////////////////////////////////////////////
+std::size_t KinematicTables::JointCount() const
+{
+  return this->jointNames.size();
+}
+
+/////////////////////////////////////////////////
+void KinematicTables::Clear()
+{
+  // The arrays are cleared rather than replaced to keep their capacity when
+  // the tables are exported again.
+  for (auto *names : {&this->linkNames, &this->jointNames})
+    names->clear();
+  for (auto *values : {&this->linkPositions, &this->linkOrientations,
+      &this->linkMasses, &this->linkCentersOfMass, &this->linkInertias,
+      &this->jointPositions, &this->jointOrientations, &this->jointAxes,
+      &this->jointLowerLimits, &this->jointUpperLimits,
+      &this->jointEffortLimits, &this->jointVelocityLimits})
+  {
+    values->clear();
+  }
+  this->jointTypes.clear();
+  this->jointParents.clear();
+  this->jointChildren.clear();
+}
+
+/////////////////////////////////////////////////
+Errors KinematicTables::AddModel(const Model &_model,
+    const ignition::math::Pose3d &_pose, const std::string &_prefix)
+{
+  // A single walk down the graph of the model resolves the poses of all
+  // its frames.
+  ResolvedPoses poses;
+  Errors errors = _model.ResolveAllPoses(poses);
+  Errors modelErrors = this->AddModel(_model, poses, "", _pose, _prefix);
+  errors.insert(errors.end(), modelErrors.begin(), modelErrors.end());
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors KinematicTables::AddModel(const Model &_model,
+    const ResolvedPoses &_poses, const std::string &_scope,
+    const ignition::math::Pose3d &_pose, const std::string &_prefix)
+{
+  Errors errors;
+  LinkIndices links;
+  addModel(*this, _model, _poses, _scope, _pose, _prefix, links, errors);
+  return errors;
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "sdf/KinematicTables.hh"
+#include "sdf/Model.hh"
+#include "sdf/Root.hh"
+#include "sdf/World.hh"
+
+/////////////////////////////////////////////////
+/// \brief Check three consecutive values of an array.
+void expectVector(const std::vector<double> &_values, std::size_t _index,
+    double _x, double _y, double _z)
+{
+  ASSERT_LE(3 * _index + 3, _values.size());
+  EXPECT_NEAR(_x, _values[3 * _index], 1e-9);
+  EXPECT_NEAR(_y, _values[3 * _index + 1], 1e-9);
+  EXPECT_NEAR(_z, _values[3 * _index + 2], 1e-9);
+}
+
+const std::string g_sdf = R"(
+<sdf version='1.8'>
+  <world name='default'>
+    <model name='robot'>
+      <pose>1 0 0 0 0 1.5707963267948966</pose>
+      <link name='base'>
+        <inertial>
+          <mass>2</mass>
+          <pose>0.1 0 0 0 0 0</pose>
+          <inertia>
+            <ixx>1</ixx><iyy>2</iyy><izz>3</izz>
+            <ixy>0</ixy><ixz>0</ixz><iyz>0</iyz>
+          </inertia>
+        </inertial>
+      </link>
+      <link name='arm'>
+        <pose>0 1 0 0 0 0</pose>
+        <inertial>
+          <mass>1</mass>
+          <pose>0 0 0 0 0 1.5707963267948966</pose>
+          <inertia>
+            <ixx>1</ixx><iyy>2</iyy><izz>3</izz>
+            <ixy>0</ixy><ixz>0</ixz><iyz>0</iyz>
+          </inertia>
+        </inertial>
+      </link>
+      <joint name='fix' type='fixed'>
+        <parent>world</parent>
+        <child>base</child>
+      </joint>
+      <joint name='elbow' type='revolute'>
+        <pose>0 0 1 0 0 0</pose>
+        <parent>base</parent>
+        <child>arm</child>
+        <axis>
+          <xyz>1 0 0</xyz>
+          <limit>
+            <lower>-1</lower>
+            <upper>2</upper>
+            <effort>10</effort>
+            <velocity>3</velocity>
+          </limit>
+        </axis>
+      </joint>
+      <model name='tool'>
+        <pose>0 0 2 0 0 0</pose>
+        <link name='tip'/>
+      </model>
+      <joint name='mount' type='revolute'>
+        <parent>arm</parent>
+        <child>tool::tip</child>
+        <axis>
+          <xyz>0 0 1</xyz>
+        </axis>
+      </joint>
+    </model>
+  </world>
+</sdf>)";
+
+/////////////////////////////////////////////////
+TEST(KinematicTables, Construction)
+{
+  sdf::KinematicTables tables;
+  EXPECT_EQ(0u, tables.LinkCount());
+  EXPECT_EQ(0u, tables.JointCount());
+
+  tables.linkNames.push_back("link");
+  tables.linkMasses.push_back(1.0);
+  EXPECT_EQ(1u, tables.LinkCount());
+
+  tables.Clear();
+  EXPECT_EQ(0u, tables.LinkCount());
+  EXPECT_TRUE(tables.linkMasses.empty());
+}
+
+/////////////////////////////////////////////////
+TEST(KinematicTables, World)
+{
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(g_sdf);
+  EXPECT_TRUE(errors.empty()) << errors;
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+
+  sdf::KinematicTables tables;
+  errors = world->ExportKinematicTables(tables);
+  EXPECT_TRUE(errors.empty()) << errors;
+
+  ASSERT_EQ(3u, tables.LinkCount());
+  EXPECT_EQ("robot::base", tables.linkNames[0]);
+  EXPECT_EQ("robot::arm", tables.linkNames[1]);
+  EXPECT_EQ("robot::tool::tip", tables.linkNames[2]);
+  EXPECT_EQ(3u * sdf::KinematicTables::positionSize,
+            tables.linkPositions.size());
+  EXPECT_EQ(3u * sdf::KinematicTables::orientationSize,
+            tables.linkOrientations.size());
+  EXPECT_EQ(3u * sdf::KinematicTables::inertiaSize,
+            tables.linkInertias.size());
+
+  // The model is rotated by 90 degrees about z.
+  expectVector(tables.linkPositions, 0, 1, 0, 0);
+  expectVector(tables.linkPositions, 1, 0, 0, 0);
+  expectVector(tables.linkPositions, 2, 1, 0, 2);
+  EXPECT_NEAR(std::sqrt(0.5), tables.linkOrientations[0], 1e-9);
+  EXPECT_NEAR(std::sqrt(0.5), tables.linkOrientations[3], 1e-9);
+
+  EXPECT_DOUBLE_EQ(2.0, tables.linkMasses[0]);
+  EXPECT_DOUBLE_EQ(1.0, tables.linkMasses[1]);
+  expectVector(tables.linkCentersOfMass, 0, 0.1, 0, 0);
+
+  // The inertia of the arm is expressed in a frame rotated by 90 degrees
+  // about z, so ixx and iyy are swapped in the link frame.
+  EXPECT_NEAR(1.0, tables.linkInertias[0], 1e-9);
+  EXPECT_NEAR(2.0, tables.linkInertias[1], 1e-9);
+  EXPECT_NEAR(2.0, tables.linkInertias[6], 1e-9);
+  EXPECT_NEAR(1.0, tables.linkInertias[7], 1e-9);
+  EXPECT_NEAR(3.0, tables.linkInertias[8], 1e-9);
+  EXPECT_NEAR(0.0, tables.linkInertias[9], 1e-9);
+
+  ASSERT_EQ(3u, tables.JointCount());
+  EXPECT_EQ("robot::fix", tables.jointNames[0]);
+  EXPECT_EQ("robot::elbow", tables.jointNames[1]);
+  EXPECT_EQ("robot::mount", tables.jointNames[2]);
+  EXPECT_EQ(sdf::JointType::FIXED, tables.jointTypes[0]);
+  EXPECT_EQ(sdf::JointType::REVOLUTE, tables.jointTypes[1]);
+
+  EXPECT_EQ(sdf::KinematicTables::noLink, tables.jointParents[0]);
+  EXPECT_EQ(0, tables.jointChildren[0]);
+  EXPECT_EQ(0, tables.jointParents[1]);
+  EXPECT_EQ(1, tables.jointChildren[1]);
+  EXPECT_EQ(1, tables.jointParents[2]);
+  EXPECT_EQ(2, tables.jointChildren[2]);
+
+  // The elbow is 1 m above the arm, and its axis is rotated with the model.
+  expectVector(tables.jointPositions, 1, 0, 0, 1);
+  expectVector(tables.jointAxes, 0, 0, 0, 0);
+  expectVector(tables.jointAxes, 1, 0, 1, 0);
+  expectVector(tables.jointAxes, 2, 0, 0, 1);
+  EXPECT_DOUBLE_EQ(-1.0, tables.jointLowerLimits[1]);
+  EXPECT_DOUBLE_EQ(2.0, tables.jointUpperLimits[1]);
+  EXPECT_DOUBLE_EQ(10.0, tables.jointEffortLimits[1]);
+  EXPECT_DOUBLE_EQ(3.0, tables.jointVelocityLimits[1]);
+}
+
+/////////////////////////////////////////////////
+TEST(KinematicTables, Model)
+{
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(g_sdf);
+  EXPECT_TRUE(errors.empty()) << errors;
+  const sdf::Model *model = root.WorldByIndex(0)->ModelByIndex(0);
+  ASSERT_NE(nullptr, model);
+
+  sdf::KinematicTables tables;
+  tables.linkNames.push_back("stale");
+  errors = model->ExportKinematicTables(tables);
+  EXPECT_TRUE(errors.empty()) << errors;
+
+  // Poses are expressed in the model frame.
+  ASSERT_EQ(3u, tables.LinkCount());
+  EXPECT_EQ("base", tables.linkNames[0]);
+  EXPECT_EQ("tool::tip", tables.linkNames[2]);
+  expectVector(tables.linkPositions, 0, 0, 0, 0);
+  expectVector(tables.linkPositions, 1, 0, 1, 0);
+  expectVector(tables.linkPositions, 2, 0, 0, 2);
+  expectVector(tables.jointPositions, 1, 0, 1, 1);
+  expectVector(tables.jointAxes, 1, 1, 0, 0);
+  EXPECT_EQ(2, tables.jointChildren[2]);
+}
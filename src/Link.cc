@@ -30,6 +30,7 @@
 #include "sdf/Visual.hh"
 
 #include "FrameSemantics.hh"
+#include "NameIndex.hh"
 #include "ScopedGraph.hh"
 #include "Utils.hh"
 
@@ -58,6 +59,18 @@ class sdf::LinkPrivate
   /// \brief The sensors specified in this link.
   public: std::vector<Sensor> sensors;
 
+  /// \brief Positions of the visuals by name.
+  public: NameIndex visualIndex;
+
+  /// \brief Positions of the lights by name.
+  public: NameIndex lightIndex;
+
+  /// \brief Positions of the collisions by name.
+  public: NameIndex collisionIndex;
+
+  /// \brief Positions of the sensors by name.
+  public: NameIndex sensorIndex;
+
   /// \brief The inertial information for this link.
   public: ignition::math::Inertiald inertial {{1.0,
             ignition::math::Vector3d::One, ignition::math::Vector3d::Zero},
@@ -150,21 +163,25 @@ Errors Link::Load(ElementPtr _sdf)
   Errors visLoadErrors = loadUniqueRepeated<Visual>(_sdf, "visual",
       this->dataPtr->visuals);
   errors.insert(errors.end(), visLoadErrors.begin(), visLoadErrors.end());
+  this->dataPtr->visualIndex.Build(this->dataPtr->visuals);
 
   // Load all the collisions.
   Errors collLoadErrors = loadUniqueRepeated<Collision>(_sdf, "collision",
       this->dataPtr->collisions);
   errors.insert(errors.end(), collLoadErrors.begin(), collLoadErrors.end());
+  this->dataPtr->collisionIndex.Build(this->dataPtr->collisions);
 
   // Load all the lights.
   Errors lightLoadErrors = loadUniqueRepeated<Light>(_sdf, "light",
       this->dataPtr->lights);
   errors.insert(errors.end(), lightLoadErrors.begin(), lightLoadErrors.end());
+  this->dataPtr->lightIndex.Build(this->dataPtr->lights);
 
   // Load all the sensors.
   Errors sensorLoadErrors = loadUniqueRepeated<Sensor>(_sdf, "sensor",
       this->dataPtr->sensors);
   errors.insert(errors.end(), sensorLoadErrors.begin(), sensorLoadErrors.end());
+  this->dataPtr->sensorIndex.Build(this->dataPtr->sensors);
 
   ignition::math::Vector3d xxyyzz = ignition::math::Vector3d::One;
   ignition::math::Vector3d xyxzyz = ignition::math::Vector3d::Zero;
@@ -242,14 +259,7 @@ const Visual *Link::VisualByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Link::VisualNameExists(const std::string &_name) const
 {
-  for (auto const &v : this->dataPtr->visuals)
-  {
-    if (v.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return nullptr != this->VisualByName(_name);
 }
 
 /////////////////////////////////////////////////
@@ -269,14 +279,7 @@ const Collision *Link::CollisionByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Link::CollisionNameExists(const std::string &_name) const
 {
-  for (auto const &c : this->dataPtr->collisions)
-  {
-    if (c.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return nullptr != this->CollisionByName(_name);
 }
 
 /////////////////////////////////////////////////
@@ -316,27 +319,14 @@ const Sensor *Link::SensorByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Link::SensorNameExists(const std::string &_name) const
 {
-  for (auto const &s : this->dataPtr->sensors)
-  {
-    if (s.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return nullptr != this->SensorByName(_name);
 }
 
 /////////////////////////////////////////////////
 const Sensor *Link::SensorByName(const std::string &_name) const
 {
-  for (auto const &s : this->dataPtr->sensors)
-  {
-    if (s.Name() == _name)
-    {
-      return &s;
-    }
-  }
-  return nullptr;
+  const std::size_t pos = this->dataPtr->sensorIndex.Find(_name);
+  return pos == NameIndex::npos ? nullptr : &this->dataPtr->sensors[pos];
 }
 
 /////////////////////////////////////////////////
@@ -418,40 +408,22 @@ sdf::SemanticPose Link::SemanticPose() const
 /////////////////////////////////////////////////
 const Visual *Link::VisualByName(const std::string &_name) const
 {
-  for (auto const &v : this->dataPtr->visuals)
-  {
-    if (v.Name() == _name)
-    {
-      return &v;
-    }
-  }
-  return nullptr;
+  const std::size_t pos = this->dataPtr->visualIndex.Find(_name);
+  return pos == NameIndex::npos ? nullptr : &this->dataPtr->visuals[pos];
 }
 
 /////////////////////////////////////////////////
 const Collision *Link::CollisionByName(const std::string &_name) const
 {
-  for (auto const &c : this->dataPtr->collisions)
-  {
-    if (c.Name() == _name)
-    {
-      return &c;
-    }
-  }
-  return nullptr;
+  const std::size_t pos = this->dataPtr->collisionIndex.Find(_name);
+  return pos == NameIndex::npos ? nullptr : &this->dataPtr->collisions[pos];
 }
 
 /////////////////////////////////////////////////
 const Light *Link::LightByName(const std::string &_name) const
 {
-  for (auto const &c : this->dataPtr->lights)
-  {
-    if (c.Name() == _name)
-    {
-      return &c;
-    }
-  }
-  return nullptr;
+  const std::size_t pos = this->dataPtr->lightIndex.Find(_name);
+  return pos == NameIndex::npos ? nullptr : &this->dataPtr->lights[pos];
 }
 
 /////////////////////////////////////////////////
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <string>
+
+#include "sdf/MemoryBreakdown.hh"
+
+using namespace sdf;
+
+/////////////////////////////////////////////////
+std::size_t MemoryBreakdown::TotalBytes() const
+{
+  return this->stringBytes + this->descriptionBytes + this->domBytes;
+}
+
+/////////////////////////////////////////////////
+MemoryBreakdown &MemoryBreakdown::operator+=(const MemoryBreakdown &_other)
+{
+  this->elementCount += _other.elementCount;
+  this->paramCount += _other.paramCount;
+  this->stringBytes += _other.stringBytes;
+  this->descriptionBytes += _other.descriptionBytes;
+  this->domBytes += _other.domBytes;
+  return *this;
+}
+
+/////////////////////////////////////////////////
+std::size_t MemoryBreakdown::StringHeapBytes(const std::string &_str)
+{
+  // The capacity of an empty string is the capacity of the inline buffer.
+  static const std::size_t inlineCapacity = std::string().capacity();
+  if (_str.capacity() <= inlineCapacity)
+    return 0;
+  return _str.capacity() + 1;
+}
+
+/////////////////////////////////////////////////
+std::ostream &sdf::operator<<(std::ostream &_out,
+    const MemoryBreakdown &_usage)
+{
+  _out << "Elements:          " << _usage.elementCount << "\n"
+       << "Params:            " << _usage.paramCount << "\n"
+       << "String bytes:      " << _usage.stringBytes << "\n"
+       << "Description bytes: " << _usage.descriptionBytes << "\n"
+       << "DOM bytes:         " << _usage.domBytes << "\n"
+       << "Total bytes:       " << _usage.TotalBytes() << "\n";
+  return _out;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "sdf/MemoryBreakdown.hh"
+
+/////////////////////////////////////////////////
+TEST(MemoryBreakdown, Sum)
+{
+  sdf::MemoryBreakdown usage;
+  EXPECT_EQ(0u, usage.TotalBytes());
+
+  sdf::MemoryBreakdown other;
+  other.elementCount = 1;
+  other.paramCount = 2;
+  other.stringBytes = 3;
+  other.descriptionBytes = 4;
+  other.domBytes = 5;
+
+  usage += other;
+  usage += other;
+  EXPECT_EQ(2u, usage.elementCount);
+  EXPECT_EQ(4u, usage.paramCount);
+  EXPECT_EQ(24u, usage.TotalBytes());
+
+  std::ostringstream stream;
+  stream << usage;
+  EXPECT_EQ(
+      "Elements:          2\n"
+      "Params:            4\n"
+      "String bytes:      6\n"
+      "Description bytes: 8\n"
+      "DOM bytes:         10\n"
+      "Total bytes:       24\n", stream.str());
+}
+
+/////////////////////////////////////////////////
+TEST(MemoryBreakdown, StringHeapBytes)
+{
+  EXPECT_EQ(0u, sdf::MemoryBreakdown::StringHeapBytes(""));
+  EXPECT_EQ(0u, sdf::MemoryBreakdown::StringHeapBytes("a"));
+
+  const std::string text(1000, 'a');
+  EXPECT_GT(sdf::MemoryBreakdown::StringHeapBytes(text), text.size());
+}
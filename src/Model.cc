@@ -23,10 +23,13 @@
 #include "sdf/Error.hh"
 #include "sdf/Frame.hh"
 #include "sdf/Joint.hh"
+#include "sdf/KinematicTables.hh"
 #include "sdf/Link.hh"
 #include "sdf/Model.hh"
 #include "sdf/Types.hh"
+#include "sdf/WorldState.hh"
 #include "FrameSemantics.hh"
+#include "NameIndex.hh"
 #include "ScopedGraph.hh"
 #include "Utils.hh"
 
@@ -74,6 +77,18 @@ class sdf::ModelPrivate
   /// \brief The nested models specified in this model.
   public: std::vector<Model> models;
 
+  /// \brief Positions of the links by name.
+  public: NameIndex linkIndex;
+
+  /// \brief Positions of the joints by name.
+  public: NameIndex jointIndex;
+
+  /// \brief Positions of the frames by name.
+  public: NameIndex frameIndex;
+
+  /// \brief Positions of the nested models by name.
+  public: NameIndex modelIndex;
+
   /// \brief The SDF element pointer used during load.
   public: sdf::ElementPtr sdf;
 
@@ -85,6 +100,21 @@ class sdf::ModelPrivate
 
   /// \brief Scope name of parent Pose Relative-To Graph (world or __model__).
   public: std::string poseGraphScopeVertexName;
+
+  /// \brief Prototype shared by an instance, or nullptr if this model owns
+  /// its links, joints, frames and nested models.
+  public: std::shared_ptr<const Model> prototype;
+
+  /// \brief Private data of the prototype, kept alive by prototype.
+  public: const ModelPrivate *prototypeData = nullptr;
+
+  /// \brief Get the data holding the links, joints, frames and nested
+  /// models, which is the data of the prototype for an instance.
+  /// \return Data of the prototype, or this.
+  public: const ModelPrivate &Contents() const
+  {
+    return this->prototypeData ? *this->prototypeData : *this;
+  }
 };
 
 /////////////////////////////////////////////////
@@ -131,6 +161,8 @@ Errors Model::Load(ElementPtr _sdf)
   Errors errors;
 
   this->dataPtr->sdf = _sdf;
+  this->dataPtr->prototype.reset();
+  this->dataPtr->prototypeData = nullptr;
   ignition::math::SemanticVersion sdfVersion(_sdf->OriginalVersion());
 
   // Check that the provided SDF element is a <model>
@@ -207,6 +239,7 @@ Errors Model::Load(ElementPtr _sdf)
   {
     frameNames.insert(model.Name());
   }
+  this->dataPtr->modelIndex.Build(this->dataPtr->models);
 
   // Load all the links.
   Errors linkLoadErrors = loadUniqueRepeated<Link>(_sdf, "link",
@@ -244,6 +277,7 @@ Errors Model::Load(ElementPtr _sdf)
     }
     frameNames.insert(linkName);
   }
+  this->dataPtr->linkIndex.Build(this->dataPtr->links);
 
   // If the model is not static and has no nested models:
   // Require at least one link so the implicit model frame can be attached to
@@ -291,6 +325,7 @@ Errors Model::Load(ElementPtr _sdf)
     }
     frameNames.insert(jointName);
   }
+  this->dataPtr->jointIndex.Build(this->dataPtr->joints);
 
   // Load all the frames.
   Errors frameLoadErrors = loadUniqueRepeated<Frame>(_sdf, "frame",
@@ -328,11 +363,143 @@ Errors Model::Load(ElementPtr _sdf)
     }
     frameNames.insert(frameName);
   }
+  this->dataPtr->frameIndex.Build(this->dataPtr->frames);
+
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors Model::LoadInstance(ElementPtr _sdf,
+    std::shared_ptr<const Model> _prototype)
+{
+  Errors errors;
+
+  if (!_prototype)
+  {
+    errors.push_back({ErrorCode::ELEMENT_INVALID,
+        "Attempting to load a model instance without a prototype."});
+    return errors;
+  }
+
+  if (_sdf->GetName() != "model")
+  {
+    errors.push_back({ErrorCode::ELEMENT_INCORRECT_TYPE,
+        "Attempting to load a Model, but the provided SDF element is not a "
+        "<model>."});
+    return errors;
+  }
+
+  *this->dataPtr = ModelPrivate();
+  this->SetPrototype(std::move(_prototype));
+  this->dataPtr->sdf = _sdf;
+
+  if (!loadName(_sdf, this->dataPtr->name))
+  {
+    errors.push_back({ErrorCode::ATTRIBUTE_MISSING,
+                     "A model name is required, but the name is not set."});
+  }
+
+  if (isReservedName(this->dataPtr->name))
+  {
+    errors.push_back({ErrorCode::RESERVED_NAME,
+                     "The supplied model name [" + this->dataPtr->name +
+                     "] is reserved."});
+  }
 
+  this->dataPtr->placementFrameName =
+      _sdf->Get<std::string>("placement_frame", "").first;
+
+  this->dataPtr->isStatic = _sdf->Get<bool>("static", false).first;
+
+  loadPose(_sdf, this->dataPtr->pose, this->dataPtr->poseRelativeTo);
+
+  if (!this->Static() && this->LinkCount() == 0 && this->ModelCount() == 0)
+  {
+    errors.push_back({ErrorCode::MODEL_WITHOUT_LINK,
+                     "A model must have at least one link."});
+  }
 
   return errors;
 }
 
+/////////////////////////////////////////////////
+void Model::SetPrototype(std::shared_ptr<const Model> _prototype)
+{
+  ModelPrivate &data = *this->dataPtr;
+  data.links.clear();
+  data.joints.clear();
+  data.frames.clear();
+  data.models.clear();
+  data.linkIndex.Clear();
+  data.jointIndex.Clear();
+  data.frameIndex.Clear();
+  data.modelIndex.Clear();
+
+  if (!_prototype)
+  {
+    data.prototype.reset();
+    data.prototypeData = nullptr;
+    return;
+  }
+
+  // Share the contents of the prototype of an instance rather than the
+  // instance itself, so that instances never chain.
+  if (_prototype->dataPtr->prototype)
+    _prototype = _prototype->dataPtr->prototype;
+
+  // Copy the properties of the prototype that are not specific to an
+  // instance. The links, joints, frames and nested models are shared.
+  const ModelPrivate &proto = *_prototype->dataPtr;
+  data.selfCollide = proto.selfCollide;
+  data.allowAutoDisable = proto.allowAutoDisable;
+  data.enableWind = proto.enableWind;
+  data.canonicalLink = proto.canonicalLink;
+  data.prototypeData = &proto;
+  data.prototype = std::move(_prototype);
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<const Model> Model::LoadPrototype(ElementPtr _sdf,
+    Errors &_errors)
+{
+  auto prototype = std::make_shared<Model>();
+  Errors errors = prototype->Load(_sdf);
+  _errors.insert(_errors.end(), errors.begin(), errors.end());
+
+  // Build graphs owned by the prototype, like Root::Load does for a
+  // standalone model.
+  ScopedGraph<FrameAttachedToGraph> frameAttachedToGraph(
+      std::make_shared<FrameAttachedToGraph>());
+  errors = buildFrameAttachedToGraph(frameAttachedToGraph, prototype.get());
+  _errors.insert(_errors.end(), errors.begin(), errors.end());
+  errors = validateFrameAttachedToGraph(frameAttachedToGraph);
+  _errors.insert(_errors.end(), errors.begin(), errors.end());
+  prototype->SetFrameAttachedToGraph(frameAttachedToGraph);
+
+  ScopedGraph<PoseRelativeToGraph> poseRelativeToGraph(
+      std::make_shared<PoseRelativeToGraph>());
+  errors = buildPoseRelativeToGraph(poseRelativeToGraph, prototype.get());
+  _errors.insert(_errors.end(), errors.begin(), errors.end());
+  errors = validatePoseRelativeToGraph(poseRelativeToGraph);
+  _errors.insert(_errors.end(), errors.begin(), errors.end());
+  prototype->SetPoseRelativeToGraph(poseRelativeToGraph);
+
+  return prototype;
+}
+
+/////////////////////////////////////////////////
+bool Model::IsInstance() const
+{
+  return nullptr != this->dataPtr->prototype;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<const Model> Model::Prototype() const
+{
+  return this->dataPtr->prototype;
+}
+
 /////////////////////////////////////////////////
 std::string Model::Name() const
 {
@@ -396,14 +563,14 @@ void Model::SetEnableWind(const bool _enableWind)
 /////////////////////////////////////////////////
 uint64_t Model::LinkCount() const
 {
-  return this->dataPtr->links.size();
+  return this->dataPtr->Contents().links.size();
 }
 
 /////////////////////////////////////////////////
 const Link *Model::LinkByIndex(const uint64_t _index) const
 {
-  if (_index < this->dataPtr->links.size())
-    return &this->dataPtr->links[_index];
+  if (_index < this->dataPtr->Contents().links.size())
+    return &this->dataPtr->Contents().links[_index];
   return nullptr;
 }
 
@@ -416,14 +583,14 @@ bool Model::LinkNameExists(const std::string &_name) const
 /////////////////////////////////////////////////
 uint64_t Model::JointCount() const
 {
-  return this->dataPtr->joints.size();
+  return this->dataPtr->Contents().joints.size();
 }
 
 /////////////////////////////////////////////////
 const Joint *Model::JointByIndex(const uint64_t _index) const
 {
-  if (_index < this->dataPtr->joints.size())
-    return &this->dataPtr->joints[_index];
+  if (_index < this->dataPtr->Contents().joints.size())
+    return &this->dataPtr->Contents().joints[_index];
   return nullptr;
 }
 
@@ -436,43 +603,24 @@ bool Model::JointNameExists(const std::string &_name) const
 /////////////////////////////////////////////////
 const Joint *Model::JointByName(const std::string &_name) const
 {
-  auto index = _name.rfind("::");
-  if (index != std::string::npos)
-  {
-    const Model *model = this->ModelByName(_name.substr(0, index));
-    if (nullptr != model)
-    {
-      return model->JointByName(_name.substr(index + 2));
-    }
-
-    // The nested model name preceding the last "::" could not be found.
-    // For now, try to find a link that matches _name exactly.
-    // When "::" are reserved and not allowed in names, then uncomment
-    // the following line to return a nullptr.
-    // return nullptr;
-  }
-
-  for (auto const &j : this->dataPtr->joints)
-  {
-    if (j.Name() == _name)
-    {
-      return &j;
-    }
-  }
-  return nullptr;
+  std::string_view name = _name;
+  const Model *scope = this->ScopeOf(name);
+  const std::size_t pos = scope->dataPtr->Contents().jointIndex.Find(name);
+  return pos == NameIndex::npos ?
+      nullptr : &scope->dataPtr->Contents().joints[pos];
 }
 
 /////////////////////////////////////////////////
 uint64_t Model::FrameCount() const
 {
-  return this->dataPtr->frames.size();
+  return this->dataPtr->Contents().frames.size();
 }
 
 /////////////////////////////////////////////////
 const Frame *Model::FrameByIndex(const uint64_t _index) const
 {
-  if (_index < this->dataPtr->frames.size())
-    return &this->dataPtr->frames[_index];
+  if (_index < this->dataPtr->Contents().frames.size())
+    return &this->dataPtr->Contents().frames[_index];
   return nullptr;
 }
 
@@ -485,43 +633,24 @@ bool Model::FrameNameExists(const std::string &_name) const
 /////////////////////////////////////////////////
 const Frame *Model::FrameByName(const std::string &_name) const
 {
-  auto index = _name.rfind("::");
-  if (index != std::string::npos)
-  {
-    const Model *model = this->ModelByName(_name.substr(0, index));
-    if (nullptr != model)
-    {
-      return model->FrameByName(_name.substr(index + 2));
-    }
-
-    // The nested model name preceding the last "::" could not be found.
-    // For now, try to find a link that matches _name exactly.
-    // When "::" are reserved and not allowed in names, then uncomment
-    // the following line to return a nullptr.
-    // return nullptr;
-  }
-
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return &f;
-    }
-  }
-  return nullptr;
+  std::string_view name = _name;
+  const Model *scope = this->ScopeOf(name);
+  const std::size_t pos = scope->dataPtr->Contents().frameIndex.Find(name);
+  return pos == NameIndex::npos ?
+      nullptr : &scope->dataPtr->Contents().frames[pos];
 }
 
 /////////////////////////////////////////////////
 uint64_t Model::ModelCount() const
 {
-  return this->dataPtr->models.size();
+  return this->dataPtr->Contents().models.size();
 }
 
 /////////////////////////////////////////////////
 const Model *Model::ModelByIndex(const uint64_t _index) const
 {
-  if (_index < this->dataPtr->models.size())
-    return &this->dataPtr->models[_index];
+  if (_index < this->dataPtr->Contents().models.size())
+    return &this->dataPtr->Contents().models[_index];
   return nullptr;
 }
 
@@ -534,24 +663,120 @@ bool Model::ModelNameExists(const std::string &_name) const
 /////////////////////////////////////////////////
 const Model *Model::ModelByName(const std::string &_name) const
 {
-  auto index = _name.find("::");
-  const std::string nextModelName = _name.substr(0, index);
-  const Model *nextModel = nullptr;
+  return this->ModelByScopedName(_name);
+}
+
+/////////////////////////////////////////////////
+const Model *Model::ModelByScopedName(std::string_view _name) const
+{
+  const Model *model = this;
+  while (true)
+  {
+    const auto index = _name.find("::");
+    const std::size_t pos =
+        model->dataPtr->Contents().modelIndex.Find(_name.substr(0, index));
+    if (pos == NameIndex::npos)
+      return nullptr;
+
+    model = &model->dataPtr->Contents().models[pos];
+    if (index == std::string_view::npos)
+      return model;
+    _name.remove_prefix(index + 2);
+  }
+}
 
-  for (auto const &m : this->dataPtr->models)
+/////////////////////////////////////////////////
+const Model *Model::ScopeOf(std::string_view &_name) const
+{
+  const auto index = _name.rfind("::");
+  if (index != std::string_view::npos)
   {
-    if (m.Name() == nextModelName)
+    const Model *model = this->ModelByScopedName(_name.substr(0, index));
+    if (nullptr != model)
     {
-      nextModel = &m;
-      break;
+      _name.remove_prefix(index + 2);
+      return model;
     }
+
+    // The nested model name preceding the last "::" could not be found.
+    // For now, try to find an object that matches _name exactly.
+    // When "::" are reserved and not allowed in names, then return a
+    // nullptr instead.
   }
+  return this;
+}
+
+/////////////////////////////////////////////////
+Errors Model::ApplyState(const ModelState &_state)
+{
+  Errors errors;
+  ModelPrivate &data = *this->dataPtr;
 
-  if (nullptr != nextModel && index != std::string::npos)
+  if (_state.pose)
   {
-    return nextModel->ModelByName(_name.substr(index + 2));
+    data.pose = *_state.pose;
+    if (data.poseGraph)
+    {
+      Errors graphErrors = updatePoseRelativeToGraph(data.poseGraph, *this);
+      errors.insert(errors.end(), graphErrors.begin(), graphErrors.end());
+    }
   }
-  return nextModel;
+
+  if (_state.links.empty() && _state.models.empty())
+    return errors;
+
+  // The links and nested models of an instance belong to its prototype,
+  // which is shared with other models.
+  if (data.prototype)
+  {
+    errors.push_back({ErrorCode::ELEMENT_INVALID,
+        "The states of the links and nested models of model with name [" +
+        data.name + "] are not applied, because the model shares them with "
+        "other instances of its prototype."});
+    return errors;
+  }
+
+  auto childPoseGraph = data.poseGraph ?
+      data.poseGraph.ChildModelScope(data.name) : data.poseGraph;
+  for (const LinkState &linkState : _state.links)
+  {
+    const std::size_t pos = data.linkIndex.Find(linkState.name);
+    if (pos == NameIndex::npos)
+    {
+      errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "State of link with name [" + linkState.name +
+          "] does not match a link in model with name [" + data.name + "]."});
+      continue;
+    }
+    if (!linkState.pose)
+      continue;
+
+    data.links[pos].SetRawPose(*linkState.pose);
+    if (childPoseGraph)
+    {
+      Errors graphErrors = updatePoseRelativeToGraph(
+          childPoseGraph, linkState.name, *linkState.pose);
+      errors.insert(errors.end(), graphErrors.begin(), graphErrors.end());
+    }
+  }
+
+  for (const ModelState &modelState : _state.models)
+  {
+    const std::size_t pos = data.modelIndex.Find(modelState.name);
+    if (pos == NameIndex::npos)
+    {
+      errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "State of nested model with name [" + modelState.name +
+          "] does not match a nested model in model with name [" +
+          data.name + "]."});
+      continue;
+    }
+
+    Errors nestedErrors = data.models[pos].ApplyState(modelState);
+    errors.insert(errors.end(), nestedErrors.begin(), nestedErrors.end());
+  }
+
+  return errors;
 }
 
 /////////////////////////////////////////////////
@@ -707,34 +932,35 @@ sdf::SemanticPose Model::SemanticPose() const
 /////////////////////////////////////////////////
 const Link *Model::LinkByName(const std::string &_name) const
 {
-  auto index = _name.rfind("::");
-  if (index != std::string::npos)
-  {
-    const Model *model = this->ModelByName(_name.substr(0, index));
-    if (nullptr != model)
-    {
-      return model->LinkByName(_name.substr(index + 2));
-    }
+  std::string_view name = _name;
+  const Model *scope = this->ScopeOf(name);
+  const std::size_t pos = scope->dataPtr->Contents().linkIndex.Find(name);
+  return pos == NameIndex::npos ?
+      nullptr : &scope->dataPtr->Contents().links[pos];
+}
 
-    // The nested model name preceding the last "::" could not be found.
-    // For now, try to find a link that matches _name exactly.
-    // When "::" are reserved and not allowed in names, then uncomment
-    // the following line to return a nullptr.
-    // return nullptr;
-  }
+/////////////////////////////////////////////////
+sdf::ElementPtr Model::Element() const
+{
+  return this->dataPtr->sdf;
+}
 
-  for (auto const &l : this->dataPtr->links)
+/////////////////////////////////////////////////
+Errors Model::ResolveAllPoses(ResolvedPoses &_poses) const
+{
+  if (!this->dataPtr->poseGraph)
   {
-    if (l.Name() == _name)
-    {
-      return &l;
-    }
+    _poses = ResolvedPoses();
+    return {{ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "Model has invalid pointer to PoseRelativeToGraph."}};
   }
-  return nullptr;
+  return resolveAllPoses(_poses,
+      this->dataPtr->poseGraph.ChildModelScope(this->Name()));
 }
 
 /////////////////////////////////////////////////
-sdf::ElementPtr Model::Element() const
+Errors Model::ExportKinematicTables(KinematicTables &_tables) const
 {
-  return this->dataPtr->sdf;
+  _tables.Clear();
+  return _tables.AddModel(*this, ignition::math::Pose3d::Zero, "");
 }
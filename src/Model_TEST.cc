@@ -15,6 +15,8 @@
  *
 */
 
+#include <memory>
+#include <string>
 #include <gtest/gtest.h>
 #include <ignition/math/Pose3.hh>
 #include "sdf/Joint.hh"
@@ -200,3 +202,78 @@ TEST(DOMModel, CopyAssignmentAfterMove)
   EXPECT_EQ("model2", model1.Name());
   EXPECT_EQ("model1", model2.Name());
 }
+
+/////////////////////////////////////////////////
+/// \brief Create an element with a name attribute.
+/// \param[in] _type Name of the element.
+/// \param[in] _name Value of the name attribute.
+/// \param[in] _parent Parent of the element, or nullptr.
+/// \return The new element.
+sdf::ElementPtr namedElement(const std::string &_type,
+    const std::string &_name, const sdf::ElementPtr &_parent)
+{
+  sdf::ElementPtr elem(new sdf::Element);
+  elem->SetName(_type);
+  elem->AddAttribute("name", "string", "", true);
+  elem->GetAttribute("name")->SetFromString(_name);
+  if (_parent)
+  {
+    elem->SetParent(_parent);
+    _parent->InsertElement(elem);
+  }
+  return elem;
+}
+
+/////////////////////////////////////////////////
+TEST(DOMModel, LoadInstance)
+{
+  sdf::ElementPtr protoElem = namedElement("model", "proto", nullptr);
+  namedElement("link", "base", protoElem);
+  namedElement("link", "arm", protoElem);
+
+  auto prototype = std::make_shared<sdf::Model>();
+  EXPECT_TRUE(prototype->Load(protoElem).empty());
+  prototype->SetSelfCollide(true);
+  EXPECT_FALSE(prototype->IsInstance());
+  EXPECT_EQ(nullptr, prototype->Prototype());
+
+  sdf::Model instance;
+  sdf::ElementPtr instanceElem = namedElement("model", "copy", nullptr);
+  EXPECT_FALSE(instance.LoadInstance(instanceElem, nullptr).empty());
+
+  sdf::Errors errors = instance.LoadInstance(instanceElem, prototype);
+  EXPECT_TRUE(errors.empty());
+  EXPECT_TRUE(instance.IsInstance());
+  EXPECT_EQ(prototype, instance.Prototype());
+  EXPECT_EQ("copy", instance.Name());
+  EXPECT_EQ(instanceElem, instance.Element());
+  EXPECT_TRUE(instance.SelfCollide());
+
+  // The links are shared with the prototype, not copied.
+  ASSERT_EQ(2u, instance.LinkCount());
+  EXPECT_EQ(prototype->LinkByIndex(1), instance.LinkByIndex(1));
+  EXPECT_EQ(prototype->LinkByName("arm"), instance.LinkByName("arm"));
+  EXPECT_EQ("base", instance.CanonicalLink()->Name());
+
+  // Properties of the instance do not change the prototype.
+  instance.SetRawPose({1, 2, 3, 0, 0, 0});
+  instance.SetStatic(true);
+  EXPECT_EQ(ignition::math::Pose3d::Zero, prototype->RawPose());
+  EXPECT_FALSE(prototype->Static());
+
+  // Copies and instances of instances share the same prototype.
+  sdf::Model copy(instance);
+  EXPECT_EQ(prototype, copy.Prototype());
+  EXPECT_EQ(prototype->LinkByIndex(0), copy.LinkByIndex(0));
+
+  sdf::Model chained;
+  auto shared = std::make_shared<const sdf::Model>(instance);
+  EXPECT_TRUE(chained.LoadInstance(instanceElem, shared).empty());
+  EXPECT_EQ(prototype, chained.Prototype());
+
+  // Loading the model again makes it own its contents.
+  EXPECT_TRUE(instance.Load(protoElem).empty());
+  EXPECT_FALSE(instance.IsInstance());
+  EXPECT_EQ(2u, instance.LinkCount());
+  EXPECT_NE(prototype->LinkByIndex(0), instance.LinkByIndex(0));
+}
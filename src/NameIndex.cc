@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <string>
+
+#include "NameIndex.hh"
+
+using namespace sdf;
+
+/////////////////////////////////////////////////
+NameIndex::NameIndex(const NameIndex &_index)
+  : names(_index.names)
+{
+  this->Rebuild();
+}
+
+/////////////////////////////////////////////////
+NameIndex &NameIndex::operator=(const NameIndex &_index)
+{
+  if (this != &_index)
+  {
+    this->names = _index.names;
+    this->Rebuild();
+  }
+  return *this;
+}
+
+/////////////////////////////////////////////////
+void NameIndex::Clear()
+{
+  this->positions.clear();
+  this->names.clear();
+}
+
+/////////////////////////////////////////////////
+void NameIndex::Add(const std::string &_name)
+{
+  this->names.push_back(_name);
+  this->positions.emplace(this->names.back(), this->names.size() - 1);
+}
+
+/////////////////////////////////////////////////
+std::size_t NameIndex::Find(std::string_view _name) const
+{
+  auto it = this->positions.find(_name);
+  return it == this->positions.end() ? npos : it->second;
+}
+
+/////////////////////////////////////////////////
+std::size_t NameIndex::Size() const
+{
+  return this->names.size();
+}
+
+/////////////////////////////////////////////////
+void NameIndex::Rebuild()
+{
+  this->positions.clear();
+  this->positions.reserve(this->names.size());
+  for (std::size_t i = 0; i < this->names.size(); ++i)
+    this->positions.emplace(this->names[i], i);
+}
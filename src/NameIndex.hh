@@ -0,0 +1,110 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDFORMAT_NAMEINDEX_HH
+#define SDFORMAT_NAMEINDEX_HH
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief Hash index from names to positions in a vector of DOM objects,
+  /// such as the links of a model. Lookups take a std::string_view and do
+  /// not allocate.
+  ///
+  /// The index holds a copy of each name, so it must be updated whenever an
+  /// object is added to the vector, and built again if an object of the
+  /// vector is renamed. When several objects have the same name, the first
+  /// one is found, like a linear search would.
+  class NameIndex
+  {
+    /// \brief Value returned by Find when a name is not in the index.
+    public: static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// \brief Default constructor.
+    public: NameIndex() = default;
+
+    /// \brief Copy constructor. The hash table refers to the names of the
+    /// index that owns it, so it is rebuilt.
+    /// \param[in] _index Index to copy.
+    public: NameIndex(const NameIndex &_index);
+
+    /// \brief Move constructor. Moving the name storage keeps the addresses
+    /// of the names, so the hash table is moved as is.
+    /// \param[in] _index Index to move.
+    public: NameIndex(NameIndex &&_index) = default;
+
+    /// \brief Copy assignment operator.
+    /// \param[in] _index Index to copy.
+    /// \return Reference to this.
+    public: NameIndex &operator=(const NameIndex &_index);
+
+    /// \brief Move assignment operator.
+    /// \param[in] _index Index to move.
+    /// \return Reference to this.
+    public: NameIndex &operator=(NameIndex &&_index) = default;
+
+    /// \brief Replace the contents of the index with the names of a vector
+    /// of DOM objects.
+    /// \param[in] _objs Objects with a Name() function.
+    public: template <typename Class>
+            void Build(const std::vector<Class> &_objs)
+    {
+      this->Clear();
+      for (const Class &obj : _objs)
+        this->Add(obj.Name());
+    }
+
+    /// \brief Remove all the names.
+    public: void Clear();
+
+    /// \brief Add the name of an object appended to the vector.
+    /// \param[in] _name Name of the object, whose position is Size().
+    public: void Add(const std::string &_name);
+
+    /// \brief Find the position of the first object with a given name.
+    /// \param[in] _name Name to find.
+    /// \return Position of the object, or npos if there is none.
+    public: std::size_t Find(std::string_view _name) const;
+
+    /// \brief Get the number of indexed objects.
+    /// \return Number of names added since the last Clear.
+    public: std::size_t Size() const;
+
+    /// \brief Rebuild the hash table from the names.
+    private: void Rebuild();
+
+    /// \brief Name of each object. A deque keeps the addresses of the names
+    /// when names are added, so the keys of the hash table stay valid.
+    private: std::deque<std::string> names;
+
+    /// \brief Position of the first object with each name.
+    private: std::unordered_map<std::string_view, std::size_t> positions;
+  };
+  }
+}
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "NameIndex.hh"
+
+/// \brief Minimal DOM object for NameIndex::Build.
+class Named
+{
+  public: explicit Named(const std::string &_name) : name(_name) {}
+  public: std::string Name() const { return this->name; }
+  private: std::string name;
+};
+
+/////////////////////////////////////////////////
+TEST(NameIndex, Find)
+{
+  sdf::NameIndex index;
+  EXPECT_EQ(0u, index.Size());
+  EXPECT_EQ(sdf::NameIndex::npos, index.Find("a"));
+
+  index.Build(std::vector<Named>{Named("a"), Named("b"), Named("a")});
+  EXPECT_EQ(3u, index.Size());
+  EXPECT_EQ(0u, index.Find("a"));
+  EXPECT_EQ(1u, index.Find("b"));
+  EXPECT_EQ(sdf::NameIndex::npos, index.Find("c"));
+
+  // Lookups by part of a larger string.
+  const std::string scoped = "model::b";
+  EXPECT_EQ(1u, index.Find(std::string_view(scoped).substr(7)));
+
+  // Enough names to move the storage around.
+  for (int i = 0; i < 1000; ++i)
+    index.Add("long_name_that_is_not_stored_inline_" + std::to_string(i));
+  EXPECT_EQ(1003u, index.Size());
+  EXPECT_EQ(3u, index.Find("long_name_that_is_not_stored_inline_0"));
+  EXPECT_EQ(1002u, index.Find("long_name_that_is_not_stored_inline_999"));
+  EXPECT_EQ(1u, index.Find("b"));
+
+  index.Clear();
+  EXPECT_EQ(0u, index.Size());
+  EXPECT_EQ(sdf::NameIndex::npos, index.Find("a"));
+}
+
+/////////////////////////////////////////////////
+TEST(NameIndex, CopyAndMove)
+{
+  sdf::NameIndex index;
+  index.Build(std::vector<Named>{Named("first"), Named("second")});
+
+  sdf::NameIndex copy(index);
+  index.Clear();
+  EXPECT_EQ(1u, copy.Find("second"));
+
+  sdf::NameIndex assigned;
+  assigned = copy;
+  copy.Add("third");
+  EXPECT_EQ(1u, assigned.Find("second"));
+  EXPECT_EQ(sdf::NameIndex::npos, assigned.Find("third"));
+  EXPECT_EQ(2u, copy.Find("third"));
+
+  sdf::NameIndex moved(std::move(assigned));
+  EXPECT_EQ(0u, moved.Find("first"));
+  EXPECT_EQ(1u, moved.Find("second"));
+
+  sdf::NameIndex moveAssigned;
+  moveAssigned = std::move(moved);
+  EXPECT_EQ(1u, moveAssigned.Find("second"));
+}
@@ -22,7 +22,6 @@
 #include <sstream>
 #include <string>
 
-#include <locale.h>
 #include <math.h>
 
 #include "sdf/Assert.hh"
@@ -117,10 +116,12 @@ Param::~Param()
 Param &Param::operator=(const Param &_param)
 {
   auto updateFuncCopy = this->dataPtr->updateFunc;
+  auto revision = std::max(this->dataPtr->revision, _param.dataPtr->revision);
   *this = Param(_param);
 
   // Restore the update func
   this->dataPtr->updateFunc = updateFuncCopy;
+  this->dataPtr->revision = revision + 1;
   return *this;
 }
 
@@ -278,6 +279,7 @@ void Param::Update()
     try
     {
       std::any newValue = this->dataPtr->updateFunc();
+      ++this->dataPtr->revision;
       std::visit([&](auto &&arg)
         {
           using T = std::decay_t<decltype(arg)>;
@@ -364,8 +366,10 @@ bool Param::ValueFromString(const std::string &_value)
 {
   // Under some circumstances, latin locales (es_ES or pt_BR) will return a
   // comma for decimal position instead of a dot, making the conversion
-  // to fail. See bug #60 for more information. Force to use always C
-  setlocale(LC_NUMERIC, "C");
+  // to fail. See bug #60 for more information. The parser entry points
+  // (init*, readFile, readString, readDoc) set the C numeric locale once,
+  // instead of every value setting it.
+  ++this->dataPtr->revision;
   std::string trimmed = sdf::trim(_value);
   std::string tmp(trimmed);
   std::string lowerTmp = lowercase(trimmed);
@@ -539,6 +543,7 @@ bool Param::SetFromString(const std::string &_value)
   else if (str.empty())
   {
     this->dataPtr->value = this->dataPtr->defaultValue;
+    ++this->dataPtr->revision;
     return true;
   }
 
@@ -564,6 +569,7 @@ void Param::Reset()
 {
   this->dataPtr->value = this->dataPtr->defaultValue;
   this->dataPtr->set = false;
+  ++this->dataPtr->revision;
 }
 
 //////////////////////////////////////////////////
@@ -608,6 +614,39 @@ bool Param::GetSet() const
   return this->dataPtr->set;
 }
 
+/////////////////////////////////////////////////
+std::uint64_t Param::Revision() const
+{
+  return this->dataPtr->revision;
+}
+
+/////////////////////////////////////////////////
+MemoryBreakdown Param::MemoryUsage() const
+{
+  MemoryBreakdown usage;
+  usage.paramCount = 1;
+  usage.domBytes = sizeof(Param) + sizeof(ParamPrivate);
+  usage.stringBytes =
+      MemoryBreakdown::StringHeapBytes(this->dataPtr->key) +
+      MemoryBreakdown::StringHeapBytes(this->dataPtr->typeName);
+  usage.descriptionBytes =
+      MemoryBreakdown::StringHeapBytes(this->dataPtr->description);
+
+  auto variantBytes = [](const ParamPrivate::ParamVariant &_variant)
+  {
+    const std::string *str = std::get_if<std::string>(&_variant);
+    return str ? MemoryBreakdown::StringHeapBytes(*str) : 0u;
+  };
+  usage.stringBytes += variantBytes(this->dataPtr->value) +
+      variantBytes(this->dataPtr->defaultValue);
+  if (this->dataPtr->minValue)
+    usage.stringBytes += variantBytes(*this->dataPtr->minValue);
+  if (this->dataPtr->maxValue)
+    usage.stringBytes += variantBytes(*this->dataPtr->maxValue);
+
+  return usage;
+}
+
 /////////////////////////////////////////////////
 bool Param::ValidateValue() const
 {
@@ -429,6 +429,35 @@ TEST(Param, SetTemplate)
 }
 
 ////////////////////////////////////////////////////
+TEST(Param, Revision)
+{
+  sdf::Param param("key", "double", "1.0", false);
+  std::uint64_t revision = param.Revision();
+
+  EXPECT_TRUE(param.SetFromString("2.0"));
+  EXPECT_LT(revision, param.Revision());
+  revision = param.Revision();
+
+  EXPECT_TRUE(param.Set(3.0));
+  EXPECT_LT(revision, param.Revision());
+  revision = param.Revision();
+
+  param.Reset();
+  EXPECT_LT(revision, param.Revision());
+  revision = param.Revision();
+
+  // Assigning from a parameter with a lower revision still increments it.
+  sdf::Param other("key", "double", "4.0", false);
+  param = other;
+  EXPECT_LT(revision, param.Revision());
+  revision = param.Revision();
+
+  double value = 0;
+  EXPECT_TRUE(param.Get(value));
+  EXPECT_EQ(revision, param.Revision());
+}
+
+/////////////////////////////////////////////////
 TEST(Param, MinMaxViolation)
 {
   sdf::Param doubleParam("key", "double", "1.0", false, "0", "10.0",
@@ -450,6 +479,27 @@ TEST(Param, MinMaxViolation)
   }
 }
 
+/////////////////////////////////////////////////
+TEST(Param, MemoryUsage)
+{
+  const std::string longText(100, 'x');
+  sdf::Param shortParam("key", "double", "1.0", false);
+  sdf::Param longParam("key", "string", longText, false, longText);
+
+  sdf::MemoryBreakdown usage = shortParam.MemoryUsage();
+  EXPECT_EQ(1u, usage.paramCount);
+  EXPECT_EQ(0u, usage.elementCount);
+  EXPECT_EQ(0u, usage.stringBytes);
+  EXPECT_EQ(0u, usage.descriptionBytes);
+  EXPECT_GT(usage.domBytes, 0u);
+
+  // The value and the default value hold a copy of the string.
+  sdf::MemoryBreakdown longUsage = longParam.MemoryUsage();
+  EXPECT_GE(longUsage.stringBytes, 2 * longText.size());
+  EXPECT_GT(longUsage.descriptionBytes, longText.size());
+  EXPECT_EQ(usage.domBytes, longUsage.domBytes);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
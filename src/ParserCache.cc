@@ -0,0 +1,128 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <mutex>
+#include <utility>
+#include <string>
+
+#include "sdf/parser.hh"
+#include "ParserCache.hh"
+
+using namespace sdf;
+
+/// \brief Cache that is active on each thread.
+static thread_local ParserCache *g_activeCache = nullptr;
+
+/////////////////////////////////////////////////
+ParserCache::Scope::Scope(ParserCache *_cache)
+  : previous(g_activeCache)
+{
+  g_activeCache = _cache;
+}
+
+/////////////////////////////////////////////////
+ParserCache::Scope::~Scope()
+{
+  g_activeCache = this->previous;
+}
+
+/////////////////////////////////////////////////
+ParserCache *ParserCache::Active()
+{
+  return g_activeCache;
+}
+
+/////////////////////////////////////////////////
+SDFPtr ParserCache::NewSDF()
+{
+  // sdf::init is an expensive call, so the schema is parsed once and
+  // cloned. The initialization of a static local is thread safe.
+  static const SDFPtr schema = []()
+  {
+    SDFPtr sdf(new SDF);
+    init(sdf);
+    return sdf;
+  }();
+
+  SDFPtr result(new SDF);
+  result->Root(schema->Root()->Clone());
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::string ParserCache::ResolveFile(const std::string &_filename,
+    bool _searchLocalPath, bool _useCallback)
+{
+  ParserCache *cache = Active();
+  if (cache)
+    return cache->FindFile(_filename, _searchLocalPath, _useCallback);
+  return sdf::findFile(_filename, _searchLocalPath, _useCallback);
+}
+
+/////////////////////////////////////////////////
+std::string ParserCache::FindFile(const std::string &_filename,
+    bool _searchLocalPath, bool _useCallback)
+{
+  std::string key;
+  key.reserve(_filename.size() + 2);
+  key += _searchLocalPath ? '1' : '0';
+  key += _useCallback ? '1' : '0';
+  key += _filename;
+
+  {
+    std::shared_lock<std::shared_mutex> lock(this->mutex);
+    auto it = this->files.find(key);
+    if (it != this->files.end())
+    {
+      ++this->hits;
+      return it->second;
+    }
+  }
+
+  // Several threads may look up the same new file at once. They all get
+  // the same path, and the first one is kept.
+  std::string path = sdf::findFile(_filename, _searchLocalPath, _useCallback);
+
+  // A file that is not found is looked up again next time, since it may be
+  // created, or found by the callback, later.
+  if (path.empty())
+  {
+    ++this->notFound;
+    return path;
+  }
+  ++this->misses;
+
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  return this->files.emplace(std::move(key), std::move(path)).first->second;
+}
+
+/////////////////////////////////////////////////
+std::size_t ParserCache::FindFileHits() const
+{
+  return this->hits;
+}
+
+/////////////////////////////////////////////////
+std::size_t ParserCache::FindFileMisses() const
+{
+  return this->misses;
+}
+
+/////////////////////////////////////////////////
+std::size_t ParserCache::FindFileNotFound() const
+{
+  return this->notFound;
+}
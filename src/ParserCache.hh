@@ -0,0 +1,129 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef SDFORMAT_PARSERCACHE_HH
+#define SDFORMAT_PARSERCACHE_HH
+
+#include <atomic>
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "sdf/SDFImpl.hh"
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+  // Inline bracket to help doxygen filtering.
+  inline namespace SDF_VERSION_NAMESPACE {
+  //
+
+  /// \brief State shared by the parses of a batch of documents, which may
+  /// run on different threads.
+  ///
+  /// A cache is used by the parser while it is active on the calling thread,
+  /// see ParserCache::Scope. It remembers the file paths returned by
+  /// sdf::findFile, so a URI included by many documents is only resolved
+  /// once. Files that are not found are not remembered, so that they are
+  /// looked up again. The URI paths and find callback must not change while the cache
+  /// is in use.
+  class ParserCache
+  {
+    /// \brief Makes a cache active on the calling thread for the lifetime of
+    /// the scope.
+    public: class Scope
+    {
+      /// \brief Constructor.
+      /// \param[in] _cache Cache to activate, or nullptr for none.
+      public: explicit Scope(ParserCache *_cache);
+
+      /// \brief Destructor. Restores the previously active cache.
+      public: ~Scope();
+
+      /// \brief Copy constructor is deleted.
+      public: Scope(const Scope &) = delete;
+
+      /// \brief Copy assignment operator is deleted.
+      public: Scope &operator=(const Scope &) = delete;
+
+      /// \brief Cache that was active before this scope.
+      private: ParserCache *previous;
+    };
+
+    /// \brief Get the cache that is active on the calling thread.
+    /// \return The active cache, or nullptr if there is none.
+    public: static ParserCache *Active();
+
+    /// \brief Create an SDF object initialized with the SDF schema, as
+    /// sdf::init does. The schema is parsed once per process and copied for
+    /// each new object. This function is thread safe.
+    /// \return New SDF object.
+    public: static SDFPtr NewSDF();
+
+    /// \brief Find a file with the active cache, or with sdf::findFile when
+    /// no cache is active on the calling thread.
+    /// \param[in] _filename Name of the file to find.
+    /// \param[in] _searchLocalPath See sdf::findFile.
+    /// \param[in] _useCallback See sdf::findFile.
+    /// \return The path of the file, or an empty string if it was not found.
+    public: static std::string ResolveFile(const std::string &_filename,
+                bool _searchLocalPath, bool _useCallback);
+
+    /// \brief Find a file with sdf::findFile, and remember the path if the
+    /// file was found. This function is thread safe.
+    /// \param[in] _filename Name of the file to find.
+    /// \param[in] _searchLocalPath See sdf::findFile.
+    /// \param[in] _useCallback See sdf::findFile.
+    /// \return The path of the file, or an empty string if it was not found.
+    public: std::string FindFile(const std::string &_filename,
+                bool _searchLocalPath, bool _useCallback);
+
+    /// \brief Get the number of file lookups that were answered by the cache.
+    /// \return Number of cache hits.
+    public: std::size_t FindFileHits() const;
+
+    /// \brief Get the number of file lookups that called sdf::findFile and
+    /// found the file.
+    /// \return Number of cache misses.
+    public: std::size_t FindFileMisses() const;
+
+    /// \brief Get the number of file lookups that called sdf::findFile and
+    /// did not find the file.
+    /// \return Number of files that were not found.
+    public: std::size_t FindFileNotFound() const;
+
+    /// \brief Protects the paths.
+    private: mutable std::shared_mutex mutex;
+
+    /// \brief Paths found for each file name. The key starts with the two
+    /// search flags.
+    private: std::unordered_map<std::string, std::string> files;
+
+    /// \brief Number of lookups answered by the cache.
+    private: std::atomic<std::size_t> hits{0};
+
+    /// \brief Number of lookups that called sdf::findFile and found the
+    /// file.
+    private: std::atomic<std::size_t> misses{0};
+
+    /// \brief Number of lookups that called sdf::findFile and did not find
+    /// the file.
+    private: std::atomic<std::size_t> notFound{0};
+  };
+  }
+}
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+#include "sdf/Filesystem.hh"
+#include "sdf/SDFImpl.hh"
+#include "ParserCache.hh"
+#include "test_config.h"
+
+/////////////////////////////////////////////////
+TEST(ParserCache, Scope)
+{
+  EXPECT_EQ(nullptr, sdf::ParserCache::Active());
+
+  sdf::ParserCache outer;
+  sdf::ParserCache inner;
+  {
+    sdf::ParserCache::Scope outerScope(&outer);
+    EXPECT_EQ(&outer, sdf::ParserCache::Active());
+    {
+      sdf::ParserCache::Scope innerScope(&inner);
+      EXPECT_EQ(&inner, sdf::ParserCache::Active());
+    }
+    EXPECT_EQ(&outer, sdf::ParserCache::Active());
+  }
+  EXPECT_EQ(nullptr, sdf::ParserCache::Active());
+}
+
+/////////////////////////////////////////////////
+TEST(ParserCache, FindFile)
+{
+  const std::string filename = sdf::filesystem::append(PROJECT_SOURCE_PATH,
+      "test", "sdf", "empty.sdf");
+
+  sdf::ParserCache cache;
+  EXPECT_EQ(filename, cache.FindFile(filename, false, false));
+  EXPECT_EQ(0u, cache.FindFileHits());
+  EXPECT_EQ(1u, cache.FindFileMisses());
+
+  EXPECT_EQ(filename, cache.FindFile(filename, false, false));
+  EXPECT_EQ(1u, cache.FindFileHits());
+  EXPECT_EQ(1u, cache.FindFileMisses());
+
+  // The flags are part of the key.
+  EXPECT_EQ(filename, cache.FindFile(filename, true, false));
+  EXPECT_EQ(2u, cache.FindFileMisses());
+
+  // Files that are not found are not remembered.
+  EXPECT_EQ(0u, cache.FindFileNotFound());
+  EXPECT_TRUE(cache.FindFile("does_not_exist.sdf", false, false).empty());
+  EXPECT_TRUE(cache.FindFile("does_not_exist.sdf", false, false).empty());
+  EXPECT_EQ(1u, cache.FindFileHits());
+  EXPECT_EQ(2u, cache.FindFileMisses());
+  EXPECT_EQ(2u, cache.FindFileNotFound());
+
+  // ResolveFile uses the active cache.
+  EXPECT_EQ(filename, sdf::ParserCache::ResolveFile(filename, false, false));
+  EXPECT_EQ(1u, cache.FindFileHits());
+  {
+    sdf::ParserCache::Scope scope(&cache);
+    EXPECT_EQ(filename,
+        sdf::ParserCache::ResolveFile(filename, false, false));
+    EXPECT_EQ(2u, cache.FindFileHits());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ParserCache, NewSDF)
+{
+  sdf::SDFPtr first = sdf::ParserCache::NewSDF();
+  sdf::SDFPtr second = sdf::ParserCache::NewSDF();
+  ASSERT_NE(nullptr, first->Root());
+  ASSERT_NE(nullptr, second->Root());
+
+  // Each object has its own copy of the schema.
+  EXPECT_NE(first->Root(), second->Root());
+  EXPECT_EQ("sdf", first->Root()->GetName());
+  EXPECT_LT(0u, first->Root()->GetElementDescriptionCount());
+  EXPECT_EQ(first->Root()->GetElementDescriptionCount(),
+            second->Root()->GetElementDescriptionCount());
+}
@@ -0,0 +1,532 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "sdf/Polyline.hh"
+#include "Utils.hh"
+
+using namespace sdf;
+
+/// \brief Vertices and triangles of an extruded polyline.
+struct PolylineMesh
+{
+  /// \brief Vertices at the bottom, then at the top.
+  std::vector<ignition::math::Vector3d> vertices;
+
+  /// \brief Three vertex indices per triangle.
+  std::vector<uint32_t> indices;
+};
+
+// Private data class
+class sdf::PolylinePrivate
+{
+  /// \brief Extend the bounds with a point.
+  /// \param[in] _point The point.
+  public: void Extend(const ignition::math::Vector2d &_point)
+  {
+    this->min.Set(std::min(this->min.X(), _point.X()),
+        std::min(this->min.Y(), _point.Y()));
+    this->max.Set(std::max(this->max.X(), _point.X()),
+        std::max(this->max.Y(), _point.Y()));
+  }
+
+  /// \brief Reset the bounds and extend them with all the points.
+  public: void UpdateBounds()
+  {
+    this->min.Set(INFINITY, INFINITY);
+    this->max.Set(-INFINITY, -INFINITY);
+    for (const auto &point : this->points)
+      this->Extend(point);
+  }
+
+  /// \brief Drop the mesh, which no longer matches the points or height.
+  public: void Invalidate()
+  {
+    std::atomic_store(&this->mesh, std::shared_ptr<const PolylineMesh>());
+  }
+
+  /// \brief Get the mesh, computing it if needed.
+  /// \return The mesh.
+  public: std::shared_ptr<const PolylineMesh> Mesh() const;
+
+  /// \brief Height of the polyline.
+  public: double height{1.0};
+
+  /// \brief Points of the polyline, stored contiguously.
+  public: std::vector<ignition::math::Vector2d> points;
+
+  /// \brief Smallest coordinates of the points.
+  public: ignition::math::Vector2d min{INFINITY, INFINITY};
+
+  /// \brief Largest coordinates of the points.
+  public: ignition::math::Vector2d max{-INFINITY, -INFINITY};
+
+  /// \brief The extruded mesh, computed on demand and accessed with the
+  /// atomic functions of std::shared_ptr. Copies of the polyline share it
+  /// until one of them is modified.
+  public: mutable std::shared_ptr<const PolylineMesh> mesh;
+
+  /// \brief The SDF element pointer used during load.
+  public: sdf::ElementPtr sdf{nullptr};
+};
+
+/// \brief Twice the signed area of a triangle, positive if it is
+/// counter-clockwise.
+/// \param[in] _a First corner.
+/// \param[in] _b Second corner.
+/// \param[in] _c Third corner.
+/// \return The signed area times two.
+static double cross(const ignition::math::Vector2d &_a,
+    const ignition::math::Vector2d &_b, const ignition::math::Vector2d &_c)
+{
+  return (_b.X() - _a.X()) * (_c.Y() - _a.Y()) -
+      (_b.Y() - _a.Y()) * (_c.X() - _a.X());
+}
+
+/// \brief Triangulate a polygon by ear clipping.
+///
+/// Only reflex corners can lie inside an ear of a simple polygon, and a
+/// reflex corner only becomes convex as ears are clipped, so the reflex
+/// corners are kept in a uniform grid and an ear is only tested against the
+/// reflex corners of the grid cells that overlap it. When no ear is found in
+/// a full turn, as happens with polygons that are not simple, a corner is
+/// clipped anyway so that the triangulation always ends.
+/// \param[in] _points The corners of the polygon, counter-clockwise.
+/// \param[in] _order Index of each corner of the polygon in _points.
+/// \param[out] _triangles Indices into _points, three per triangle.
+static void triangulate(const std::vector<ignition::math::Vector2d> &_points,
+    const std::vector<uint32_t> &_order, std::vector<uint32_t> &_triangles)
+{
+  const std::size_t n = _order.size();
+  std::vector<std::size_t> prev(n);
+  std::vector<std::size_t> next(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    prev[i] = (i + n - 1) % n;
+    next[i] = (i + 1) % n;
+  }
+
+  auto point = [&](std::size_t _i) -> const ignition::math::Vector2d &
+  {
+    return _points[_order[_i]];
+  };
+  auto isReflex = [&](std::size_t _i)
+  {
+    return cross(point(prev[_i]), point(_i), point(next[_i])) < 0;
+  };
+
+  std::vector<bool> reflex(n);
+  std::vector<bool> removed(n, false);
+  ignition::math::Vector2d low(INFINITY, INFINITY);
+  ignition::math::Vector2d high(-INFINITY, -INFINITY);
+  std::size_t reflexCount = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    reflex[i] = isReflex(i);
+    if (reflex[i])
+    {
+      ++reflexCount;
+      low.Set(std::min(low.X(), point(i).X()),
+          std::min(low.Y(), point(i).Y()));
+      high.Set(std::max(high.X(), point(i).X()),
+          std::max(high.Y(), point(i).Y()));
+    }
+  }
+
+  // Grid of the reflex corners, with about one corner per cell.
+  const std::size_t cells = std::max<std::size_t>(1,
+      static_cast<std::size_t>(std::sqrt(static_cast<double>(reflexCount))));
+  const double cellX = std::max((high.X() - low.X()) / cells, 1e-12);
+  const double cellY = std::max((high.Y() - low.Y()) / cells, 1e-12);
+  auto cellOf = [&](double _v, double _low, double _size)
+  {
+    const double c = std::floor((_v - _low) / _size);
+    return static_cast<std::size_t>(
+        std::clamp(c, 0.0, static_cast<double>(cells - 1)));
+  };
+  std::vector<std::vector<std::size_t>> grid(cells * cells);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (reflex[i])
+    {
+      grid[cellOf(point(i).Y(), low.Y(), cellY) * cells +
+          cellOf(point(i).X(), low.X(), cellX)].push_back(i);
+    }
+  }
+
+  auto isEar = [&](std::size_t _i)
+  {
+    const std::size_t a = prev[_i];
+    const std::size_t c = next[_i];
+    const auto &pa = point(a);
+    const auto &pb = point(_i);
+    const auto &pc = point(c);
+    const double area = cross(pa, pb, pc);
+    if (area < 0)
+      return false;
+
+    // A corner between two collinear sides is clipped as an empty triangle,
+    // instead of waiting for its neighbors to be clipped.
+    if (area == 0)
+    {
+      return (pa.X() - pb.X()) * (pc.X() - pb.X()) +
+          (pa.Y() - pb.Y()) * (pc.Y() - pb.Y()) <= 0;
+    }
+    if (reflexCount == 0)
+      return true;
+
+    const double minX = std::min({pa.X(), pb.X(), pc.X()});
+    const double maxX = std::max({pa.X(), pb.X(), pc.X()});
+    const double minY = std::min({pa.Y(), pb.Y(), pc.Y()});
+    const double maxY = std::max({pa.Y(), pb.Y(), pc.Y()});
+    if (maxX < low.X() || minX > high.X() || maxY < low.Y() || minY > high.Y())
+      return true;
+
+    const std::size_t x0 = cellOf(minX, low.X(), cellX);
+    const std::size_t x1 = cellOf(maxX, low.X(), cellX);
+    const std::size_t y0 = cellOf(minY, low.Y(), cellY);
+    const std::size_t y1 = cellOf(maxY, low.Y(), cellY);
+    for (std::size_t y = y0; y <= y1; ++y)
+    {
+      for (std::size_t x = x0; x <= x1; ++x)
+      {
+        for (std::size_t r : grid[y * cells + x])
+        {
+          if (!reflex[r] || removed[r] || r == a || r == _i || r == c)
+            continue;
+          const auto &p = point(r);
+          if (p == pa || p == pb || p == pc)
+            continue;
+          if (cross(pa, pb, p) >= 0 && cross(pb, pc, p) >= 0 &&
+              cross(pc, pa, p) >= 0)
+          {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  };
+
+  std::size_t remaining = n;
+  std::size_t current = 0;
+  std::size_t sinceLastEar = 0;
+  while (remaining > 3)
+  {
+    if (!isEar(current) && sinceLastEar < remaining)
+    {
+      current = next[current];
+      ++sinceLastEar;
+      continue;
+    }
+
+    const std::size_t a = prev[current];
+    const std::size_t c = next[current];
+    _triangles.insert(_triangles.end(), {_order[a], _order[current],
+        _order[c]});
+    removed[current] = true;
+    next[a] = c;
+    prev[c] = a;
+    --remaining;
+    sinceLastEar = 0;
+
+    // The neighbors of the ear may have become convex.
+    for (std::size_t i : {a, c})
+    {
+      if (reflex[i] && !isReflex(i))
+      {
+        reflex[i] = false;
+        --reflexCount;
+      }
+    }
+    current = c;
+  }
+  _triangles.insert(_triangles.end(), {_order[prev[current]],
+      _order[current], _order[next[current]]});
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<const PolylineMesh> PolylinePrivate::Mesh() const
+{
+  auto cached = std::atomic_load(&this->mesh);
+  if (cached)
+    return cached;
+
+  auto newMesh = std::make_shared<PolylineMesh>();
+  const std::size_t count = this->points.size();
+  newMesh->vertices.reserve(2 * count);
+  for (double z : {0.0, this->height})
+  {
+    for (const auto &point : this->points)
+      newMesh->vertices.emplace_back(point.X(), point.Y(), z);
+  }
+
+  // A last point equal to the first one closes the polygon explicitly.
+  std::size_t corners = count;
+  if (corners > 1 && this->points.front() == this->points.back())
+    --corners;
+
+  if (corners >= 3)
+  {
+    double area = 0;
+    for (std::size_t i = 0; i < corners; ++i)
+    {
+      const auto &p = this->points[i];
+      const auto &q = this->points[(i + 1) % corners];
+      area += p.X() * q.Y() - q.X() * p.Y();
+    }
+
+    // Corners in counter-clockwise order.
+    std::vector<uint32_t> order(corners);
+    for (std::size_t i = 0; i < corners; ++i)
+    {
+      order[i] = static_cast<uint32_t>(area >= 0 ? i : corners - 1 - i);
+    }
+
+    const uint32_t top = static_cast<uint32_t>(count);
+    auto &indices = newMesh->indices;
+    indices.reserve(3 * (2 * corners + 2 * (corners - 2)));
+    for (std::size_t i = 0; i < corners; ++i)
+    {
+      const uint32_t a = order[i];
+      const uint32_t b = order[(i + 1) % corners];
+      indices.insert(indices.end(), {a, b, b + top, a, b + top, a + top});
+    }
+
+    std::vector<uint32_t> cap;
+    cap.reserve(3 * (corners - 2));
+    triangulate(this->points, order, cap);
+    for (std::size_t i = 0; i < cap.size(); i += 3)
+    {
+      // The bottom face is seen from below, so its winding is reversed.
+      indices.insert(indices.end(), {cap[i], cap[i + 2], cap[i + 1]});
+    }
+    for (std::size_t i = 0; i < cap.size(); i += 3)
+    {
+      indices.insert(indices.end(),
+          {cap[i] + top, cap[i + 1] + top, cap[i + 2] + top});
+    }
+  }
+
+  // Keep the mesh of another thread if it was stored first, so that all the
+  // callers share one mesh.
+  std::shared_ptr<const PolylineMesh> expected;
+  std::shared_ptr<const PolylineMesh> desired = std::move(newMesh);
+  if (std::atomic_compare_exchange_strong(&this->mesh, &expected, desired))
+    return desired;
+  return expected;
+}
+
+/////////////////////////////////////////////////
+Polyline::Polyline()
+  : dataPtr(new PolylinePrivate)
+{
+}
+
+/////////////////////////////////////////////////
+Polyline::~Polyline()
+{
+  delete this->dataPtr;
+  this->dataPtr = nullptr;
+}
+
+//////////////////////////////////////////////////
+Polyline::Polyline(const Polyline &_polyline)
+  : dataPtr(new PolylinePrivate)
+{
+  this->dataPtr->height = _polyline.dataPtr->height;
+  this->dataPtr->points = _polyline.dataPtr->points;
+  this->dataPtr->min = _polyline.dataPtr->min;
+  this->dataPtr->max = _polyline.dataPtr->max;
+  this->dataPtr->mesh = std::atomic_load(&_polyline.dataPtr->mesh);
+  this->dataPtr->sdf = _polyline.dataPtr->sdf;
+}
+
+//////////////////////////////////////////////////
+Polyline::Polyline(Polyline &&_polyline) noexcept
+  : dataPtr(std::exchange(_polyline.dataPtr, nullptr))
+{
+}
+
+/////////////////////////////////////////////////
+Polyline &Polyline::operator=(const Polyline &_polyline)
+{
+  return *this = Polyline(_polyline);
+}
+
+/////////////////////////////////////////////////
+Polyline &Polyline::operator=(Polyline &&_polyline)
+{
+  std::swap(this->dataPtr, _polyline.dataPtr);
+  return *this;
+}
+
+/////////////////////////////////////////////////
+Errors Polyline::Load(ElementPtr _sdf)
+{
+  Errors errors;
+
+  this->dataPtr->sdf = _sdf;
+
+  // Check that sdf is a valid pointer
+  if (!_sdf)
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Attempting to load a polyline, but the provided SDF element is "
+        "null."});
+    return errors;
+  }
+
+  // We need a polyline element
+  if (_sdf->GetName() != "polyline")
+  {
+    errors.push_back({ErrorCode::ELEMENT_INCORRECT_TYPE,
+        "Attempting to load a polyline geometry, but the provided SDF "
+        "element is not a <polyline>."});
+    return errors;
+  }
+
+  // Read the values of the <point> elements directly, in one pass over the
+  // children.
+  const ElementPtr_V pointElems = childElements(_sdf, "point");
+  this->dataPtr->points.clear();
+  this->dataPtr->points.reserve(pointElems.size());
+  for (const ElementPtr &pointElem : pointElems)
+  {
+    ignition::math::Vector2d point;
+    ParamPtr value = pointElem->GetValue();
+    if (!value || !value->Get<ignition::math::Vector2d>(point))
+    {
+      errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "Unable to read the value of a polyline <point> element."});
+      continue;
+    }
+    this->dataPtr->points.push_back(point);
+  }
+  this->dataPtr->UpdateBounds();
+  this->dataPtr->Invalidate();
+
+  if (pointElems.empty())
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Polyline geometry is missing a <point> child element."});
+  }
+
+  if (_sdf->HasElement("height"))
+  {
+    this->dataPtr->height = _sdf->Get<double>("height",
+        this->dataPtr->height).first;
+  }
+  else
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Polyline geometry is missing a <height> child element."});
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+sdf::ElementPtr Polyline::Element() const
+{
+  return this->dataPtr->sdf;
+}
+
+//////////////////////////////////////////////////
+double Polyline::Height() const
+{
+  return this->dataPtr->height;
+}
+
+//////////////////////////////////////////////////
+void Polyline::SetHeight(double _height)
+{
+  this->dataPtr->height = _height;
+  this->dataPtr->Invalidate();
+}
+
+//////////////////////////////////////////////////
+uint64_t Polyline::PointCount() const
+{
+  return this->dataPtr->points.size();
+}
+
+//////////////////////////////////////////////////
+const ignition::math::Vector2d *Polyline::PointByIndex(uint64_t _index) const
+{
+  if (_index < this->dataPtr->points.size())
+    return &this->dataPtr->points[_index];
+  return nullptr;
+}
+
+//////////////////////////////////////////////////
+void Polyline::AddPoint(const ignition::math::Vector2d &_point)
+{
+  this->dataPtr->points.push_back(_point);
+  this->dataPtr->Extend(_point);
+  this->dataPtr->Invalidate();
+}
+
+//////////////////////////////////////////////////
+void Polyline::SetPoints(std::vector<ignition::math::Vector2d> _points)
+{
+  this->dataPtr->points = std::move(_points);
+  this->dataPtr->UpdateBounds();
+  this->dataPtr->Invalidate();
+}
+
+//////////////////////////////////////////////////
+void Polyline::ClearPoints()
+{
+  this->dataPtr->points.clear();
+  this->dataPtr->UpdateBounds();
+  this->dataPtr->Invalidate();
+}
+
+//////////////////////////////////////////////////
+const std::vector<ignition::math::Vector2d> &Polyline::Points() const
+{
+  return this->dataPtr->points;
+}
+
+//////////////////////////////////////////////////
+ignition::math::AxisAlignedBox Polyline::BoundingBox() const
+{
+  if (this->dataPtr->points.empty())
+    return ignition::math::AxisAlignedBox();
+
+  return ignition::math::AxisAlignedBox(
+      {this->dataPtr->min.X(), this->dataPtr->min.Y(), 0.0},
+      {this->dataPtr->max.X(), this->dataPtr->max.Y(),
+       this->dataPtr->height});
+}
+
+//////////////////////////////////////////////////
+const std::vector<ignition::math::Vector3d> &Polyline::ExtrudedVertices() const
+{
+  return this->dataPtr->Mesh()->vertices;
+}
+
+//////////////////////////////////////////////////
+const std::vector<uint32_t> &Polyline::TriangleIndices() const
+{
+  return this->dataPtr->Mesh()->indices;
+}
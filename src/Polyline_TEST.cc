@@ -0,0 +1,256 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "sdf/Element.hh"
+#include "sdf/Polyline.hh"
+
+/// \brief Sum the signed areas of the triangles of a mesh, projected on
+/// the xy plane, separately for the triangles facing up and down.
+/// \param[in] _polyline The polyline.
+/// \param[out] _up Area of the triangles facing +z.
+/// \param[out] _down Area of the triangles facing -z.
+void capAreas(const sdf::Polyline &_polyline, double &_up, double &_down)
+{
+  const auto &vertices = _polyline.ExtrudedVertices();
+  const auto &indices = _polyline.TriangleIndices();
+  _up = 0;
+  _down = 0;
+  for (std::size_t i = 0; i < indices.size(); i += 3)
+  {
+    const auto &a = vertices[indices[i]];
+    const auto &b = vertices[indices[i + 1]];
+    const auto &c = vertices[indices[i + 2]];
+    const double area = 0.5 * ((b.X() - a.X()) * (c.Y() - a.Y()) -
+        (b.Y() - a.Y()) * (c.X() - a.X()));
+    if (a.Z() == b.Z() && b.Z() == c.Z())
+      (a.Z() > 0 ? _up : _down) += area;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(DOMPolyline, Construction)
+{
+  sdf::Polyline polyline;
+  EXPECT_EQ(nullptr, polyline.Element());
+  EXPECT_DOUBLE_EQ(1.0, polyline.Height());
+  EXPECT_EQ(0u, polyline.PointCount());
+  EXPECT_EQ(nullptr, polyline.PointByIndex(0));
+  EXPECT_TRUE(polyline.Points().empty());
+  EXPECT_TRUE(polyline.ExtrudedVertices().empty());
+  EXPECT_TRUE(polyline.TriangleIndices().empty());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMPolyline, CopyAndMove)
+{
+  sdf::Polyline polyline;
+  polyline.SetHeight(1.2);
+  polyline.AddPoint({0, 0});
+  polyline.AddPoint({1, 0});
+  polyline.AddPoint({0, 1});
+  const auto &indices = polyline.TriangleIndices();
+  EXPECT_EQ(3u * 8u, indices.size());
+
+  sdf::Polyline polyline2(polyline);
+  EXPECT_DOUBLE_EQ(1.2, polyline2.Height());
+  EXPECT_EQ(polyline.Points(), polyline2.Points());
+
+  // The copy shares the mesh until it is modified.
+  EXPECT_EQ(&indices, &polyline2.TriangleIndices());
+  polyline2.SetHeight(3.4);
+  EXPECT_NE(&indices, &polyline2.TriangleIndices());
+  EXPECT_DOUBLE_EQ(3.4, polyline2.ExtrudedVertices().back().Z());
+  EXPECT_DOUBLE_EQ(1.2, polyline.ExtrudedVertices().back().Z());
+
+  sdf::Polyline polyline3(std::move(polyline2));
+  EXPECT_DOUBLE_EQ(3.4, polyline3.Height());
+  EXPECT_EQ(3u, polyline3.PointCount());
+
+  sdf::Polyline polyline4;
+  polyline4 = polyline3;
+  EXPECT_DOUBLE_EQ(3.4, polyline4.Height());
+
+  sdf::Polyline polyline5;
+  polyline5 = std::move(polyline4);
+  EXPECT_EQ(3u, polyline5.PointCount());
+
+  // Copy assignment after move
+  polyline4 = polyline5;
+  EXPECT_EQ(3u, polyline4.PointCount());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMPolyline, Load)
+{
+  sdf::Polyline polyline;
+  sdf::Errors errors;
+
+  // Null element name
+  errors = polyline.Load(nullptr);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_MISSING, errors[0].Code());
+  EXPECT_EQ(nullptr, polyline.Element());
+
+  // Bad element name
+  sdf::ElementPtr sdf(new sdf::Element());
+  sdf->SetName("bad");
+  errors = polyline.Load(sdf);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_INCORRECT_TYPE, errors[0].Code());
+  EXPECT_NE(nullptr, polyline.Element());
+
+  // Missing <point> and <height> elements
+  sdf->SetName("polyline");
+  errors = polyline.Load(sdf);
+  ASSERT_EQ(2u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_MISSING, errors[0].Code());
+  EXPECT_NE(std::string::npos, errors[0].Message().find("missing a <point>"));
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_MISSING, errors[1].Code());
+  EXPECT_NE(std::string::npos, errors[1].Message().find("missing a <height>"));
+
+  // Points are read in order.
+  for (const std::string value : {"1 2", "3 4", "-5 6"})
+  {
+    sdf::ElementPtr point(new sdf::Element());
+    point->SetName("point");
+    point->AddValue("vector2d", "0 0", true);
+    point->GetValue()->SetFromString(value);
+    point->SetParent(sdf);
+    sdf->InsertElement(point);
+  }
+  sdf::ElementPtr height(new sdf::Element());
+  height->SetName("height");
+  height->AddValue("double", "1.0", true);
+  height->GetValue()->SetFromString("2.5");
+  height->SetParent(sdf);
+  sdf->InsertElement(height);
+
+  errors = polyline.Load(sdf);
+  EXPECT_TRUE(errors.empty());
+  EXPECT_DOUBLE_EQ(2.5, polyline.Height());
+  ASSERT_EQ(3u, polyline.PointCount());
+  EXPECT_EQ(ignition::math::Vector2d(1, 2), *polyline.PointByIndex(0));
+  EXPECT_EQ(ignition::math::Vector2d(3, 4), *polyline.PointByIndex(1));
+  EXPECT_EQ(ignition::math::Vector2d(-5, 6), *polyline.PointByIndex(2));
+
+  auto box = polyline.BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-5, 2, 0), box.Min());
+  EXPECT_EQ(ignition::math::Vector3d(3, 6, 2.5), box.Max());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMPolyline, Extrusion)
+{
+  sdf::Polyline polyline;
+  polyline.SetHeight(2);
+
+  // Clockwise L shape, with the first point repeated at the end.
+  polyline.SetPoints({{0, 0}, {0, 2}, {1, 2}, {1, 1}, {2, 1}, {2, 0}, {0, 0}});
+  EXPECT_EQ(7u, polyline.PointCount());
+
+  auto box = polyline.BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(0, 0, 0), box.Min());
+  EXPECT_EQ(ignition::math::Vector3d(2, 2, 2), box.Max());
+
+  const auto &vertices = polyline.ExtrudedVertices();
+  ASSERT_EQ(14u, vertices.size());
+  EXPECT_EQ(ignition::math::Vector3d(0, 2, 0), vertices[1]);
+  EXPECT_EQ(ignition::math::Vector3d(0, 2, 2), vertices[8]);
+
+  // 6 sides of 2 triangles, and 4 triangles on each cap.
+  const auto &indices = polyline.TriangleIndices();
+  ASSERT_EQ(3u * (12u + 8u), indices.size());
+  for (uint32_t index : indices)
+  {
+    EXPECT_LT(index, vertices.size());
+    EXPECT_NE(6u, index % 7u);
+  }
+
+  // The caps cover the L, facing out.
+  double up = 0;
+  double down = 0;
+  capAreas(polyline, up, down);
+  EXPECT_NEAR(3.0, up, 1e-9);
+  EXPECT_NEAR(-3.0, down, 1e-9);
+
+  // The sides face out: the side along x = 0 faces -x.
+  for (std::size_t i = 0; i < 3 * 12; i += 3)
+  {
+    const auto &a = vertices[indices[i]];
+    const auto &b = vertices[indices[i + 1]];
+    const auto &c = vertices[indices[i + 2]];
+    if (a.X() == 0 && b.X() == 0 && c.X() == 0)
+    {
+      EXPECT_LT((b - a).Cross(c - a).X(), 0);
+    }
+  }
+
+  // Adding a point updates the box and the mesh.
+  polyline.AddPoint({-1, 3});
+  box = polyline.BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-1, 0, 0), box.Min());
+  EXPECT_EQ(ignition::math::Vector3d(2, 3, 2), box.Max());
+  EXPECT_EQ(16u, polyline.ExtrudedVertices().size());
+
+  polyline.ClearPoints();
+  EXPECT_EQ(0u, polyline.PointCount());
+  EXPECT_TRUE(polyline.ExtrudedVertices().empty());
+  EXPECT_TRUE(polyline.TriangleIndices().empty());
+
+  // Fewer than 3 points have no triangles.
+  polyline.AddPoint({0, 0});
+  polyline.AddPoint({1, 0});
+  EXPECT_EQ(4u, polyline.ExtrudedVertices().size());
+  EXPECT_TRUE(polyline.TriangleIndices().empty());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMPolyline, LargeConcave)
+{
+  // A comb with many narrow teeth, counter-clockwise, in which most of the
+  // corners are reflex.
+  const int teeth = 5000;
+  std::vector<ignition::math::Vector2d> points;
+  for (int i = 0; i < teeth; ++i)
+  {
+    points.emplace_back(i, 0);
+    points.emplace_back(i + 0.5, 0);
+    points.emplace_back(i + 0.5, 10);
+    points.emplace_back(i + 1, 10);
+  }
+  points.emplace_back(teeth, -1);
+  points.emplace_back(0, -1);
+  std::reverse(points.begin(), points.end());
+
+  sdf::Polyline polyline;
+  polyline.SetPoints(points);
+
+  const std::size_t corners = points.size();
+  ASSERT_EQ(3u * (2 * corners + 2 * (corners - 2)),
+      polyline.TriangleIndices().size());
+
+  // Area of the base and of the teeth.
+  const double area = teeth * 1.0 + teeth * 0.5 * 10;
+  double up = 0;
+  double down = 0;
+  capAreas(polyline, up, down);
+  EXPECT_NEAR(area, up, 1e-6);
+  EXPECT_NEAR(-area, down, 1e-6);
+}
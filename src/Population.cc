@@ -0,0 +1,545 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "sdf/Box.hh"
+#include "sdf/Cylinder.hh"
+#include "sdf/Error.hh"
+#include "sdf/Model.hh"
+#include "sdf/Population.hh"
+#include "sdf/Types.hh"
+#include "Utils.hh"
+
+using namespace sdf;
+
+class sdf::PopulationPrivate
+{
+  /// \brief Name of the population.
+  public: std::string name = "";
+
+  /// \brief Number of models to place.
+  public: uint64_t modelCount = 1;
+
+  /// \brief Distribution of the models.
+  public: PopulationDistributionType type = PopulationDistributionType::RANDOM;
+
+  /// \brief Number of rows of a grid.
+  public: uint64_t rows = 1;
+
+  /// \brief Number of columns of a grid.
+  public: uint64_t cols = 1;
+
+  /// \brief Distance between the models of a grid.
+  public: ignition::math::Vector3d step{0.5, 0.5, 0};
+
+  /// \brief Box region, if any.
+  public: std::optional<Box> box;
+
+  /// \brief Cylinder region, if any.
+  public: std::optional<Cylinder> cylinder;
+
+  /// \brief Seed of the random distribution.
+  public: uint64_t seed = 0;
+
+  /// \brief Pose of the population.
+  public: ignition::math::Pose3d pose = ignition::math::Pose3d::Zero;
+
+  /// \brief Name of the relative-to frame.
+  public: std::string poseRelativeTo = "";
+
+  /// \brief The model placed by the population.
+  public: std::shared_ptr<const Model> model;
+
+  /// \brief The SDF element pointer used during load.
+  public: sdf::ElementPtr sdf;
+};
+
+/////////////////////////////////////////////////
+/// \brief Names of the distribution types in SDFormat, in the order of
+/// PopulationDistributionType.
+static const std::vector<std::string> kDistributionTypeNames = {
+  "random", "uniform", "grid", "linear-x", "linear-y", "linear-z"};
+
+/////////////////////////////////////////////////
+/// \brief Get a random number in [0, 1) that only depends on a seed and on
+/// a counter, using the SplitMix64 mixing function. Unlike a sequential
+/// generator, any instance can be generated without generating the ones
+/// before it.
+/// \param[in] _seed Seed of the distribution.
+/// \param[in] _counter Index of the number.
+/// \return Random number.
+static double uniformRandom(uint64_t _seed, uint64_t _counter)
+{
+  uint64_t z = _seed + (_counter + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  z ^= z >> 31;
+  return static_cast<double>(z >> 11) * 0x1.0p-53;
+}
+
+/////////////////////////////////////////////////
+Population::Population()
+  : dataPtr(new PopulationPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+Population::~Population()
+{
+  delete this->dataPtr;
+  this->dataPtr = nullptr;
+}
+
+/////////////////////////////////////////////////
+Population::Population(const Population &_population)
+  : dataPtr(new PopulationPrivate(*_population.dataPtr))
+{
+}
+
+/////////////////////////////////////////////////
+Population::Population(Population &&_population) noexcept
+  : dataPtr(std::exchange(_population.dataPtr, nullptr))
+{
+}
+
+/////////////////////////////////////////////////
+Population &Population::operator=(const Population &_population)
+{
+  return *this = Population(_population);
+}
+
+/////////////////////////////////////////////////
+Population &Population::operator=(Population &&_population)
+{
+  std::swap(this->dataPtr, _population.dataPtr);
+  return *this;
+}
+
+/////////////////////////////////////////////////
+Errors Population::Load(ElementPtr _sdf)
+{
+  Errors errors;
+
+  this->dataPtr->sdf = _sdf;
+
+  // Check that the provided SDF element is a <population>
+  // This is an error that cannot be recovered, so return an error.
+  if (_sdf->GetName() != "population")
+  {
+    errors.push_back({ErrorCode::ELEMENT_INCORRECT_TYPE,
+        "Attempting to load a Population, but the provided SDF element is "
+        "not a <population>."});
+    return errors;
+  }
+
+  // Read the population's name
+  if (!loadName(_sdf, this->dataPtr->name))
+  {
+    errors.push_back({ErrorCode::ATTRIBUTE_MISSING,
+        "A population name is required, but the name is not set."});
+  }
+
+  const int modelCount = _sdf->Get<int>("model_count", 1).first;
+  if (modelCount < 0)
+  {
+    errors.push_back({ErrorCode::ELEMENT_INVALID,
+        "The model count of population [" + this->dataPtr->name +
+        "] is negative."});
+  }
+  this->dataPtr->modelCount = static_cast<uint64_t>(std::max(modelCount, 0));
+
+  if (_sdf->HasElement("distribution"))
+  {
+    ElementPtr distElem = _sdf->GetElement("distribution");
+    const std::string type = distElem->Get<std::string>("type", "random").first;
+    auto it = std::find(kDistributionTypeNames.begin(),
+        kDistributionTypeNames.end(), type);
+    if (it == kDistributionTypeNames.end())
+    {
+      errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "The distribution type [" + type + "] of population [" +
+          this->dataPtr->name + "] is not supported."});
+    }
+    else
+    {
+      this->dataPtr->type = static_cast<PopulationDistributionType>(
+          it - kDistributionTypeNames.begin());
+    }
+
+    const int rows = distElem->Get<int>("rows", 1).first;
+    const int cols = distElem->Get<int>("cols", 1).first;
+    if (rows < 0 || cols < 0)
+    {
+      errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "The grid of population [" + this->dataPtr->name +
+          "] has a negative number of rows or columns."});
+    }
+    this->dataPtr->rows = static_cast<uint64_t>(std::max(rows, 0));
+    this->dataPtr->cols = static_cast<uint64_t>(std::max(cols, 0));
+    this->dataPtr->step = distElem->Get<ignition::math::Vector3d>("step",
+        this->dataPtr->step).first;
+  }
+  else
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "A population requires a <distribution> element."});
+  }
+
+  if (_sdf->HasElement("box"))
+  {
+    this->dataPtr->box.emplace();
+    Errors boxErrors = this->dataPtr->box->Load(_sdf->GetElement("box"));
+    errors.insert(errors.end(), boxErrors.begin(), boxErrors.end());
+  }
+  else if (_sdf->HasElement("cylinder"))
+  {
+    this->dataPtr->cylinder.emplace();
+    Errors cylinderErrors =
+        this->dataPtr->cylinder->Load(_sdf->GetElement("cylinder"));
+    errors.insert(errors.end(), cylinderErrors.begin(), cylinderErrors.end());
+  }
+  else if (this->dataPtr->type != PopulationDistributionType::GRID)
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "Population [" + this->dataPtr->name + "] requires a <box> or "
+        "<cylinder> region for a [" +
+        kDistributionTypeNames[static_cast<int>(this->dataPtr->type)] +
+        "] distribution."});
+  }
+
+  // Load the pose. Ignore the return value since the pose is optional.
+  loadPose(_sdf, this->dataPtr->pose, this->dataPtr->poseRelativeTo);
+
+  // Load the model once, as the prototype of the instances.
+  if (_sdf->HasElement("model"))
+  {
+    this->dataPtr->model =
+        Model::LoadPrototype(_sdf->GetElement("model"), errors);
+  }
+  else
+  {
+    errors.push_back({ErrorCode::ELEMENT_MISSING,
+        "A population requires a <model> element."});
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+const std::string &Population::Name() const
+{
+  return this->dataPtr->name;
+}
+
+/////////////////////////////////////////////////
+void Population::SetName(const std::string &_name)
+{
+  this->dataPtr->name = _name;
+}
+
+/////////////////////////////////////////////////
+uint64_t Population::ModelCount() const
+{
+  return this->dataPtr->modelCount;
+}
+
+/////////////////////////////////////////////////
+void Population::SetModelCount(uint64_t _count)
+{
+  this->dataPtr->modelCount = _count;
+}
+
+/////////////////////////////////////////////////
+PopulationDistributionType Population::DistributionType() const
+{
+  return this->dataPtr->type;
+}
+
+/////////////////////////////////////////////////
+void Population::SetDistributionType(PopulationDistributionType _type)
+{
+  this->dataPtr->type = _type;
+}
+
+/////////////////////////////////////////////////
+uint64_t Population::Rows() const
+{
+  return this->dataPtr->rows;
+}
+
+/////////////////////////////////////////////////
+void Population::SetRows(uint64_t _rows)
+{
+  this->dataPtr->rows = _rows;
+}
+
+/////////////////////////////////////////////////
+uint64_t Population::Cols() const
+{
+  return this->dataPtr->cols;
+}
+
+/////////////////////////////////////////////////
+void Population::SetCols(uint64_t _cols)
+{
+  this->dataPtr->cols = _cols;
+}
+
+/////////////////////////////////////////////////
+const ignition::math::Vector3d &Population::Step() const
+{
+  return this->dataPtr->step;
+}
+
+/////////////////////////////////////////////////
+void Population::SetStep(const ignition::math::Vector3d &_step)
+{
+  this->dataPtr->step = _step;
+}
+
+/////////////////////////////////////////////////
+const Box *Population::BoxShape() const
+{
+  return this->dataPtr->box ? &*this->dataPtr->box : nullptr;
+}
+
+/////////////////////////////////////////////////
+void Population::SetBoxShape(const Box &_box)
+{
+  this->dataPtr->box = _box;
+  this->dataPtr->cylinder.reset();
+}
+
+/////////////////////////////////////////////////
+const Cylinder *Population::CylinderShape() const
+{
+  return this->dataPtr->cylinder ? &*this->dataPtr->cylinder : nullptr;
+}
+
+/////////////////////////////////////////////////
+void Population::SetCylinderShape(const Cylinder &_cylinder)
+{
+  this->dataPtr->cylinder = _cylinder;
+  this->dataPtr->box.reset();
+}
+
+/////////////////////////////////////////////////
+uint64_t Population::Seed() const
+{
+  return this->dataPtr->seed;
+}
+
+/////////////////////////////////////////////////
+void Population::SetSeed(uint64_t _seed)
+{
+  this->dataPtr->seed = _seed;
+}
+
+/////////////////////////////////////////////////
+const ignition::math::Pose3d &Population::RawPose() const
+{
+  return this->dataPtr->pose;
+}
+
+/////////////////////////////////////////////////
+void Population::SetRawPose(const ignition::math::Pose3d &_pose)
+{
+  this->dataPtr->pose = _pose;
+}
+
+/////////////////////////////////////////////////
+const std::string &Population::PoseRelativeTo() const
+{
+  return this->dataPtr->poseRelativeTo;
+}
+
+/////////////////////////////////////////////////
+void Population::SetPoseRelativeTo(const std::string &_frame)
+{
+  this->dataPtr->poseRelativeTo = _frame;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<const Model> Population::ModelPrototype() const
+{
+  return this->dataPtr->model;
+}
+
+/////////////////////////////////////////////////
+void Population::SetModelPrototype(std::shared_ptr<const Model> _model)
+{
+  this->dataPtr->model = std::move(_model);
+}
+
+/////////////////////////////////////////////////
+uint64_t Population::InstanceCount() const
+{
+  if (this->dataPtr->type == PopulationDistributionType::GRID)
+    return this->dataPtr->rows * this->dataPtr->cols;
+  return this->dataPtr->modelCount;
+}
+
+/////////////////////////////////////////////////
+ignition::math::Pose3d Population::InstancePose(uint64_t _index) const
+{
+  const PopulationPrivate &data = *this->dataPtr;
+  const double count = static_cast<double>(std::max<uint64_t>(
+      this->InstanceCount(), 1));
+  const double index = static_cast<double>(_index);
+
+  // Half extents of the region, with the cylinder axis along z.
+  ignition::math::Vector3d half = ignition::math::Vector3d::Zero;
+  double radius = 0;
+  if (data.box)
+  {
+    half = data.box->Size() * 0.5;
+  }
+  else if (data.cylinder)
+  {
+    radius = data.cylinder->Radius();
+    half.Set(radius, radius, data.cylinder->Length() * 0.5);
+  }
+
+  // Position of the instance, centered on the population for a box or
+  // cylinder region.
+  ignition::math::Vector3d offset = ignition::math::Vector3d::Zero;
+  switch (data.type)
+  {
+    case PopulationDistributionType::RANDOM:
+    {
+      const double u0 = uniformRandom(data.seed, 3 * _index);
+      const double u1 = uniformRandom(data.seed, 3 * _index + 1);
+      const double u2 = uniformRandom(data.seed, 3 * _index + 2);
+      if (data.cylinder)
+      {
+        // The square root makes the density uniform over the disc.
+        const double r = radius * std::sqrt(u0);
+        const double angle = 2 * IGN_PI * u1;
+        offset.Set(r * std::cos(angle), r * std::sin(angle),
+            (2 * u2 - 1) * half.Z());
+      }
+      else
+      {
+        offset.Set((2 * u0 - 1) * half.X(), (2 * u1 - 1) * half.Y(),
+            (2 * u2 - 1) * half.Z());
+      }
+      break;
+    }
+    case PopulationDistributionType::UNIFORM:
+    {
+      if (data.cylinder)
+      {
+        // Sunflower spiral: each model covers the same area of the disc.
+        const double goldenAngle = IGN_PI * (3 - std::sqrt(5.0));
+        const double r = radius * std::sqrt((index + 0.5) / count);
+        const double angle = index * goldenAngle;
+        offset.Set(r * std::cos(angle), r * std::sin(angle), 0);
+      }
+      else
+      {
+        // Cells of a grid with the aspect ratio of the box, filled row by
+        // row, with one model at the center of each cell.
+        double cols = count;
+        if (half.Y() > 0)
+        {
+          cols = std::max(1.0,
+              std::round(std::sqrt(count * half.X() / half.Y())));
+        }
+        const double rows = std::ceil(count / cols);
+        const double row = std::floor(index / cols);
+        const double col = index - row * cols;
+        offset.Set(half.X() * (2 * (col + 0.5) / cols - 1),
+            half.Y() * (2 * (row + 0.5) / rows - 1), 0);
+      }
+      break;
+    }
+    case PopulationDistributionType::GRID:
+    {
+      const uint64_t cols = std::max<uint64_t>(data.cols, 1);
+      offset.Set(static_cast<double>(_index % cols) * data.step.X(),
+          static_cast<double>(_index / cols) * data.step.Y(), 0);
+      break;
+    }
+    case PopulationDistributionType::LINEAR_X:
+      offset.X(half.X() * (2 * (index + 0.5) / count - 1));
+      break;
+    case PopulationDistributionType::LINEAR_Y:
+      offset.Y(half.Y() * (2 * (index + 0.5) / count - 1));
+      break;
+    case PopulationDistributionType::LINEAR_Z:
+      offset.Z(half.Z() * (2 * (index + 0.5) / count - 1));
+      break;
+  }
+
+  return data.pose * ignition::math::Pose3d(offset,
+      ignition::math::Quaterniond::Identity);
+}
+
+/////////////////////////////////////////////////
+std::vector<ignition::math::Pose3d> Population::InstancePoses() const
+{
+  std::vector<ignition::math::Pose3d> poses;
+  const uint64_t count = this->InstanceCount();
+  poses.reserve(count);
+  for (uint64_t i = 0; i < count; ++i)
+    poses.push_back(this->InstancePose(i));
+  return poses;
+}
+
+/////////////////////////////////////////////////
+Model Population::Instance(uint64_t _index) const
+{
+  Model instance;
+  instance.SetPrototype(this->dataPtr->model);
+  if (this->dataPtr->model)
+  {
+    instance.SetName(
+        this->dataPtr->model->Name() + "_clone_" + std::to_string(_index));
+    instance.SetStatic(this->dataPtr->model->Static());
+    instance.SetPlacementFrameName(
+        this->dataPtr->model->PlacementFrameName());
+  }
+  instance.SetRawPose(this->InstancePose(_index));
+  instance.SetPoseRelativeTo(this->dataPtr->poseRelativeTo);
+  return instance;
+}
+
+/////////////////////////////////////////////////
+std::vector<Model> Population::Instances() const
+{
+  std::vector<Model> instances;
+  const uint64_t count = this->InstanceCount();
+  instances.reserve(count);
+  for (uint64_t i = 0; i < count; ++i)
+    instances.push_back(this->Instance(i));
+  return instances;
+}
+
+/////////////////////////////////////////////////
+sdf::ElementPtr Population::Element() const
+{
+  return this->dataPtr->sdf;
+}
@@ -0,0 +1,300 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <ignition/math/Pose3.hh>
+#include "sdf/Box.hh"
+#include "sdf/Cylinder.hh"
+#include "sdf/Link.hh"
+#include "sdf/Model.hh"
+#include "sdf/Population.hh"
+#include "sdf/Root.hh"
+#include "sdf/World.hh"
+
+/////////////////////////////////////////////////
+TEST(DOMPopulation, Construction)
+{
+  sdf::Population population;
+  EXPECT_EQ(nullptr, population.Element());
+  EXPECT_TRUE(population.Name().empty());
+  EXPECT_EQ(1u, population.ModelCount());
+  EXPECT_EQ(sdf::PopulationDistributionType::RANDOM,
+            population.DistributionType());
+  EXPECT_EQ(1u, population.Rows());
+  EXPECT_EQ(1u, population.Cols());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 0.5, 0), population.Step());
+  EXPECT_EQ(nullptr, population.BoxShape());
+  EXPECT_EQ(nullptr, population.CylinderShape());
+  EXPECT_EQ(0u, population.Seed());
+  EXPECT_EQ(ignition::math::Pose3d::Zero, population.RawPose());
+  EXPECT_TRUE(population.PoseRelativeTo().empty());
+  EXPECT_EQ(nullptr, population.ModelPrototype());
+  EXPECT_EQ(1u, population.InstanceCount());
+
+  population.SetName("forest");
+  EXPECT_EQ("forest", population.Name());
+
+  population.SetModelCount(10);
+  EXPECT_EQ(10u, population.ModelCount());
+
+  population.SetSeed(42);
+  EXPECT_EQ(42u, population.Seed());
+
+  sdf::Box box;
+  box.SetSize({2, 4, 0});
+  population.SetBoxShape(box);
+  ASSERT_NE(nullptr, population.BoxShape());
+  EXPECT_EQ(ignition::math::Vector3d(2, 4, 0), population.BoxShape()->Size());
+
+  population.SetCylinderShape(sdf::Cylinder());
+  EXPECT_EQ(nullptr, population.BoxShape());
+  EXPECT_NE(nullptr, population.CylinderShape());
+
+  population.SetPoseRelativeTo("frame");
+  EXPECT_EQ("frame", population.PoseRelativeTo());
+
+  sdf::Population copy(population);
+  EXPECT_EQ("forest", copy.Name());
+  EXPECT_EQ(42u, copy.Seed());
+  EXPECT_NE(nullptr, copy.CylinderShape());
+
+  sdf::Population moved(std::move(copy));
+  EXPECT_EQ("forest", moved.Name());
+
+  sdf::Population assigned;
+  assigned = moved;
+  EXPECT_EQ(10u, assigned.ModelCount());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMPopulation, GridAndLinear)
+{
+  sdf::Population population;
+  population.SetRawPose({1, 2, 3, 0, 0, 0});
+  population.SetDistributionType(sdf::PopulationDistributionType::GRID);
+  population.SetRows(2);
+  population.SetCols(3);
+  population.SetStep({1, 2, 0});
+
+  ASSERT_EQ(6u, population.InstanceCount());
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0, 0, 0),
+            population.InstancePose(0));
+  EXPECT_EQ(ignition::math::Pose3d(3, 2, 3, 0, 0, 0),
+            population.InstancePose(2));
+  EXPECT_EQ(ignition::math::Pose3d(2, 4, 3, 0, 0, 0),
+            population.InstancePose(4));
+
+  sdf::Box box;
+  box.SetSize({4, 2, 6});
+  population.SetBoxShape(box);
+  population.SetRawPose(ignition::math::Pose3d::Zero);
+  population.SetModelCount(2);
+
+  population.SetDistributionType(sdf::PopulationDistributionType::LINEAR_X);
+  ASSERT_EQ(2u, population.InstanceCount());
+  EXPECT_EQ(ignition::math::Vector3d(-1, 0, 0),
+            population.InstancePose(0).Pos());
+  EXPECT_EQ(ignition::math::Vector3d(1, 0, 0),
+            population.InstancePose(1).Pos());
+
+  population.SetDistributionType(sdf::PopulationDistributionType::LINEAR_Z);
+  EXPECT_EQ(ignition::math::Vector3d(0, 0, 1.5),
+            population.InstancePose(1).Pos());
+
+  // The offsets are rotated with the population.
+  population.SetRawPose({0, 0, 0, 0, IGN_PI_2, 0});
+  EXPECT_NEAR(1.5, population.InstancePose(1).Pos().X(), 1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST(DOMPopulation, RandomAndUniform)
+{
+  sdf::Population population;
+  population.SetModelCount(100);
+  sdf::Box box;
+  box.SetSize({4, 2, 0});
+  population.SetBoxShape(box);
+
+  // Random poses are repeatable, and can be generated in any order.
+  auto poses = population.InstancePoses();
+  ASSERT_EQ(100u, poses.size());
+  EXPECT_EQ(poses[57], population.InstancePose(57));
+  std::set<double> xs;
+  for (const auto &pose : poses)
+  {
+    EXPECT_LE(std::abs(pose.Pos().X()), 2.0);
+    EXPECT_LE(std::abs(pose.Pos().Y()), 1.0);
+    EXPECT_DOUBLE_EQ(0.0, pose.Pos().Z());
+    xs.insert(pose.Pos().X());
+  }
+  EXPECT_EQ(100u, xs.size());
+
+  population.SetSeed(1);
+  EXPECT_NE(poses[0], population.InstancePose(0));
+
+  sdf::Cylinder cylinder;
+  cylinder.SetRadius(2);
+  cylinder.SetLength(1);
+  population.SetCylinderShape(cylinder);
+  for (const auto &pose : population.InstancePoses())
+  {
+    EXPECT_LE(pose.Pos().Length(), std::sqrt(4.25));
+    EXPECT_LE(std::hypot(pose.Pos().X(), pose.Pos().Y()), 2.0);
+  }
+
+  // Uniform poses are distinct and inside the region.
+  population.SetDistributionType(sdf::PopulationDistributionType::UNIFORM);
+  std::set<std::pair<double, double>> cylinderPoints;
+  for (const auto &pose : population.InstancePoses())
+  {
+    EXPECT_LE(std::hypot(pose.Pos().X(), pose.Pos().Y()), 2.0);
+    cylinderPoints.insert({pose.Pos().X(), pose.Pos().Y()});
+  }
+  EXPECT_EQ(100u, cylinderPoints.size());
+
+  population.SetBoxShape(box);
+  std::set<std::pair<double, double>> boxPoints;
+  for (const auto &pose : population.InstancePoses())
+  {
+    EXPECT_LT(std::abs(pose.Pos().X()), 2.0);
+    EXPECT_LT(std::abs(pose.Pos().Y()), 1.0);
+    boxPoints.insert({pose.Pos().X(), pose.Pos().Y()});
+  }
+  EXPECT_EQ(100u, boxPoints.size());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMPopulation, Instances)
+{
+  sdf::Population population;
+  population.SetModelCount(3);
+  population.SetDistributionType(sdf::PopulationDistributionType::LINEAR_Y);
+  sdf::Box box;
+  box.SetSize({1, 3, 1});
+  population.SetBoxShape(box);
+  population.SetPoseRelativeTo("frame");
+
+  // Without a model, instances have no contents.
+  EXPECT_EQ(0u, population.Instance(0).LinkCount());
+
+  auto prototype = std::make_shared<sdf::Model>();
+  prototype->SetName("tree");
+  prototype->SetStatic(true);
+  population.SetModelPrototype(prototype);
+  EXPECT_EQ(prototype, population.ModelPrototype());
+
+  auto instances = population.Instances();
+  ASSERT_EQ(3u, instances.size());
+  EXPECT_EQ("tree_clone_0", instances[0].Name());
+  EXPECT_EQ("tree_clone_2", instances[2].Name());
+  EXPECT_TRUE(instances[1].IsInstance());
+  EXPECT_EQ(prototype, instances[1].Prototype());
+  EXPECT_TRUE(instances[1].Static());
+  EXPECT_EQ("frame", instances[1].PoseRelativeTo());
+  EXPECT_EQ(population.InstancePose(2), instances[2].RawPose());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMPopulation, Load)
+{
+  const std::string sdf = R"(
+<sdf version='1.8'>
+  <world name='default'>
+    <population name='forest'>
+      <model_count>5</model_count>
+      <distribution>
+        <type>random</type>
+      </distribution>
+      <box>
+        <size>10 10 0</size>
+      </box>
+      <pose>1 2 0 0 0 0</pose>
+      <model name='tree'>
+        <static>true</static>
+        <link name='trunk'/>
+      </model>
+    </population>
+    <population name='shelves'>
+      <distribution>
+        <type>grid</type>
+        <rows>2</rows>
+        <cols>4</cols>
+        <step>2 3 0</step>
+      </distribution>
+      <model name='shelf'>
+        <link name='base'/>
+      </model>
+    </population>
+    <population name='broken'>
+      <distribution>
+        <type>linear-x</type>
+      </distribution>
+      <model name='crate'>
+        <link name='base'/>
+      </model>
+    </population>
+  </world>
+</sdf>)";
+
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(sdf);
+
+  // The linear distribution without a region is reported, which makes the
+  // world fail to load.
+  ASSERT_EQ(2u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_MISSING, errors[0].Code());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_INVALID, errors[1].Code());
+
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+  ASSERT_EQ(3u, world->PopulationCount());
+  EXPECT_TRUE(world->PopulationNameExists("shelves"));
+  EXPECT_EQ(nullptr, world->PopulationByName("desert"));
+
+  const sdf::Population *forest = world->PopulationByIndex(0);
+  ASSERT_NE(nullptr, forest);
+  EXPECT_EQ("forest", forest->Name());
+  EXPECT_NE(nullptr, forest->Element());
+  EXPECT_EQ(5u, forest->InstanceCount());
+  ASSERT_NE(nullptr, forest->BoxShape());
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 0, 0, 0, 0), forest->RawPose());
+
+  // The model is loaded once and shared by the instances, whose links
+  // resolve their poses in the graphs of the prototype.
+  auto tree = forest->ModelPrototype();
+  ASSERT_NE(nullptr, tree);
+  EXPECT_EQ("tree", tree->Name());
+  sdf::Model instance = forest->Instance(4);
+  EXPECT_EQ("tree_clone_4", instance.Name());
+  EXPECT_TRUE(instance.Static());
+  EXPECT_EQ(tree->LinkByName("trunk"), instance.LinkByName("trunk"));
+  ignition::math::Pose3d pose;
+  EXPECT_TRUE(instance.LinkByName("trunk")->SemanticPose().Resolve(
+      pose, "__model__").empty());
+
+  const sdf::Population *shelves = world->PopulationByName("shelves");
+  ASSERT_NE(nullptr, shelves);
+  EXPECT_EQ(sdf::PopulationDistributionType::GRID,
+            shelves->DistributionType());
+  EXPECT_EQ(8u, shelves->InstanceCount());
+  EXPECT_EQ(ignition::math::Vector3d(6, 3, 0),
+            shelves->InstancePose(7).Pos());
+}
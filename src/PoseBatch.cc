@@ -0,0 +1,363 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "PoseBatch.hh"
+
+// The AVX2 kernel is built for every x86-64 target with GCC or Clang and
+// only used when the CPU supports it. Other compilers need AVX2 to be
+// enabled for the whole build.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SDF_POSE_BATCH_AVX2 __attribute__((target("avx2")))
+#define SDF_POSE_BATCH_AVX2_CHECK __builtin_cpu_supports("avx2")
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define SDF_POSE_BATCH_AVX2
+#define SDF_POSE_BATCH_AVX2_CHECK true
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SDF_POSE_BATCH_NEON
+#endif
+
+namespace sdf
+{
+inline namespace SDF_VERSION_NAMESPACE {
+
+/// \brief Quaternions with a squared norm up to this value have no inverse,
+/// as in ignition::math::Quaternion::Inverse.
+static const double kInverseEpsilon = 1e-6;
+
+/// \brief Pointers to the components of the poses of a batch.
+template <typename T>
+struct PoseArrays
+{
+  T *x;
+  T *y;
+  T *z;
+  T *qw;
+  T *qx;
+  T *qy;
+  T *qz;
+};
+
+/////////////////////////////////////////////////
+/// \brief Compose a range of poses one at a time.
+/// \param[out] _out Composed poses.
+/// \param[in] _first Poses relative to which _second poses are expressed.
+/// \param[in] _second Poses to compose.
+/// \param[in] _begin Index of the first pose of the range.
+/// \param[in] _end Index past the last pose of the range.
+static void composeScalar(const PoseArrays<double> &_out,
+    const PoseArrays<const double> &_first,
+    const PoseArrays<const double> &_second,
+    std::size_t _begin, std::size_t _end)
+{
+  for (std::size_t i = _begin; i < _end; ++i)
+  {
+    const double aw = _first.qw[i];
+    const double ax = _first.qx[i];
+    const double ay = _first.qy[i];
+    const double az = _first.qz[i];
+    const double bw = _second.qw[i];
+    const double bx = _second.qx[i];
+    const double by = _second.qy[i];
+    const double bz = _second.qz[i];
+    const double px = _second.x[i];
+    const double py = _second.y[i];
+    const double pz = _second.z[i];
+
+    // Inverse of the first rotation.
+    const double s = aw * aw + ax * ax + ay * ay + az * az;
+    double iw = 1.0;
+    double ix = 0.0;
+    double iy = 0.0;
+    double iz = 0.0;
+    if (std::abs(s) > kInverseEpsilon)
+    {
+      iw = aw / s;
+      ix = -ax / s;
+      iy = -ay / s;
+      iz = -az / s;
+    }
+
+    // Rotate the second position as q * (p * q^-1).
+    const double tw = -(px * ix) - py * iy - pz * iz;
+    const double tx = px * iw + py * iz - pz * iy;
+    const double ty = -(px * iz) + py * iw + pz * ix;
+    const double tz = px * iy - py * ix + pz * iw;
+    const double rx = aw * tx + ax * tw + ay * tz - az * ty;
+    const double ry = aw * ty - ax * tz + ay * tw + az * tx;
+    const double rz = aw * tz + ax * ty - ay * tx + az * tw;
+
+    _out.x[i] = _first.x[i] + rx;
+    _out.y[i] = _first.y[i] + ry;
+    _out.z[i] = _first.z[i] + rz;
+    _out.qw[i] = aw * bw - ax * bx - ay * by - az * bz;
+    _out.qx[i] = aw * bx + ax * bw + ay * bz - az * by;
+    _out.qy[i] = aw * by - ax * bz + ay * bw + az * bx;
+    _out.qz[i] = aw * bz + ax * by - ay * bx + az * bw;
+  }
+}
+
+#ifdef SDF_POSE_BATCH_AVX2
+/////////////////////////////////////////////////
+/// \brief Compose poses four at a time with AVX2 instructions, with the
+/// same operations as composeScalar.
+/// \param[out] _out Composed poses.
+/// \param[in] _first Poses relative to which _second poses are expressed.
+/// \param[in] _second Poses to compose.
+/// \param[in] _count Number of poses.
+/// \return Number of poses composed, a multiple of four.
+SDF_POSE_BATCH_AVX2
+static std::size_t composeAvx2(const PoseArrays<double> &_out,
+    const PoseArrays<const double> &_first,
+    const PoseArrays<const double> &_second, std::size_t _count)
+{
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  const __m256d epsilon = _mm256_set1_pd(kInverseEpsilon);
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d zero = _mm256_setzero_pd();
+
+  std::size_t i = 0;
+  for (; i + 4 <= _count; i += 4)
+  {
+    const __m256d aw = _mm256_loadu_pd(_first.qw + i);
+    const __m256d ax = _mm256_loadu_pd(_first.qx + i);
+    const __m256d ay = _mm256_loadu_pd(_first.qy + i);
+    const __m256d az = _mm256_loadu_pd(_first.qz + i);
+    const __m256d bw = _mm256_loadu_pd(_second.qw + i);
+    const __m256d bx = _mm256_loadu_pd(_second.qx + i);
+    const __m256d by = _mm256_loadu_pd(_second.qy + i);
+    const __m256d bz = _mm256_loadu_pd(_second.qz + i);
+    const __m256d px = _mm256_loadu_pd(_second.x + i);
+    const __m256d py = _mm256_loadu_pd(_second.y + i);
+    const __m256d pz = _mm256_loadu_pd(_second.z + i);
+
+    // Inverse of the first rotation.
+    const __m256d s = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(aw, aw), _mm256_mul_pd(ax, ax)),
+        _mm256_mul_pd(ay, ay)), _mm256_mul_pd(az, az));
+    const __m256d invertible = _mm256_cmp_pd(
+        _mm256_andnot_pd(sign, s), epsilon, _CMP_GT_OQ);
+    const __m256d iw = _mm256_blendv_pd(one, _mm256_div_pd(aw, s),
+        invertible);
+    const __m256d ix = _mm256_blendv_pd(zero,
+        _mm256_div_pd(_mm256_xor_pd(ax, sign), s), invertible);
+    const __m256d iy = _mm256_blendv_pd(zero,
+        _mm256_div_pd(_mm256_xor_pd(ay, sign), s), invertible);
+    const __m256d iz = _mm256_blendv_pd(zero,
+        _mm256_div_pd(_mm256_xor_pd(az, sign), s), invertible);
+
+    // Rotate the second position as q * (p * q^-1).
+    const __m256d tw = _mm256_sub_pd(_mm256_sub_pd(
+        _mm256_xor_pd(_mm256_mul_pd(px, ix), sign),
+        _mm256_mul_pd(py, iy)), _mm256_mul_pd(pz, iz));
+    const __m256d tx = _mm256_sub_pd(_mm256_add_pd(
+        _mm256_mul_pd(px, iw), _mm256_mul_pd(py, iz)),
+        _mm256_mul_pd(pz, iy));
+    const __m256d ty = _mm256_add_pd(_mm256_add_pd(
+        _mm256_xor_pd(_mm256_mul_pd(px, iz), sign),
+        _mm256_mul_pd(py, iw)), _mm256_mul_pd(pz, ix));
+    const __m256d tz = _mm256_add_pd(_mm256_sub_pd(
+        _mm256_mul_pd(px, iy), _mm256_mul_pd(py, ix)),
+        _mm256_mul_pd(pz, iw));
+    const __m256d rx = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(aw, tx), _mm256_mul_pd(ax, tw)),
+        _mm256_mul_pd(ay, tz)), _mm256_mul_pd(az, ty));
+    const __m256d ry = _mm256_add_pd(_mm256_add_pd(_mm256_sub_pd(
+        _mm256_mul_pd(aw, ty), _mm256_mul_pd(ax, tz)),
+        _mm256_mul_pd(ay, tw)), _mm256_mul_pd(az, tx));
+    const __m256d rz = _mm256_add_pd(_mm256_sub_pd(_mm256_add_pd(
+        _mm256_mul_pd(aw, tz), _mm256_mul_pd(ax, ty)),
+        _mm256_mul_pd(ay, tx)), _mm256_mul_pd(az, tw));
+
+    const __m256d qw = _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(
+        _mm256_mul_pd(aw, bw), _mm256_mul_pd(ax, bx)),
+        _mm256_mul_pd(ay, by)), _mm256_mul_pd(az, bz));
+    const __m256d qx = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(
+        _mm256_mul_pd(aw, bx), _mm256_mul_pd(ax, bw)),
+        _mm256_mul_pd(ay, bz)), _mm256_mul_pd(az, by));
+    const __m256d qy = _mm256_add_pd(_mm256_add_pd(_mm256_sub_pd(
+        _mm256_mul_pd(aw, by), _mm256_mul_pd(ax, bz)),
+        _mm256_mul_pd(ay, bw)), _mm256_mul_pd(az, bx));
+    const __m256d qz = _mm256_add_pd(_mm256_sub_pd(_mm256_add_pd(
+        _mm256_mul_pd(aw, bz), _mm256_mul_pd(ax, by)),
+        _mm256_mul_pd(ay, bx)), _mm256_mul_pd(az, bw));
+
+    _mm256_storeu_pd(_out.x + i,
+        _mm256_add_pd(_mm256_loadu_pd(_first.x + i), rx));
+    _mm256_storeu_pd(_out.y + i,
+        _mm256_add_pd(_mm256_loadu_pd(_first.y + i), ry));
+    _mm256_storeu_pd(_out.z + i,
+        _mm256_add_pd(_mm256_loadu_pd(_first.z + i), rz));
+    _mm256_storeu_pd(_out.qw + i, qw);
+    _mm256_storeu_pd(_out.qx + i, qx);
+    _mm256_storeu_pd(_out.qy + i, qy);
+    _mm256_storeu_pd(_out.qz + i, qz);
+  }
+  return i;
+}
+#endif
+
+#ifdef SDF_POSE_BATCH_NEON
+/////////////////////////////////////////////////
+/// \brief Compose poses two at a time with NEON instructions, with the
+/// same operations as composeScalar.
+/// \param[out] _out Composed poses.
+/// \param[in] _first Poses relative to which _second poses are expressed.
+/// \param[in] _second Poses to compose.
+/// \param[in] _count Number of poses.
+/// \return Number of poses composed, a multiple of two.
+static std::size_t composeNeon(const PoseArrays<double> &_out,
+    const PoseArrays<const double> &_first,
+    const PoseArrays<const double> &_second, std::size_t _count)
+{
+  const float64x2_t epsilon = vdupq_n_f64(kInverseEpsilon);
+  const float64x2_t one = vdupq_n_f64(1.0);
+  const float64x2_t zero = vdupq_n_f64(0.0);
+
+  std::size_t i = 0;
+  for (; i + 2 <= _count; i += 2)
+  {
+    const float64x2_t aw = vld1q_f64(_first.qw + i);
+    const float64x2_t ax = vld1q_f64(_first.qx + i);
+    const float64x2_t ay = vld1q_f64(_first.qy + i);
+    const float64x2_t az = vld1q_f64(_first.qz + i);
+    const float64x2_t bw = vld1q_f64(_second.qw + i);
+    const float64x2_t bx = vld1q_f64(_second.qx + i);
+    const float64x2_t by = vld1q_f64(_second.qy + i);
+    const float64x2_t bz = vld1q_f64(_second.qz + i);
+    const float64x2_t px = vld1q_f64(_second.x + i);
+    const float64x2_t py = vld1q_f64(_second.y + i);
+    const float64x2_t pz = vld1q_f64(_second.z + i);
+
+    // Inverse of the first rotation.
+    const float64x2_t s = vaddq_f64(vaddq_f64(vaddq_f64(
+        vmulq_f64(aw, aw), vmulq_f64(ax, ax)),
+        vmulq_f64(ay, ay)), vmulq_f64(az, az));
+    const uint64x2_t invertible = vcgtq_f64(vabsq_f64(s), epsilon);
+    const float64x2_t iw = vbslq_f64(invertible, vdivq_f64(aw, s), one);
+    const float64x2_t ix =
+        vbslq_f64(invertible, vdivq_f64(vnegq_f64(ax), s), zero);
+    const float64x2_t iy =
+        vbslq_f64(invertible, vdivq_f64(vnegq_f64(ay), s), zero);
+    const float64x2_t iz =
+        vbslq_f64(invertible, vdivq_f64(vnegq_f64(az), s), zero);
+
+    // Rotate the second position as q * (p * q^-1).
+    const float64x2_t tw = vsubq_f64(vsubq_f64(
+        vnegq_f64(vmulq_f64(px, ix)), vmulq_f64(py, iy)),
+        vmulq_f64(pz, iz));
+    const float64x2_t tx = vsubq_f64(vaddq_f64(
+        vmulq_f64(px, iw), vmulq_f64(py, iz)), vmulq_f64(pz, iy));
+    const float64x2_t ty = vaddq_f64(vaddq_f64(
+        vnegq_f64(vmulq_f64(px, iz)), vmulq_f64(py, iw)),
+        vmulq_f64(pz, ix));
+    const float64x2_t tz = vaddq_f64(vsubq_f64(
+        vmulq_f64(px, iy), vmulq_f64(py, ix)), vmulq_f64(pz, iw));
+    const float64x2_t rx = vsubq_f64(vaddq_f64(vaddq_f64(
+        vmulq_f64(aw, tx), vmulq_f64(ax, tw)), vmulq_f64(ay, tz)),
+        vmulq_f64(az, ty));
+    const float64x2_t ry = vaddq_f64(vaddq_f64(vsubq_f64(
+        vmulq_f64(aw, ty), vmulq_f64(ax, tz)), vmulq_f64(ay, tw)),
+        vmulq_f64(az, tx));
+    const float64x2_t rz = vaddq_f64(vsubq_f64(vaddq_f64(
+        vmulq_f64(aw, tz), vmulq_f64(ax, ty)), vmulq_f64(ay, tx)),
+        vmulq_f64(az, tw));
+
+    const float64x2_t qw = vsubq_f64(vsubq_f64(vsubq_f64(
+        vmulq_f64(aw, bw), vmulq_f64(ax, bx)), vmulq_f64(ay, by)),
+        vmulq_f64(az, bz));
+    const float64x2_t qx = vsubq_f64(vaddq_f64(vaddq_f64(
+        vmulq_f64(aw, bx), vmulq_f64(ax, bw)), vmulq_f64(ay, bz)),
+        vmulq_f64(az, by));
+    const float64x2_t qy = vaddq_f64(vaddq_f64(vsubq_f64(
+        vmulq_f64(aw, by), vmulq_f64(ax, bz)), vmulq_f64(ay, bw)),
+        vmulq_f64(az, bx));
+    const float64x2_t qz = vaddq_f64(vsubq_f64(vaddq_f64(
+        vmulq_f64(aw, bz), vmulq_f64(ax, by)), vmulq_f64(ay, bx)),
+        vmulq_f64(az, bw));
+
+    vst1q_f64(_out.x + i, vaddq_f64(vld1q_f64(_first.x + i), rx));
+    vst1q_f64(_out.y + i, vaddq_f64(vld1q_f64(_first.y + i), ry));
+    vst1q_f64(_out.z + i, vaddq_f64(vld1q_f64(_first.z + i), rz));
+    vst1q_f64(_out.qw + i, qw);
+    vst1q_f64(_out.qx + i, qx);
+    vst1q_f64(_out.qy + i, qy);
+    vst1q_f64(_out.qz + i, qz);
+  }
+  return i;
+}
+#endif
+
+/////////////////////////////////////////////////
+std::size_t PoseBatch::Size() const
+{
+  return this->x.size();
+}
+
+/////////////////////////////////////////////////
+void PoseBatch::Clear()
+{
+  this->Resize(0);
+}
+
+/////////////////////////////////////////////////
+void PoseBatch::Resize(std::size_t _size)
+{
+  for (auto *component : {&this->x, &this->y, &this->z,
+                          &this->qx, &this->qy, &this->qz})
+  {
+    component->resize(_size, 0.0);
+  }
+  this->qw.resize(_size, 1.0);
+}
+
+/////////////////////////////////////////////////
+void composePoses(PoseBatch &_out, const PoseBatch &_first,
+    const PoseBatch &_second)
+{
+  const std::size_t count = std::min(_first.Size(), _second.Size());
+  _out.Resize(count);
+
+  const PoseArrays<double> out{_out.x.data(), _out.y.data(), _out.z.data(),
+      _out.qw.data(), _out.qx.data(), _out.qy.data(), _out.qz.data()};
+  const PoseArrays<const double> first{_first.x.data(), _first.y.data(),
+      _first.z.data(), _first.qw.data(), _first.qx.data(), _first.qy.data(),
+      _first.qz.data()};
+  const PoseArrays<const double> second{_second.x.data(), _second.y.data(),
+      _second.z.data(), _second.qw.data(), _second.qx.data(),
+      _second.qy.data(), _second.qz.data()};
+
+  std::size_t done = 0;
+#if defined(SDF_POSE_BATCH_AVX2)
+  static const bool hasAvx2 = SDF_POSE_BATCH_AVX2_CHECK;
+  if (hasAvx2)
+  {
+    done = composeAvx2(out, first, second, count);
+  }
+#elif defined(SDF_POSE_BATCH_NEON)
+  done = composeNeon(out, first, second, count);
+#endif
+  composeScalar(out, first, second, done, count);
+}
+}
+}
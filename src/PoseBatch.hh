@@ -0,0 +1,127 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef SDF_POSE_BATCH_HH
+#define SDF_POSE_BATCH_HH
+
+#include <cstddef>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+
+#include "sdf/sdf_config.h"
+
+namespace sdf
+{
+// Inline bracket to help doxygen filtering.
+inline namespace SDF_VERSION_NAMESPACE {
+
+/// \brief Poses stored as a structure of arrays, with one array per
+/// component of the position and of the rotation quaternion, so that
+/// composePoses can compose several independent poses at once with SIMD
+/// instructions.
+struct PoseBatch
+{
+  /// \brief Get the number of poses.
+  /// \return Number of poses.
+  std::size_t Size() const;
+
+  /// \brief Remove all the poses, keeping the allocated memory.
+  void Clear();
+
+  /// \brief Change the number of poses. New poses are zero poses.
+  /// \param[in] _size New number of poses.
+  void Resize(std::size_t _size);
+
+  /// \brief Add a pose at the end.
+  /// \param[in] _pose Pose to add.
+  void PushBack(const ignition::math::Pose3d &_pose);
+
+  /// \brief Set a pose.
+  /// \param[in] _index Index of the pose, less than Size().
+  /// \param[in] _pose New pose.
+  void Set(std::size_t _index, const ignition::math::Pose3d &_pose);
+
+  /// \brief Get a pose.
+  /// \param[in] _index Index of the pose, less than Size().
+  /// \return The pose.
+  ignition::math::Pose3d Pose(std::size_t _index) const;
+
+  /// \brief X, Y and Z components of the positions.
+  std::vector<double> x, y, z;
+
+  /// \brief W, X, Y and Z components of the rotations.
+  std::vector<double> qw, qx, qy, qz;
+};
+
+/// \brief Number of poses of the batches of bulk pose resolution. Batches
+/// of this size stay in the L1 cache while they are filled, composed and
+/// read back, which matters more than the size of the SIMD loops.
+constexpr std::size_t kPoseBatchSize = 64;
+
+/// \brief Compose the poses of two batches, pose by pose, so that
+/// _out.Pose(i) is _first.Pose(i) * _second.Pose(i). The arithmetic is the
+/// same as ignition::math::Pose3d::operator*, in the same order, with AVX2
+/// or NEON instructions when the CPU supports them. Results may only differ
+/// from operator* when the compiler fuses multiplications and additions
+/// differently.
+/// \param[out] _out Composed poses. Its size becomes the smaller size of
+/// _first and _second. It can be the same batch as _first or _second.
+/// \param[in] _first Poses relative to which _second poses are expressed.
+/// \param[in] _second Poses to compose.
+void composePoses(PoseBatch &_out, const PoseBatch &_first,
+    const PoseBatch &_second);
+
+/////////////////////////////////////////////////
+inline void PoseBatch::PushBack(const ignition::math::Pose3d &_pose)
+{
+  this->x.push_back(_pose.Pos().X());
+  this->y.push_back(_pose.Pos().Y());
+  this->z.push_back(_pose.Pos().Z());
+  this->qw.push_back(_pose.Rot().W());
+  this->qx.push_back(_pose.Rot().X());
+  this->qy.push_back(_pose.Rot().Y());
+  this->qz.push_back(_pose.Rot().Z());
+}
+
+/////////////////////////////////////////////////
+inline void PoseBatch::Set(std::size_t _index,
+    const ignition::math::Pose3d &_pose)
+{
+  this->x[_index] = _pose.Pos().X();
+  this->y[_index] = _pose.Pos().Y();
+  this->z[_index] = _pose.Pos().Z();
+  this->qw[_index] = _pose.Rot().W();
+  this->qx[_index] = _pose.Rot().X();
+  this->qy[_index] = _pose.Rot().Y();
+  this->qz[_index] = _pose.Rot().Z();
+}
+
+/////////////////////////////////////////////////
+inline ignition::math::Pose3d PoseBatch::Pose(std::size_t _index) const
+{
+  // The Pose3d constructor that takes the components of a quaternion
+  // normalizes it, so build the quaternion first to keep it as is.
+  return ignition::math::Pose3d(
+      ignition::math::Vector3d(this->x[_index], this->y[_index],
+          this->z[_index]),
+      ignition::math::Quaterniond(this->qw[_index], this->qx[_index],
+          this->qy[_index], this->qz[_index]));
+}
+}
+}
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ignition/math/Pose3.hh>
+
+#include "PoseBatch.hh"
+
+using Pose = ignition::math::Pose3d;
+
+/////////////////////////////////////////////////
+/// \brief Make random poses, with rotations that are not quite normalized
+/// as after long chains of compositions.
+/// \param[in] _count Number of poses.
+/// \param[in] _seed Seed of the random generator.
+/// \return The poses.
+std::vector<Pose> randomPoses(std::size_t _count, unsigned int _seed)
+{
+  std::mt19937 generator(_seed);
+  std::uniform_real_distribution<double> position(-100.0, 100.0);
+  std::uniform_real_distribution<double> angle(-4.0, 4.0);
+  std::uniform_real_distribution<double> scale(0.999, 1.001);
+  std::vector<Pose> poses;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    Pose pose(position(generator), position(generator), position(generator),
+        angle(generator), angle(generator), angle(generator));
+    const double s = scale(generator);
+    pose.Rot().Set(pose.Rot().W() * s, pose.Rot().X() * s,
+        pose.Rot().Y() * s, pose.Rot().Z() * s);
+    poses.push_back(pose);
+  }
+  return poses;
+}
+
+/////////////////////////////////////////////////
+/// \brief Expect two numbers to be equal up to the last few bits.
+/// \param[in] _expected Expected number.
+/// \param[in] _actual Actual number.
+void expectClose(double _expected, double _actual)
+{
+  EXPECT_NEAR(_expected, _actual,
+      1e-13 * std::max(1.0, std::abs(_expected)));
+}
+
+/////////////////////////////////////////////////
+/// \brief Expect two poses to be equal up to the last few bits.
+/// \param[in] _expected Expected pose.
+/// \param[in] _actual Actual pose.
+void expectClose(const Pose &_expected, const Pose &_actual)
+{
+  expectClose(_expected.Pos().X(), _actual.Pos().X());
+  expectClose(_expected.Pos().Y(), _actual.Pos().Y());
+  expectClose(_expected.Pos().Z(), _actual.Pos().Z());
+  expectClose(_expected.Rot().W(), _actual.Rot().W());
+  expectClose(_expected.Rot().X(), _actual.Rot().X());
+  expectClose(_expected.Rot().Y(), _actual.Rot().Y());
+  expectClose(_expected.Rot().Z(), _actual.Rot().Z());
+}
+
+/////////////////////////////////////////////////
+TEST(PoseBatch, Poses)
+{
+  sdf::PoseBatch batch;
+  EXPECT_EQ(0u, batch.Size());
+  batch.PushBack(Pose(1, 2, 3, 0.1, 0.2, 0.3));
+  batch.Resize(2);
+  ASSERT_EQ(2u, batch.Size());
+  EXPECT_EQ(Pose(1, 2, 3, 0.1, 0.2, 0.3), batch.Pose(0));
+  EXPECT_EQ(Pose::Zero, batch.Pose(1));
+
+  // Rotations are kept as they are, without normalizing them.
+  Pose pose(4, 5, 6, 0, 0, 0);
+  pose.Rot().Set(2, 0, 0, 0);
+  batch.Set(1, pose);
+  EXPECT_DOUBLE_EQ(2.0, batch.Pose(1).Rot().W());
+
+  batch.Clear();
+  EXPECT_EQ(0u, batch.Size());
+}
+
+/////////////////////////////////////////////////
+TEST(PoseBatch, Compose)
+{
+  // Sizes that are not multiples of the SIMD widths exercise the scalar
+  // code as well.
+  for (std::size_t count : {0u, 1u, 2u, 3u, 4u, 5u, 7u, 8u, 9u, 31u, 1000u})
+  {
+    const auto firstPoses = randomPoses(count, 1u);
+    const auto secondPoses = randomPoses(count, 2u);
+    sdf::PoseBatch first;
+    sdf::PoseBatch second;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      first.PushBack(firstPoses[i]);
+      second.PushBack(secondPoses[i]);
+    }
+
+    sdf::PoseBatch out;
+    sdf::composePoses(out, first, second);
+    ASSERT_EQ(count, out.Size());
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      expectClose(firstPoses[i] * secondPoses[i], out.Pose(i));
+    }
+
+    // The output can be one of the inputs.
+    sdf::composePoses(first, first, second);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      expectClose(firstPoses[i] * secondPoses[i], first.Pose(i));
+    }
+  }
+
+  // Rotations without an inverse don't rotate the position, like in
+  // Quaternion::Inverse, and batches of different sizes compose the poses
+  // they have in common.
+  sdf::PoseBatch first;
+  sdf::PoseBatch second;
+  std::vector<Pose> firstPoses;
+  std::vector<Pose> secondPoses;
+  for (std::size_t i = 0; i < 5; ++i)
+  {
+    firstPoses.push_back(Pose(1, 2, 3, 0, 0, 0));
+    firstPoses.back().Rot().Set(0, 0, 0, 0);
+    secondPoses.push_back(Pose(4, 5, 6, 0.1, 0.2, 0.3));
+    first.PushBack(firstPoses.back());
+    second.PushBack(secondPoses.back());
+  }
+  second.PushBack(Pose::Zero);
+  sdf::PoseBatch out;
+  sdf::composePoses(out, first, second);
+  ASSERT_EQ(5u, out.Size());
+  for (std::size_t i = 0; i < 5; ++i)
+  {
+    expectClose(firstPoses[i] * secondPoses[i], out.Pose(i));
+    EXPECT_DOUBLE_EQ(1.0, out.Pose(i).Pos().X());
+  }
+}
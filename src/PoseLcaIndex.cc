@@ -0,0 +1,219 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PoseBatch.hh"
+#include "PoseLcaIndex.hh"
+
+using namespace sdf;
+
+/////////////////////////////////////////////////
+PoseLcaIndex::PoseLcaIndex(const ScopedGraph<PoseRelativeToGraph> &_graph)
+    : graph(_graph)
+{
+  const Index kNullIndex = FrozenGraph<PoseRelativeToGraph>::kNullIndex;
+  this->count = this->graph.VertexCount();
+  this->depths.assign(this->count, kNullIndex);
+
+  const Index scopeIndex = this->graph.ScopeIndex();
+  if (scopeIndex == kNullIndex)
+  {
+    return;
+  }
+
+  // Walk the tree down from the scope vertex to find the parent and depth
+  // of each vertex. Vertices with several incoming edges are left out.
+  std::vector<Index> parents(this->count, scopeIndex);
+  std::vector<ignition::math::Pose3d> parentPoses(this->count);
+  std::size_t maxDepth = 0;
+  this->depths[scopeIndex] = 0;
+  std::vector<Index> stack{scopeIndex};
+  while (!stack.empty())
+  {
+    const Index parent = stack.back();
+    stack.pop_back();
+    for (const auto &edge : this->graph.OutEdges(parent))
+    {
+      const Index child = edge.vertex;
+      if (this->depths[child] != kNullIndex ||
+          this->graph.InEdges(child).size() != 1)
+      {
+        continue;
+      }
+      this->depths[child] = this->depths[parent] + 1;
+      maxDepth = std::max(maxDepth, this->depths[child]);
+      parents[child] = parent;
+      parentPoses[child] = edge.data;
+      stack.push_back(child);
+    }
+  }
+
+  // Only as many levels as needed to jump over the deepest path.
+  while ((std::size_t(1) << this->levels) <= maxDepth)
+  {
+    ++this->levels;
+  }
+
+  this->ancestors = std::move(parents);
+  this->jumps = std::move(parentPoses);
+  this->ancestors.resize(this->levels * this->count);
+  this->jumps.resize(this->levels * this->count);
+
+  // The jumps of a level are independent of each other, so they are
+  // composed in batches.
+  PoseBatch first;
+  PoseBatch second;
+  for (std::size_t k = 1; k < this->levels; ++k)
+  {
+    const std::size_t previous = (k - 1) * this->count;
+    const std::size_t current = k * this->count;
+    for (std::size_t begin = 0; begin < this->count; begin += kPoseBatchSize)
+    {
+      const std::size_t size = std::min(kPoseBatchSize, this->count - begin);
+      first.Resize(size);
+      second.Resize(size);
+      for (std::size_t j = 0; j < size; ++j)
+      {
+        const std::size_t i = begin + j;
+        const Index middle = this->ancestors[previous + i];
+        this->ancestors[current + i] = this->ancestors[previous + middle];
+        first.Set(j, this->jumps[previous + middle]);
+        second.Set(j, this->jumps[previous + i]);
+      }
+      composePoses(first, first, second);
+      for (std::size_t j = 0; j < size; ++j)
+      {
+        this->jumps[current + begin + j] = first.Pose(j);
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+const FrozenGraph<PoseRelativeToGraph> &PoseLcaIndex::Graph() const
+{
+  return this->graph;
+}
+
+/////////////////////////////////////////////////
+auto PoseLcaIndex::LowestCommonAncestor(Index _first, Index _second) const
+    -> Index
+{
+  const Index kNullIndex = FrozenGraph<PoseRelativeToGraph>::kNullIndex;
+  if (_first >= this->count || _second >= this->count ||
+      this->depths[_first] == kNullIndex ||
+      this->depths[_second] == kNullIndex)
+  {
+    return kNullIndex;
+  }
+
+  // Lift the deeper vertex to the depth of the other one.
+  if (this->depths[_first] < this->depths[_second])
+  {
+    std::swap(_first, _second);
+  }
+  const std::size_t difference = this->depths[_first] - this->depths[_second];
+  for (std::size_t k = 0; k < this->levels; ++k)
+  {
+    if (difference & (std::size_t(1) << k))
+    {
+      _first = this->ancestors[k * this->count + _first];
+    }
+  }
+  if (_first == _second)
+  {
+    return _first;
+  }
+
+  // Lift both vertices to just below their lowest common ancestor.
+  for (std::size_t k = this->levels; k-- > 0;)
+  {
+    const Index firstAncestor = this->ancestors[k * this->count + _first];
+    const Index secondAncestor = this->ancestors[k * this->count + _second];
+    if (firstAncestor != secondAncestor)
+    {
+      _first = firstAncestor;
+      _second = secondAncestor;
+    }
+  }
+  return this->ancestors[_first];
+}
+
+/////////////////////////////////////////////////
+ignition::math::Pose3d PoseLcaIndex::PoseToAncestor(
+    Index _index, std::size_t _levels) const
+{
+  ignition::math::Pose3d pose;
+  for (std::size_t k = 0; k < this->levels; ++k)
+  {
+    if (_levels & (std::size_t(1) << k))
+    {
+      pose = this->jumps[k * this->count + _index] * pose;
+      _index = this->ancestors[k * this->count + _index];
+    }
+  }
+  return pose;
+}
+
+/////////////////////////////////////////////////
+Errors PoseLcaIndex::ResolvePose(ignition::math::Pose3d &_pose,
+    const std::string &_frameName, const std::string &_resolveTo) const
+{
+  const Index frameIndex = this->graph.IndexByName(_frameName);
+  const Index resolveToIndex = this->graph.IndexByName(_resolveTo);
+  if (this->LowestCommonAncestor(frameIndex, resolveToIndex) ==
+      FrozenGraph<PoseRelativeToGraph>::kNullIndex)
+  {
+    // Resolve the poses on their own to report the same errors.
+    return resolvePose(_pose, this->graph, _frameName, _resolveTo);
+  }
+  return this->ResolvePose(_pose, frameIndex, resolveToIndex);
+}
+
+/////////////////////////////////////////////////
+Errors PoseLcaIndex::ResolvePose(ignition::math::Pose3d &_pose,
+    Index _frameIndex, Index _resolveToIndex) const
+{
+  const Index ancestor =
+      this->LowestCommonAncestor(_frameIndex, _resolveToIndex);
+  if (ancestor == FrozenGraph<PoseRelativeToGraph>::kNullIndex)
+  {
+    // Resolve the poses on their own to report the same errors.
+    Errors errors =
+        resolvePoseRelativeToRoot(_pose, this->graph, _frameIndex);
+    ignition::math::Pose3d poseR;
+    Errors errorsR =
+        resolvePoseRelativeToRoot(poseR, this->graph, _resolveToIndex);
+    errors.insert(errors.end(), errorsR.begin(), errorsR.end());
+    if (errors.empty())
+    {
+      _pose = poseR.Inverse() * _pose;
+    }
+    return errors;
+  }
+
+  const ignition::math::Pose3d pose = this->PoseToAncestor(
+      _frameIndex, this->depths[_frameIndex] - this->depths[ancestor]);
+  const ignition::math::Pose3d poseR = this->PoseToAncestor(
+      _resolveToIndex, this->depths[_resolveToIndex] - this->depths[ancestor]);
+  _pose = poseR.Inverse() * pose;
+  return Errors();
+}
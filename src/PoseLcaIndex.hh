@@ -0,0 +1,119 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef SDF_POSE_LCA_INDEX_HH
+#define SDF_POSE_LCA_INDEX_HH
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+
+#include "sdf/Error.hh"
+#include "sdf/sdf_config.h"
+#include "FrameSemantics.hh"
+#include "FrozenGraph.hh"
+
+namespace sdf
+{
+// Inline bracket to help doxygen filtering.
+inline namespace SDF_VERSION_NAMESPACE {
+
+/// \brief Lowest common ancestor (LCA) index of the tree formed by a scope of
+/// a PoseRelativeToGraph, for many relative pose queries between frames.
+///
+/// resolvePose resolves both frames up to the scope vertex and multiplies
+/// one pose by the inverse of the other. This index instead finds the lowest
+/// common ancestor of the two frames with binary lifting, and only composes
+/// the edges on the path between them. A query costs O(log d), where d is
+/// the depth of the tree, and is more accurate when the frames are close to
+/// each other but far from the scope vertex.
+///
+/// The index holds a FrozenGraph of the scope, and has to be rebuilt when
+/// the graph changes. It uses O(n log d) memory for n vertices.
+class PoseLcaIndex
+{
+  /// \brief Dense index of a vertex, as in FrozenGraph.
+  public: using Index = FrozenGraph<PoseRelativeToGraph>::Index;
+
+  /// \brief Build the index of a scope.
+  /// \param[in] _graph Scope of the graph to index.
+  public: explicit PoseLcaIndex(const ScopedGraph<PoseRelativeToGraph> &_graph);
+
+  /// \brief Get the frozen graph the index was built from.
+  /// \return The frozen graph.
+  public: const FrozenGraph<PoseRelativeToGraph> &Graph() const;
+
+  /// \brief Get the lowest common ancestor of two vertices.
+  /// \param[in] _first Index of the first vertex.
+  /// \param[in] _second Index of the second vertex.
+  /// \return Index of the lowest common ancestor, or
+  /// FrozenGraph::kNullIndex if either vertex is not in the tree below the
+  /// scope vertex.
+  public: Index LowestCommonAncestor(Index _first, Index _second) const;
+
+  /// \brief Resolve the pose of a frame relative to another frame.
+  /// \param[out] _pose Pose object to write.
+  /// \param[in] _frameName Local name of frame whose pose is to be resolved.
+  /// \param[in] _resolveTo Local name of frame relative to which the pose is
+  /// to be resolved.
+  /// \return Errors, which match those of resolvePose.
+  public: Errors ResolvePose(ignition::math::Pose3d &_pose,
+              const std::string &_frameName,
+              const std::string &_resolveTo) const;
+
+  /// \brief Resolve the pose of a vertex relative to another vertex.
+  /// \param[out] _pose Pose object to write.
+  /// \param[in] _frameIndex Index of vertex whose pose is to be resolved.
+  /// \param[in] _resolveToIndex Index of vertex relative to which the pose
+  /// is to be resolved.
+  /// \return Errors, which match those of resolvePose.
+  public: Errors ResolvePose(ignition::math::Pose3d &_pose,
+              Index _frameIndex, Index _resolveToIndex) const;
+
+  /// \brief Pose of a vertex relative to one of its ancestors.
+  /// \param[in] _index Index of the vertex.
+  /// \param[in] _levels Number of edges between the vertex and the ancestor.
+  /// \return The pose.
+  private: ignition::math::Pose3d PoseToAncestor(
+               Index _index, std::size_t _levels) const;
+
+  /// \brief Frozen copy of the graph.
+  private: FrozenGraph<PoseRelativeToGraph> graph;
+
+  /// \brief Number of vertices.
+  private: std::size_t count = 0;
+
+  /// \brief Number of levels of the ancestor and jump tables.
+  private: std::size_t levels = 1;
+
+  /// \brief Depth of each vertex below the scope vertex, or kNullIndex if
+  /// the vertex is not in the tree.
+  private: std::vector<std::size_t> depths;
+
+  /// \brief ancestors[k * count + i] is the ancestor 2^k levels above vertex
+  /// i, or the scope vertex if the tree is not that deep.
+  private: std::vector<Index> ancestors;
+
+  /// \brief jumps[k * count + i] is the pose of vertex i relative to
+  /// ancestors[k * count + i].
+  private: std::vector<ignition::math::Pose3d> jumps;
+};
+}
+}
+#endif
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "FrameSemantics.hh"
+#include "PoseLcaIndex.hh"
+#include "ScopedGraph.hh"
+
+using Pose = ignition::math::Pose3d;
+
+/////////////////////////////////////////////////
+/// \brief Build a model graph whose frames form a binary tree below a link.
+/// \param[in] _frameCount Number of frames.
+/// \return Scope of the model graph.
+sdf::ScopedGraph<sdf::PoseRelativeToGraph> binaryTree(std::size_t _frameCount)
+{
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> graph(
+      std::make_shared<sdf::PoseRelativeToGraph>());
+  graph = graph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  const auto linkId = graph.AddVertex("L", sdf::FrameType::LINK).Id();
+  graph.AddEdge({graph.ScopeVertexId(), linkId}, Pose(1, 2, 3, 0, 0, 0));
+
+  std::vector<ignition::math::graph::VertexId> ids;
+  for (std::size_t i = 0; i < _frameCount; ++i)
+  {
+    ids.push_back(graph.AddVertex(
+          "F" + std::to_string(i), sdf::FrameType::FRAME).Id());
+    const auto parentId = i == 0 ? linkId : ids[(i - 1) / 2];
+    graph.AddEdge({parentId, ids.back()},
+        Pose(0.1 * (i % 3), 0.2, 0, 0, IGN_PI / 7, IGN_PI / (i % 5 + 3)));
+  }
+  return graph;
+}
+
+/////////////////////////////////////////////////
+TEST(PoseLcaIndex, LowestCommonAncestor)
+{
+  auto graph = binaryTree(10);
+  sdf::PoseLcaIndex index(graph);
+  const auto &frozen = index.Graph();
+  auto lca = [&](const std::string &_first, const std::string &_second)
+  {
+    const auto ancestor = index.LowestCommonAncestor(
+        frozen.IndexByName(_first), frozen.IndexByName(_second));
+    if (ancestor == sdf::FrozenGraph<sdf::PoseRelativeToGraph>::kNullIndex)
+      return std::string("null");
+    return frozen.LocalName(ancestor);
+  };
+
+  // Frame Fi has children F(2i+1) and F(2i+2).
+  EXPECT_EQ("F3", lca("F7", "F8"));
+  EXPECT_EQ("F1", lca("F7", "F4"));
+  EXPECT_EQ("F1", lca("F9", "F8"));
+  EXPECT_EQ("F0", lca("F7", "F5"));
+  EXPECT_EQ("F3", lca("F7", "F3"));
+  EXPECT_EQ("F3", lca("F3", "F7"));
+  EXPECT_EQ("F9", lca("F9", "F9"));
+  EXPECT_EQ("L", lca("L", "F9"));
+  EXPECT_EQ("__model__", lca("__model__", "F6"));
+  EXPECT_EQ("null", lca("F0", "missing"));
+}
+
+/////////////////////////////////////////////////
+TEST(PoseLcaIndex, ResolvePose)
+{
+  auto graph = binaryTree(40);
+  sdf::PoseLcaIndex index(graph);
+
+  const auto names = graph.VertexNames();
+  for (const auto &frame : names)
+  {
+    for (const auto &resolveTo : names)
+    {
+      Pose expected;
+      Pose pose;
+      EXPECT_TRUE(
+          sdf::resolvePose(expected, graph, frame, resolveTo).empty());
+      EXPECT_TRUE(index.ResolvePose(pose, frame, resolveTo).empty());
+      EXPECT_EQ(expected, pose) << frame << " " << resolveTo;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(PoseLcaIndex, Accuracy)
+{
+  // Two frames close to each other, at the end of a long chain of frames
+  // that rotate and move far away from the model frame.
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> graph(
+      std::make_shared<sdf::PoseRelativeToGraph>());
+  graph = graph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  auto parentId = graph.ScopeVertexId();
+  for (int i = 0; i < 200; ++i)
+  {
+    const auto id = graph.AddVertex(
+        "C" + std::to_string(i), sdf::FrameType::FRAME).Id();
+    graph.AddEdge({parentId, id}, Pose(1e4, 0, 0, 0.1, 0.2, 0.3));
+    parentId = id;
+  }
+  const auto aId = graph.AddVertex("A", sdf::FrameType::FRAME).Id();
+  const auto bId = graph.AddVertex("B", sdf::FrameType::FRAME).Id();
+  graph.AddEdge({parentId, aId}, Pose(1e-3, 0, 0, 0, 0, 0));
+  graph.AddEdge({parentId, bId}, Pose(0, 1e-3, 0, 0, 0, 0));
+
+  sdf::PoseLcaIndex index(graph);
+  Pose pose;
+  EXPECT_TRUE(index.ResolvePose(pose, "A", "B").empty());
+  EXPECT_DOUBLE_EQ(1e-3, pose.Pos().X());
+  EXPECT_DOUBLE_EQ(-1e-3, pose.Pos().Y());
+  EXPECT_DOUBLE_EQ(0.0, pose.Pos().Z());
+
+  // Resolving to the model frame first loses most of the precision.
+  Pose rootPose;
+  EXPECT_TRUE(sdf::resolvePose(rootPose, graph, "A", "B").empty());
+  EXPECT_GT(std::abs(rootPose.Pos().X() - 1e-3),
+      std::abs(pose.Pos().X() - 1e-3));
+}
+
+/////////////////////////////////////////////////
+TEST(PoseLcaIndex, Errors)
+{
+  auto graph = binaryTree(3);
+  const auto f0Id = graph.VertexIdByName("F0");
+  const auto f1Id = graph.VertexIdByName("F1");
+  const auto xId = graph.AddVertex("X", sdf::FrameType::FRAME).Id();
+  const auto yId = graph.AddVertex("Y", sdf::FrameType::FRAME).Id();
+  graph.AddEdge({f0Id, yId}, Pose::Zero);
+  graph.AddEdge({f1Id, yId}, Pose::Zero);
+
+  sdf::PoseLcaIndex index(graph);
+  const auto &frozen = index.Graph();
+  EXPECT_EQ(sdf::FrozenGraph<sdf::PoseRelativeToGraph>::kNullIndex,
+      index.LowestCommonAncestor(frozen.IndexOf(xId), frozen.IndexOf(f0Id)));
+
+  // X is disconnected and Y has two incoming edges.
+  for (const std::string name : {"X", "Y", "missing"})
+  {
+    Pose pose;
+    auto expected = sdf::resolvePose(pose, graph, name, "F1");
+    auto errors = index.ResolvePose(pose, name, "F1");
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected.size(), errors.size()) << name;
+    for (std::size_t i = 0; i < errors.size(); ++i)
+    {
+      EXPECT_EQ(expected[i].Code(), errors[i].Code());
+      EXPECT_EQ(expected[i].Message(), errors[i].Message());
+    }
+
+    errors = index.ResolvePose(
+        pose, frozen.IndexByName(name), frozen.IndexByName("F1"));
+    EXPECT_FALSE(errors.empty());
+  }
+}
@@ -14,19 +14,30 @@
  * limitations under the License.
  *
 */
+#include <set>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include <utility>
 
 #include "sdf/Actor.hh"
+#include "sdf/Collision.hh"
+#include "sdf/Frame.hh"
+#include "sdf/Joint.hh"
 #include "sdf/Light.hh"
+#include "sdf/Link.hh"
 #include "sdf/Model.hh"
 #include "sdf/Root.hh"
+#include "sdf/Sensor.hh"
 #include "sdf/Types.hh"
+#include "sdf/Visual.hh"
 #include "sdf/World.hh"
+#include "sdf/WorldState.hh"
 #include "sdf/parser.hh"
 #include "sdf/sdf_config.h"
 #include "FrameSemantics.hh"
+#include "GraphExport.hh"
+#include "NameIndex.hh"
 #include "ScopedGraph.hh"
 #include "Utils.hh"
 
@@ -38,6 +49,12 @@ class sdf::RootPrivate
   /// \brief Version string
   public: std::string version = "";
 
+  /// \brief Maximum number of threads used to load the DOM objects.
+  public: unsigned int loadThreads = 1;
+
+  /// \brief True if the worlds share prototypes between identical models.
+  public: bool modelInstancing = false;
+
   /// \brief The worlds specified under the root SDF element
   public: std::vector<World> worlds;
 
@@ -50,6 +67,18 @@ class sdf::RootPrivate
   /// \brief The actors specified under the root SDF element
   public: std::vector<Actor> actors;
 
+  /// \brief Positions of the worlds by name.
+  public: NameIndex worldIndex;
+
+  /// \brief Positions of the models by name.
+  public: NameIndex modelIndex;
+
+  /// \brief Positions of the lights by name.
+  public: NameIndex lightIndex;
+
+  /// \brief Positions of the actors by name.
+  public: NameIndex actorIndex;
+
   /// \brief Frame Attached-To Graphs constructed when loading Worlds.
   public: std::vector<sdf::ScopedGraph<FrameAttachedToGraph>>
               worldFrameAttachedToGraphs;
@@ -74,7 +103,7 @@ class sdf::RootPrivate
 template <typename T>
 sdf::ScopedGraph<FrameAttachedToGraph> addFrameAttachedToGraph(
     std::vector<sdf::ScopedGraph<sdf::FrameAttachedToGraph>> &_graphList,
-    const T &_domObj, sdf::Errors &_errors)
+    const T &_domObj, sdf::Errors &_errors, unsigned int _threads)
 {
   auto &frameGraph =
       _graphList.emplace_back(std::make_shared<FrameAttachedToGraph>());
@@ -83,7 +112,8 @@ sdf::ScopedGraph<FrameAttachedToGraph> addFrameAttachedToGraph(
       sdf::buildFrameAttachedToGraph(frameGraph, &_domObj);
   _errors.insert(_errors.end(), buildErrors.begin(), buildErrors.end());
 
-  sdf::Errors validateErrors = sdf::validateFrameAttachedToGraph(frameGraph);
+  sdf::Errors validateErrors =
+      sdf::validateFrameAttachedToGraph(frameGraph, _threads);
   _errors.insert(_errors.end(), validateErrors.begin(), validateErrors.end());
 
   return frameGraph;
@@ -93,7 +123,7 @@ sdf::ScopedGraph<FrameAttachedToGraph> addFrameAttachedToGraph(
 template <typename T>
 ScopedGraph<PoseRelativeToGraph> addPoseRelativeToGraph(
     std::vector<sdf::ScopedGraph<sdf::PoseRelativeToGraph>> &_graphList,
-    const T &_domObj, Errors &_errors)
+    const T &_domObj, Errors &_errors, unsigned int _threads)
 {
   auto &poseGraph =
       _graphList.emplace_back(std::make_shared<sdf::PoseRelativeToGraph>());
@@ -101,12 +131,93 @@ ScopedGraph<PoseRelativeToGraph> addPoseRelativeToGraph(
   Errors buildErrors = buildPoseRelativeToGraph(poseGraph, &_domObj);
   _errors.insert(_errors.end(), buildErrors.begin(), buildErrors.end());
 
-  Errors validateErrors = validatePoseRelativeToGraph(poseGraph);
+  Errors validateErrors = validatePoseRelativeToGraph(poseGraph, _threads);
   _errors.insert(_errors.end(), validateErrors.begin(), validateErrors.end());
 
   return poseGraph;
 }
 
+/////////////////////////////////////////////////
+/// \brief Estimate the bytes of a model and of its nested models, counting
+/// each DOM object by its own size. The contents of a model instance are
+/// counted with its prototype, once per prototype.
+/// \param[in] _model Model to measure.
+/// \param[in,out] _prototypes Prototypes counted so far.
+/// \return Bytes of the DOM objects.
+static std::size_t modelDomBytes(const Model *_model,
+    std::unordered_set<const Model *> &_prototypes)
+{
+  std::size_t bytes = 0;
+  std::vector<const Model *> pending = {_model};
+  while (!pending.empty())
+  {
+    const Model *model = pending.back();
+    pending.pop_back();
+
+    if (model->IsInstance())
+    {
+      bytes += sizeof(Model);
+      model = model->Prototype().get();
+      if (!_prototypes.insert(model).second)
+        continue;
+    }
+
+    bytes += sizeof(Model) + model->JointCount() * sizeof(Joint) +
+        model->FrameCount() * sizeof(Frame);
+    for (uint64_t i = 0; i < model->LinkCount(); ++i)
+    {
+      const Link *link = model->LinkByIndex(i);
+      bytes += sizeof(Link) + link->VisualCount() * sizeof(Visual) +
+          link->CollisionCount() * sizeof(Collision) +
+          link->LightCount() * sizeof(Light) +
+          link->SensorCount() * sizeof(Sensor);
+    }
+    for (uint64_t i = 0; i < model->ModelCount(); ++i)
+      pending.push_back(model->ModelByIndex(i));
+  }
+  return bytes;
+}
+
+/////////////////////////////////////////////////
+/// \brief Estimate the bytes of a frame graph: its vertices, edges,
+/// adjacency lists and name map.
+/// \param[in] _graph Graph to measure.
+/// \return Bytes of the graph.
+template <typename T>
+static std::size_t graphBytes(const ScopedGraph<T> &_graph)
+{
+  using VertexType = typename ScopedGraph<T>::Vertex;
+  using EdgeType = typename ScopedGraph<T>::Edge;
+
+  // Size of the links of a node of a std::map or std::set.
+  const std::size_t treeNode = 4 * sizeof(void *);
+
+  std::size_t bytes = sizeof(T);
+  for (const auto &vertex : _graph.Graph().Vertices())
+  {
+    bytes += treeNode + sizeof(vertex.first) + sizeof(VertexType) +
+        MemoryBreakdown::StringHeapBytes(vertex.second.get().Name());
+  }
+  const std::size_t edgeCount = _graph.Graph().Edges().size();
+  bytes += edgeCount * (treeNode + sizeof(ignition::math::graph::EdgeId) +
+      sizeof(EdgeType));
+
+  // Adjacency lists, with one entry per vertex and per edge.
+  bytes += _graph.Graph().Vertices().size() *
+      (treeNode + sizeof(ignition::math::graph::VertexId) +
+      sizeof(std::set<ignition::math::graph::EdgeId>));
+  bytes += edgeCount * (treeNode + sizeof(ignition::math::graph::EdgeId));
+
+  // The name map is a hash map, whose entries have a node link, a cached
+  // hash and a bucket pointer.
+  for (const auto &entry : _graph.Map())
+  {
+    bytes += 2 * sizeof(void *) + sizeof(std::size_t) + sizeof(entry) +
+        MemoryBreakdown::StringHeapBytes(entry.first.Name());
+  }
+  return bytes;
+}
+
 /////////////////////////////////////////////////
 Root::Root()
   : dataPtr(new RootPrivate)
@@ -217,23 +328,28 @@ Errors Root::Load(SDFPtr _sdf)
     while (elem)
     {
       World world;
+      world.SetLoadThreads(this->dataPtr->loadThreads);
+      world.SetModelInstancing(this->dataPtr->modelInstancing);
 
       Errors worldErrors = world.Load(elem);
 
-      // Build the graphs.
+      // Build the graphs. The graphs of the models of the world are built
+      // in parallel.
       auto frameAttachedToGraph = addFrameAttachedToGraph(
-          this->dataPtr->worldFrameAttachedToGraphs, world, worldErrors);
+          this->dataPtr->worldFrameAttachedToGraphs, world, worldErrors,
+          this->dataPtr->loadThreads);
       world.SetFrameAttachedToGraph(frameAttachedToGraph);
 
       auto poseRelativeToGraph = addPoseRelativeToGraph(
-          this->dataPtr->worldPoseRelativeToGraphs, world, worldErrors);
+          this->dataPtr->worldPoseRelativeToGraphs, world, worldErrors,
+          this->dataPtr->loadThreads);
       world.SetPoseRelativeToGraph(poseRelativeToGraph);
 
       // Attempt to load the world
       if (worldErrors.empty())
       {
         // Check that the world's name does not exist.
-        if (this->WorldNameExists(world.Name()))
+        if (this->dataPtr->worldIndex.Find(world.Name()) != NameIndex::npos)
         {
           errors.push_back({ErrorCode::DUPLICATE_NAME,
                 "World with name[" + world.Name() + "] already exists."
@@ -248,6 +364,7 @@ Errors Root::Load(SDFPtr _sdf)
                           "Failed to load a world."});
       }
 
+      this->dataPtr->worldIndex.Add(world.Name());
       this->dataPtr->worlds.push_back(std::move(world));
       elem = elem->GetNextElement("world");
     }
@@ -255,35 +372,65 @@ Errors Root::Load(SDFPtr _sdf)
 
   // Load all the models.
   Errors modelLoadErrors = loadUniqueRepeated<Model>(
-      this->dataPtr->sdf, "model", this->dataPtr->models);
+      this->dataPtr->sdf, "model", this->dataPtr->models,
+      this->dataPtr->loadThreads);
   errors.insert(errors.end(), modelLoadErrors.begin(), modelLoadErrors.end());
+  this->dataPtr->modelIndex.Build(this->dataPtr->models);
 
   // Build the graphs.
   for (sdf::Model &model : this->dataPtr->models)
   {
     auto frameAttachedToGraph = addFrameAttachedToGraph(
-        this->dataPtr->modelFrameAttachedToGraphs, model, errors);
+        this->dataPtr->modelFrameAttachedToGraphs, model, errors,
+        this->dataPtr->loadThreads);
 
     model.SetFrameAttachedToGraph(frameAttachedToGraph);
 
     auto poseRelativeToGraph = addPoseRelativeToGraph(
-        this->dataPtr->modelPoseRelativeToGraphs, model, errors);
+        this->dataPtr->modelPoseRelativeToGraphs, model, errors,
+        this->dataPtr->loadThreads);
     model.SetPoseRelativeToGraph(poseRelativeToGraph);
   }
 
   // Load all the lights.
   Errors lightLoadErrors = loadUniqueRepeated<Light>(this->dataPtr->sdf,
-      "light", this->dataPtr->lights);
+      "light", this->dataPtr->lights, this->dataPtr->loadThreads);
   errors.insert(errors.end(), lightLoadErrors.begin(), lightLoadErrors.end());
+  this->dataPtr->lightIndex.Build(this->dataPtr->lights);
 
   // Load all the actors.
   Errors actorLoadErrors = loadUniqueRepeated<Actor>(this->dataPtr->sdf,
-      "actor", this->dataPtr->actors);
+      "actor", this->dataPtr->actors, this->dataPtr->loadThreads);
   errors.insert(errors.end(), actorLoadErrors.begin(), actorLoadErrors.end());
+  this->dataPtr->actorIndex.Build(this->dataPtr->actors);
 
   return errors;
 }
 
+/////////////////////////////////////////////////
+void Root::SetLoadThreads(unsigned int _threads)
+{
+  this->dataPtr->loadThreads = _threads;
+}
+
+/////////////////////////////////////////////////
+unsigned int Root::LoadThreads() const
+{
+  return this->dataPtr->loadThreads;
+}
+
+/////////////////////////////////////////////////
+void Root::SetModelInstancing(bool _instancing)
+{
+  this->dataPtr->modelInstancing = _instancing;
+}
+
+/////////////////////////////////////////////////
+bool Root::ModelInstancing() const
+{
+  return this->dataPtr->modelInstancing;
+}
+
 /////////////////////////////////////////////////
 std::string Root::Version() const
 {
@@ -311,16 +458,34 @@ const World *Root::WorldByIndex(const uint64_t _index) const
 }
 
 /////////////////////////////////////////////////
-bool Root::WorldNameExists(const std::string &_name) const
+Errors Root::ApplyState(const WorldState &_state)
 {
-  for (auto const &w : this->dataPtr->worlds)
+  std::size_t index = NameIndex::npos;
+  if (!_state.WorldName().empty())
   {
-    if (w.Name() == _name)
-    {
-      return true;
-    }
+    index = this->dataPtr->worldIndex.Find(_state.WorldName());
   }
-  return false;
+  else if (this->dataPtr->worlds.size() == 1)
+  {
+    index = 0;
+  }
+
+  if (index == NameIndex::npos)
+  {
+    return {{ErrorCode::ELEMENT_INVALID,
+        "State of world with name [" + _state.WorldName() +
+        "] does not match a world of the root."}};
+  }
+
+  // World::ApplyState neither renames the world nor replaces its graphs,
+  // so the world index and the graphs of the root stay valid.
+  return this->dataPtr->worlds[index].ApplyState(_state);
+}
+
+/////////////////////////////////////////////////
+bool Root::WorldNameExists(const std::string &_name) const
+{
+  return this->dataPtr->worldIndex.Find(_name) != NameIndex::npos;
 }
 
 /////////////////////////////////////////////////
@@ -340,14 +505,7 @@ const Model *Root::ModelByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::ModelNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
-  {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->modelIndex.Find(_name) != NameIndex::npos;
 }
 
 /////////////////////////////////////////////////
@@ -367,14 +525,7 @@ const Light *Root::LightByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::LightNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->lights)
-  {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->lightIndex.Find(_name) != NameIndex::npos;
 }
 
 /////////////////////////////////////////////////
@@ -394,18 +545,102 @@ const Actor *Root::ActorByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool Root::ActorNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->actors)
+  return this->dataPtr->actorIndex.Find(_name) != NameIndex::npos;
+}
+
+/////////////////////////////////////////////////
+sdf::ElementPtr Root::Element() const
+{
+  return this->dataPtr->sdf;
+}
+
+/////////////////////////////////////////////////
+MemoryBreakdown Root::MemoryUsage() const
+{
+  MemoryBreakdown usage;
+  if (this->dataPtr->sdf)
+    usage = this->dataPtr->sdf->MemoryUsage();
+
+  usage.domBytes += sizeof(Root) + sizeof(RootPrivate) +
+      MemoryBreakdown::StringHeapBytes(this->dataPtr->version) +
+      this->dataPtr->worlds.capacity() * sizeof(World) +
+      this->dataPtr->models.capacity() * sizeof(Model) +
+      this->dataPtr->lights.capacity() * sizeof(Light) +
+      this->dataPtr->actors.capacity() * sizeof(Actor);
+
+  // The objects of the vectors above are already counted.
+  std::unordered_set<const Model *> prototypes;
+  for (const World &world : this->dataPtr->worlds)
+  {
+    usage.domBytes += world.ActorCount() * sizeof(Actor) +
+        world.LightCount() * sizeof(Light) +
+        world.FrameCount() * sizeof(Frame);
+    for (uint64_t i = 0; i < world.ModelCount(); ++i)
+      usage.domBytes += modelDomBytes(world.ModelByIndex(i), prototypes);
+  }
+  for (const Model &model : this->dataPtr->models)
+    usage.domBytes += modelDomBytes(&model, prototypes) - sizeof(Model);
+
+  // Nested scopes share the graph of their world or model, so each graph is
+  // counted once.
+  std::unordered_set<const void *> graphs;
+  auto addGraphs = [&](const auto &_graphs)
   {
-    if (m.Name() == _name)
+    for (const auto &graph : _graphs)
     {
-      return true;
+      usage.domBytes += sizeof(graph);
+      if (graph && graphs.insert(&graph.Graph()).second)
+        usage.domBytes += graphBytes(graph);
     }
-  }
-  return false;
+  };
+  addGraphs(this->dataPtr->worldFrameAttachedToGraphs);
+  addGraphs(this->dataPtr->modelFrameAttachedToGraphs);
+  addGraphs(this->dataPtr->worldPoseRelativeToGraphs);
+  addGraphs(this->dataPtr->modelPoseRelativeToGraphs);
+
+  return usage;
 }
 
 /////////////////////////////////////////////////
-sdf::ElementPtr Root::Element() const
+/// \brief Find the graph of a world or of a model of a root.
+/// \param[in] _data Data of the root.
+/// \param[in] _worldGraphs Graphs of the worlds of the root.
+/// \param[in] _modelGraphs Graphs of the models of the root.
+/// \param[in] _name Name of the world or model, or empty for the first
+/// world, or the first model when there is no world.
+/// \return The graph, which is false when it is not found.
+template <typename T>
+static ScopedGraph<T> findRootGraph(const RootPrivate &_data,
+    const std::vector<ScopedGraph<T>> &_worldGraphs,
+    const std::vector<ScopedGraph<T>> &_modelGraphs,
+    const std::string &_name)
 {
-  return this->dataPtr->sdf;
+  // The graphs are built in the order of the worlds and of the models.
+  std::size_t index = _name.empty() ? 0 : _data.worldIndex.Find(_name);
+  if (index < _worldGraphs.size())
+    return _worldGraphs[index];
+
+  index = _name.empty() ? 0 : _data.modelIndex.Find(_name);
+  if (index < _modelGraphs.size())
+    return _modelGraphs[index];
+
+  return ScopedGraph<T>();
+}
+
+/////////////////////////////////////////////////
+ScopedGraph<PoseRelativeToGraph> RootGraphs::PoseRelativeTo(
+    const Root &_root, const std::string &_name)
+{
+  return findRootGraph(*_root.dataPtr,
+      _root.dataPtr->worldPoseRelativeToGraphs,
+      _root.dataPtr->modelPoseRelativeToGraphs, _name);
+}
+
+/////////////////////////////////////////////////
+ScopedGraph<FrameAttachedToGraph> RootGraphs::FrameAttachedTo(
+    const Root &_root, const std::string &_name)
+{
+  return findRootGraph(*_root.dataPtr,
+      _root.dataPtr->worldFrameAttachedToGraphs,
+      _root.dataPtr->modelFrameAttachedToGraphs, _name);
 }
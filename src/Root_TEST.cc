@@ -155,6 +155,43 @@ TEST(DOMRoot, StringParse)
   EXPECT_NE(nullptr, actor->Element());
 }
 
+/////////////////////////////////////////////////
+TEST(DOMRoot, MemoryUsage)
+{
+  sdf::Root root;
+  sdf::MemoryBreakdown empty = root.MemoryUsage();
+  EXPECT_EQ(0u, empty.elementCount);
+  EXPECT_GT(empty.domBytes, 0u);
+
+  std::string sdf = "<?xml version=\"1.0\"?>"
+    " <sdf version=\"1.8\">"
+    "   <model name='shapes'>"
+    "     <link name='link'>"
+    "       <visual name='visual'>"
+    "         <geometry>"
+    "           <box>"
+    "             <size>3 4 5</size>"
+    "           </box>"
+    "         </geometry>"
+    "       </visual>"
+    "     </link>"
+    "   </model>"
+    " </sdf>";
+  EXPECT_TRUE(root.LoadSdfString(sdf).empty());
+
+  sdf::MemoryBreakdown usage = root.MemoryUsage();
+  sdf::MemoryBreakdown elementUsage = root.Element()->MemoryUsage();
+  EXPECT_EQ(elementUsage.elementCount, usage.elementCount);
+  EXPECT_EQ(elementUsage.paramCount, usage.paramCount);
+  EXPECT_EQ(elementUsage.stringBytes, usage.stringBytes);
+  EXPECT_EQ(elementUsage.descriptionBytes, usage.descriptionBytes);
+
+  // The DOM objects and the frame graphs are counted on top of the
+  // elements.
+  EXPECT_GT(usage.domBytes, elementUsage.domBytes + empty.domBytes);
+  EXPECT_GT(usage.descriptionBytes, usage.stringBytes);
+}
+
 /////////////////////////////////////////////////
 TEST(DOMRoot, Set)
 {
@@ -162,6 +199,194 @@ TEST(DOMRoot, Set)
   EXPECT_STREQ("", root.Version().c_str());
   root.SetVersion(SDF_PROTOCOL_VERSION);
   EXPECT_STREQ(SDF_PROTOCOL_VERSION, root.Version().c_str());
+
+  EXPECT_FALSE(root.ModelInstancing());
+  root.SetModelInstancing(true);
+  EXPECT_TRUE(root.ModelInstancing());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMRoot, ParallelLoad)
+{
+  std::string sdf = "<?xml version=\"1.0\"?>"
+    " <sdf version=\"1.8\">"
+    "   <world name='default'>";
+  for (int i = 0; i < 16; ++i)
+  {
+    sdf += "<model name='model" + std::to_string(i) + "'>"
+      "  <link name='link'/>"
+      "</model>";
+  }
+  sdf +=
+    "     <model name='model3'>"
+    "       <link name='link'/>"
+    "     </model>"
+    "     <model name='no_links'/>"
+    "     <light type='point' name='lamp'/>"
+    "   </world>"
+    "   <model name='top'>"
+    "     <link name='link'/>"
+    "   </model>"
+    " </sdf>";
+
+  sdf::Root serial;
+  EXPECT_EQ(1u, serial.LoadThreads());
+  sdf::Errors serialErrors = serial.LoadSdfString(sdf);
+
+  sdf::Root parallel;
+  parallel.SetLoadThreads(4);
+  EXPECT_EQ(4u, parallel.LoadThreads());
+  sdf::Errors parallelErrors = parallel.LoadSdfString(sdf);
+
+  // The duplicate model and the model without links are reported in the
+  // same order.
+  ASSERT_FALSE(serialErrors.empty());
+  ASSERT_EQ(serialErrors.size(), parallelErrors.size());
+  for (std::size_t i = 0; i < serialErrors.size(); ++i)
+  {
+    EXPECT_EQ(serialErrors[i].Code(), parallelErrors[i].Code());
+    EXPECT_EQ(serialErrors[i].Message(), parallelErrors[i].Message());
+  }
+
+  ASSERT_EQ(1u, parallel.WorldCount());
+  const sdf::World *serialWorld = serial.WorldByIndex(0);
+  const sdf::World *parallelWorld = parallel.WorldByIndex(0);
+  ASSERT_NE(nullptr, parallelWorld);
+  EXPECT_EQ(4u, parallelWorld->LoadThreads());
+  ASSERT_EQ(serialWorld->ModelCount(), parallelWorld->ModelCount());
+  EXPECT_EQ(17u, parallelWorld->ModelCount());
+  for (uint64_t i = 0; i < parallelWorld->ModelCount(); ++i)
+  {
+    EXPECT_EQ(serialWorld->ModelByIndex(i)->Name(),
+              parallelWorld->ModelByIndex(i)->Name());
+  }
+  EXPECT_EQ(1u, parallelWorld->LightCount());
+  EXPECT_EQ(1u, parallel.ModelCount());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMRoot, ParallelLoadWarnings)
+{
+  // Every model writes a warning about its non-unique child names while the
+  // models are loaded on different threads.
+  std::string sdf = "<?xml version=\"1.0\"?>"
+    " <sdf version=\"1.8\">"
+    "   <world name='default'>";
+  for (int i = 0; i < 16; ++i)
+  {
+    sdf += "<model name='model" + std::to_string(i) + "'>"
+      "  <link name='link'/>"
+      "  <link name='link'/>"
+      "</model>";
+  }
+  sdf +=
+    "   </world>"
+    " </sdf>";
+
+  sdf::Root serial;
+  sdf::Errors serialErrors = serial.LoadSdfString(sdf);
+
+  sdf::Root parallel;
+  parallel.SetLoadThreads(4);
+  sdf::Errors parallelErrors = parallel.LoadSdfString(sdf);
+
+  ASSERT_FALSE(serialErrors.empty());
+  ASSERT_EQ(serialErrors.size(), parallelErrors.size());
+  for (std::size_t i = 0; i < serialErrors.size(); ++i)
+  {
+    EXPECT_EQ(serialErrors[i].Code(), parallelErrors[i].Code());
+    EXPECT_EQ(serialErrors[i].Message(), parallelErrors[i].Message());
+  }
+
+  ASSERT_EQ(1u, parallel.WorldCount());
+  EXPECT_EQ(serial.WorldByIndex(0)->ModelCount(),
+            parallel.WorldByIndex(0)->ModelCount());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMRoot, ParallelFrameGraphs)
+{
+  std::string sdf = "<?xml version=\"1.0\"?>"
+    " <sdf version=\"1.8\">"
+    "   <world name='default'>";
+  for (int i = 0; i < 16; ++i)
+  {
+    const std::string relativeTo = i == 5 ? "missing" : "nested::nested_link";
+    sdf += "<model name='model" + std::to_string(i) + "'>"
+      "  <pose>" + std::to_string(i) + " 0 0 0 0 0.1</pose>"
+      "  <link name='link'><pose>0 0 1 0 0 0</pose></link>"
+      "  <frame name='frame'><pose relative_to='link'>0 1 0 0 0 0</pose>"
+      "  </frame>"
+      "  <model name='nested'>"
+      "    <pose>0 0 2 0 0 0</pose>"
+      "    <link name='nested_link'/>"
+      "  </model>"
+      "  <link name='other_link'>"
+      "    <pose relative_to='" + relativeTo + "'>1 0 0 0 0 0</pose>"
+      "  </link>"
+      "</model>";
+  }
+  sdf +=
+    "     <frame name='world_frame'>"
+    "       <pose relative_to='model4::link'>0 0 2 0 0 0</pose>"
+    "     </frame>"
+    "   </world>"
+    " </sdf>";
+
+  sdf::Root serial;
+  sdf::Errors serialErrors = serial.LoadSdfString(sdf);
+
+  sdf::Root parallel;
+  parallel.SetLoadThreads(4);
+  sdf::Errors parallelErrors = parallel.LoadSdfString(sdf);
+
+  // The invalid relative_to of model5 is reported in the same order.
+  ASSERT_FALSE(serialErrors.empty());
+  ASSERT_EQ(serialErrors.size(), parallelErrors.size());
+  for (std::size_t i = 0; i < serialErrors.size(); ++i)
+  {
+    EXPECT_EQ(serialErrors[i].Code(), parallelErrors[i].Code());
+    EXPECT_EQ(serialErrors[i].Message(), parallelErrors[i].Message());
+  }
+
+  // Every pose resolves the same way.
+  const sdf::World *serialWorld = serial.WorldByIndex(0);
+  const sdf::World *parallelWorld = parallel.WorldByIndex(0);
+  ASSERT_NE(nullptr, serialWorld);
+  ASSERT_NE(nullptr, parallelWorld);
+  ASSERT_EQ(16u, parallelWorld->ModelCount());
+  auto expectSamePose = [](const sdf::SemanticPose &_serialPose,
+                           const sdf::SemanticPose &_parallelPose)
+  {
+    ignition::math::Pose3d serialPose;
+    ignition::math::Pose3d parallelPose;
+    const auto serialPoseErrors = _serialPose.Resolve(serialPose, "world");
+    const auto parallelPoseErrors =
+        _parallelPose.Resolve(parallelPose, "world");
+    EXPECT_EQ(serialPoseErrors.size(), parallelPoseErrors.size());
+    EXPECT_EQ(serialPose, parallelPose);
+  };
+  for (uint64_t m = 0; m < parallelWorld->ModelCount(); ++m)
+  {
+    const sdf::Model *serialModel = serialWorld->ModelByIndex(m);
+    const sdf::Model *parallelModel = parallelWorld->ModelByIndex(m);
+    expectSamePose(serialModel->SemanticPose(), parallelModel->SemanticPose());
+    ASSERT_EQ(serialModel->LinkCount(), parallelModel->LinkCount());
+    for (uint64_t l = 0; l < parallelModel->LinkCount(); ++l)
+    {
+      expectSamePose(serialModel->LinkByIndex(l)->SemanticPose(),
+                     parallelModel->LinkByIndex(l)->SemanticPose());
+    }
+    expectSamePose(serialModel->FrameByIndex(0)->SemanticPose(),
+                   parallelModel->FrameByIndex(0)->SemanticPose());
+  }
+  expectSamePose(serialWorld->FrameByIndex(0)->SemanticPose(),
+                 parallelWorld->FrameByIndex(0)->SemanticPose());
+
+  std::string body;
+  EXPECT_TRUE(parallelWorld->FrameByIndex(0)->ResolveAttachedToBody(
+      body).empty());
+  EXPECT_EQ("world", body);
 }
 
 /////////////////////////////////////////////////
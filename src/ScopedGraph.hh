@@ -19,8 +19,10 @@
 #define SDF_SCOPED_GRAPH_HH
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -114,6 +116,7 @@ class ScopedGraph
   public: using Vertex = ignition::math::graph::Vertex<VertexType>;
   public: using Edge = ignition::math::graph::DirectedEdge<EdgeType>;
   public: using MapType = typename T::MapType;
+  public: using NameType = typename MapType::key_type;
 
   /// \brief Default constructor. The constructed object is invalid as it
   /// doesn't point to any graph.
@@ -150,6 +153,14 @@ class ScopedGraph
   /// FrameAttachedTo::map.
   public: const MapType &Map() const;
 
+  /// \brief Mutable reference to the cache of resolved poses of the
+  /// underlying PoseRelativeToGraph. The cache is shared by all the scopes of
+  /// the graph. Adding, updating or removing an edge erases the poses of the
+  /// vertices below the edge.
+  /// \remark Only available when T is PoseRelativeToGraph.
+  /// \return Reference to PoseRelativeToGraph::cache.
+  public: auto &PoseCache() const;
+
   /// \brief Adds a scope vertex to the graph. This creates a new
   /// scope by making a copy of the current scope with a new prefix and scope
   /// type name. A new scope vertex is then added to the graph.
@@ -178,6 +189,28 @@ class ScopedGraph
   public: Edge &AddEdge(const ignition::math::graph::VertexId_P &_vertexPair,
               const EdgeType &_data);
 
+  /// \brief Adds copies of all the vertices and edges of another graph to
+  /// the graph, in the order of their ids. The prefix of the current scope is
+  /// prepended to the names of the copied vertices. A graph built on its own
+  /// and then added this way ends up with the same vertices and edges as if
+  /// it had been built in place. The copies get new ids, which are not
+  /// guaranteed to match those of a build in place, for example when edges
+  /// were replaced while building.
+  /// \param[in] _graph Scope of the graph to copy. Only the underlying graph
+  /// is used.
+  public: void AddGraph(const ScopedGraph<T> &_graph);
+
+  /// \brief Removes a vertex and all its incoming and outgoing edges from the
+  /// graph.
+  /// \param[in] _name The local name of the vertex.
+  /// \return True if the vertex was found and removed.
+  public: bool RemoveVertex(const std::string &_name);
+
+  /// \brief Removes an edge from the graph.
+  /// \param[in] _edge The edge to remove.
+  /// \return True if the edge was found and removed.
+  public: bool RemoveEdge(const Edge &_edge);
+
   /// \brief Gets all the local names of the vertices in the current scope.
   /// \return A list of vertex names in the current scope.
   public: std::vector<std::string> VertexNames() const;
@@ -247,6 +280,12 @@ class ScopedGraph
   public: std::pair<std::string, bool> FindAndRemovePrefix(
               const std::string &_name) const;
 
+  /// \brief Erase the cached poses of a vertex and of all the vertices below
+  /// it, if the graph caches poses. Must be called whenever an edge that
+  /// points to the vertex changes.
+  /// \param[in] _vertexId Id of the head vertex of the edge that changed.
+  private: void InvalidateCaches(VertexId _vertexId);
+
   /// \brief Shared pointer to either a FrameAttachedToGraph or
   /// PoseRelativeToGraph.
   private: std::shared_ptr<T> graphPtr;
@@ -298,6 +337,56 @@ auto ScopedGraph<T>::Map() const -> const MapType &
   return this->graphPtr->map;
 }
 
+/////////////////////////////////////////////////
+template <typename T>
+auto &ScopedGraph<T>::PoseCache() const
+{
+  static_assert(std::is_same_v<T, sdf::PoseRelativeToGraph>,
+      "Only a PoseRelativeToGraph has a pose cache");
+  return this->graphPtr->cache;
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+void ScopedGraph<T>::InvalidateCaches(VertexId _vertexId)
+{
+  if constexpr (std::is_same_v<T, sdf::PoseRelativeToGraph>)
+  {
+    auto &cache = this->graphPtr->cache;
+    if (cache.Size() == 0)
+    {
+      return;
+    }
+
+    // The poses of the vertex and of its descendants were composed from the
+    // edge that changed. Vertices of cycles are only visited once: a vertex
+    // was visited by this call when its stamp is the stamp of the call.
+    const std::size_t stamp = ++this->graphPtr->invalidateStamp;
+    auto &visited = this->graphPtr->invalidateVisited;
+    auto &stack = this->graphPtr->invalidateStack;
+    stack.assign(1, _vertexId);
+    while (!stack.empty())
+    {
+      const VertexId id = stack.back();
+      stack.pop_back();
+      if (id >= visited.size())
+      {
+        visited.resize(id + 1, 0);
+      }
+      if (visited[id] == stamp)
+      {
+        continue;
+      }
+      visited[id] = stamp;
+      cache.Erase(id);
+      for (const auto &edgePair : this->graphPtr->graph.IncidentsFrom(id))
+      {
+        stack.push_back(edgePair.second.get().Head());
+      }
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 template <typename T>
 ScopedGraph<T> ScopedGraph<T>::AddScopeVertex(const std::string &_prefix,
@@ -320,7 +409,7 @@ auto ScopedGraph<T>::AddVertex(
 {
   const std::string newName = this->AddPrefix(_name);
   Vertex &vert = this->graphPtr->graph.AddVertex(newName, _data);
-  this->graphPtr->map[newName] = vert.Id();
+  this->graphPtr->map[NameType(newName)] = vert.Id();
   return vert;
 }
 
@@ -331,9 +420,56 @@ auto ScopedGraph<T>::AddEdge(
     -> Edge &
 {
   Edge &edge = this->graphPtr->graph.AddEdge(_vertexPair, _data);
+  this->InvalidateCaches(edge.Head());
   return edge;
 }
 
+/////////////////////////////////////////////////
+template <typename T>
+void ScopedGraph<T>::AddGraph(const ScopedGraph<T> &_graph)
+{
+  const auto &graph = _graph.Graph();
+  std::map<VertexId, VertexId> ids;
+  for (const auto &vertexPair : graph.Vertices())
+  {
+    const auto &vertex = vertexPair.second.get();
+    ids[vertex.Id()] = this->AddVertex(vertex.Name(), vertex.Data()).Id();
+  }
+  for (const auto &edgePair : graph.Edges())
+  {
+    const auto &edge = edgePair.second.get();
+    this->graphPtr->graph.AddEdge({ids[edge.Tail()], ids[edge.Head()]},
+        edge.Data(), edge.Weight());
+  }
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+bool ScopedGraph<T>::RemoveVertex(const std::string &_name)
+{
+  auto &map = this->graphPtr->map;
+  auto it = map.find(NameType(this->dataPtr->prefix, _name));
+  if (it == map.end())
+  {
+    return false;
+  }
+  const VertexId id = it->second;
+
+  // The descendants of the vertex lose the edges to it.
+  this->InvalidateCaches(id);
+  map.erase(it);
+  return this->graphPtr->graph.RemoveVertex(id);
+}
+
+/////////////////////////////////////////////////
+template <typename T>
+bool ScopedGraph<T>::RemoveEdge(const Edge &_edge)
+{
+  const VertexId headVertexId = _edge.Head();
+  this->InvalidateCaches(headVertexId);
+  return this->graphPtr->graph.RemoveEdge(_edge.Id());
+}
+
 /////////////////////////////////////////////////
 template <typename T>
 std::vector<std::string> ScopedGraph<T>::VertexNames() const
@@ -341,12 +477,15 @@ std::vector<std::string> ScopedGraph<T>::VertexNames() const
   std::vector<std::string> out;
   for (const auto &namePair : this->Map())
   {
-    const auto &idNamePair = this->FindAndRemovePrefix(namePair.first);
+    const auto &idNamePair = this->FindAndRemovePrefix(namePair.first.Name());
     if (idNamePair.second)
     {
       out.push_back(idNamePair.first);
     }
   }
+
+  // The name index is unordered, so sort the names to keep the order stable.
+  std::sort(out.begin(), out.end());
   return out;
 }
 
@@ -375,6 +514,7 @@ void ScopedGraph<T>::UpdateEdge(Edge &_edge, const EdgeType &_data)
   auto &graph = this->graphPtr->graph;
   graph.RemoveEdge(_edge.Id());
   _edge = graph.AddEdge({tailVertexId, headVertexId}, _data);
+  this->InvalidateCaches(headVertexId);
 }
 
 /////////////////////////////////////////////////
@@ -395,7 +535,7 @@ void ScopedGraph<T>::SetScopeContextName(const std::string &_name)
 template <typename T>
 std::size_t ScopedGraph<T>::Count(const std::string &_name) const
 {
-  return this->graphPtr->map.count(this->AddPrefix(_name));
+  return this->graphPtr->map.count(NameType(this->dataPtr->prefix, _name));
 }
 
 /////////////////////////////////////////////////
@@ -403,7 +543,7 @@ template <typename T>
 auto ScopedGraph<T>::VertexIdByName(const std::string &_name) const -> VertexId
 {
   auto &map = this->Map();
-  auto it = map.find(this->AddPrefix(_name));
+  auto it = map.find(NameType(this->dataPtr->prefix, _name));
   if (it != map.end())
     return it->second;
   else
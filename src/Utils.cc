@@ -14,8 +14,17 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <atomic>
+#include <clocale>
+#include <cstring>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
+#include "sdf/ElementPath.hh"
 #include "Utils.hh"
 
 namespace sdf
@@ -75,6 +84,97 @@ bool loadPose(sdf::ElementPtr _sdf, ignition::math::Pose3d &_pose,
   return posePair.second;
 }
 
+/////////////////////////////////////////////////
+ElementPtr_V childElements(sdf::ElementPtr _sdf, const std::string &_sdfName)
+{
+  if (!_sdf->HasElement(_sdfName))
+    return {};
+
+  // A single step path selects the children through the child index of
+  // _sdf.
+  ElementPath path;
+  if (path.Compile(_sdfName).empty())
+    return _sdf->SelectAll(path);
+
+  // Names that are not valid path steps.
+  ElementPtr_V result;
+  for (ElementPtr elem = _sdf->GetElement(_sdfName); elem;
+       elem = elem->GetNextElement(_sdfName))
+  {
+    result.push_back(elem);
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+void useClassicNumericLocale()
+{
+  // Querying the locale doesn't change it, so the common case, where the
+  // locale is already C, doesn't lock. setlocale is not thread-safe, so the
+  // calls that change the locale are serialized.
+  const char *current = std::setlocale(LC_NUMERIC, nullptr);
+  if (current && std::strcmp(current, "C") == 0)
+    return;
+
+  static std::mutex localeMutex;
+  std::lock_guard<std::mutex> lock(localeMutex);
+  current = std::setlocale(LC_NUMERIC, nullptr);
+  if (!current || std::strcmp(current, "C") != 0)
+    std::setlocale(LC_NUMERIC, "C");
+}
+
+/////////////////////////////////////////////////
+void parallelFor(std::size_t _count, unsigned int _threads,
+    const std::function<void(std::size_t)> &_func)
+{
+  if (_threads == 0)
+    _threads = std::max(1u, std::thread::hardware_concurrency());
+  _threads = static_cast<unsigned int>(
+      std::min<std::size_t>(_threads, _count));
+
+  if (_threads <= 1)
+  {
+    for (std::size_t i = 0; i < _count; ++i)
+      _func(i);
+    return;
+  }
+
+  useClassicNumericLocale();
+
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> stop(false);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto work = [&]()
+  {
+    for (std::size_t i = next++; i < _count && !stop; i = next++)
+    {
+      try
+      {
+        _func(i);
+      }
+      catch(...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+          error = std::current_exception();
+        stop = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(_threads - 1);
+  for (unsigned int t = 1; t < _threads; ++t)
+    workers.emplace_back(work);
+  work();
+  for (std::thread &worker : workers)
+    worker.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
 /////////////////////////////////////////////////
 bool isValidFrameReference(const std::string &_name)
 {
@@ -18,7 +18,10 @@
 #define SDFORMAT_UTILS_HH
 
 #include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include "sdf/Error.hh"
 #include "sdf/Element.hh"
@@ -61,6 +64,39 @@ namespace sdf
   bool loadPose(sdf::ElementPtr _sdf, ignition::math::Pose3d &_pose,
                 std::string &_frame);
 
+  /// \brief Get the child elements with a given name, in document order.
+  /// Unlike a loop over Element::GetNextElement, which searches for the
+  /// position of each element, this is linear in the number of children.
+  /// \param[in] _sdf The SDF element that contains zero or more elements.
+  /// \param[in] _sdfName Name of the child elements, such as "model".
+  /// \return The child elements.
+  ElementPtr_V childElements(sdf::ElementPtr _sdf,
+      const std::string &_sdfName);
+
+  /// \brief Make numbers use the C locale, whose decimal separator is a
+  /// dot, when the LC_NUMERIC locale is not already C. Latin locales, such
+  /// as es_ES or pt_BR, use a comma, which makes number parsing fail. The
+  /// parser entry points call this once per document, and Param doesn't
+  /// call it for each value. When the locale is already C, it is only read,
+  /// without locking, so threads can call this while others parse numbers,
+  /// as long as the locale was set before they started.
+  void useClassicNumericLocale();
+
+  /// \brief Call a function for each index in [0, _count), on a pool of
+  /// threads. The calls are made in an unspecified order, and the function
+  /// must be safe to call concurrently for different indices. If a call
+  /// throws, the remaining indices are skipped and the first exception is
+  /// rethrown once all the threads are done.
+  /// \param[in] _count Number of indices.
+  /// \param[in] _threads Maximum number of threads, including the calling
+  /// thread. 0 uses the number of hardware threads, and 1 makes every call
+  /// on the calling thread, in order. Before starting threads, the
+  /// numeric locale is set with useClassicNumericLocale, so that the
+  /// calls don't change it while other threads parse numbers.
+  /// \param[in] _func Function to call with each index.
+  void parallelFor(std::size_t _count, unsigned int _threads,
+      const std::function<void(std::size_t)> &_func);
+
   /// \brief Load all objects of a specific sdf element type. No error
   /// is returned if an element is not present. This function assumes that
   /// an element has a "name" attribute that must be unique.
@@ -69,55 +105,62 @@ namespace sdf
   /// \param[out] _objs Elements that match _sdfName in _sdf are added to this
   /// vector, unless an error is encountered during load or a duplicate name
   /// exists.
+  /// \param[in] _threads Maximum number of threads used to load the
+  /// objects, see parallelFor. Objects are only loaded concurrently when
+  /// they are independent of each other, such as the models of a world. The
+  /// objects and errors are the same as a serial load, in document order.
+  /// \param[in] _loadFunc Function that loads an object from its element,
+  /// called instead of Class::Load if set. It is called concurrently when
+  /// _threads is not 1.
   /// \return The vector of errors. An empty vector indicates no errors were
   /// experienced.
   template <typename Class>
   sdf::Errors loadUniqueRepeated(sdf::ElementPtr _sdf,
-      const std::string &_sdfName, std::vector<Class> &_objs)
+      const std::string &_sdfName, std::vector<Class> &_objs,
+      unsigned int _threads = 1,
+      const std::function<Errors(Class &, const ElementPtr &)> &_loadFunc = {})
   {
     Errors errors;
 
-    std::vector<std::string> names;
+    const ElementPtr_V elems = childElements(_sdf, _sdfName);
 
-    // Check that an element exists.
-    if (_sdf->HasElement(_sdfName))
+    // Load the objects. Each Load call only reads and fills in the subtree
+    // of its own element, so the calls can run on different threads. The
+    // warnings they write go through the Console, which serializes them.
+    std::vector<Class> objs(elems.size());
+    std::vector<Errors> loadErrors(elems.size());
+    parallelFor(elems.size(), _threads, [&](std::size_t _i)
     {
-      // Read all the elements.
-      sdf::ElementPtr elem = _sdf->GetElement(_sdfName);
-      while (elem)
+      loadErrors[_i] = _loadFunc ? _loadFunc(objs[_i], elems[_i]) :
+                                   objs[_i].Load(elems[_i]);
+    });
+
+    std::unordered_set<std::string> names;
+
+    // Merge the objects and errors in document order.
+    for (std::size_t i = 0; i < elems.size(); ++i)
+    {
+      // keep processing even if there are loadErrors
+      std::string name;
+
+      // Read the name for uniqueness checks. Don't report errors here.
+      // Errors are captured in Load above.
+      sdf::loadName(elems[i], name);
+
+      // Check that the name does not exist.
+      if (!names.insert(name).second)
       {
-        Class obj;
-
-        // Load the model and capture the errors.
-        Errors loadErrors = obj.Load(elem);
-
-        // keep processing even if there are loadErrors
-        {
-          std::string name;
-
-          // Read the name for uniqueness checks. Don't report errors here.
-          // Errors are captured in obj.Load(elem) above.
-          sdf::loadName(elem, name);
-
-          // Check that the name does not exist.
-          if (std::find(names.begin(), names.end(), name) != names.end())
-          {
-            errors.push_back({ErrorCode::DUPLICATE_NAME,
-                _sdfName + " with name[" + name + "] already exists."});
-          }
-          else
-          {
-            // Add the object to the result if no errors have been encountered.
-            _objs.push_back(std::move(obj));
-            names.push_back(name);
-          }
-
-          // Add the load errors to the master error list.
-          errors.insert(errors.end(), loadErrors.begin(), loadErrors.end());
-        }
-
-        elem = elem->GetNextElement(_sdfName);
+        errors.push_back({ErrorCode::DUPLICATE_NAME,
+            _sdfName + " with name[" + name + "] already exists."});
       }
+      else
+      {
+        // Add the object to the result if no errors have been encountered.
+        _objs.push_back(std::move(objs[i]));
+      }
+
+      // Add the load errors to the master error list.
+      errors.insert(errors.end(), loadErrors[i].begin(), loadErrors[i].end());
     }
     // Do not add an error if the model tag is missing. This is an internal
     // function that is called by class without checking if an element actually
@@ -141,31 +184,24 @@ namespace sdf
   {
     Errors errors;
 
-    // Check that an element exists.
-    if (_sdf->HasElement(_sdfName))
+    // Read all the elements.
+    for (const sdf::ElementPtr &elem : childElements(_sdf, _sdfName))
     {
-      // Read all the elements.
-      sdf::ElementPtr elem = _sdf->GetElement(_sdfName);
-      while (elem)
+      Class obj;
+      if (_beforeLoadFunc)
       {
-        Class obj;
-        if (_beforeLoadFunc)
-        {
-          _beforeLoadFunc(obj);
-        }
-
-        // Load the model and capture the errors.
-        Errors loadErrors = obj.Load(elem);
+        _beforeLoadFunc(obj);
+      }
 
-        {
-          // Add the load errors to the master error list.
-          errors.insert(errors.end(), loadErrors.begin(), loadErrors.end());
+      // Load the model and capture the errors.
+      Errors loadErrors = obj.Load(elem);
 
-          // but keep object anyway
-          _objs.push_back(std::move(obj));
-        }
+      {
+        // Add the load errors to the master error list.
+        errors.insert(errors.end(), loadErrors.begin(), loadErrors.end());
 
-        elem = elem->GetNextElement(_sdfName);
+        // but keep object anyway
+        _objs.push_back(std::move(obj));
       }
     }
     // Do not add an error if the model tag is missing. This is an internal
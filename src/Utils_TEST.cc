@@ -16,9 +16,13 @@
 */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
 #include <string>
+#include <vector>
 #include <ignition/math/Pose3.hh>
 #include "sdf/Element.hh"
+#include "sdf/Frame.hh"
 #include "Utils.hh"
 
 /////////////////////////////////////////////////
@@ -122,3 +126,69 @@ TEST(DOMUtils, ReservedNames)
   EXPECT_TRUE(sdf::isReservedName("__world__"));
   EXPECT_TRUE(sdf::isReservedName("__anything__"));
 }
+
+/////////////////////////////////////////////////
+TEST(DOMUtils, ParallelFor)
+{
+  for (unsigned int threads : {0u, 1u, 4u})
+  {
+    std::vector<std::atomic<int>> calls(100);
+    sdf::parallelFor(calls.size(), threads, [&](std::size_t _i)
+    {
+      ++calls[_i];
+    });
+    for (const auto &count : calls)
+      EXPECT_EQ(1, count);
+  }
+
+  // Nothing to do.
+  bool called = false;
+  sdf::parallelFor(0, 4, [&](std::size_t) {called = true;});
+  EXPECT_FALSE(called);
+
+  // The exception of a call is rethrown on the calling thread.
+  EXPECT_THROW(sdf::parallelFor(100, 4, [](std::size_t _i)
+  {
+    if (_i == 50)
+      throw std::runtime_error("failed");
+  }), std::runtime_error);
+}
+
+/////////////////////////////////////////////////
+TEST(DOMUtils, LoadUniqueRepeatedThreads)
+{
+  sdf::ElementPtr parent(new sdf::Element);
+  parent->SetName("world");
+  for (const char *name : {"a", "b", "c", "b", "d"})
+  {
+    sdf::ElementPtr frame(new sdf::Element);
+    frame->SetName("frame");
+    frame->AddAttribute("name", "string", "", true);
+    frame->GetAttribute("name")->SetFromString(name);
+    frame->SetParent(parent);
+    parent->InsertElement(frame);
+  }
+
+  std::vector<sdf::Frame> serial;
+  sdf::Errors serialErrors =
+      sdf::loadUniqueRepeated<sdf::Frame>(parent, "frame", serial);
+
+  std::vector<sdf::Frame> parallel;
+  sdf::Errors parallelErrors =
+      sdf::loadUniqueRepeated<sdf::Frame>(parent, "frame", parallel, 4);
+
+  // The duplicate "b" is skipped, and the objects are in document order.
+  ASSERT_EQ(4u, serial.size());
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (std::size_t i = 0; i < serial.size(); ++i)
+    EXPECT_EQ(serial[i].Name(), parallel[i].Name());
+  EXPECT_EQ("d", parallel[3].Name());
+
+  ASSERT_FALSE(serialErrors.empty());
+  ASSERT_EQ(serialErrors.size(), parallelErrors.size());
+  for (std::size_t i = 0; i < serialErrors.size(); ++i)
+  {
+    EXPECT_EQ(serialErrors[i].Code(), parallelErrors[i].Code());
+    EXPECT_EQ(serialErrors[i].Message(), parallelErrors[i].Message());
+  }
+}
@@ -14,19 +14,29 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 #include <ignition/math/Vector3.hh>
 
 #include "sdf/Actor.hh"
+#include "sdf/ElementVisitor.hh"
 #include "sdf/Frame.hh"
+#include "sdf/KinematicTables.hh"
 #include "sdf/Light.hh"
 #include "sdf/Model.hh"
 #include "sdf/Physics.hh"
+#include "sdf/Population.hh"
 #include "sdf/Types.hh"
 #include "sdf/World.hh"
+#include "sdf/WorldState.hh"
 #include "FrameSemantics.hh"
+#include "NameIndex.hh"
 #include "ScopedGraph.hh"
 #include "Utils.hh"
 
@@ -63,9 +73,21 @@ class sdf::WorldPrivate
   /// \brief The frames specified in this world.
   public: std::vector<Frame> frames;
 
+  /// \brief Positions of the frames by name.
+  public: NameIndex frameIndex;
+
+  /// \brief The populations specified in this world.
+  public: std::vector<Population> populations;
+
+  /// \brief Positions of the populations by name.
+  public: NameIndex populationIndex;
+
   /// \brief The lights specified in this world.
   public: std::vector<Light> lights;
 
+  /// \brief Positions of the lights by name.
+  public: NameIndex lightIndex;
+
   /// \brief The actors specified in this world.
   public: std::vector<Actor> actors;
 
@@ -76,9 +98,18 @@ class sdf::WorldPrivate
   /// \brief The models specified in this world.
   public: std::vector<Model> models;
 
+  /// \brief Positions of the models by name.
+  public: NameIndex modelIndex;
+
   /// \brief Name of the world.
   public: std::string name = "";
 
+  /// \brief Maximum number of threads used by Load.
+  public: unsigned int loadThreads = 1;
+
+  /// \brief True if Load shares prototypes between identical models.
+  public: bool modelInstancing = false;
+
   /// \brief The physics profiles specified in this world.
   public: std::vector<Physics> physics;
 
@@ -103,11 +134,18 @@ WorldPrivate::WorldPrivate(const WorldPrivate &_worldPrivate)
     : audioDevice(_worldPrivate.audioDevice),
       gravity(_worldPrivate.gravity),
       frames(_worldPrivate.frames),
+      frameIndex(_worldPrivate.frameIndex),
+      populations(_worldPrivate.populations),
+      populationIndex(_worldPrivate.populationIndex),
       lights(_worldPrivate.lights),
+      lightIndex(_worldPrivate.lightIndex),
       actors(_worldPrivate.actors),
       magneticField(_worldPrivate.magneticField),
       models(_worldPrivate.models),
+      modelIndex(_worldPrivate.modelIndex),
       name(_worldPrivate.name),
+      loadThreads(_worldPrivate.loadThreads),
+      modelInstancing(_worldPrivate.modelInstancing),
       physics(_worldPrivate.physics),
       sdf(_worldPrivate.sdf),
       windLinearVelocity(_worldPrivate.windLinearVelocity),
@@ -129,6 +167,186 @@ WorldPrivate::WorldPrivate(const WorldPrivate &_worldPrivate)
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Prototypes shared by the models of a world, keyed by the element
+/// of each instance.
+using ModelPrototypes =
+    std::unordered_map<const Element *, std::shared_ptr<const Model>>;
+
+/////////////////////////////////////////////////
+/// \brief Check whether a child element or attribute of a model is read by
+/// Model::LoadInstance instead of being shared with the prototype.
+/// \param[in] _name Name of the element or attribute.
+/// \return True for the name, pose, placement frame and static flag.
+static bool isInstanceProperty(const std::string &_name)
+{
+  return _name == "name" || _name == "pose" || _name == "static" ||
+      _name == "placement_frame";
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether two elements have the same name, file path,
+/// attributes and value, without comparing their children.
+/// \param[in] _a First element.
+/// \param[in] _b Second element.
+/// \param[in] _skipInstance True to ignore the values of the attributes
+/// that are read by Model::LoadInstance.
+/// \return True if the elements are identical.
+static bool sameOwnFields(const ElementPtr &_a, const ElementPtr &_b,
+    bool _skipInstance)
+{
+  if (_a->GetName() != _b->GetName() || _a->FilePath() != _b->FilePath() ||
+      _a->GetAttributeCount() != _b->GetAttributeCount())
+  {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < _a->GetAttributeCount(); ++i)
+  {
+    ParamPtr attrA = _a->GetAttribute(i);
+    ParamPtr attrB = _b->GetAttribute(i);
+    if (attrA->GetKey() != attrB->GetKey())
+      return false;
+    if (!(_skipInstance && isInstanceProperty(attrA->GetKey())) &&
+        attrA->GetAsString() != attrB->GetAsString())
+    {
+      return false;
+    }
+  }
+
+  ParamPtr valueA = _a->GetValue();
+  ParamPtr valueB = _b->GetValue();
+  return (valueA == nullptr) == (valueB == nullptr) &&
+      (!valueA || valueA->GetAsString() == valueB->GetAsString());
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the descendants of an element in document order, with their
+/// depth below it. The children that are read by Model::LoadInstance, and
+/// their descendants, can be left out.
+/// \param[in] _elem Element.
+/// \param[in] _skipInstance True to leave out the instance properties.
+/// \return The descendants and their depths, children at depth 1.
+static std::vector<std::pair<ElementPtr, std::size_t>> descendants(
+    const ElementPtr &_elem, bool _skipInstance)
+{
+  std::vector<std::pair<ElementPtr, std::size_t>> result;
+  ElementVisitor visitor;
+  visitor.SetPreVisit([&](const ElementPtr &_child, std::size_t _depth)
+  {
+    if (_skipInstance && _depth == 1 && isInstanceProperty(_child->GetName()))
+      return TraversalAction::SKIP_CHILDREN;
+    result.emplace_back(_child, _depth);
+    return TraversalAction::CONTINUE;
+  });
+  visitor.VisitChildren(*_elem);
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether two element trees are identical: same names, file
+/// paths, attributes, values and children.
+/// \param[in] _a First element.
+/// \param[in] _b Second element.
+/// \param[in] _skipInstance True to ignore the children and attributes of
+/// the two elements that are read by Model::LoadInstance.
+/// \return True if the trees are identical.
+static bool sameElement(const ElementPtr &_a, const ElementPtr &_b,
+    bool _skipInstance)
+{
+  if (!sameOwnFields(_a, _b, _skipInstance))
+    return false;
+
+  // Two trees are identical when their elements are, in document order and
+  // at the same depths. The cached hashes of the children rule out most
+  // differences before their descendants are compared.
+  const auto elemsA = descendants(_a, _skipInstance);
+  const auto elemsB = descendants(_b, _skipInstance);
+  if (elemsA.size() != elemsB.size())
+    return false;
+
+  for (std::size_t i = 0; i < elemsA.size(); ++i)
+  {
+    if (elemsA[i].second != elemsB[i].second ||
+        (elemsA[i].second == 1 &&
+         elemsA[i].first->Hash() != elemsB[i].first->Hash()))
+    {
+      return false;
+    }
+  }
+
+  for (std::size_t i = 0; i < elemsA.size(); ++i)
+  {
+    if (elemsA[i].first != elemsB[i].first &&
+        !sameOwnFields(elemsA[i].first, elemsB[i].first, false))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Group the model elements of a world that only differ by the
+/// properties read by Model::LoadInstance.
+/// \param[in] _sdf World element.
+/// \return Groups of model elements in document order.
+static std::vector<ElementPtr_V> groupModelElements(const ElementPtr &_sdf)
+{
+  std::vector<ElementPtr_V> groups;
+
+  // Candidates are found by a hash of the shared children, then compared.
+  std::unordered_multimap<std::size_t, std::size_t> groupsByHash;
+  for (const ElementPtr &elem : childElements(_sdf, "model"))
+  {
+    std::size_t hash = std::hash<std::string>()(elem->FilePath());
+    for (ElementPtr child = elem->GetFirstElement(); child;
+         child = child->GetNextElement())
+    {
+      if (!isInstanceProperty(child->GetName()))
+        hash = hash * 31 + child->Hash();
+    }
+
+    auto range = groupsByHash.equal_range(hash);
+    auto it = std::find_if(range.first, range.second,
+        [&](const std::pair<const std::size_t, std::size_t> &_entry)
+        {
+          return sameElement(groups[_entry.second].front(), elem, true);
+        });
+    if (it == range.second)
+    {
+      groupsByHash.emplace(hash, groups.size());
+      groups.push_back({elem});
+    }
+    else
+    {
+      groups[it->second].push_back(elem);
+    }
+  }
+  return groups;
+}
+
+/////////////////////////////////////////////////
+/// \brief Remove marked objects from a vector in a single pass, keeping
+/// the order of the other objects.
+/// \param[in,out] _objs Objects.
+/// \param[in] _marked True for each object to remove.
+template <typename Class>
+static void eraseMarked(std::vector<Class> &_objs,
+    const std::vector<bool> &_marked)
+{
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < _objs.size(); ++i)
+  {
+    if (_marked[i])
+      continue;
+    if (kept != i)
+      _objs[kept] = std::move(_objs[i]);
+    ++kept;
+  }
+  _objs.erase(_objs.begin() + kept, _objs.end());
+}
+
 /////////////////////////////////////////////////
 World::World()
   : dataPtr(new WorldPrivate)
@@ -246,9 +464,51 @@ Errors World::Load(sdf::ElementPtr _sdf)
   // name collisions
   std::unordered_set<std::string> frameNames;
 
-  // Load all the models.
+  // Load all the models, sharing a prototype between identical models if
+  // instancing is enabled.
+  std::function<Errors(Model &, const ElementPtr &)> loadModel;
+  if (this->dataPtr->modelInstancing)
+  {
+    const std::vector<ElementPtr_V> groups = groupModelElements(_sdf);
+
+    // Load a prototype for each group of several models, with graphs of its
+    // own in which the shared objects resolve their poses. Groups whose
+    // prototype has errors are loaded model by model, so that each model
+    // reports its errors as usual.
+    std::vector<std::shared_ptr<const Model>> prototypes(groups.size());
+    parallelFor(groups.size(), this->dataPtr->loadThreads,
+        [&](std::size_t _i)
+    {
+      if (groups[_i].size() < 2)
+        return;
+
+      Errors prototypeErrors;
+      auto prototype =
+          Model::LoadPrototype(groups[_i].front(), prototypeErrors);
+      if (prototypeErrors.empty())
+        prototypes[_i] = std::move(prototype);
+    });
+
+    auto instances = std::make_shared<ModelPrototypes>();
+    for (std::size_t i = 0; i < groups.size(); ++i)
+    {
+      if (prototypes[i])
+      {
+        for (const ElementPtr &elem : groups[i])
+          instances->emplace(elem.get(), prototypes[i]);
+      }
+    }
+
+    loadModel = [instances](Model &_model, const ElementPtr &_elem)
+    {
+      auto it = instances->find(_elem.get());
+      return it == instances->end() ? _model.Load(_elem) :
+          _model.LoadInstance(_elem, it->second);
+    };
+  }
   Errors modelLoadErrors =
-      loadUniqueRepeated<Model>(_sdf, "model", this->dataPtr->models);
+      loadUniqueRepeated<Model>(_sdf, "model", this->dataPtr->models,
+          this->dataPtr->loadThreads, loadModel);
   errors.insert(errors.end(), modelLoadErrors.begin(), modelLoadErrors.end());
 
   // Models are loaded first, and loadUniqueRepeated ensures there are no
@@ -258,6 +518,7 @@ Errors World::Load(sdf::ElementPtr _sdf)
   {
     frameNames.insert(model.Name());
   }
+  this->dataPtr->modelIndex.Build(this->dataPtr->models);
 
   // Load all the physics.
   if (_sdf->HasElement("physics"))
@@ -271,13 +532,14 @@ Errors World::Load(sdf::ElementPtr _sdf)
 
   // Load all the actors.
   Errors actorLoadErrors = loadUniqueRepeated<Actor>(_sdf, "actor",
-      this->dataPtr->actors);
+      this->dataPtr->actors, this->dataPtr->loadThreads);
   errors.insert(errors.end(), actorLoadErrors.begin(), actorLoadErrors.end());
 
   // Load all the lights.
   Errors lightLoadErrors = loadUniqueRepeated<Light>(_sdf, "light",
-      this->dataPtr->lights);
+      this->dataPtr->lights, this->dataPtr->loadThreads);
   errors.insert(errors.end(), lightLoadErrors.begin(), lightLoadErrors.end());
+  this->dataPtr->lightIndex.Build(this->dataPtr->lights);
 
   // Load all the frames.
   Errors frameLoadErrors = loadUniqueRepeated<Frame>(_sdf, "frame",
@@ -304,6 +566,15 @@ Errors World::Load(sdf::ElementPtr _sdf)
     }
     frameNames.insert(frameName);
   }
+  this->dataPtr->frameIndex.Build(this->dataPtr->frames);
+
+  // Load all the populations. Each one loads its model once, as the
+  // prototype of its instances.
+  Errors populationLoadErrors = loadUniqueRepeated<Population>(_sdf,
+      "population", this->dataPtr->populations, this->dataPtr->loadThreads);
+  errors.insert(errors.end(), populationLoadErrors.begin(),
+      populationLoadErrors.end());
+  this->dataPtr->populationIndex.Build(this->dataPtr->populations);
 
   // Load the Gui
   if (_sdf->HasElement("gui"))
@@ -325,6 +596,30 @@ Errors World::Load(sdf::ElementPtr _sdf)
   return errors;
 }
 
+/////////////////////////////////////////////////
+void World::SetLoadThreads(unsigned int _threads)
+{
+  this->dataPtr->loadThreads = _threads;
+}
+
+/////////////////////////////////////////////////
+unsigned int World::LoadThreads() const
+{
+  return this->dataPtr->loadThreads;
+}
+
+/////////////////////////////////////////////////
+void World::SetModelInstancing(bool _instancing)
+{
+  this->dataPtr->modelInstancing = _instancing;
+}
+
+/////////////////////////////////////////////////
+bool World::ModelInstancing() const
+{
+  return this->dataPtr->modelInstancing;
+}
+
 /////////////////////////////////////////////////
 std::string World::Name() const
 {
@@ -402,27 +697,14 @@ const Model *World::ModelByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool World::ModelNameExists(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
-  {
-    if (m.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return nullptr != this->ModelByName(_name);
 }
 
 /////////////////////////////////////////////////
 const Model *World::ModelByName(const std::string &_name) const
 {
-  for (auto const &m : this->dataPtr->models)
-  {
-    if (m.Name() == _name)
-    {
-      return &m;
-    }
-  }
-  return nullptr;
+  const std::size_t pos = this->dataPtr->modelIndex.Find(_name);
+  return pos == NameIndex::npos ? nullptr : &this->dataPtr->models[pos];
 }
 
 /////////////////////////////////////////////////
@@ -467,6 +749,176 @@ sdf::ElementPtr World::Element() const
   return this->dataPtr->sdf;
 }
 
+/////////////////////////////////////////////////
+Errors World::ExportKinematicTables(KinematicTables &_tables) const
+{
+  Errors errors;
+  _tables.Clear();
+
+  // A single walk down the world graph resolves the poses of all the frames
+  // of the models relative to the world frame.
+  ResolvedPoses poses;
+  if (this->dataPtr->poseRelativeToGraph)
+  {
+    errors = resolveAllPoses(poses, this->dataPtr->poseRelativeToGraph);
+  }
+  else
+  {
+    errors.push_back({ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR,
+        "World has invalid pointer to PoseRelativeToGraph."});
+  }
+
+  for (const Model &model : this->dataPtr->models)
+  {
+    const std::string prefix = model.Name() + "::";
+    Errors modelErrors = _tables.AddModel(model, poses, prefix,
+        ignition::math::Pose3d::Zero, prefix);
+    errors.insert(errors.end(), modelErrors.begin(), modelErrors.end());
+  }
+  return errors;
+}
+
+/////////////////////////////////////////////////
+Errors World::ApplyState(const WorldState &_state)
+{
+  Errors errors;
+  WorldPrivate &data = *this->dataPtr;
+
+  if (!_state.WorldName().empty() && _state.WorldName() != data.name)
+  {
+    errors.push_back({ErrorCode::ELEMENT_INVALID,
+        "State of world with name [" + _state.WorldName() +
+        "] cannot be applied to world with name [" + data.name + "]."});
+    return errors;
+  }
+
+  // Deleting shifts the entities that follow, so the deleted entities are
+  // marked first and removed in a single pass. The vertices of the deleted
+  // models are removed from the graphs shared with Root right away.
+  if (!_state.Deletions().empty())
+  {
+    std::vector<bool> deletedModels(data.models.size(), false);
+    std::vector<bool> deletedLights(data.lights.size(), false);
+    bool modelsChanged = false;
+    bool lightsChanged = false;
+    for (const std::string &name : _state.Deletions())
+    {
+      std::size_t pos = data.modelIndex.Find(name);
+      if (pos != NameIndex::npos)
+      {
+        if (!deletedModels[pos] && data.frameAttachedToGraph &&
+            data.poseRelativeToGraph)
+        {
+          Errors graphErrors = removeModelFromGraphs(
+              data.frameAttachedToGraph, data.poseRelativeToGraph,
+              data.models[pos]);
+          errors.insert(errors.end(), graphErrors.begin(), graphErrors.end());
+        }
+        deletedModels[pos] = true;
+        modelsChanged = true;
+        continue;
+      }
+      pos = data.lightIndex.Find(name);
+      if (pos != NameIndex::npos)
+      {
+        deletedLights[pos] = true;
+        lightsChanged = true;
+        continue;
+      }
+      errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "Deleted entity with name [" + name + "] does not match a model "
+          "or light in world with name [" + data.name + "]."});
+    }
+
+    if (modelsChanged)
+    {
+      eraseMarked(data.models, deletedModels);
+      data.modelIndex.Build(data.models);
+    }
+    if (lightsChanged)
+    {
+      eraseMarked(data.lights, deletedLights);
+      data.lightIndex.Build(data.lights);
+    }
+  }
+
+  for (uint64_t i = 0; i < _state.InsertedModelCount(); ++i)
+  {
+    const Model *model = _state.InsertedModelByIndex(i);
+    if (data.modelIndex.Find(model->Name()) != NameIndex::npos ||
+        data.frameIndex.Find(model->Name()) != NameIndex::npos)
+    {
+      errors.push_back({ErrorCode::DUPLICATE_NAME,
+          "Inserted model with name [" + model->Name() +
+          "] has the name of an existing model or frame in world with name [" +
+          data.name + "]."});
+      continue;
+    }
+    Model &inserted = data.models.emplace_back(*model);
+    data.modelIndex.Add(inserted.Name());
+    if (data.frameAttachedToGraph && data.poseRelativeToGraph)
+    {
+      Errors graphErrors = addModelToGraphs(data.frameAttachedToGraph,
+          data.poseRelativeToGraph, inserted);
+      errors.insert(errors.end(), graphErrors.begin(), graphErrors.end());
+      inserted.SetFrameAttachedToGraph(data.frameAttachedToGraph);
+      inserted.SetPoseRelativeToGraph(data.poseRelativeToGraph);
+    }
+  }
+
+  for (uint64_t i = 0; i < _state.InsertedLightCount(); ++i)
+  {
+    const Light *light = _state.InsertedLightByIndex(i);
+    if (data.lightIndex.Find(light->Name()) != NameIndex::npos)
+    {
+      errors.push_back({ErrorCode::DUPLICATE_NAME,
+          "Inserted light with name [" + light->Name() +
+          "] has the name of an existing light in world with name [" +
+          data.name + "]."});
+      continue;
+    }
+    Light &inserted = data.lights.emplace_back(*light);
+    data.lightIndex.Add(inserted.Name());
+    inserted.SetXmlParentName("world");
+    if (data.poseRelativeToGraph)
+      inserted.SetPoseRelativeToGraph(data.poseRelativeToGraph);
+  }
+
+  for (uint64_t i = 0; i < _state.ModelStateCount(); ++i)
+  {
+    const ModelState *modelState = _state.ModelStateByIndex(i);
+    const std::size_t pos = data.modelIndex.Find(modelState->name);
+    if (pos == NameIndex::npos)
+    {
+      errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "State of model with name [" + modelState->name +
+          "] does not match a model in world with name [" + data.name +
+          "]."});
+      continue;
+    }
+    Errors modelErrors = data.models[pos].ApplyState(*modelState);
+    errors.insert(errors.end(), modelErrors.begin(), modelErrors.end());
+  }
+
+  for (uint64_t i = 0; i < _state.LightStateCount(); ++i)
+  {
+    const LightState *lightState = _state.LightStateByIndex(i);
+    const std::size_t pos = data.lightIndex.Find(lightState->name);
+    if (pos == NameIndex::npos)
+    {
+      errors.push_back({ErrorCode::ELEMENT_INVALID,
+          "State of light with name [" + lightState->name +
+          "] does not match a light in world with name [" + data.name +
+          "]."});
+      continue;
+    }
+    if (lightState->pose)
+      data.lights[pos].SetRawPose(*lightState->pose);
+  }
+
+  return errors;
+}
+
 /////////////////////////////////////////////////
 uint64_t World::FrameCount() const
 {
@@ -484,29 +936,43 @@ const Frame *World::FrameByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool World::FrameNameExists(const std::string &_name) const
 {
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return nullptr != this->FrameByName(_name);
 }
 
 /////////////////////////////////////////////////
-const Frame *World::FrameByName(const std::string &_name) const
+uint64_t World::PopulationCount() const
 {
-  for (auto const &f : this->dataPtr->frames)
-  {
-    if (f.Name() == _name)
-    {
-      return &f;
-    }
-  }
+  return this->dataPtr->populations.size();
+}
+
+/////////////////////////////////////////////////
+const Population *World::PopulationByIndex(const uint64_t _index) const
+{
+  if (_index < this->dataPtr->populations.size())
+    return &this->dataPtr->populations[_index];
   return nullptr;
 }
 
+/////////////////////////////////////////////////
+const Population *World::PopulationByName(const std::string &_name) const
+{
+  const std::size_t pos = this->dataPtr->populationIndex.Find(_name);
+  return pos == NameIndex::npos ? nullptr : &this->dataPtr->populations[pos];
+}
+
+/////////////////////////////////////////////////
+bool World::PopulationNameExists(const std::string &_name) const
+{
+  return nullptr != this->PopulationByName(_name);
+}
+
+/////////////////////////////////////////////////
+const Frame *World::FrameByName(const std::string &_name) const
+{
+  const std::size_t pos = this->dataPtr->frameIndex.Find(_name);
+  return pos == NameIndex::npos ? nullptr : &this->dataPtr->frames[pos];
+}
+
 /////////////////////////////////////////////////
 uint64_t World::LightCount() const
 {
@@ -524,14 +990,7 @@ const Light *World::LightByIndex(const uint64_t _index) const
 /////////////////////////////////////////////////
 bool World::LightNameExists(const std::string &_name) const
 {
-  for (auto const &l : this->dataPtr->lights)
-  {
-    if (l.Name() == _name)
-    {
-      return true;
-    }
-  }
-  return false;
+  return this->dataPtr->lightIndex.Find(_name) != NameIndex::npos;
 }
 
 /////////////////////////////////////////////////
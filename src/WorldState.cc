@@ -0,0 +1,457 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "sdf/Error.hh"
+#include "sdf/Light.hh"
+#include "sdf/Model.hh"
+#include "sdf/Types.hh"
+#include "sdf/WorldState.hh"
+#include "NameIndex.hh"
+#include "Utils.hh"
+
+using namespace sdf;
+
+class sdf::WorldStatePrivate
+{
+  /// \brief Name of the world the state applies to.
+  public: std::string worldName = "";
+
+  /// \brief Simulation time stamp.
+  public: Time simTime;
+
+  /// \brief Wall time stamp.
+  public: Time wallTime;
+
+  /// \brief Real time stamp.
+  public: Time realTime;
+
+  /// \brief Number of simulation iterations.
+  public: uint64_t iterations = 0;
+
+  /// \brief Inserted models.
+  public: std::vector<Model> insertedModels;
+
+  /// \brief Inserted lights.
+  public: std::vector<Light> insertedLights;
+
+  /// \brief Names of the deleted entities.
+  public: std::vector<std::string> deletions;
+
+  /// \brief States of the models.
+  public: std::vector<ModelState> modelStates;
+
+  /// \brief Positions of the model states by name.
+  public: NameIndex modelStateIndex;
+
+  /// \brief States of the lights.
+  public: std::vector<LightState> lightStates;
+
+  /// \brief Positions of the light states by name.
+  public: NameIndex lightStateIndex;
+
+  /// \brief The SDF element pointer used during load.
+  public: sdf::ElementPtr sdf;
+};
+
+/////////////////////////////////////////////////
+/// \brief Read the value of a child element that is only set if it was
+/// recorded.
+/// \param[in] _sdf Parent element.
+/// \param[in] _name Name of the child element.
+/// \return The value of the child, or nullopt if there is no such child.
+template <typename T>
+static std::optional<T> loadOptional(const ElementPtr &_sdf,
+    const std::string &_name)
+{
+  if (!_sdf->HasElement(_name))
+    return std::nullopt;
+  return _sdf->GetElement(_name)->Get<T>();
+}
+
+/////////////////////////////////////////////////
+/// \brief Read the pose of an entity state, if it was recorded.
+/// \param[in] _sdf Element of the entity state.
+/// \return The pose, or nullopt if there is no <pose> element.
+static std::optional<ignition::math::Pose3d> loadOptionalPose(
+    const ElementPtr &_sdf)
+{
+  ignition::math::Pose3d pose;
+  std::string frame;
+  if (!loadPose(_sdf, pose, frame))
+    return std::nullopt;
+  return pose;
+}
+
+/////////////////////////////////////////////////
+/// \brief Read the name of an entity state.
+/// \param[in] _sdf Element of the entity state.
+/// \param[in] _type Type of the entity, for error messages.
+/// \param[out] _name Name of the entity.
+/// \param[out] _errors Errors, appended to.
+static void loadStateName(const ElementPtr &_sdf, const std::string &_type,
+    std::string &_name, Errors &_errors)
+{
+  if (!loadName(_sdf, _name))
+  {
+    _errors.push_back({ErrorCode::ATTRIBUTE_MISSING,
+        "A " + _type + " state name is required, but the name is not set."});
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a <model> element of a state, and its nested models.
+/// \param[in] _sdf The <model> element.
+/// \param[out] _state State of the model.
+/// \param[out] _errors Errors, appended to.
+static void loadModelState(const ElementPtr &_sdf, ModelState &_state,
+    Errors &_errors)
+{
+  loadStateName(_sdf, "model", _state.name, _errors);
+  _state.pose = loadOptionalPose(_sdf);
+  _state.scale = loadOptional<ignition::math::Vector3d>(_sdf, "scale");
+
+  for (const ElementPtr &jointElem : childElements(_sdf, "joint"))
+  {
+    JointState &joint = _state.joints.emplace_back();
+    loadStateName(jointElem, "joint", joint.name, _errors);
+    for (const ElementPtr &angleElem : childElements(jointElem, "angle"))
+    {
+      const unsigned int axis = angleElem->Get<unsigned int>("axis");
+      if (axis >= joint.angles.size())
+        joint.angles.resize(axis + 1, 0.0);
+      joint.angles[axis] = angleElem->Get<double>();
+    }
+  }
+
+  for (const ElementPtr &linkElem : childElements(_sdf, "link"))
+  {
+    LinkState &link = _state.links.emplace_back();
+    loadStateName(linkElem, "link", link.name, _errors);
+    link.pose = loadOptionalPose(linkElem);
+    link.velocity =
+        loadOptional<ignition::math::Pose3d>(linkElem, "velocity");
+    link.acceleration =
+        loadOptional<ignition::math::Pose3d>(linkElem, "acceleration");
+    link.wrench = loadOptional<ignition::math::Pose3d>(linkElem, "wrench");
+  }
+
+  for (const ElementPtr &modelElem : childElements(_sdf, "model"))
+  {
+    loadModelState(modelElem, _state.models.emplace_back(), _errors);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Add or replace the state of an entity.
+/// \param[in,out] _states States of the entities.
+/// \param[in,out] _index Positions of the states by name.
+/// \param[in] _state State to add.
+template <typename State>
+static void addState(std::vector<State> &_states, NameIndex &_index,
+    const State &_state)
+{
+  const std::size_t pos = _index.Find(_state.name);
+  if (pos != NameIndex::npos)
+  {
+    _states[pos] = _state;
+    return;
+  }
+  _states.push_back(_state);
+  _index.Add(_state.name);
+}
+
+/////////////////////////////////////////////////
+WorldState::WorldState()
+  : dataPtr(new WorldStatePrivate)
+{
+}
+
+/////////////////////////////////////////////////
+WorldState::WorldState(const WorldState &_state)
+  : dataPtr(new WorldStatePrivate(*_state.dataPtr))
+{
+}
+
+/////////////////////////////////////////////////
+WorldState::WorldState(WorldState &&_state) noexcept
+  : dataPtr(std::exchange(_state.dataPtr, nullptr))
+{
+}
+
+/////////////////////////////////////////////////
+WorldState::~WorldState()
+{
+  delete this->dataPtr;
+  this->dataPtr = nullptr;
+}
+
+/////////////////////////////////////////////////
+WorldState &WorldState::operator=(const WorldState &_state)
+{
+  return *this = WorldState(_state);
+}
+
+/////////////////////////////////////////////////
+WorldState &WorldState::operator=(WorldState &&_state)
+{
+  std::swap(this->dataPtr, _state.dataPtr);
+  return *this;
+}
+
+/////////////////////////////////////////////////
+Errors WorldState::Load(ElementPtr _sdf)
+{
+  Errors errors;
+
+  this->dataPtr->sdf = _sdf;
+
+  // Check that the provided SDF element is a <state>
+  // This is an error that cannot be recovered, so return an error.
+  if (_sdf->GetName() != "state")
+  {
+    errors.push_back({ErrorCode::ELEMENT_INCORRECT_TYPE,
+        "Attempting to load a WorldState, but the provided SDF element is "
+        "not a <state>."});
+    return errors;
+  }
+
+  this->dataPtr->worldName = _sdf->Get<std::string>("world_name");
+  this->dataPtr->simTime = _sdf->Get<Time>("sim_time", Time()).first;
+  this->dataPtr->wallTime = _sdf->Get<Time>("wall_time", Time()).first;
+  this->dataPtr->realTime = _sdf->Get<Time>("real_time", Time()).first;
+  this->dataPtr->iterations =
+      _sdf->Get<unsigned int>("iterations", 0u).first;
+
+  if (_sdf->HasElement("insertions"))
+  {
+    ElementPtr insertions = _sdf->GetElement("insertions");
+    Errors modelErrors = loadRepeated<Model>(insertions, "model",
+        this->dataPtr->insertedModels);
+    errors.insert(errors.end(), modelErrors.begin(), modelErrors.end());
+    Errors lightErrors = loadRepeated<Light>(insertions, "light",
+        this->dataPtr->insertedLights);
+    errors.insert(errors.end(), lightErrors.begin(), lightErrors.end());
+  }
+
+  if (_sdf->HasElement("deletions"))
+  {
+    for (const ElementPtr &nameElem :
+         childElements(_sdf->GetElement("deletions"), "name"))
+    {
+      this->dataPtr->deletions.push_back(nameElem->Get<std::string>());
+    }
+  }
+
+  for (const ElementPtr &modelElem : childElements(_sdf, "model"))
+  {
+    ModelState state;
+    loadModelState(modelElem, state, errors);
+    addState(this->dataPtr->modelStates, this->dataPtr->modelStateIndex,
+        state);
+  }
+
+  for (const ElementPtr &lightElem : childElements(_sdf, "light"))
+  {
+    LightState state;
+    loadStateName(lightElem, "light", state.name, errors);
+    state.pose = loadOptionalPose(lightElem);
+    addState(this->dataPtr->lightStates, this->dataPtr->lightStateIndex,
+        state);
+  }
+
+  return errors;
+}
+
+/////////////////////////////////////////////////
+const std::string &WorldState::WorldName() const
+{
+  return this->dataPtr->worldName;
+}
+
+/////////////////////////////////////////////////
+void WorldState::SetWorldName(const std::string &_name)
+{
+  this->dataPtr->worldName = _name;
+}
+
+/////////////////////////////////////////////////
+const Time &WorldState::SimTime() const
+{
+  return this->dataPtr->simTime;
+}
+
+/////////////////////////////////////////////////
+void WorldState::SetSimTime(const Time &_time)
+{
+  this->dataPtr->simTime = _time;
+}
+
+/////////////////////////////////////////////////
+const Time &WorldState::WallTime() const
+{
+  return this->dataPtr->wallTime;
+}
+
+/////////////////////////////////////////////////
+void WorldState::SetWallTime(const Time &_time)
+{
+  this->dataPtr->wallTime = _time;
+}
+
+/////////////////////////////////////////////////
+const Time &WorldState::RealTime() const
+{
+  return this->dataPtr->realTime;
+}
+
+/////////////////////////////////////////////////
+void WorldState::SetRealTime(const Time &_time)
+{
+  this->dataPtr->realTime = _time;
+}
+
+/////////////////////////////////////////////////
+uint64_t WorldState::Iterations() const
+{
+  return this->dataPtr->iterations;
+}
+
+/////////////////////////////////////////////////
+void WorldState::SetIterations(uint64_t _iterations)
+{
+  this->dataPtr->iterations = _iterations;
+}
+
+/////////////////////////////////////////////////
+uint64_t WorldState::InsertedModelCount() const
+{
+  return this->dataPtr->insertedModels.size();
+}
+
+/////////////////////////////////////////////////
+const Model *WorldState::InsertedModelByIndex(uint64_t _index) const
+{
+  if (_index < this->dataPtr->insertedModels.size())
+    return &this->dataPtr->insertedModels[_index];
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+void WorldState::AddInsertedModel(const Model &_model)
+{
+  this->dataPtr->insertedModels.push_back(_model);
+}
+
+/////////////////////////////////////////////////
+uint64_t WorldState::InsertedLightCount() const
+{
+  return this->dataPtr->insertedLights.size();
+}
+
+/////////////////////////////////////////////////
+const Light *WorldState::InsertedLightByIndex(uint64_t _index) const
+{
+  if (_index < this->dataPtr->insertedLights.size())
+    return &this->dataPtr->insertedLights[_index];
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+void WorldState::AddInsertedLight(const Light &_light)
+{
+  this->dataPtr->insertedLights.push_back(_light);
+}
+
+/////////////////////////////////////////////////
+const std::vector<std::string> &WorldState::Deletions() const
+{
+  return this->dataPtr->deletions;
+}
+
+/////////////////////////////////////////////////
+void WorldState::AddDeletion(const std::string &_name)
+{
+  this->dataPtr->deletions.push_back(_name);
+}
+
+/////////////////////////////////////////////////
+uint64_t WorldState::ModelStateCount() const
+{
+  return this->dataPtr->modelStates.size();
+}
+
+/////////////////////////////////////////////////
+const ModelState *WorldState::ModelStateByIndex(uint64_t _index) const
+{
+  if (_index < this->dataPtr->modelStates.size())
+    return &this->dataPtr->modelStates[_index];
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+const ModelState *WorldState::ModelStateByName(const std::string &_name) const
+{
+  const std::size_t pos = this->dataPtr->modelStateIndex.Find(_name);
+  return pos == NameIndex::npos ? nullptr : &this->dataPtr->modelStates[pos];
+}
+
+/////////////////////////////////////////////////
+void WorldState::AddModelState(const ModelState &_state)
+{
+  addState(this->dataPtr->modelStates, this->dataPtr->modelStateIndex,
+      _state);
+}
+
+/////////////////////////////////////////////////
+uint64_t WorldState::LightStateCount() const
+{
+  return this->dataPtr->lightStates.size();
+}
+
+/////////////////////////////////////////////////
+const LightState *WorldState::LightStateByIndex(uint64_t _index) const
+{
+  if (_index < this->dataPtr->lightStates.size())
+    return &this->dataPtr->lightStates[_index];
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+const LightState *WorldState::LightStateByName(const std::string &_name) const
+{
+  const std::size_t pos = this->dataPtr->lightStateIndex.Find(_name);
+  return pos == NameIndex::npos ? nullptr : &this->dataPtr->lightStates[pos];
+}
+
+/////////////////////////////////////////////////
+void WorldState::AddLightState(const LightState &_state)
+{
+  addState(this->dataPtr->lightStates, this->dataPtr->lightStateIndex,
+      _state);
+}
+
+/////////////////////////////////////////////////
+sdf::ElementPtr WorldState::Element() const
+{
+  return this->dataPtr->sdf;
+}
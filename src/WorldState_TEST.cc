@@ -0,0 +1,446 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <ignition/math/Pose3.hh>
+#include "sdf/Frame.hh"
+#include "sdf/Light.hh"
+#include "sdf/Link.hh"
+#include "sdf/Model.hh"
+#include "sdf/Root.hh"
+#include "sdf/World.hh"
+#include "sdf/WorldState.hh"
+
+/////////////////////////////////////////////////
+/// \brief World with two models, a frame relative to a link and two
+/// lights, followed by a state that changes it.
+const std::string kWorldWithState = R"(
+<sdf version="1.8">
+  <world name="default">
+    <model name="box">
+      <pose>1 0 0 0 0 0</pose>
+      <link name="base">
+        <pose>0 0 1 0 0 0</pose>
+      </link>
+      <model name="lid">
+        <link name="top"/>
+      </model>
+    </model>
+    <model name="ball">
+      <link name="body"/>
+    </model>
+    <frame name="above_base">
+      <pose relative_to="box::base">0 0 2 0 0 0</pose>
+    </frame>
+    <light type="point" name="lamp">
+      <pose>0 0 5 0 0 0</pose>
+    </light>
+    <light type="point" name="spot"/>
+    <state world_name="default">
+      <sim_time>12 500</sim_time>
+      <iterations>42</iterations>
+      <model name="box">
+        <pose>2 0 0 0 0 0</pose>
+        <scale>1 2 3</scale>
+        <joint name="hinge">
+          <angle axis="1">0.5</angle>
+        </joint>
+        <link name="base">
+          <pose>0 0 3 0 0 0</pose>
+          <velocity>1 0 0 0 0 0</velocity>
+        </link>
+        <model name="lid">
+          <pose>0 1 0 0 0 0</pose>
+        </model>
+      </model>
+      <light name="lamp">
+        <pose>0 0 6 0 0 0</pose>
+      </light>
+    </state>
+  </world>
+</sdf>)";
+
+/////////////////////////////////////////////////
+TEST(DOMWorldState, Construction)
+{
+  sdf::WorldState state;
+  EXPECT_EQ(nullptr, state.Element());
+  EXPECT_TRUE(state.WorldName().empty());
+  EXPECT_EQ(0, state.SimTime().sec);
+  EXPECT_EQ(0u, state.Iterations());
+  EXPECT_EQ(0u, state.InsertedModelCount());
+  EXPECT_EQ(nullptr, state.InsertedModelByIndex(0));
+  EXPECT_EQ(0u, state.InsertedLightCount());
+  EXPECT_EQ(nullptr, state.InsertedLightByIndex(0));
+  EXPECT_TRUE(state.Deletions().empty());
+  EXPECT_EQ(0u, state.ModelStateCount());
+  EXPECT_EQ(nullptr, state.ModelStateByIndex(0));
+  EXPECT_EQ(nullptr, state.ModelStateByName("box"));
+  EXPECT_EQ(0u, state.LightStateCount());
+  EXPECT_EQ(nullptr, state.LightStateByName("lamp"));
+
+  state.SetWorldName("default");
+  state.SetSimTime(sdf::Time(1, 2));
+  state.SetWallTime(sdf::Time(3, 4));
+  state.SetRealTime(sdf::Time(5, 6));
+  state.SetIterations(7);
+  state.AddDeletion("ball");
+
+  sdf::ModelState modelState;
+  modelState.name = "box";
+  modelState.pose = ignition::math::Pose3d(1, 2, 3, 0, 0, 0);
+  state.AddModelState(modelState);
+
+  // A second state for the same model replaces the first one.
+  modelState.pose = ignition::math::Pose3d(4, 5, 6, 0, 0, 0);
+  state.AddModelState(modelState);
+  ASSERT_EQ(1u, state.ModelStateCount());
+  ASSERT_NE(nullptr, state.ModelStateByName("box"));
+  EXPECT_EQ(ignition::math::Pose3d(4, 5, 6, 0, 0, 0),
+            *state.ModelStateByName("box")->pose);
+
+  sdf::LightState lightState;
+  lightState.name = "lamp";
+  state.AddLightState(lightState);
+  EXPECT_EQ(1u, state.LightStateCount());
+
+  sdf::WorldState copy(state);
+  EXPECT_EQ("default", copy.WorldName());
+  EXPECT_EQ(3, copy.WallTime().sec);
+  EXPECT_EQ(6, copy.RealTime().nsec);
+  EXPECT_EQ(7u, copy.Iterations());
+  ASSERT_EQ(1u, copy.Deletions().size());
+  EXPECT_EQ("ball", copy.Deletions()[0]);
+  EXPECT_NE(nullptr, copy.ModelStateByName("box"));
+
+  sdf::WorldState moved(std::move(copy));
+  EXPECT_EQ(1u, moved.LightStateCount());
+  EXPECT_NE(nullptr, moved.LightStateByName("lamp"));
+
+  sdf::WorldState assigned;
+  assigned = moved;
+  EXPECT_EQ(1u, assigned.ModelStateCount());
+
+  sdf::WorldState moveAssigned;
+  moveAssigned = std::move(assigned);
+  EXPECT_EQ("default", moveAssigned.WorldName());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMWorldState, Load)
+{
+  sdf::WorldState state;
+  sdf::Errors errors;
+
+  // Bad element name
+  sdf::ElementPtr sdf(new sdf::Element());
+  sdf->SetName("bad");
+  errors = state.Load(sdf);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_INCORRECT_TYPE, errors[0].Code());
+  EXPECT_NE(nullptr, state.Element());
+
+  sdf::Root root;
+  errors = root.LoadSdfString(kWorldWithState);
+  EXPECT_TRUE(errors.empty());
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+
+  errors = state.Load(world->Element()->GetElement("state"));
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ("default", state.WorldName());
+  EXPECT_EQ(12, state.SimTime().sec);
+  EXPECT_EQ(500, state.SimTime().nsec);
+  EXPECT_EQ(42u, state.Iterations());
+  EXPECT_EQ(0u, state.InsertedModelCount());
+  EXPECT_TRUE(state.Deletions().empty());
+
+  ASSERT_EQ(1u, state.ModelStateCount());
+  const sdf::ModelState *box = state.ModelStateByName("box");
+  ASSERT_NE(nullptr, box);
+  EXPECT_EQ(ignition::math::Pose3d(2, 0, 0, 0, 0, 0), *box->pose);
+  EXPECT_EQ(ignition::math::Vector3d(1, 2, 3), *box->scale);
+
+  ASSERT_EQ(1u, box->joints.size());
+  EXPECT_EQ("hinge", box->joints[0].name);
+  ASSERT_EQ(2u, box->joints[0].angles.size());
+  EXPECT_DOUBLE_EQ(0.5, box->joints[0].angles[1]);
+
+  ASSERT_EQ(1u, box->links.size());
+  EXPECT_EQ("base", box->links[0].name);
+  EXPECT_EQ(ignition::math::Pose3d(0, 0, 3, 0, 0, 0), *box->links[0].pose);
+  EXPECT_EQ(ignition::math::Pose3d(1, 0, 0, 0, 0, 0),
+            *box->links[0].velocity);
+  EXPECT_FALSE(box->links[0].acceleration);
+  EXPECT_FALSE(box->links[0].wrench);
+
+  ASSERT_EQ(1u, box->models.size());
+  EXPECT_EQ("lid", box->models[0].name);
+  EXPECT_FALSE(box->models[0].scale);
+
+  ASSERT_EQ(1u, state.LightStateCount());
+  EXPECT_EQ(ignition::math::Pose3d(0, 0, 6, 0, 0, 0),
+            *state.LightStateByIndex(0)->pose);
+}
+
+/////////////////////////////////////////////////
+TEST(DOMWorldState, ApplyPoses)
+{
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(kWorldWithState);
+  EXPECT_TRUE(errors.empty());
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+
+  sdf::WorldState state;
+  errors = state.Load(world->Element()->GetElement("state"));
+  EXPECT_TRUE(errors.empty());
+
+  errors = root.ApplyState(state);
+  EXPECT_TRUE(errors.empty());
+
+  const sdf::Model *box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  EXPECT_EQ(ignition::math::Pose3d(2, 0, 0, 0, 0, 0), box->RawPose());
+
+  // The graph edges are updated, so the poses of the entities that depend
+  // on the changed ones are resolved with the new poses.
+  ignition::math::Pose3d pose;
+  errors = box->SemanticPose().Resolve(pose, "world");
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(ignition::math::Pose3d(2, 0, 0, 0, 0, 0), pose);
+
+  const sdf::Link *base = box->LinkByName("base");
+  ASSERT_NE(nullptr, base);
+  EXPECT_EQ(ignition::math::Pose3d(0, 0, 3, 0, 0, 0), base->RawPose());
+  errors = base->SemanticPose().Resolve(pose, "__model__");
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(ignition::math::Pose3d(0, 0, 3, 0, 0, 0), pose);
+
+  const sdf::Frame *frame = world->FrameByName("above_base");
+  ASSERT_NE(nullptr, frame);
+  errors = frame->SemanticPose().Resolve(pose, "world");
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(ignition::math::Pose3d(2, 0, 5, 0, 0, 0), pose);
+
+  const sdf::Model *lid = box->ModelByName("lid");
+  ASSERT_NE(nullptr, lid);
+  errors = lid->SemanticPose().Resolve(pose, "__model__");
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(ignition::math::Pose3d(0, 1, 0, 0, 0, 0), pose);
+
+  const sdf::Light *lamp = world->LightByIndex(0);
+  ASSERT_NE(nullptr, lamp);
+  EXPECT_EQ(ignition::math::Pose3d(0, 0, 6, 0, 0, 0), lamp->RawPose());
+
+  // Entities that are not in the state keep their poses.
+  const sdf::Model *ball = world->ModelByName("ball");
+  ASSERT_NE(nullptr, ball);
+  EXPECT_EQ(ignition::math::Pose3d::Zero, ball->RawPose());
+}
+
+/////////////////////////////////////////////////
+TEST(DOMWorldState, InsertAndDelete)
+{
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(kWorldWithState);
+  EXPECT_TRUE(errors.empty());
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+
+  // Take a model to insert from another world.
+  sdf::Root other;
+  errors = other.LoadSdfString(R"(
+<sdf version="1.8">
+  <world name="other">
+    <model name="crate">
+      <pose>0 3 0 0 0 0</pose>
+      <link name="body">
+        <pose>0 0 1 0 0 0</pose>
+      </link>
+    </model>
+    <light type="point" name="torch"/>
+  </world>
+</sdf>)");
+  EXPECT_TRUE(errors.empty());
+
+  sdf::WorldState state;
+  state.AddDeletion("ball");
+  state.AddDeletion("spot");
+  state.AddInsertedModel(*other.WorldByIndex(0)->ModelByIndex(0));
+  state.AddInsertedLight(*other.WorldByIndex(0)->LightByIndex(0));
+
+  sdf::ModelState crateState;
+  crateState.name = "crate";
+  crateState.pose = ignition::math::Pose3d(0, 4, 0, 0, 0, 0);
+  state.AddModelState(crateState);
+
+  errors = root.ApplyState(state);
+  EXPECT_TRUE(errors.empty());
+
+  ASSERT_EQ(2u, world->ModelCount());
+  EXPECT_EQ("box", world->ModelByIndex(0)->Name());
+  EXPECT_EQ("crate", world->ModelByIndex(1)->Name());
+  EXPECT_FALSE(world->ModelNameExists("ball"));
+  ASSERT_EQ(2u, world->LightCount());
+  EXPECT_EQ("lamp", world->LightByIndex(0)->Name());
+  EXPECT_EQ("torch", world->LightByIndex(1)->Name());
+  EXPECT_FALSE(world->LightNameExists("spot"));
+  EXPECT_TRUE(world->LightNameExists("torch"));
+
+  // The inserted model resolves its poses in the graphs of the world.
+  const sdf::Model *crate = world->ModelByName("crate");
+  ASSERT_NE(nullptr, crate);
+  ignition::math::Pose3d pose;
+  errors = crate->SemanticPose().Resolve(pose, "world");
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(ignition::math::Pose3d(0, 4, 0, 0, 0, 0), pose);
+  errors = crate->LinkByName("body")->SemanticPose().Resolve(pose, "__model__");
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(ignition::math::Pose3d(0, 0, 1, 0, 0, 0), pose);
+
+  // The models that were kept still resolve their poses.
+  const sdf::Frame *frame = world->FrameByName("above_base");
+  ASSERT_NE(nullptr, frame);
+  errors = frame->SemanticPose().Resolve(pose, "world");
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(ignition::math::Pose3d(1, 0, 3, 0, 0, 0), pose);
+}
+
+/////////////////////////////////////////////////
+TEST(DOMWorldState, DeleteReferencedModel)
+{
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(R"(
+<sdf version="1.8">
+  <world name="default">
+    <model name="ball">
+      <link name="body"/>
+    </model>
+    <model name="box">
+      <pose relative_to="ball">1 0 0 0 0 0</pose>
+      <link name="base"/>
+    </model>
+    <frame name="on_ball" attached_to="ball::body">
+      <pose>0 0 1 0 0 0</pose>
+    </frame>
+  </world>
+</sdf>)");
+  EXPECT_TRUE(errors.empty()) << errors;
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+
+  // The frame attached to a link of the deleted model and the model whose
+  // pose is relative to it are reported, the other vertices are kept.
+  sdf::WorldState state;
+  state.AddDeletion("ball");
+  errors = root.ApplyState(state);
+  ASSERT_EQ(3u, errors.size()) << errors;
+  EXPECT_EQ(sdf::ErrorCode::FRAME_ATTACHED_TO_GRAPH_ERROR, errors[0].Code());
+  EXPECT_NE(std::string::npos, errors[0].Message().find("on_ball"));
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR, errors[1].Code());
+  EXPECT_EQ(sdf::ErrorCode::POSE_RELATIVE_TO_GRAPH_ERROR, errors[2].Code());
+
+  ASSERT_EQ(1u, world->ModelCount());
+  const sdf::Model *box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  ignition::math::Pose3d pose;
+  errors = box->LinkByName("base")->SemanticPose().Resolve(pose, "__model__");
+  EXPECT_TRUE(errors.empty()) << errors;
+
+  // A model with the name of the deleted one can be inserted again.
+  sdf::Root other;
+  errors = other.LoadSdfString(R"(
+<sdf version="1.8">
+  <world name="other">
+    <model name="ball">
+      <pose>0 0 2 0 0 0</pose>
+      <link name="body"/>
+    </model>
+  </world>
+</sdf>)");
+  EXPECT_TRUE(errors.empty()) << errors;
+  state = sdf::WorldState();
+  state.AddInsertedModel(*other.WorldByIndex(0)->ModelByIndex(0));
+  errors = root.ApplyState(state);
+  EXPECT_TRUE(errors.empty()) << errors;
+  errors = world->ModelByName("ball")->SemanticPose().Resolve(pose, "world");
+  EXPECT_TRUE(errors.empty()) << errors;
+  EXPECT_EQ(ignition::math::Pose3d(0, 0, 2, 0, 0, 0), pose);
+}
+
+/////////////////////////////////////////////////
+TEST(DOMWorldState, ApplyErrors)
+{
+  sdf::Root root;
+  sdf::Errors errors = root.LoadSdfString(kWorldWithState);
+  EXPECT_TRUE(errors.empty());
+  const sdf::World *world = root.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+
+  // A state of another world is not applied, by the root or by the world.
+  sdf::WorldState state;
+  state.SetWorldName("other");
+  state.AddDeletion("ball");
+  errors = root.ApplyState(state);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_INVALID, errors[0].Code());
+  EXPECT_TRUE(world->ModelNameExists("ball"));
+
+  sdf::World copy = *world;
+  errors = copy.ApplyState(state);
+  ASSERT_EQ(1u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_INVALID, errors[0].Code());
+  EXPECT_TRUE(copy.ModelNameExists("ball"));
+  EXPECT_TRUE(root.WorldNameExists("default"));
+
+  // Unknown entities are reported and skipped.
+  state = sdf::WorldState();
+  state.AddDeletion("missing");
+  state.AddInsertedModel(*world->ModelByName("ball"));
+
+  sdf::ModelState boxState;
+  boxState.name = "box";
+  boxState.pose = ignition::math::Pose3d(3, 0, 0, 0, 0, 0);
+  boxState.links.push_back({"missing", {}, {}, {}, {}});
+  boxState.models.emplace_back().name = "missing";
+  state.AddModelState(boxState);
+
+  sdf::ModelState missingState;
+  missingState.name = "missing";
+  state.AddModelState(missingState);
+
+  sdf::LightState lightState;
+  lightState.name = "missing";
+  state.AddLightState(lightState);
+
+  errors = root.ApplyState(state);
+  ASSERT_EQ(6u, errors.size());
+  EXPECT_EQ(sdf::ErrorCode::ELEMENT_INVALID, errors[0].Code());
+  EXPECT_NE(std::string::npos, errors[0].Message().find("Deleted entity"));
+  EXPECT_EQ(sdf::ErrorCode::DUPLICATE_NAME, errors[1].Code());
+  EXPECT_NE(std::string::npos, errors[2].Message().find("link"));
+  EXPECT_NE(std::string::npos, errors[3].Message().find("nested model"));
+  EXPECT_NE(std::string::npos, errors[4].Message().find("model"));
+  EXPECT_NE(std::string::npos, errors[5].Message().find("light"));
+
+  EXPECT_EQ(2u, world->ModelCount());
+  EXPECT_EQ(ignition::math::Pose3d(3, 0, 0, 0, 0, 0),
+            world->ModelByName("box")->RawPose());
+}
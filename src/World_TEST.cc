@@ -15,9 +15,13 @@
  *
 */
 
+#include <string>
 #include <gtest/gtest.h>
 #include <ignition/math/Color.hh>
+#include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
+#include "sdf/Link.hh"
+#include "sdf/Model.hh"
 #include "sdf/World.hh"
 
 /////////////////////////////////////////////////
@@ -290,6 +294,18 @@ TEST(DOMWorld, Set)
 
   world.SetMagneticField({1.2, -2.3, 4.5});
   EXPECT_EQ(ignition::math::Vector3d(1.2, -2.3, 4.5), world.MagneticField());
+
+  EXPECT_EQ(1u, world.LoadThreads());
+  world.SetLoadThreads(0);
+  EXPECT_EQ(0u, world.LoadThreads());
+
+  EXPECT_FALSE(world.ModelInstancing());
+  world.SetModelInstancing(true);
+  EXPECT_TRUE(world.ModelInstancing());
+
+  sdf::World world2(world);
+  EXPECT_EQ(0u, world2.LoadThreads());
+  EXPECT_TRUE(world2.ModelInstancing());
 }
 
 /////////////////////////////////////////////////
@@ -327,3 +343,79 @@ TEST(DOMWorld, SetScene)
   EXPECT_TRUE(world.Scene()->Shadows());
   EXPECT_TRUE(world.Scene()->OriginVisual());
 }
+
+/////////////////////////////////////////////////
+/// \brief Create an element with a name attribute.
+/// \param[in] _type Name of the element.
+/// \param[in] _name Value of the name attribute.
+/// \param[in] _parent Parent of the element, or nullptr.
+/// \return The new element.
+sdf::ElementPtr namedElement(const std::string &_type,
+    const std::string &_name, const sdf::ElementPtr &_parent)
+{
+  sdf::ElementPtr elem(new sdf::Element);
+  elem->SetName(_type);
+  elem->AddAttribute("name", "string", "", true);
+  elem->GetAttribute("name")->SetFromString(_name);
+  if (_parent)
+  {
+    elem->SetParent(_parent);
+    _parent->InsertElement(elem);
+  }
+  return elem;
+}
+
+/////////////////////////////////////////////////
+TEST(DOMWorld, ModelInstancing)
+{
+  sdf::ElementPtr worldElem = namedElement("world", "default", nullptr);
+  for (int i = 0; i < 4; ++i)
+  {
+    sdf::ElementPtr modelElem =
+        namedElement("model", "robot" + std::to_string(i), worldElem);
+    namedElement("link", "base", modelElem);
+    namedElement("link", "arm", modelElem);
+  }
+  sdf::ElementPtr otherElem = namedElement("model", "other", worldElem);
+  namedElement("link", "base", otherElem);
+  namedElement("link", "wheel", otherElem);
+  namedElement("model", "robot2", worldElem);
+
+  sdf::World separate;
+  sdf::Errors separateErrors = separate.Load(worldElem);
+
+  sdf::World instanced;
+  instanced.SetModelInstancing(true);
+  sdf::Errors instancedErrors = instanced.Load(worldElem);
+
+  // The duplicate model name is reported in both cases.
+  ASSERT_EQ(separateErrors.size(), instancedErrors.size());
+  for (std::size_t i = 0; i < separateErrors.size(); ++i)
+    EXPECT_EQ(separateErrors[i].Message(), instancedErrors[i].Message());
+
+  ASSERT_EQ(5u, separate.ModelCount());
+  ASSERT_EQ(5u, instanced.ModelCount());
+  for (uint64_t i = 0; i < separate.ModelCount(); ++i)
+  {
+    EXPECT_FALSE(separate.ModelByIndex(i)->IsInstance());
+    EXPECT_EQ(separate.ModelByIndex(i)->Name(),
+              instanced.ModelByIndex(i)->Name());
+  }
+
+  // The robots share a single prototype, and the other model is loaded on
+  // its own.
+  const sdf::Model *robot0 = instanced.ModelByName("robot0");
+  const sdf::Model *robot3 = instanced.ModelByName("robot3");
+  ASSERT_NE(nullptr, robot0);
+  ASSERT_NE(nullptr, robot3);
+  EXPECT_TRUE(robot0->IsInstance());
+  EXPECT_EQ(robot0->Prototype(), robot3->Prototype());
+  EXPECT_EQ(robot0->LinkByName("arm"), robot3->LinkByName("arm"));
+  EXPECT_FALSE(instanced.ModelByName("other")->IsInstance());
+
+  // The shared links resolve their poses in the graphs of the prototype.
+  ignition::math::Pose3d pose;
+  EXPECT_TRUE(
+      robot3->LinkByName("arm")->SemanticPose().Resolve(pose).empty());
+  EXPECT_EQ(ignition::math::Pose3d::Zero, pose);
+}
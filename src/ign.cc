@@ -26,6 +26,7 @@
 #include "sdf/system_util.hh"
 
 #include "FrameSemantics.hh"
+#include "GraphExport.hh"
 #include "ScopedGraph.hh"
 #include "ign.hh"
 
@@ -163,8 +164,9 @@ extern "C" SDFORMAT_VISIBLE int cmdPrint(const char *_path)
 
 //////////////////////////////////////////////////
 // cppcheck-suppress unusedFunction
-extern "C" SDFORMAT_VISIBLE int cmdGraph(
-    const char *_graphType, const char *_path)
+extern "C" SDFORMAT_VISIBLE int cmdGraphExport(
+    const char *_graphType, const char *_format, const char *_name,
+    const char *_scope, int _depth, const char *_path)
 {
   if (!sdf::filesystem::exists(_path))
   {
@@ -172,6 +174,20 @@ extern "C" SDFORMAT_VISIBLE int cmdGraph(
     return -1;
   }
 
+  sdf::GraphExportOptions options;
+  if (std::strcmp(_format, "json") == 0)
+  {
+    options.format = sdf::GraphFormat::JSON;
+  }
+  else if (std::strcmp(_format, "dot") != 0)
+  {
+    std::cerr << R"(Only "dot" and "json" graph formats are supported)"
+              << std::endl;
+    return -1;
+  }
+  options.scope = _scope;
+  options.depth = _depth;
+
   sdf::Root root;
   sdf::Errors errors = root.Load(_path);
   if (!errors.empty())
@@ -179,49 +195,67 @@ extern "C" SDFORMAT_VISIBLE int cmdGraph(
     std::cerr << errors << std::endl;
   }
 
-  if (std::strcmp(_graphType, "pose") == 0)
+  // Export the graphs built by Root::Load instead of building new ones.
+  const std::string name = _name;
+  auto exportRootGraph = [&](const auto &_graph)
   {
-    auto ownedGraph = std::make_shared<sdf::PoseRelativeToGraph>();
-    sdf::ScopedGraph<sdf::PoseRelativeToGraph> graph(ownedGraph);
-    if (root.WorldCount() > 0)
-    {
-      errors = sdf::buildPoseRelativeToGraph(graph, root.WorldByIndex(0));
-    }
-    else if (root.ModelCount() > 0)
+    if (!_graph)
     {
-      errors = sdf::buildPoseRelativeToGraph(graph, root.ModelByIndex(0));
+      std::cerr << "Error: Unable to find a world or model"
+                << (name.empty() ? "" : " with name [" + name + "]")
+                << " in file [" << _path << "].\n";
+      return -1;
     }
 
+    errors = sdf::exportGraph(std::cout, _graph, options);
     if (!errors.empty())
     {
       std::cerr << errors << std::endl;
+      return -1;
     }
-    std::cout << graph.Graph() << std::endl;
+    return 0;
+  };
+
+  if (std::strcmp(_graphType, "pose") == 0)
+  {
+    return exportRootGraph(sdf::RootGraphs::PoseRelativeTo(root, name));
   }
   else if (std::strcmp(_graphType, "frame") == 0)
   {
-    auto ownedGraph = std::make_shared<sdf::FrameAttachedToGraph>();
-    sdf::ScopedGraph<sdf::FrameAttachedToGraph> graph(ownedGraph);
-    if (root.WorldCount() > 0)
-    {
-      errors = sdf::buildFrameAttachedToGraph(graph, root.WorldByIndex(0));
-    }
-    else if (root.ModelCount() > 0)
-    {
-      errors = sdf::buildFrameAttachedToGraph(graph, root.ModelByIndex(0));
-    }
+    return exportRootGraph(sdf::RootGraphs::FrameAttachedTo(root, name));
+  }
 
-    if (!errors.empty())
-    {
-      std::cerr << errors << std::endl;
-    }
-    std::cout << graph.Graph() << std::endl;
+  std::cerr << R"(Only "pose" and "frame" graph types are supported)"
+            << std::endl;
+  return 0;
+}
+
+//////////////////////////////////////////////////
+// cppcheck-suppress unusedFunction
+extern "C" SDFORMAT_VISIBLE int cmdGraph(
+    const char *_graphType, const char *_path)
+{
+  return cmdGraphExport(_graphType, "dot", "", "", -1, _path);
+}
+
+//////////////////////////////////////////////////
+// cppcheck-suppress unusedFunction
+extern "C" SDFORMAT_VISIBLE int cmdMemory(const char *_path)
+{
+  if (!sdf::filesystem::exists(_path))
+  {
+    std::cerr << "Error: File [" << _path << "] does not exist.\n";
+    return -1;
   }
-  else
+
+  sdf::Root root;
+  sdf::Errors errors = root.Load(_path);
+  if (!errors.empty())
   {
-    std::cerr << R"(Only "pose" and "frame" graph types are supported)"
-              << std::endl;
+    std::cerr << errors << std::endl;
   }
 
+  std::cout << root.MemoryUsage();
+
   return 0;
 }
@@ -900,6 +900,24 @@ TEST(print, SDF)
   }
 }
 
+/////////////////////////////////////////////////
+TEST(memory, SDF)
+{
+  std::string path = PROJECT_SOURCE_PATH;
+  path += "/test/sdf/box_plane_low_friction_test.world";
+
+  std::string output =
+    custom_exec_str(g_ignCommand + " sdf -m " + path + g_sdfVersion);
+  EXPECT_EQ(0u, output.find("Elements:"));
+  EXPECT_NE(std::string::npos, output.find("Description bytes:"));
+  EXPECT_NE(std::string::npos, output.find("Total bytes:"));
+
+  // A missing file.
+  output = custom_exec_str(
+      g_ignCommand + " sdf -m " + path + ".missing" + g_sdfVersion);
+  EXPECT_NE(std::string::npos, output.find("does not exist"));
+}
+
 /////////////////////////////////////////////////
 TEST(GraphCmd, WorldPoseRelativeTo)
 {
@@ -1122,6 +1140,55 @@ TEST(GraphCmd, ModelFrameAttachedTo)
   EXPECT_EQ(sdf::trim(expected.str()), sdf::trim(output));
 }
 
+/////////////////////////////////////////////////
+TEST(GraphCmd, WorldPoseRelativeToScope)
+{
+  const std::string pathBase = std::string(PROJECT_SOURCE_PATH) + "/test/sdf";
+  const std::string path =
+    pathBase + "/world_relative_to_nested_reference.sdf";
+
+  // The frames whose poses are relative to the nested model M1::CM1.
+  std::string output = custom_exec_str(g_ignCommand +
+      " sdf -g pose --graph-scope M1::CM1 " + path + g_sdfVersion);
+
+  std::stringstream expected;
+  expected << "digraph {\n"
+    << "  8 [label=\"M1::CM1 (8)\"];\n"
+    << "  9 [label=\"M1::CM1::__model__ (9)\"];\n"
+    << "  10 [label=\"M1::CM1::L (10)\"];\n"
+    << "  15 [label=\"F6 (15)\"];\n"
+    << "  16 [label=\"F7 (16)\"];\n"
+    << "  8 -> 9 [label=0];\n"
+    << "  9 -> 10 [label=1];\n"
+    << "  8 -> 15 [label=1];\n"
+    << "  10 -> 16 [label=1];\n"
+    << "}";
+  EXPECT_EQ(sdf::trim(expected.str()), sdf::trim(output));
+
+  // The same, one edge deep, in JSON.
+  output = custom_exec_str(g_ignCommand +
+      " sdf -g pose --graph-format json --graph-scope M1::CM1"
+      " --graph-depth 1 " + path + g_sdfVersion);
+  EXPECT_EQ(0u, output.find("{\"vertices\": [\n"));
+  EXPECT_NE(std::string::npos, output.find("\"name\": \"M1::CM1::__model__\""));
+  EXPECT_NE(std::string::npos, output.find("\"name\": \"F6\""));
+  EXPECT_EQ(std::string::npos, output.find("\"name\": \"M1::CM1::L\""));
+  EXPECT_NE(std::string::npos,
+      output.find("{\"id\": 14, \"tail\": 8, \"head\": 15, "));
+
+  // A missing scope frame.
+  output = custom_exec_str(g_ignCommand +
+      " sdf -g pose --graph-scope M1::missing " + path + g_sdfVersion);
+  EXPECT_NE(std::string::npos, output.find(
+      "Unable to find vertex with name [M1::missing] in graph."));
+
+  // A missing world.
+  output = custom_exec_str(g_ignCommand +
+      " sdf -g frame --graph-root missing " + path + g_sdfVersion);
+  EXPECT_NE(std::string::npos, output.find(
+      "Unable to find a world or model with name [missing]"));
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
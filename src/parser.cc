@@ -18,12 +18,16 @@
 #include <iostream>
 #include <cstdlib>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <ignition/math/SemanticVersion.hh>
 
 #include "sdf/Console.hh"
+#include "sdf/ElementVisitor.hh"
 #include "sdf/Filesystem.hh"
 #include "sdf/Frame.hh"
 #include "sdf/Joint.hh"
@@ -38,6 +42,7 @@
 
 #include "Converter.hh"
 #include "FrameSemantics.hh"
+#include "ParserCache.hh"
 #include "ScopedGraph.hh"
 #include "Utils.hh"
 #include "parser_private.hh"
@@ -81,6 +86,16 @@ bool readStringInternal(
     const bool _convert,
     Errors &_errors);
 
+//////////////////////////////////////////////////
+/// \brief Get the mutex that serializes URDF conversions, since the URDF
+/// parser keeps its state in global variables.
+/// \return The mutex.
+static std::mutex &urdfMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
 //////////////////////////////////////////////////
 template <typename TPtr>
 static inline bool _initFile(const std::string &_filename, TPtr _sdf)
@@ -166,6 +181,9 @@ inline tinyxml2::XMLElement *_initDocGetElement(tinyxml2::XMLDocument *_xmlDoc)
 //////////////////////////////////////////////////
 bool initDoc(tinyxml2::XMLDocument *_xmlDoc, SDFPtr _sdf)
 {
+  // The default values of the description are parsed as numbers.
+  useClassicNumericLocale();
+
   auto element = _initDocGetElement(_xmlDoc);
   if (!element)
   {
@@ -178,6 +196,9 @@ bool initDoc(tinyxml2::XMLDocument *_xmlDoc, SDFPtr _sdf)
 //////////////////////////////////////////////////
 bool initDoc(tinyxml2::XMLDocument *_xmlDoc, ElementPtr _sdf)
 {
+  // The default values of the description are parsed as numbers.
+  useClassicNumericLocale();
+
   auto element = _initDocGetElement(_xmlDoc);
   if (!element)
   {
@@ -394,7 +415,7 @@ bool readFileInternal(const std::string &_filename, SDFPtr _sdf,
       const bool _convert, Errors &_errors)
 {
   tinyxml2::XMLDocument xmlDoc;
-  std::string filename = sdf::findFile(_filename, true, true);
+  std::string filename = ParserCache::ResolveFile(_filename, true, true);
 
   if (filename.empty())
   {
@@ -428,9 +449,12 @@ bool readFileInternal(const std::string &_filename, SDFPtr _sdf,
   }
   else if (URDF2SDF::IsURDF(filename))
   {
-    URDF2SDF u2g;
     tinyxml2::XMLDocument doc;
-    u2g.InitModelFile(filename, &doc);
+    {
+      std::lock_guard<std::mutex> lock(urdfMutex());
+      URDF2SDF u2g;
+      u2g.InitModelFile(filename, &doc);
+    }
     if (sdf::readDoc(&doc, _sdf, "urdf file", _convert, _errors))
     {
       sdfdbg << "parse from urdf file [" << _filename << "].\n";
@@ -489,9 +513,12 @@ bool readStringInternal(const std::string &_xmlString, SDFPtr _sdf,
   }
   else
   {
-    URDF2SDF u2g;
     tinyxml2::XMLDocument doc;
-    u2g.InitModelString(_xmlString, &doc);
+    {
+      std::lock_guard<std::mutex> lock(urdfMutex());
+      URDF2SDF u2g;
+      u2g.InitModelString(_xmlString, &doc);
+    }
 
     if (sdf::readDoc(&doc, _sdf, "urdf string", _convert, _errors))
     {
@@ -547,6 +574,10 @@ bool readString(const std::string &_xmlString, ElementPtr _sdf, Errors &_errors)
 bool readDoc(tinyxml2::XMLDocument *_xmlDoc, SDFPtr _sdf,
     const std::string &_source, bool _convert, Errors &_errors)
 {
+  // Parse numbers with a dot as decimal separator, see
+  // useClassicNumericLocale.
+  useClassicNumericLocale();
+
   if (!_xmlDoc)
   {
     sdfwarn << "Could not parse the xml from source[" << _source << "]\n";
@@ -620,6 +651,10 @@ bool readDoc(tinyxml2::XMLDocument *_xmlDoc, SDFPtr _sdf,
 bool readDoc(tinyxml2::XMLDocument *_xmlDoc, ElementPtr _sdf,
              const std::string &_source, bool _convert, Errors &_errors)
 {
+  // Parse numbers with a dot as decimal separator, see
+  // useClassicNumericLocale.
+  useClassicNumericLocale();
+
   if (!_xmlDoc)
   {
     sdfwarn << "Could not parse the xml\n";
@@ -943,7 +978,7 @@ bool readXml(tinyxml2::XMLElement *_xml, ElementPtr _sdf, Errors &_errors)
         if (elemXml->FirstChildElement("uri"))
         {
           std::string uri = elemXml->FirstChildElement("uri")->GetText();
-          modelPath = sdf::findFile(uri, true, true);
+          modelPath = ParserCache::ResolveFile(uri, true, true);
 
           // Test the model path
           if (modelPath.empty())
@@ -982,16 +1017,7 @@ bool readXml(tinyxml2::XMLElement *_xml, ElementPtr _sdf, Errors &_errors)
         // NOTE: sdf::init is an expensive call. For performance reason,
         // a new sdf pointer is created here by cloning a fresh sdf template
         // pointer instead of calling init every iteration.
-        // SDFPtr includeSDF(new SDF);
-        // init(includeSDF);
-        static SDFPtr includeSDFTemplate;
-        if (!includeSDFTemplate)
-        {
-          includeSDFTemplate.reset(new SDF);
-          init(includeSDFTemplate);
-        }
-        SDFPtr includeSDF(new SDF);
-        includeSDF->Root(includeSDFTemplate->Root()->Clone());
+        SDFPtr includeSDF = ParserCache::NewSDF();
 
         if (!readFile(filename, includeSDF))
         {
@@ -1210,57 +1236,70 @@ void copyChildren(ElementPtr _sdf,
                   tinyxml2::XMLElement *_xml,
                   const bool _onlyUnknown)
 {
-  // Iterate over all the child elements
-  tinyxml2::XMLElement *elemXml = nullptr;
-  for (elemXml = _xml->FirstChildElement(); elemXml;
-       elemXml = elemXml->NextSiblingElement())
+  // Pairs of elements whose children still need to be copied, processed
+  // with an explicit stack so that deep documents do not recurse.
+  std::vector<std::pair<ElementPtr, tinyxml2::XMLElement *>> pending;
+  pending.emplace_back(_sdf, _xml);
+
+  while (!pending.empty())
   {
-    std::string elem_name = elemXml->Name();
+    ElementPtr sdfParent = pending.back().first;
+    tinyxml2::XMLElement *xmlParent = pending.back().second;
+    pending.pop_back();
 
-    if (_sdf->HasElementDescription(elem_name))
+    // Iterate over all the child elements
+    tinyxml2::XMLElement *elemXml = nullptr;
+    for (elemXml = xmlParent->FirstChildElement(); elemXml;
+         elemXml = elemXml->NextSiblingElement())
     {
-      if (!_onlyUnknown)
+      std::string elem_name = elemXml->Name();
+
+      if (sdfParent->HasElementDescription(elem_name))
       {
-        sdf::ElementPtr element = _sdf->AddElement(elem_name);
+        if (!_onlyUnknown)
+        {
+          sdf::ElementPtr element = sdfParent->AddElement(elem_name);
 
-        // FIXME: copy attributes
-        for (const auto *attribute = elemXml->FirstAttribute();
+          // FIXME: copy attributes
+          for (const auto *attribute = elemXml->FirstAttribute();
+               attribute; attribute = attribute->Next())
+          {
+            element->GetAttribute(attribute->Name())->SetFromString(
+              attribute->Value());
+          }
+
+          // copy value
+          std::string value = elemXml->GetText();
+          if (!value.empty())
+          {
+            element->GetValue()->SetFromString(value);
+          }
+          pending.emplace_back(element, elemXml);
+        }
+      }
+      else
+      {
+        ElementPtr element(new Element);
+        element->SetParent(sdfParent);
+        element->SetName(elem_name);
+        if (elemXml->GetText() != nullptr)
+        {
+          element->AddValue("string", elemXml->GetText(), "1");
+        }
+
+        for (const tinyxml2::XMLAttribute *attribute =
+               elemXml->FirstAttribute();
              attribute; attribute = attribute->Next())
         {
+          element->AddAttribute(attribute->Name(), "string", "", 1, "");
           element->GetAttribute(attribute->Name())->SetFromString(
             attribute->Value());
         }
 
-        // copy value
-        std::string value = elemXml->GetText();
-        if (!value.empty())
-        {
-          element->GetValue()->SetFromString(value);
-        }
-        copyChildren(element, elemXml, _onlyUnknown);
+        sdfParent->InsertElement(element);
+        pending.emplace_back(element, elemXml);
       }
     }
-    else
-    {
-      ElementPtr element(new Element);
-      element->SetParent(_sdf);
-      element->SetName(elem_name);
-      if (elemXml->GetText() != nullptr)
-      {
-        element->AddValue("string", elemXml->GetText(), "1");
-      }
-
-      for (const tinyxml2::XMLAttribute *attribute = elemXml->FirstAttribute();
-           attribute; attribute = attribute->Next())
-      {
-        element->AddAttribute(attribute->Name(), "string", "", 1, "");
-        element->GetAttribute(attribute->Name())->SetFromString(
-          attribute->Value());
-      }
-
-      copyChildren(element, elemXml, _onlyUnknown);
-      _sdf->InsertElement(element);
-    }
   }
 }
 
@@ -1553,29 +1592,29 @@ bool checkFrameAttachedToNames(const sdf::Root *_root)
 //////////////////////////////////////////////////
 bool recursiveSameTypeUniqueNames(sdf::ElementPtr _elem)
 {
-  if (!shouldValidateElement(_elem))
-    return true;
-
   bool result = true;
-  auto typeNames = _elem->GetElementTypeNames();
-  for (const std::string &typeName : typeNames)
+
+  ElementVisitor visitor;
+  visitor.SetPreVisit([&result](const ElementPtr &_child, std::size_t)
   {
-    if (!_elem->HasUniqueChildNames(typeName))
+    if (!shouldValidateElement(_child))
+      return TraversalAction::SKIP_CHILDREN;
+
+    auto typeNames = _child->GetElementTypeNames();
+    for (const std::string &typeName : typeNames)
     {
-      std::cerr << "Error: Non-unique names detected in type "
-                << typeName << " in\n"
-                << _elem->ToString("")
-                << std::endl;
-      result = false;
+      if (!_child->HasUniqueChildNames(typeName))
+      {
+        std::cerr << "Error: Non-unique names detected in type "
+                  << typeName << " in\n"
+                  << _child->ToString("")
+                  << std::endl;
+        result = false;
+      }
     }
-  }
-
-  sdf::ElementPtr child = _elem->GetFirstElement();
-  while (child)
-  {
-    result = recursiveSameTypeUniqueNames(child) && result;
-    child = child->GetNextElement();
-  }
+    return TraversalAction::CONTINUE;
+  });
+  visitor.Visit(_elem);
 
   return result;
 }
@@ -1583,24 +1622,24 @@ bool recursiveSameTypeUniqueNames(sdf::ElementPtr _elem)
 //////////////////////////////////////////////////
 bool recursiveSiblingUniqueNames(sdf::ElementPtr _elem)
 {
-  if (!shouldValidateElement(_elem))
-    return true;
+  bool result = true;
 
-  bool result = _elem->HasUniqueChildNames();
-  if (!result)
+  ElementVisitor visitor;
+  visitor.SetPreVisit([&result](const ElementPtr &_child, std::size_t)
   {
-    std::cerr << "Error: Non-unique names detected in "
-              << _elem->ToString("")
-              << std::endl;
-    result = false;
-  }
+    if (!shouldValidateElement(_child))
+      return TraversalAction::SKIP_CHILDREN;
 
-  sdf::ElementPtr child = _elem->GetFirstElement();
-  while (child)
-  {
-    result = recursiveSiblingUniqueNames(child) && result;
-    child = child->GetNextElement();
-  }
+    if (!_child->HasUniqueChildNames())
+    {
+      std::cerr << "Error: Non-unique names detected in "
+                << _child->ToString("")
+                << std::endl;
+      result = false;
+    }
+    return TraversalAction::CONTINUE;
+  });
+  visitor.Visit(_elem);
 
   return result;
 }
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "FrameSemantics.hh"
+#include "FrozenGraph.hh"
+#include "ScopedGraph.hh"
+
+using Pose = ignition::math::Pose3d;
+
+/////////////////////////////////////////////////
+/// \brief Graphs of a model whose frames form a binary tree below a link.
+struct ModelGraphs
+{
+  /// \brief Constructor.
+  /// \param[in] _frameCount Number of frames.
+  explicit ModelGraphs(std::size_t _frameCount)
+  {
+    this->pose = this->pose.AddScopeVertex(
+        "", "__model__", "__model__", sdf::FrameType::MODEL);
+    this->attachedTo = this->attachedTo.AddScopeVertex(
+        "", "__model__", "__model__", sdf::FrameType::MODEL);
+
+    const auto linkPoseId =
+        this->pose.AddVertex("L", sdf::FrameType::LINK).Id();
+    const auto linkAttachedToId =
+        this->attachedTo.AddVertex("L", sdf::FrameType::LINK).Id();
+    this->pose.AddEdge(
+        {this->pose.ScopeVertexId(), linkPoseId}, Pose(1, 0, 0, 0, 0, 0));
+    this->attachedTo.AddEdge(
+        {this->attachedTo.ScopeVertexId(), linkAttachedToId}, true);
+
+    std::vector<ignition::math::graph::VertexId> poseIds;
+    std::vector<ignition::math::graph::VertexId> attachedToIds;
+    for (std::size_t i = 0; i < _frameCount; ++i)
+    {
+      const std::string name = "F" + std::to_string(i);
+      poseIds.push_back(
+          this->pose.AddVertex(name, sdf::FrameType::FRAME).Id());
+      attachedToIds.push_back(
+          this->attachedTo.AddVertex(name, sdf::FrameType::FRAME).Id());
+      const auto poseParent = i == 0 ? linkPoseId : poseIds[(i - 1) / 2];
+      const auto attachedToParent =
+          i == 0 ? linkAttachedToId : attachedToIds[(i - 1) / 2];
+      this->pose.AddEdge({poseParent, poseIds.back()},
+          Pose(0.1, 0, 0, 0, 0, IGN_PI / 8));
+      this->attachedTo.AddEdge({attachedToIds.back(), attachedToParent}, true);
+    }
+  }
+
+  /// \brief PoseRelativeTo graph.
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> pose{
+      std::make_shared<sdf::PoseRelativeToGraph>()};
+
+  /// \brief FrameAttachedTo graph.
+  sdf::ScopedGraph<sdf::FrameAttachedToGraph> attachedTo{
+      std::make_shared<sdf::FrameAttachedToGraph>()};
+};
+
+/////////////////////////////////////////////////
+/// \brief Time a function.
+/// \param[in] _label Label to print with the time.
+/// \param[in] _function Function to time.
+template <typename F>
+void timed(const std::string &_label, F _function)
+{
+  auto start = std::chrono::steady_clock::now();
+  _function();
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "  " << _label << ": "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+}
+
+/////////////////////////////////////////////////
+/// \brief Compare resolution and validation on the original and the frozen
+/// graphs of a model.
+/// \param[in] _frameCount Number of frames of the model.
+void benchmark(std::size_t _frameCount)
+{
+  std::cout << _frameCount << " frames" << std::endl;
+  ModelGraphs graphs(_frameCount);
+  const auto names = graphs.pose.VertexNames();
+
+  timed("validate", [&]
+  {
+    EXPECT_TRUE(sdf::validatePoseRelativeToGraph(graphs.pose).empty());
+    EXPECT_TRUE(sdf::validateFrameAttachedToGraph(graphs.attachedTo).empty());
+  });
+
+  std::unique_ptr<sdf::FrozenGraph<sdf::PoseRelativeToGraph>> frozenPose;
+  std::unique_ptr<sdf::FrozenGraph<sdf::FrameAttachedToGraph>>
+      frozenAttachedTo;
+  timed("freeze", [&]
+  {
+    frozenPose = std::make_unique<sdf::FrozenGraph<sdf::PoseRelativeToGraph>>(
+        graphs.pose);
+    frozenAttachedTo =
+        std::make_unique<sdf::FrozenGraph<sdf::FrameAttachedToGraph>>(
+            graphs.attachedTo);
+  });
+
+  std::size_t errorCount = 0;
+  Pose pose;
+  std::string body;
+  timed("resolve poses, uncached", [&]
+  {
+    for (const auto &name : names)
+    {
+      graphs.pose.PoseCache().Clear();
+      errorCount +=
+          sdf::resolvePoseRelativeToRoot(pose, graphs.pose, name).size();
+    }
+  });
+  timed("resolve poses, cached", [&]
+  {
+    for (const auto &name : names)
+    {
+      errorCount +=
+          sdf::resolvePoseRelativeToRoot(pose, graphs.pose, name).size();
+    }
+  });
+  timed("resolve poses, frozen", [&]
+  {
+    for (const auto index : frozenPose->ScopeIndices())
+    {
+      errorCount +=
+          sdf::resolvePoseRelativeToRoot(pose, *frozenPose, index).size();
+    }
+  });
+  timed("resolve bodies", [&]
+  {
+    for (const auto &name : names)
+    {
+      errorCount += sdf::resolveFrameAttachedToBody(
+          body, graphs.attachedTo, name).size();
+    }
+  });
+  timed("resolve bodies, frozen", [&]
+  {
+    for (const auto index : frozenAttachedTo->ScopeIndices())
+    {
+      errorCount += sdf::resolveFrameAttachedToBody(
+          body, *frozenAttachedTo, index).size();
+    }
+  });
+  EXPECT_EQ(0u, errorCount);
+}
+
+/////////////////////////////////////////////////
+TEST(FrozenGraph, Benchmark)
+{
+  benchmark(1000);
+  benchmark(10000);
+  benchmark(100000);
+}
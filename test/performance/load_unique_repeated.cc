@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "sdf/sdf.hh"
+
+#include "test_config.h"
+
+/////////////////////////////////////////////////
+/// \brief Create an element with a name attribute.
+/// \param[in] _type Name of the element.
+/// \param[in] _name Value of the name attribute.
+/// \param[in] _parent Parent of the element.
+/// \return The new element.
+sdf::ElementPtr namedElement(const std::string &_type,
+    const std::string &_name, const sdf::ElementPtr &_parent)
+{
+  sdf::ElementPtr elem(new sdf::Element);
+  elem->SetName(_type);
+  elem->AddAttribute("name", "string", "", true);
+  elem->GetAttribute("name")->SetFromString(_name);
+  if (_parent)
+  {
+    elem->SetParent(_parent);
+    _parent->InsertElement(elem);
+  }
+  return elem;
+}
+
+/////////////////////////////////////////////////
+/// \brief Load a model with _count links and one duplicate link name. The
+/// elements are built directly instead of being parsed, so the time is spent
+/// in Model::Load.
+/// \param[in] _count Number of links with distinct names.
+void loadModelWithLinks(std::size_t _count)
+{
+  sdf::ElementPtr modelElem = namedElement("model", "m", nullptr);
+  for (std::size_t i = 0; i < _count; ++i)
+    namedElement("link", "link_" + std::to_string(i), modelElem);
+  namedElement("link", "link_0", modelElem);
+
+  sdf::Model model;
+  auto start = std::chrono::steady_clock::now();
+  sdf::Errors errors = model.Load(modelElem);
+  auto end = std::chrono::steady_clock::now();
+
+  std::cout << _count << " links loaded in "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  std::size_t duplicates = 0;
+  for (const auto &error : errors)
+  {
+    if (error.Code() == sdf::ErrorCode::DUPLICATE_NAME)
+      ++duplicates;
+  }
+  EXPECT_EQ(1u, duplicates);
+  EXPECT_EQ(_count, model.LinkCount());
+  EXPECT_TRUE(model.LinkNameExists("link_" + std::to_string(_count - 1)));
+}
+
+/////////////////////////////////////////////////
+TEST(LoadUniqueRepeated, Links1k)
+{
+  loadModelWithLinks(1000);
+}
+
+/////////////////////////////////////////////////
+TEST(LoadUniqueRepeated, Links10k)
+{
+  loadModelWithLinks(10000);
+}
+
+/////////////////////////////////////////////////
+TEST(LoadUniqueRepeated, Links100k)
+{
+  loadModelWithLinks(100000);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "sdf/sdf.hh"
+
+#include "test_config.h"
+
+/////////////////////////////////////////////////
+/// \brief Load a world of independent models with a number of threads.
+/// \param[in] _worldElem The world element.
+/// \param[in] _threads Number of threads, 0 for the hardware threads.
+/// \return Load time in milliseconds.
+double loadWorld(const sdf::ElementPtr &_worldElem, unsigned int _threads)
+{
+  sdf::World world;
+  world.SetLoadThreads(_threads);
+  auto start = std::chrono::steady_clock::now();
+  sdf::Errors errors = world.Load(_worldElem);
+  auto end = std::chrono::steady_clock::now();
+
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(512u, world.ModelCount());
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/////////////////////////////////////////////////
+TEST(ParallelWorldLoad, Models512Links64)
+{
+  std::string sdf = "<?xml version=\"1.0\"?>"
+    "<sdf version=\"1.8\">"
+    "  <world name='default'>";
+  for (int m = 0; m < 512; ++m)
+  {
+    sdf += "<model name='model_" + std::to_string(m) + "'>";
+    for (int l = 0; l < 64; ++l)
+      sdf += "<link name='link_" + std::to_string(l) + "'/>";
+    sdf += "</model>";
+  }
+  sdf += "  </world>"
+    "</sdf>";
+
+  // Parse the document once, so that only World::Load is timed.
+  sdf::SDFPtr sdfParsed(new sdf::SDF());
+  sdf::init(sdfParsed);
+  sdf::Errors errors;
+  ASSERT_TRUE(sdf::readString(sdf, sdfParsed, errors));
+  EXPECT_TRUE(errors.empty());
+  sdf::ElementPtr worldElem = sdfParsed->Root()->GetElement("world");
+
+  // Load once first, so that the caches are warm for both timed loads.
+  loadWorld(worldElem, 1);
+
+  const double serial = loadWorld(worldElem, 1);
+  const double parallel = loadWorld(worldElem, 0);
+  std::cout << "Serial load:   " << serial << " ms\n"
+            << "Parallel load: " << parallel << " ms ("
+            << std::thread::hardware_concurrency() << " hardware threads)"
+            << std::endl;
+}
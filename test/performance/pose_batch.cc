@@ -0,0 +1,98 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ignition/math/Pose3.hh>
+
+#include "PoseBatch.hh"
+
+using Pose = ignition::math::Pose3d;
+
+/////////////////////////////////////////////////
+/// \brief Make random poses, with rotations that are not quite normalized
+/// as after long chains of compositions.
+/// \param[in] _count Number of poses.
+/// \param[in] _seed Seed of the random generator.
+/// \return The poses.
+std::vector<Pose> randomPoses(std::size_t _count, unsigned int _seed)
+{
+  std::mt19937 generator(_seed);
+  std::uniform_real_distribution<double> position(-100.0, 100.0);
+  std::uniform_real_distribution<double> angle(-4.0, 4.0);
+  std::uniform_real_distribution<double> scale(0.999, 1.001);
+  std::vector<Pose> poses;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    Pose pose(position(generator), position(generator), position(generator),
+        angle(generator), angle(generator), angle(generator));
+    const double s = scale(generator);
+    pose.Rot().Set(pose.Rot().W() * s, pose.Rot().X() * s,
+        pose.Rot().Y() * s, pose.Rot().Z() * s);
+    poses.push_back(pose);
+  }
+  return poses;
+}
+
+/////////////////////////////////////////////////
+TEST(PoseBatch, Benchmark)
+{
+  const std::size_t count = 100000;
+  const auto firstPoses = randomPoses(count, 1u);
+  const auto secondPoses = randomPoses(count, 2u);
+  sdf::PoseBatch first;
+  sdf::PoseBatch second;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    first.PushBack(firstPoses[i]);
+    second.PushBack(secondPoses[i]);
+  }
+
+  // Compose once before timing, so that the output memory is allocated.
+  std::vector<Pose> expected(count);
+  sdf::PoseBatch out;
+  sdf::composePoses(out, first, second);
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    expected[i] = firstPoses[i] * secondPoses[i];
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::cout << count << " poses composed with Pose3d::operator* in "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  sdf::composePoses(out, first, second);
+  end = std::chrono::steady_clock::now();
+  std::cout << count << " poses composed with composePoses in "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+
+  ASSERT_EQ(count, out.Size());
+  const Pose last = out.Pose(count - 1);
+  EXPECT_NEAR(0.0, (expected.back().Pos() - last.Pos()).Length(), 1e-10);
+  EXPECT_NEAR(expected.back().Rot().W(), last.Rot().W(), 1e-10);
+  EXPECT_NEAR(expected.back().Rot().X(), last.Rot().X(), 1e-10);
+  EXPECT_NEAR(expected.back().Rot().Y(), last.Rot().Y(), 1e-10);
+  EXPECT_NEAR(expected.back().Rot().Z(), last.Rot().Z(), 1e-10);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "FrameSemantics.hh"
+#include "PoseLcaIndex.hh"
+#include "ScopedGraph.hh"
+
+using Pose = ignition::math::Pose3d;
+
+/////////////////////////////////////////////////
+/// \brief Build a model graph whose frames form a binary tree below a link.
+/// \param[in] _frameCount Number of frames.
+/// \return Scope of the model graph.
+sdf::ScopedGraph<sdf::PoseRelativeToGraph> binaryTree(std::size_t _frameCount)
+{
+  sdf::ScopedGraph<sdf::PoseRelativeToGraph> graph(
+      std::make_shared<sdf::PoseRelativeToGraph>());
+  graph = graph.AddScopeVertex(
+      "", "__model__", "__model__", sdf::FrameType::MODEL);
+  const auto linkId = graph.AddVertex("L", sdf::FrameType::LINK).Id();
+  graph.AddEdge({graph.ScopeVertexId(), linkId}, Pose(1, 2, 3, 0, 0, 0));
+
+  std::vector<ignition::math::graph::VertexId> ids;
+  for (std::size_t i = 0; i < _frameCount; ++i)
+  {
+    ids.push_back(graph.AddVertex(
+          "F" + std::to_string(i), sdf::FrameType::FRAME).Id());
+    const auto parentId = i == 0 ? linkId : ids[(i - 1) / 2];
+    graph.AddEdge({parentId, ids.back()},
+        Pose(0.1 * (i % 3), 0.2, 0, 0, IGN_PI / 7, IGN_PI / (i % 5 + 3)));
+  }
+  return graph;
+}
+
+/////////////////////////////////////////////////
+TEST(PoseLcaIndex, Benchmark)
+{
+  for (std::size_t frameCount : {1000u, 10000u, 100000u})
+  {
+    auto graph = binaryTree(frameCount);
+    const auto names = graph.VertexNames();
+
+    auto start = std::chrono::steady_clock::now();
+    sdf::PoseLcaIndex index(graph);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << frameCount << " frames indexed in "
+              << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms" << std::endl;
+
+    // Query pairs of neighboring frames.
+    Pose pose;
+    std::size_t errorCount = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 1; i < names.size(); ++i)
+    {
+      errorCount += sdf::resolvePose(
+          pose, index.Graph(), names[i - 1], names[i]).size();
+    }
+    end = std::chrono::steady_clock::now();
+    std::cout << "  resolvePose on the frozen graph: "
+              << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 1; i < names.size(); ++i)
+    {
+      errorCount += index.ResolvePose(pose, names[i - 1], names[i]).size();
+    }
+    end = std::chrono::steady_clock::now();
+    std::cout << "  PoseLcaIndex::ResolvePose: "
+              << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms" << std::endl;
+    EXPECT_EQ(0u, errorCount);
+  }
+}